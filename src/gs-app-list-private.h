@@ -40,6 +40,20 @@ typedef enum {
 	GS_APP_LIST_FILTER_FLAG_LAST
 } GsAppListFilterFlags;
 
+/**
+ * GsAppListIter:
+ *
+ * An iterator over a snapshot of a #GsAppList.
+ **/
+typedef struct {
+	/*< private >*/
+	GsAppList	*list;
+	GPtrArray	*array;
+	guint		 idx;
+} GsAppListIter;
+
+typedef struct _GsAppListQuery GsAppListQuery;
+
 typedef gboolean (*GsAppListFilterFunc)		(GsApp		*app,
 						 gpointer	 user_data);
 typedef gboolean (*GsAppListSortFunc)		(GsApp		*app1,
@@ -57,6 +71,28 @@ void		 gs_app_list_filter_duplicates	(GsAppList	*list,
 						 GsAppListFilterFlags flags);
 void		 gs_app_list_randomize		(GsAppList	*list);
 void		 gs_app_list_remove_all		(GsAppList	*list);
+void		 gs_app_list_iter_init		(GsAppListIter	*iter,
+						 GsAppList	*list);
+gboolean	 gs_app_list_iter_next		(GsAppListIter	*iter,
+						 GsApp		**app);
+void		 gs_app_list_iter_clear		(GsAppListIter	*iter);
+
+GsAppListQuery	*gs_app_list_query_new		(void);
+void		 gs_app_list_query_free		(GsAppListQuery	*query);
+void		 gs_app_list_query_add_filter	(GsAppListQuery	*query,
+						 GsAppListFilterFunc func,
+						 gpointer	 user_data);
+void		 gs_app_list_query_set_dedupe	(GsAppListQuery	*query,
+						 GsAppListFilterFlags flags);
+void		 gs_app_list_query_set_sort	(GsAppListQuery	*query,
+						 GsAppListSortFunc func,
+						 gpointer	 user_data);
+void		 gs_app_list_query_set_max_results (GsAppListQuery *query,
+						 guint		 max_results);
+void		 gs_app_list_query_run		(GsAppListQuery	*query,
+						 GsAppList	*list);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (GsAppListQuery, gs_app_list_query_free)
 
 G_END_DECLS
 
@@ -27,6 +27,10 @@
  * @short_description: An application list
  *
  * These functions provide a refcounted list of #GsApp objects.
+ *
+ * All the functions are safe to call from multiple threads. Iterating with
+ * gs_app_list_iter_init() works on a snapshot of the list, so other threads
+ * can keep adding applications while the caller is looping.
  */
 
 #include "config.h"
@@ -40,12 +44,31 @@ struct _GsAppList
 {
 	GObject			 parent_instance;
 	GPtrArray		*array;
+	guint			 array_snapshots;	/* iterators using array */
 	GHashTable		*hash_by_id;		/* app-id : app */
 	GMutex			 mutex;
 };
 
 G_DEFINE_TYPE (GsAppList, gs_app_list, G_TYPE_OBJECT)
 
+/* copy the array before it is modified if a snapshot is using it */
+static void
+gs_app_list_unshare (GsAppList *list)
+{
+	GPtrArray *array;
+	guint i;
+
+	if (list->array_snapshots == 0)
+		return;
+	array = g_ptr_array_new_full (list->array->len,
+				      (GDestroyNotify) g_object_unref);
+	for (i = 0; i < list->array->len; i++)
+		g_ptr_array_add (array, g_object_ref (g_ptr_array_index (list->array, i)));
+	g_ptr_array_unref (list->array);
+	list->array = array;
+	list->array_snapshots = 0;
+}
+
 /**
  * gs_app_list_lookup:
  * @list: A #GsAppList
@@ -105,6 +128,8 @@ gs_app_list_add_safe (GsAppList *list, GsApp *app)
 	const gchar *id;
 	guint i;
 
+	gs_app_list_unshare (list);
+
 	/* if we're lazy-loading the ID then we can't filter for duplicates */
 	id = gs_app_get_unique_id (app);
 	if (id == NULL) {
@@ -145,6 +170,36 @@ gs_app_list_add (GsAppList *list, GsApp *app)
 	gs_app_list_add_safe (list, app);
 }
 
+/**
+ * gs_app_list_add_list:
+ * @list: A #GsAppList
+ * @donor: Another #GsAppList
+ *
+ * Adds all the applications in @donor to @list, taking the lock on @list
+ * only once. This allows threads to build results in private lists and
+ * merge them at the end, rather than contending on a shared list.
+ *
+ * Since: 3.24
+ **/
+void
+gs_app_list_add_list (GsAppList *list, GsAppList *donor)
+{
+	GsAppListIter iter;
+	GsApp *app;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_APP_LIST (list));
+	g_return_if_fail (GS_IS_APP_LIST (donor));
+	g_return_if_fail (list != donor);
+
+	/* snapshot first so the two locks are never held together */
+	gs_app_list_iter_init (&iter, donor);
+	locker = g_mutex_locker_new (&list->mutex);
+	while (gs_app_list_iter_next (&iter, &app))
+		gs_app_list_add_safe (list, app);
+	gs_app_list_iter_clear (&iter);
+}
+
 /**
  * gs_app_list_index:
  * @list: A #GsAppList
@@ -159,6 +214,9 @@ gs_app_list_add (GsAppList *list, GsApp *app)
 GsApp *
 gs_app_list_index (GsAppList *list, guint idx)
 {
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&list->mutex);
+	if (idx >= list->array->len)
+		return NULL;
 	return GS_APP (g_ptr_array_index (list->array, idx));
 }
 
@@ -175,17 +233,129 @@ gs_app_list_index (GsAppList *list, guint idx)
 guint
 gs_app_list_length (GsAppList *list)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_return_val_if_fail (GS_IS_APP_LIST (list), 0);
+	locker = g_mutex_locker_new (&list->mutex);
 	return list->array->len;
 }
 
+/**
+ * gs_app_list_iter_init:
+ * @iter: A #GsAppListIter
+ * @list: A #GsAppList
+ *
+ * Initializes an iterator over a snapshot of @list. Taking the snapshot
+ * does not copy the list; it is only copied if @list is modified while
+ * the iterator is in use.
+ *
+ * The iterator must be freed with gs_app_list_iter_clear().
+ **/
+void
+gs_app_list_iter_init (GsAppListIter *iter, GsAppList *list)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&list->mutex);
+	iter->list = g_object_ref (list);
+	iter->array = g_ptr_array_ref (list->array);
+	iter->idx = 0;
+	list->array_snapshots++;
+}
+
+/**
+ * gs_app_list_iter_next:
+ * @iter: A #GsAppListIter
+ * @app: (out) (transfer none): the next #GsApp
+ *
+ * Advances the iterator.
+ *
+ * Returns: %FALSE when there are no more applications
+ **/
+gboolean
+gs_app_list_iter_next (GsAppListIter *iter, GsApp **app)
+{
+	if (iter->idx >= iter->array->len)
+		return FALSE;
+	*app = g_ptr_array_index (iter->array, iter->idx++);
+	return TRUE;
+}
+
+/**
+ * gs_app_list_iter_clear:
+ * @iter: A #GsAppListIter
+ *
+ * Frees the snapshot held by the iterator.
+ **/
+void
+gs_app_list_iter_clear (GsAppListIter *iter)
+{
+	GsAppList *list = iter->list;
+
+	if (list == NULL)
+		return;
+
+	/* the list can be modified in place again once nothing is using it */
+	g_mutex_lock (&list->mutex);
+	if (iter->array == list->array && list->array_snapshots > 0)
+		list->array_snapshots--;
+	g_mutex_unlock (&list->mutex);
+	g_clear_pointer (&iter->array, g_ptr_array_unref);
+	g_clear_object (&iter->list);
+}
+
 static void
 gs_app_list_remove_all_safe (GsAppList *list)
 {
+	gs_app_list_unshare (list);
 	g_ptr_array_set_size (list->array, 0);
 	g_hash_table_remove_all (list->hash_by_id);
 }
 
+/* shrink the array to @len without unreffing the entries past the end */
+static void
+gs_app_list_set_size_safe (GsAppList *list, guint len)
+{
+	/* the removed entries have already been moved or unreffed */
+	g_ptr_array_set_free_func (list->array, NULL);
+	g_ptr_array_set_size (list->array, len);
+	g_ptr_array_set_free_func (list->array, (GDestroyNotify) g_object_unref);
+}
+
+/* drop the entries set to %NULL, keeping the order of the others */
+static void
+gs_app_list_compact_safe (GsAppList *list)
+{
+	guint i;
+	guint j = 0;
+
+	for (i = 0; i < list->array->len; i++) {
+		gpointer app = g_ptr_array_index (list->array, i);
+		if (app != NULL)
+			list->array->pdata[j++] = app;
+	}
+	gs_app_list_set_size_safe (list, j);
+}
+
+/* release the reference the list holds on @app, which must already have
+ * been taken out of the array */
+static void
+gs_app_list_drop_safe (GsAppList *list, GsApp *app)
+{
+	const gchar *id = gs_app_get_unique_id (app);
+
+	if (id != NULL && g_hash_table_lookup (list->hash_by_id, id) == app)
+		g_hash_table_remove (list->hash_by_id, id);
+	g_object_unref (app);
+}
+
+/* take @app at @idx out of the list, leaving a %NULL to be compacted */
+static void
+gs_app_list_steal_safe (GsAppList *list, guint idx)
+{
+	GsApp *app = g_ptr_array_index (list->array, idx);
+
+	list->array->pdata[idx] = NULL;
+	gs_app_list_drop_safe (list, app);
+}
+
 /**
  * gs_app_list_remove_all:
  * @list: A #GsAppList
@@ -210,29 +380,28 @@ gs_app_list_remove_all (GsAppList *list)
  *
  * If func() returns TRUE for the GsApp, then the app is kept.
  *
+ * The list is filtered in place and the order of the kept applications
+ * is preserved.
+ *
  * Since: 3.22
  **/
 void
 gs_app_list_filter (GsAppList *list, GsAppListFilterFunc func, gpointer user_data)
 {
 	guint i;
-	GsApp *app;
-	g_autoptr(GsAppList) old = NULL;
 	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&list->mutex);
 
 	g_return_if_fail (GS_IS_APP_LIST (list));
 	g_return_if_fail (func != NULL);
 
-	/* deep copy to a temp list and clear the current one */
-	old = gs_app_list_copy (list);
-	gs_app_list_remove_all_safe (list);
-
 	/* see if any of the apps need filtering */
-	for (i = 0; i < old->array->len; i++) {
-		app = gs_app_list_index (old, i);
-		if (func (app, user_data))
-			gs_app_list_add_safe (list, app);
+	gs_app_list_unshare (list);
+	for (i = 0; i < list->array->len; i++) {
+		GsApp *app = g_ptr_array_index (list->array, i);
+		if (!func (app, user_data))
+			gs_app_list_steal_safe (list, i);
 	}
+	gs_app_list_compact_safe (list);
 }
 
 typedef struct {
@@ -266,6 +435,7 @@ gs_app_list_sort (GsAppList *list, GsAppListSortFunc func, gpointer user_data)
 	g_return_if_fail (GS_IS_APP_LIST (list));
 	helper.func = func;
 	helper.user_data = user_data;
+	gs_app_list_unshare (list);
 	g_ptr_array_sort_with_data (list->array, gs_app_list_sort_cb, &helper);
 }
 
@@ -310,16 +480,17 @@ gs_app_list_randomize (GsAppList *list)
 	rand = g_rand_new ();
 	date = g_date_time_new_now_utc ();
 	g_rand_set_seed (rand, (guint32) g_date_time_get_day_of_year (date));
-	for (i = 0; i < gs_app_list_length (list); i++) {
-		app = gs_app_list_index (list, i);
+	gs_app_list_unshare (list);
+	for (i = 0; i < list->array->len; i++) {
+		app = g_ptr_array_index (list->array, i);
 		sort_key[0] = (gchar) g_rand_int_range (rand, (gint32) 'A', (gint32) 'Z');
 		sort_key[1] = (gchar) g_rand_int_range (rand, (gint32) 'A', (gint32) 'Z');
 		sort_key[2] = (gchar) g_rand_int_range (rand, (gint32) 'A', (gint32) 'Z');
 		gs_app_set_metadata (app, key, sort_key);
 	}
 	g_ptr_array_sort_with_data (list->array, gs_app_list_randomize_cb, list);
-	for (i = 0; i < gs_app_list_length (list); i++) {
-		app = gs_app_list_index (list, i);
+	for (i = 0; i < list->array->len; i++) {
+		app = g_ptr_array_index (list->array, i);
 		gs_app_set_metadata (app, key, NULL);
 	}
 	g_rand_free (rand);
@@ -331,73 +502,416 @@ gs_app_list_randomize (GsAppList *list)
  *
  * Filter any duplicate applications from the list.
  *
+ * The first application for each ID keeps its position in the list. With
+ * %GS_APP_LIST_FILTER_FLAG_PRIORITY a better duplicate takes over that
+ * position rather than being added at the end.
+ *
  * Since: 3.22
  **/
 void
 gs_app_list_filter_duplicates (GsAppList *list, GsAppListFilterFlags flags)
+{
+	g_autoptr(GsAppListQuery) query = gs_app_list_query_new ();
+
+	g_return_if_fail (GS_IS_APP_LIST (list));
+
+	gs_app_list_query_set_dedupe (query, flags);
+	gs_app_list_query_run (query, list);
+}
+
+typedef struct {
+	GsAppListFilterFunc	 func;
+	gpointer		 user_data;
+} GsAppListQueryFilter;
+
+struct _GsAppListQuery
+{
+	GArray			*filters;	/* of GsAppListQueryFilter */
+	gboolean		 dedupe;
+	GsAppListFilterFlags	 dedupe_flags;
+	GsAppListSortFunc	 sort_func;
+	gpointer		 sort_user_data;
+	guint			 max_results;
+};
+
+typedef struct {
+	GsApp			*app;
+	guint			 idx;		/* position before sorting */
+} GsAppListQueryItem;
+
+/**
+ * gs_app_list_query_new:
+ *
+ * Creates a query that filters, de-duplicates, sorts and truncates a
+ * #GsAppList in one pass with gs_app_list_query_run().
+ *
+ * This is cheaper than calling gs_app_list_filter() once for each check,
+ * as the list is only locked and compacted once, and when a maximum
+ * number of results is set only the applications that are kept are
+ * sorted.
+ *
+ * Returns: A newly allocated #GsAppListQuery
+ **/
+GsAppListQuery *
+gs_app_list_query_new (void)
+{
+	GsAppListQuery *query = g_slice_new0 (GsAppListQuery);
+	query->filters = g_array_new (FALSE, FALSE, sizeof (GsAppListQueryFilter));
+	return query;
+}
+
+/**
+ * gs_app_list_query_free:
+ * @query: A #GsAppListQuery
+ *
+ * Frees the query.
+ **/
+void
+gs_app_list_query_free (GsAppListQuery *query)
+{
+	g_array_unref (query->filters);
+	g_slice_free (GsAppListQuery, query);
+}
+
+/**
+ * gs_app_list_query_add_filter:
+ * @query: A #GsAppListQuery
+ * @func: A #GsAppListFilterFunc
+ * @user_data: the user pointer to pass to @func
+ *
+ * Adds a filter to the query. The filters are run in the order they were
+ * added and an application is only kept if all of them return %TRUE, so
+ * filters that just set properties on the application, such as the
+ * priority used for de-duplication, should be added last.
+ **/
+void
+gs_app_list_query_add_filter (GsAppListQuery *query,
+			      GsAppListFilterFunc func,
+			      gpointer user_data)
+{
+	GsAppListQueryFilter filter;
+
+	g_return_if_fail (func != NULL);
+
+	filter.func = func;
+	filter.user_data = user_data;
+	g_array_append_val (query->filters, filter);
+}
+
+/**
+ * gs_app_list_query_set_dedupe:
+ * @query: A #GsAppListQuery
+ * @flags: a #GsAppListFilterFlags
+ *
+ * Makes the query remove duplicate applications in the same way as
+ * gs_app_list_filter_duplicates().
+ **/
+void
+gs_app_list_query_set_dedupe (GsAppListQuery *query, GsAppListFilterFlags flags)
+{
+	query->dedupe = TRUE;
+	query->dedupe_flags = flags;
+}
+
+/**
+ * gs_app_list_query_set_sort:
+ * @query: A #GsAppListQuery
+ * @func: A #GsAppListSortFunc
+ * @user_data: the user pointer to pass to @func
+ *
+ * Sorts the results of the query. Applications that compare equal keep
+ * the order they had in the list.
+ **/
+void
+gs_app_list_query_set_sort (GsAppListQuery *query,
+			    GsAppListSortFunc func,
+			    gpointer user_data)
+{
+	query->sort_func = func;
+	query->sort_user_data = user_data;
+}
+
+/**
+ * gs_app_list_query_set_max_results:
+ * @query: A #GsAppListQuery
+ * @max_results: the number of applications to keep, or 0 for no limit
+ *
+ * Limits the number of results of the query. If a sort function is set the
+ * best @max_results applications are kept, otherwise the first ones.
+ **/
+void
+gs_app_list_query_set_max_results (GsAppListQuery *query, guint max_results)
+{
+	query->max_results = max_results;
+}
+
+static gboolean
+gs_app_list_query_match (GsAppListQuery *query, GsApp *app)
 {
 	guint i;
-	GsApp *app;
+
+	for (i = 0; i < query->filters->len; i++) {
+		GsAppListQueryFilter *filter;
+		filter = &g_array_index (query->filters, GsAppListQueryFilter, i);
+		if (!filter->func (app, filter->user_data))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/* returns %TRUE if @app is not a duplicate and should be kept at @len;
+ * the values in @hash are the index of the app that is kept, plus one */
+static gboolean
+gs_app_list_query_dedupe_safe (GsAppListQuery *query,
+			       GsAppList *list,
+			       GHashTable *hash,
+			       GsApp *app,
+			       guint len)
+{
 	GsApp *found;
 	const gchar *id;
-	g_autoptr(GHashTable) hash = NULL;
-	g_autoptr(GList) values = NULL;
-	GList *l;
-	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&list->mutex);
+	guint idx;
 
-	g_return_if_fail (GS_IS_APP_LIST (list));
+	if (query->dedupe_flags & GS_APP_LIST_FILTER_FLAG_PRIORITY)
+		id = gs_app_get_id (app);
+	else
+		id = gs_app_get_unique_id (app);
+	if (id == NULL) {
+		g_autofree gchar *str = gs_app_to_string (app);
+		g_debug ("ignoring as no application id for: %s", str);
+		gs_app_list_drop_safe (list, app);
+		return FALSE;
+	}
+	idx = GPOINTER_TO_UINT (g_hash_table_lookup (hash, id));
+	if (idx == 0) {
+		g_debug ("found new %s", id);
+		g_hash_table_insert (hash, (gpointer) id, GUINT_TO_POINTER (len + 1));
+		return TRUE;
+	}
+	found = g_ptr_array_index (list->array, idx - 1);
+
+	/* the same object added twice, so keep the hash entry */
+	if (found == app) {
+		g_object_unref (app);
+		return FALSE;
+	}
+
+	/* better? */
+	if (query->dedupe_flags & GS_APP_LIST_FILTER_FLAG_PRIORITY) {
+		if (gs_app_get_priority (app) >
+		    gs_app_get_priority (found)) {
+			g_debug ("using better %s (priority %u > %u)",
+				 id,
+				 gs_app_get_priority (app),
+				 gs_app_get_priority (found));
+
+			/* the better app takes the earlier slot, and the
+			 * key now has to be owned by it */
+			list->array->pdata[idx - 1] = app;
+			g_hash_table_replace (hash, (gpointer) id,
+					      GUINT_TO_POINTER (idx));
+			gs_app_list_drop_safe (list, found);
+			return FALSE;
+		}
+		g_debug ("ignoring worse duplicate %s (priority %u > %u)",
+			 id,
+			 gs_app_get_priority (app),
+			 gs_app_get_priority (found));
+		gs_app_list_drop_safe (list, app);
+		return FALSE;
+	}
+	g_debug ("ignoring duplicate %s", id);
+	gs_app_list_drop_safe (list, app);
+	return FALSE;
+}
+
+static gint
+gs_app_list_query_item_cmp (GsAppListQuery *query,
+			    GsAppListQueryItem *item1,
+			    GsAppListQueryItem *item2)
+{
+	gint rc;
+
+	rc = query->sort_func (item1->app, item2->app, query->sort_user_data);
+	if (rc != 0)
+		return rc;
+
+	/* keep the sort stable */
+	if (item1->idx < item2->idx)
+		return -1;
+	if (item1->idx > item2->idx)
+		return 1;
+	return 0;
+}
+
+static gint
+gs_app_list_query_item_sort_cb (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	return gs_app_list_query_item_cmp ((GsAppListQuery *) user_data,
+					   (GsAppListQueryItem *) a,
+					   (GsAppListQueryItem *) b);
+}
 
-	/* create a new list with just the unique items */
-	hash = g_hash_table_new_full (g_str_hash, g_str_equal,
-				      g_free, (GDestroyNotify) g_object_unref);
+static void
+gs_app_list_query_heap_swap (GArray *heap, guint idx1, guint idx2)
+{
+	GsAppListQueryItem tmp = g_array_index (heap, GsAppListQueryItem, idx1);
+	g_array_index (heap, GsAppListQueryItem, idx1) = g_array_index (heap, GsAppListQueryItem, idx2);
+	g_array_index (heap, GsAppListQueryItem, idx2) = tmp;
+}
+
+/* the heap keeps the worst of the kept apps at the top */
+static void
+gs_app_list_query_heap_up (GsAppListQuery *query, GArray *heap, guint idx)
+{
+	while (idx > 0) {
+		guint parent = (idx - 1) / 2;
+		if (gs_app_list_query_item_cmp (query,
+						&g_array_index (heap, GsAppListQueryItem, idx),
+						&g_array_index (heap, GsAppListQueryItem, parent)) <= 0)
+			break;
+		gs_app_list_query_heap_swap (heap, idx, parent);
+		idx = parent;
+	}
+}
+
+static void
+gs_app_list_query_heap_down (GsAppListQuery *query, GArray *heap, guint idx)
+{
+	while (TRUE) {
+		guint child = idx * 2 + 1;
+		guint worst = idx;
+
+		if (child < heap->len &&
+		    gs_app_list_query_item_cmp (query,
+						&g_array_index (heap, GsAppListQueryItem, child),
+						&g_array_index (heap, GsAppListQueryItem, worst)) > 0)
+			worst = child;
+		child++;
+		if (child < heap->len &&
+		    gs_app_list_query_item_cmp (query,
+						&g_array_index (heap, GsAppListQueryItem, child),
+						&g_array_index (heap, GsAppListQueryItem, worst)) > 0)
+			worst = child;
+		if (worst == idx)
+			break;
+		gs_app_list_query_heap_swap (heap, idx, worst);
+		idx = worst;
+	}
+}
+
+/* sort the list, keeping only the best max_results apps in a bounded heap
+ * so that the apps that are thrown away never get sorted */
+static void
+gs_app_list_query_sort_safe (GsAppListQuery *query, GsAppList *list)
+{
+	guint i;
+	guint len = list->array->len;
+	g_autoptr(GArray) items = NULL;
+
+	if (query->max_results > 0 && query->max_results < len)
+		len = query->max_results;
+	items = g_array_sized_new (FALSE, FALSE, sizeof (GsAppListQueryItem), len);
 	for (i = 0; i < list->array->len; i++) {
-		app = gs_app_list_index (list, i);
-		id = gs_app_get_unique_id (app);
-		if (flags & GS_APP_LIST_FILTER_FLAG_PRIORITY)
-			id = gs_app_get_id (app);
-		if (id == NULL) {
-			g_autofree gchar *str = gs_app_to_string (app);
-			g_debug ("ignoring as no application id for: %s", str);
+		GsAppListQueryItem item;
+		GsAppListQueryItem *worst;
+
+		item.app = g_ptr_array_index (list->array, i);
+		item.idx = i;
+		if (items->len < len) {
+			g_array_append_val (items, item);
+			if (len < list->array->len)
+				gs_app_list_query_heap_up (query, items, items->len - 1);
 			continue;
 		}
-		found = g_hash_table_lookup (hash, id);
-		if (found == NULL) {
-			g_debug ("found new %s", id);
-			g_hash_table_insert (hash,
-					     g_strdup (id),
-					     g_object_ref (app));
+
+		/* only replace the worst kept app if this one is better */
+		worst = &g_array_index (items, GsAppListQueryItem, 0);
+		if (gs_app_list_query_item_cmp (query, &item, worst) >= 0) {
+			gs_app_list_drop_safe (list, item.app);
 			continue;
 		}
+		gs_app_list_drop_safe (list, worst->app);
+		*worst = item;
+		gs_app_list_query_heap_down (query, items, 0);
+	}
 
-		/* better? */
-		if (flags & GS_APP_LIST_FILTER_FLAG_PRIORITY) {
-			if (gs_app_get_priority (app) >
-			    gs_app_get_priority (found)) {
-				g_debug ("using better %s (priority %u > %u)",
-					 id,
-					 gs_app_get_priority (app),
-					 gs_app_get_priority (found));
-				g_hash_table_insert (hash,
-						     g_strdup (id),
-						     g_object_ref (app));
-				continue;
-			}
-			g_debug ("ignoring worse duplicate %s (priority %u > %u)",
-				 id,
-				 gs_app_get_priority (app),
-				 gs_app_get_priority (found));
+	/* sort what is left */
+	g_array_sort_with_data (items, gs_app_list_query_item_sort_cb, query);
+	for (i = 0; i < items->len; i++) {
+		GsAppListQueryItem *item = &g_array_index (items, GsAppListQueryItem, i);
+		list->array->pdata[i] = item->app;
+	}
+	gs_app_list_set_size_safe (list, items->len);
+}
+
+/**
+ * gs_app_list_query_run:
+ * @query: A #GsAppListQuery
+ * @list: A #GsAppList
+ *
+ * Runs the query on the list in place, taking the lock on @list only once.
+ *
+ * The filters and de-duplication are done in a single pass over the list,
+ * and then the applications that are left are sorted and truncated.
+ **/
+void
+gs_app_list_query_run (GsAppListQuery *query, GsAppList *list)
+{
+	guint i;
+	guint len = 0;
+	g_autoptr(GHashTable) hash = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (query != NULL);
+	g_return_if_fail (GS_IS_APP_LIST (list));
+
+	/* the keys are owned by the apps in the list */
+	if (query->dedupe) {
+		if (query->dedupe_flags & GS_APP_LIST_FILTER_FLAG_PRIORITY) {
+			hash = g_hash_table_new (g_str_hash, g_str_equal);
+		} else {
+			hash = g_hash_table_new ((GHashFunc) as_utils_unique_id_hash,
+						 (GEqualFunc) as_utils_unique_id_equal);
+		}
+	}
+
+	/* filter and de-duplicate, compacting the array as we go */
+	locker = g_mutex_locker_new (&list->mutex);
+	gs_app_list_unshare (list);
+	for (i = 0; i < list->array->len; i++) {
+		GsApp *app = g_ptr_array_index (list->array, i);
+		if (!gs_app_list_query_match (query, app)) {
+			gs_app_list_drop_safe (list, app);
+			continue;
+		}
+		if (hash != NULL &&
+		    !gs_app_list_query_dedupe_safe (query, list, hash, app, len))
 			continue;
+		list->array->pdata[len++] = app;
+	}
+	gs_app_list_set_size_safe (list, len);
+
+	/* lazy-loaded IDs were not known when the apps were added */
+	if (query->dedupe) {
+		for (i = 0; i < list->array->len; i++) {
+			GsApp *app = g_ptr_array_index (list->array, i);
+			const gchar *id = gs_app_get_unique_id (app);
+			if (id == NULL)
+				continue;
+			if (g_hash_table_lookup (list->hash_by_id, id) != NULL)
+				continue;
+			g_hash_table_insert (list->hash_by_id, g_strdup (id), g_object_ref (app));
 		}
-		g_debug ("ignoring duplicate %s", id);
-		continue;
 	}
 
-	/* add back the best results to the existing list */
-	gs_app_list_remove_all_safe (list);
-	values = g_hash_table_get_values (hash);
-	for (l = values; l != NULL; l = l->next) {
-		app = GS_APP (l->data);
-		gs_app_list_add_safe (list, app);
+	/* order and limit what is left */
+	if (query->sort_func != NULL) {
+		gs_app_list_query_sort_safe (query, list);
+	} else if (query->max_results > 0 && list->array->len > query->max_results) {
+		for (i = query->max_results; i < list->array->len; i++)
+			gs_app_list_drop_safe (list, g_ptr_array_index (list->array, i));
+		gs_app_list_set_size_safe (list, query->max_results);
 	}
 }
 
@@ -415,15 +929,11 @@ GsAppList *
 gs_app_list_copy (GsAppList *list)
 {
 	GsAppList *new;
-	guint i;
 
 	g_return_val_if_fail (GS_IS_APP_LIST (list), NULL);
 
 	new = gs_app_list_new ();
-	for (i = 0; i < gs_app_list_length (list); i++) {
-		GsApp *app = gs_app_list_index (list, i);
-		gs_app_list_add_safe (new, app);
-	}
+	gs_app_list_add_list (new, list);
 	return new;
 }
 
@@ -61,13 +61,13 @@ struct _GsApp
 	gchar			*id;
 	gchar			*unique_id;
 	gboolean		 unique_id_valid;
-	gchar			*branch;
+	const gchar		*branch;	/* pooled */
 	gchar			*name;
 	GsAppQuality		 name_quality;
 	GPtrArray		*icons;
 	GPtrArray		*sources;
 	GPtrArray		*source_ids;
-	gchar			*project_group;
+	const gchar		*project_group;	/* interned */
 	gchar			*version;
 	gchar			*version_ui;
 	gchar			*summary;
@@ -76,21 +76,21 @@ struct _GsApp
 	gchar			*description;
 	GsAppQuality		 description_quality;
 	GPtrArray		*screenshots;
-	GPtrArray		*categories;
+	GPtrArray		*categories;	/* of interned strings */
 	GPtrArray		*key_colors;
 	GPtrArray		*keywords;
 	GHashTable		*urls;
-	gchar			*license;
+	const gchar		*license;	/* pooled */
 	GsAppQuality		 license_quality;
 	gchar			**menu_path;
-	gchar			*origin;
-	gchar			*origin_ui;
-	gchar			*origin_hostname;
+	const gchar		*origin;	/* pooled */
+	const gchar		*origin_ui;	/* pooled */
+	const gchar		*origin_hostname; /* pooled */
 	gchar			*update_version;
 	gchar			*update_version_ui;
 	gchar			*update_details;
 	AsUrgencyKind		 update_urgency;
-	gchar			*management_plugin;
+	const gchar		*management_plugin; /* interned */
 	guint			 match_value;
 	guint			 priority;
 	gint			 rating;
@@ -119,6 +119,7 @@ struct _GsApp
 	GsApp			*runtime;
 	GFile			*local_file;
 	AsContentRating		*content_rating;
+	guint			 content_age;	/* G_MAXUINT for unknown */
 	GdkPixbuf		*pixbuf;
 };
 
@@ -140,6 +141,67 @@ enum {
 
 G_DEFINE_TYPE (GsApp, gs_app, G_TYPE_OBJECT)
 
+/*
+ * Values that repeat across many apps but that are not from a small fixed
+ * set, e.g. licenses and origins, are shared using a refcounted pool so that
+ * they are freed when the last app using them goes away. Values from a small
+ * fixed set, e.g. categories and plugin names, use g_intern_string().
+ */
+static GHashTable *gs_app_string_pool = NULL;	/* str : guint refcount */
+G_LOCK_DEFINE_STATIC (gs_app_string_pool);
+
+static const gchar *
+gs_app_string_pool_ref (const gchar *str)
+{
+	gpointer key = NULL;
+	gpointer value = NULL;
+
+	if (str == NULL)
+		return NULL;
+	G_LOCK (gs_app_string_pool);
+	if (gs_app_string_pool == NULL) {
+		gs_app_string_pool = g_hash_table_new_full (g_str_hash,
+							    g_str_equal,
+							    g_free,
+							    g_free);
+	}
+	if (g_hash_table_lookup_extended (gs_app_string_pool, str,
+					  &key, &value)) {
+		(*((guint *) value))++;
+	} else {
+		key = g_strdup (str);
+		value = g_new0 (guint, 1);
+		*((guint *) value) = 1;
+		g_hash_table_insert (gs_app_string_pool, key, value);
+	}
+	G_UNLOCK (gs_app_string_pool);
+	return key;
+}
+
+static void
+gs_app_string_pool_unref (const gchar *str)
+{
+	guint *refcount;
+
+	if (str == NULL)
+		return;
+	G_LOCK (gs_app_string_pool);
+	refcount = g_hash_table_lookup (gs_app_string_pool, str);
+	g_assert (refcount != NULL);
+	if (--(*refcount) == 0)
+		g_hash_table_remove (gs_app_string_pool, str);
+	G_UNLOCK (gs_app_string_pool);
+}
+
+/* replaces a pooled field, taking care if the new value is the old one */
+static void
+gs_app_string_pool_set (const gchar **field, const gchar *str)
+{
+	const gchar *tmp = gs_app_string_pool_ref (str);
+	gs_app_string_pool_unref (*field);
+	*field = tmp;
+}
+
 static void
 gs_app_kv_lpad (GString *str, const gchar *key, const gchar *value)
 {
@@ -374,9 +436,8 @@ gs_app_to_string (GsApp *app)
 		gs_app_kv_lpad (str, "local-filename", fn);
 	}
 	if (app->content_rating != NULL) {
-		guint age = as_content_rating_get_minimum_age (app->content_rating);
-		if (age != G_MAXUINT) {
-			g_autofree gchar *value = g_strdup_printf ("%u", age);
+		if (app->content_age != G_MAXUINT) {
+			g_autofree gchar *value = g_strdup_printf ("%u", app->content_age);
 			gs_app_kv_lpad (str, "content-age", value);
 		}
 		gs_app_kv_lpad (str, "content-rating",
@@ -1076,8 +1137,7 @@ void
 gs_app_set_branch (GsApp *app, const gchar *branch)
 {
 	g_return_if_fail (GS_IS_APP (app));
-	g_free (app->branch);
-	app->branch = g_strdup (branch);
+	gs_app_string_pool_set (&app->branch, branch);
 
 	/* no longer valid */
 	app->unique_id_valid = FALSE;
@@ -1294,8 +1354,7 @@ void
 gs_app_set_project_group (GsApp *app, const gchar *project_group)
 {
 	g_return_if_fail (GS_IS_APP (app));
-	g_free (app->project_group);
-	app->project_group = g_strdup (project_group);
+	app->project_group = g_intern_string (project_group);
 }
 
 /**
@@ -1418,7 +1477,32 @@ void
 gs_app_set_content_rating (GsApp *app, AsContentRating *content_rating)
 {
 	g_return_if_fail (GS_IS_APP (app));
-	g_set_object (&app->content_rating, content_rating);
+	if (!g_set_object (&app->content_rating, content_rating))
+		return;
+
+	/* this is checked when filtering every list of results */
+	if (content_rating != NULL)
+		app->content_age = as_content_rating_get_minimum_age (content_rating);
+	else
+		app->content_age = G_MAXUINT;
+}
+
+/**
+ * gs_app_get_content_age:
+ * @app: a #GsApp
+ *
+ * Gets the minimum age the application is suitable for, as worked out
+ * from the content rating when it was set.
+ *
+ * Returns: an age in years, or %G_MAXUINT if unknown
+ *
+ * Since: 3.24
+ **/
+guint
+gs_app_get_content_age (GsApp *app)
+{
+	g_return_val_if_fail (GS_IS_APP (app), G_MAXUINT);
+	return app->content_age;
 }
 
 /**
@@ -1842,8 +1926,7 @@ gs_app_set_license (GsApp *app, GsAppQuality quality, const gchar *license)
 		}
 	}
 
-	g_free (app->license);
-	app->license = g_strdup (license);
+	gs_app_string_pool_set (&app->license, license);
 }
 
 /**
@@ -1947,7 +2030,7 @@ void
 gs_app_set_origin (GsApp *app, const gchar *origin)
 {
 	g_return_if_fail (GS_IS_APP (app));
-	if (origin == app->origin)
+	if (g_strcmp0 (origin, app->origin) == 0)
 		return;
 
 	/* trying to change */
@@ -1959,8 +2042,7 @@ gs_app_set_origin (GsApp *app, const gchar *origin)
 		return;
 	}
 
-	g_free (app->origin);
-	app->origin = g_strdup (origin);
+	gs_app_string_pool_set (&app->origin, origin);
 
 	/* no longer valid */
 	app->unique_id_valid = FALSE;
@@ -1997,10 +2079,7 @@ void
 gs_app_set_origin_ui (GsApp *app, const gchar *origin_ui)
 {
 	g_return_if_fail (GS_IS_APP (app));
-	if (origin_ui == app->origin_ui)
-		return;
-	g_free (app->origin_ui);
-	app->origin_ui = g_strdup (origin_ui);
+	gs_app_string_pool_set (&app->origin_ui, origin_ui);
 }
 
 /**
@@ -2044,9 +2123,8 @@ gs_app_set_origin_hostname (GsApp *app, const gchar *origin_hostname)
 
 	g_return_if_fail (GS_IS_APP (app));
 
-	if (origin_hostname == app->origin_hostname)
+	if (g_strcmp0 (origin_hostname, app->origin_hostname) == 0)
 		return;
-	g_free (app->origin_hostname);
 
 	/* use libsoup to convert a URL */
 	uri = soup_uri_new (origin_hostname);
@@ -2060,7 +2138,7 @@ gs_app_set_origin_hostname (GsApp *app, const gchar *origin_hostname)
 	}
 
 	/* success */
-	app->origin_hostname = g_strdup (origin_hostname);
+	gs_app_string_pool_set (&app->origin_hostname, origin_hostname);
 }
 
 /**
@@ -2281,7 +2359,8 @@ gs_app_set_management_plugin (GsApp *app, const gchar *management_plugin)
 	}
 
 	/* same */
-	if (g_strcmp0 (app->management_plugin, management_plugin) == 0)
+	management_plugin = g_intern_string (management_plugin);
+	if (app->management_plugin == management_plugin)
 		return;
 
 	/* trying to change */
@@ -2294,8 +2373,7 @@ gs_app_set_management_plugin (GsApp *app, const gchar *management_plugin)
 		return;
 	}
 
-	g_free (app->management_plugin);
-	app->management_plugin = g_strdup (management_plugin);
+	app->management_plugin = management_plugin;
 }
 
 /**
@@ -2832,14 +2910,18 @@ gboolean
 gs_app_has_category (GsApp *app, const gchar *category)
 {
 	const gchar *tmp;
+	GQuark quark;
 	guint i;
 
 	g_return_val_if_fail (GS_IS_APP (app), FALSE);
 
-	/* find the category */
+	/* a category nobody has used cannot match */
+	quark = g_quark_try_string (category);
+	if (quark == 0)
+		return FALSE;
+	tmp = g_quark_to_string (quark);
 	for (i = 0; i < app->categories->len; i++) {
-		tmp = g_ptr_array_index (app->categories, i);
-		if (g_strcmp0 (tmp, category) == 0)
+		if (g_ptr_array_index (app->categories, i) == tmp)
 			return TRUE;
 	}
 	return FALSE;
@@ -2850,18 +2932,25 @@ gs_app_has_category (GsApp *app, const gchar *category)
  * @app: a #GsApp
  * @categories: a set of categories
  *
- * Set the list of categories for an application.
+ * Set the list of categories for an application. The category IDs are copied
+ * into the application.
  *
  * Since: 3.22
  **/
 void
 gs_app_set_categories (GsApp *app, GPtrArray *categories)
 {
+	guint i;
+
 	g_return_if_fail (GS_IS_APP (app));
 	g_return_if_fail (categories != NULL);
-	if (app->categories != NULL)
-		g_ptr_array_unref (app->categories);
-	app->categories = g_ptr_array_ref (categories);
+	if (categories == app->categories)
+		return;
+	g_ptr_array_set_size (app->categories, 0);
+	for (i = 0; i < categories->len; i++) {
+		const gchar *tmp = g_ptr_array_index (categories, i);
+		g_ptr_array_add (app->categories, (gpointer) g_intern_string (tmp));
+	}
 }
 
 /**
@@ -2880,7 +2969,7 @@ gs_app_add_category (GsApp *app, const gchar *category)
 	g_return_if_fail (category != NULL);
 	if (gs_app_has_category (app, category))
 		return;
-	g_ptr_array_add (app->categories, g_strdup (category));
+	g_ptr_array_add (app->categories, (gpointer) g_intern_string (category));
 }
 
 /**
@@ -3370,17 +3459,11 @@ gs_app_finalize (GObject *object)
 
 	g_free (app->id);
 	g_free (app->unique_id);
-	g_free (app->branch);
 	g_free (app->name);
 	g_hash_table_unref (app->urls);
-	g_free (app->license);
 	g_strfreev (app->menu_path);
-	g_free (app->origin);
-	g_free (app->origin_ui);
-	g_free (app->origin_hostname);
 	g_ptr_array_unref (app->sources);
 	g_ptr_array_unref (app->source_ids);
-	g_free (app->project_group);
 	g_free (app->version);
 	g_free (app->version_ui);
 	g_free (app->summary);
@@ -3389,7 +3472,11 @@ gs_app_finalize (GObject *object)
 	g_free (app->update_version);
 	g_free (app->update_version_ui);
 	g_free (app->update_details);
-	g_free (app->management_plugin);
+	gs_app_string_pool_unref (app->branch);
+	gs_app_string_pool_unref (app->license);
+	gs_app_string_pool_unref (app->origin);
+	gs_app_string_pool_unref (app->origin_ui);
+	gs_app_string_pool_unref (app->origin_hostname);
 	g_hash_table_unref (app->metadata);
 	g_hash_table_unref (app->addons_hash);
 	g_hash_table_unref (app->related_hash);
@@ -3510,9 +3597,10 @@ static void
 gs_app_init (GsApp *app)
 {
 	app->rating = -1;
+	app->content_age = G_MAXUINT;
 	app->sources = g_ptr_array_new_with_free_func (g_free);
 	app->source_ids = g_ptr_array_new_with_free_func (g_free);
-	app->categories = g_ptr_array_new_with_free_func (g_free);
+	app->categories = g_ptr_array_new ();
 	app->key_colors = g_ptr_array_new_with_free_func ((GDestroyNotify) gdk_rgba_free);
 	app->addons = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
 	app->related = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
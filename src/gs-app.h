@@ -209,6 +209,7 @@ void		 gs_app_set_local_file		(GsApp		*app,
 AsContentRating	*gs_app_get_content_rating	(GsApp		*app);
 void		 gs_app_set_content_rating	(GsApp		*app,
 						 AsContentRating *content_rating);
+guint		 gs_app_get_content_age		(GsApp		*app);
 GsApp		*gs_app_get_runtime		(GsApp		*app);
 void		 gs_app_set_runtime		(GsApp		*app,
 						 GsApp		*runtime);
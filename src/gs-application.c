@@ -45,6 +45,7 @@
 #include "gs-shell.h"
 #include "gs-update-monitor.h"
 #include "gs-shell-search-provider.h"
+#include "gs-stats-generated.h"
 #include "gs-folders.h"
 #include "gs-utils.h"
 
@@ -64,6 +65,8 @@ struct _GsApplication {
 	GsDbusHelper	*dbus_helper;
 #endif
 	GsShellSearchProvider *search_provider;
+	GsStats		*stats;
+	guint		 stats_refresh_id;
 	GNetworkMonitor *network_monitor;
 	gulong		 network_changed_handler;
 	GSettings       *settings;
@@ -110,6 +113,8 @@ gs_application_init (GsApplication *application)
 		  _("Show verbose debugging information"), NULL },
 		{ "profile", 0, 0, G_OPTION_ARG_NONE, NULL,
 		  _("Show profiling information for the service"), NULL },
+		{ "dump-stats", 0, 0, G_OPTION_ARG_NONE, NULL,
+		  _("Show plugin statistics for the running instance"), NULL },
 		{ "quit", 0, 0, G_OPTION_ARG_NONE, NULL,
 		  _("Quit the running instance"), NULL },
 		{ "prefer-local", '\0', 0, G_OPTION_ARG_NONE, NULL,
@@ -197,13 +202,29 @@ gs_application_monitor_network (GsApplication *app)
 			    app);
 }
 
+static void
+gs_application_setup_plugins_cb (GObject *source,
+				 GAsyncResult *res,
+				 gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
+	g_autoptr(GError) error = NULL;
+
+	if (!gs_plugin_loader_setup_finish (plugin_loader, res, &error)) {
+		g_warning ("Failed to setup plugins: %s", error->message);
+		exit (1);
+	}
+
+	/* show the priority of each plugin */
+	gs_plugin_loader_dump_state (plugin_loader);
+}
+
 static void
 gs_application_initialize_plugins (GsApplication *app)
 {
 	static gboolean initialized = FALSE;
 	g_auto(GStrv) plugin_blacklist = NULL;
 	g_auto(GStrv) plugin_whitelist = NULL;
-	g_autoptr(GError) error = NULL;
 	const gchar *tmp;
 
 	if (initialized)
@@ -219,19 +240,41 @@ gs_application_initialize_plugins (GsApplication *app)
 	if (tmp != NULL)
 		plugin_whitelist = g_strsplit (tmp, ",", -1);
 
+	/* the plugins are set up in the background, and any actions
+	 * started before then wait for them to be ready */
 	app->plugin_loader = gs_plugin_loader_new ();
 	gs_plugin_loader_set_location (app->plugin_loader, NULL);
-	if (!gs_plugin_loader_setup (app->plugin_loader,
-				     plugin_whitelist,
-				     plugin_blacklist,
-				     &error)) {
-		g_warning ("Failed to setup plugins: %s", error->message);
-		exit (1);
-	}
+	gs_plugin_loader_setup_async (app->plugin_loader,
+				      plugin_whitelist,
+				      plugin_blacklist,
+				      NULL,
+				      gs_application_setup_plugins_cb,
+				      NULL);
+}
 
-	/* show the priority of each plugin */
-	gs_plugin_loader_dump_state (app->plugin_loader);
+static gboolean
+gs_application_stats_refresh_cb (gpointer user_data)
+{
+	GsApplication *app = GS_APPLICATION (user_data);
+	g_autoptr(GVariant) stats = NULL;
 
+	app->stats_refresh_id = 0;
+	stats = gs_plugin_loader_get_stats (app->plugin_loader);
+	gs_stats_set_plugin_stats (app->stats, stats);
+	return FALSE;
+}
+
+static void
+gs_application_stats_changed_cb (GsPluginLoader *plugin_loader,
+				 GsApp *app_tmp,
+				 GsPluginStatus status,
+				 GsApplication *app)
+{
+	/* plugins have been called, so refresh at most once a second */
+	if (app->stats_refresh_id != 0)
+		return;
+	app->stats_refresh_id =
+		g_timeout_add_seconds (1, gs_application_stats_refresh_cb, app);
 }
 
 static gboolean
@@ -246,8 +289,16 @@ gs_application_dbus_register (GApplication    *application,
 	app->search_provider = gs_shell_search_provider_new ();
 	gs_shell_search_provider_setup (app->search_provider,
 					app->plugin_loader);
-
-	return gs_shell_search_provider_register (app->search_provider, connection, error);
+	if (!gs_shell_search_provider_register (app->search_provider, connection, error))
+		return FALSE;
+
+	/* export the plugin statistics */
+	app->stats = gs_stats_skeleton_new ();
+	gs_application_stats_refresh_cb (app);
+	g_signal_connect (app->plugin_loader, "status-changed",
+			  G_CALLBACK (gs_application_stats_changed_cb), app);
+	return g_dbus_interface_skeleton_export (G_DBUS_INTERFACE_SKELETON (app->stats),
+						 connection, object_path, error);
 }
 
 static void
@@ -261,6 +312,97 @@ gs_application_dbus_unregister (GApplication    *application,
 		gs_shell_search_provider_unregister (app->search_provider);
 		g_clear_object (&app->search_provider);
 	}
+	if (app->stats != NULL) {
+		g_signal_handlers_disconnect_by_func (app->plugin_loader,
+						      gs_application_stats_changed_cb,
+						      app);
+		if (app->stats_refresh_id != 0) {
+			g_source_remove (app->stats_refresh_id);
+			app->stats_refresh_id = 0;
+		}
+		g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (app->stats));
+		g_clear_object (&app->stats);
+	}
+}
+
+/* the bucket that contains the value at this percentile */
+static guint64
+gs_application_stats_percentile (GVariant *histogram, guint calls, guint pct)
+{
+	GVariantIter iter;
+	guint count;
+	guint64 value = 0;
+	guint64 seen = 0;
+	guint64 target = ((guint64) calls * pct + 99) / 100;
+
+	g_variant_iter_init (&iter, histogram);
+	while (g_variant_iter_next (&iter, "(tu)", &value, &count)) {
+		seen += count;
+		if (seen >= target)
+			break;
+	}
+	return value;
+}
+
+static gint
+gs_application_dump_stats (GApplication *application)
+{
+	GVariantIter iter;
+	GVariant *histogram;
+	const gchar *object_path;
+	const gchar *function_name;
+	const gchar *plugin_name;
+	guint calls, errors, cancelled;
+	guint64 total_us, max_us;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GVariant) retval = NULL;
+	g_autoptr(GVariant) stats = NULL;
+
+	/* this has to come from the instance that has been running */
+	if (!g_application_get_is_remote (application)) {
+		g_printerr ("%s\n", _("No running instance"));
+		return 1;
+	}
+	object_path = g_application_get_dbus_object_path (application);
+	if (object_path == NULL)
+		object_path = "/org/gnome/Software";
+	retval = g_dbus_connection_call_sync (g_application_get_dbus_connection (application),
+					      g_application_get_application_id (application),
+					      object_path,
+					      "org.freedesktop.DBus.Properties",
+					      "Get",
+					      g_variant_new ("(ss)",
+							     "org.gnome.Software.Stats",
+							     "PluginStats"),
+					      G_VARIANT_TYPE ("(v)"),
+					      G_DBUS_CALL_FLAGS_NONE,
+					      -1,
+					      NULL,
+					      &error);
+	if (retval == NULL) {
+		g_printerr ("%s\n", error->message);
+		return 1;
+	}
+	g_variant_get (retval, "(v)", &stats);
+
+	/* all times are in ms */
+	g_print ("%-20s %-36s %7s %6s %6s %9s %9s %9s %9s %9s\n",
+		 "plugin", "function", "calls", "errors", "cancel",
+		 "mean", "p50", "p90", "p99", "max");
+	g_variant_iter_init (&iter, stats);
+	while (g_variant_iter_loop (&iter, "(&s&suuutt@a(tu))",
+				    &plugin_name, &function_name,
+				    &calls, &errors, &cancelled,
+				    &total_us, &max_us, &histogram)) {
+		g_print ("%-20s %-36s %7u %6u %6u %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+			 plugin_name, function_name, calls, errors, cancelled,
+			 calls > 0 ? (gdouble) total_us / calls / 1000.f : 0.f,
+			 gs_application_stats_percentile (histogram, calls, 50) / 1000.f,
+			 gs_application_stats_percentile (histogram, calls, 90) / 1000.f,
+			 gs_application_stats_percentile (histogram, calls, 99) / 1000.f,
+			 max_us / 1000.f);
+	}
+	return 0;
 }
 
 static void
@@ -862,6 +1004,8 @@ gs_application_handle_local_options (GApplication *app, GVariantDict *options)
 		return 1;
 	}
 
+	if (g_variant_dict_contains (options, "dump-stats"))
+		return gs_application_dump_stats (app);
 	if (g_variant_dict_contains (options, "profile")) {
 		g_action_group_activate_action (G_ACTION_GROUP (app),
 						"profile",
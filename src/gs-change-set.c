@@ -0,0 +1,352 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * SECTION:gs-change-set
+ * @title: GsChangeSet
+ * @stability: Unstable
+ * @short_description: A description of what changed since the last update
+ *
+ * A change set is emitted by the plugin loader when applications have been
+ * installed, removed or updated, or when the metadata catalog changed. Pages
+ * can use it to work out whether they are affected at all rather than
+ * reloading unconditionally.
+ *
+ * Each unique ID is only ever in one of the added, removed or changed sets,
+ * so an application that is installed and then removed again before the
+ * change set is emitted is only reported as removed.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#include "gs-change-set.h"
+
+struct _GsChangeSet
+{
+	GObject			 parent_instance;
+	GsChangeSetKind		 kind;
+	GPtrArray		*added;
+	GPtrArray		*removed;
+	GPtrArray		*changed;
+};
+
+G_DEFINE_TYPE (GsChangeSet, gs_change_set, G_TYPE_OBJECT)
+
+static gboolean
+gs_change_set_array_find (GPtrArray *array, const gchar *unique_id)
+{
+	guint i;
+	for (i = 0; i < array->len; i++) {
+		const gchar *tmp = g_ptr_array_index (array, i);
+		if (g_strcmp0 (tmp, unique_id) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+gs_change_set_array_remove (GPtrArray *array, const gchar *unique_id)
+{
+	guint i;
+	for (i = 0; i < array->len; i++) {
+		const gchar *tmp = g_ptr_array_index (array, i);
+		if (g_strcmp0 (tmp, unique_id) == 0) {
+			g_ptr_array_remove_index (array, i);
+			return;
+		}
+	}
+}
+
+static void
+gs_change_set_array_add (GPtrArray *array, const gchar *unique_id)
+{
+	if (gs_change_set_array_find (array, unique_id))
+		return;
+	g_ptr_array_add (array, g_strdup (unique_id));
+}
+
+/**
+ * gs_change_set_add_kind:
+ * @change_set: A #GsChangeSet
+ * @kind: A #GsChangeSetKind, e.g. %GS_CHANGE_SET_KIND_CATALOG
+ *
+ * Adds a kind of change to the change set.
+ *
+ * Since: 3.24
+ **/
+void
+gs_change_set_add_kind (GsChangeSet *change_set, GsChangeSetKind kind)
+{
+	g_return_if_fail (GS_IS_CHANGE_SET (change_set));
+	change_set->kind |= kind;
+}
+
+/**
+ * gs_change_set_has_kind:
+ * @change_set: A #GsChangeSet
+ * @kind: A #GsChangeSetKind, e.g. %GS_CHANGE_SET_KIND_CATALOG
+ *
+ * Finds out if the change set includes a specific kind of change.
+ *
+ * Returns: %TRUE if the kind has been added
+ *
+ * Since: 3.24
+ **/
+gboolean
+gs_change_set_has_kind (GsChangeSet *change_set, GsChangeSetKind kind)
+{
+	g_return_val_if_fail (GS_IS_CHANGE_SET (change_set), FALSE);
+	return (change_set->kind & kind) > 0;
+}
+
+/**
+ * gs_change_set_is_empty:
+ * @change_set: A #GsChangeSet
+ *
+ * Finds out if the change set describes any change at all.
+ *
+ * Returns: %TRUE if nothing has changed
+ *
+ * Since: 3.24
+ **/
+gboolean
+gs_change_set_is_empty (GsChangeSet *change_set)
+{
+	g_return_val_if_fail (GS_IS_CHANGE_SET (change_set), TRUE);
+	return change_set->kind == GS_CHANGE_SET_KIND_NONE &&
+		change_set->added->len == 0 &&
+		change_set->removed->len == 0 &&
+		change_set->changed->len == 0;
+}
+
+/**
+ * gs_change_set_add_added:
+ * @change_set: A #GsChangeSet
+ * @unique_id: A unique ID, e.g. "system/package/fedora/desktop/gimp.desktop/i386/master"
+ *
+ * Records that an application has been installed. This also adds the
+ * %GS_CHANGE_SET_KIND_APPS kind.
+ *
+ * Since: 3.24
+ **/
+void
+gs_change_set_add_added (GsChangeSet *change_set, const gchar *unique_id)
+{
+	g_return_if_fail (GS_IS_CHANGE_SET (change_set));
+	g_return_if_fail (unique_id != NULL);
+	change_set->kind |= GS_CHANGE_SET_KIND_APPS;
+	gs_change_set_array_remove (change_set->removed, unique_id);
+	gs_change_set_array_remove (change_set->changed, unique_id);
+	gs_change_set_array_add (change_set->added, unique_id);
+}
+
+/**
+ * gs_change_set_add_removed:
+ * @change_set: A #GsChangeSet
+ * @unique_id: A unique ID, e.g. "system/package/fedora/desktop/gimp.desktop/i386/master"
+ *
+ * Records that an application has been removed. This also adds the
+ * %GS_CHANGE_SET_KIND_APPS kind.
+ *
+ * Since: 3.24
+ **/
+void
+gs_change_set_add_removed (GsChangeSet *change_set, const gchar *unique_id)
+{
+	g_return_if_fail (GS_IS_CHANGE_SET (change_set));
+	g_return_if_fail (unique_id != NULL);
+	change_set->kind |= GS_CHANGE_SET_KIND_APPS;
+	gs_change_set_array_remove (change_set->added, unique_id);
+	gs_change_set_array_remove (change_set->changed, unique_id);
+	gs_change_set_array_add (change_set->removed, unique_id);
+}
+
+/**
+ * gs_change_set_add_changed:
+ * @change_set: A #GsChangeSet
+ * @unique_id: A unique ID, e.g. "system/package/fedora/desktop/gimp.desktop/i386/master"
+ *
+ * Records that an application has been changed in some other way, for
+ * instance by being updated. If the application is already recorded as added
+ * or removed then this does nothing. This also adds the
+ * %GS_CHANGE_SET_KIND_APPS kind.
+ *
+ * Since: 3.24
+ **/
+void
+gs_change_set_add_changed (GsChangeSet *change_set, const gchar *unique_id)
+{
+	g_return_if_fail (GS_IS_CHANGE_SET (change_set));
+	g_return_if_fail (unique_id != NULL);
+	change_set->kind |= GS_CHANGE_SET_KIND_APPS;
+	if (gs_change_set_array_find (change_set->added, unique_id))
+		return;
+	if (gs_change_set_array_find (change_set->removed, unique_id))
+		return;
+	gs_change_set_array_add (change_set->changed, unique_id);
+}
+
+/**
+ * gs_change_set_get_added:
+ * @change_set: A #GsChangeSet
+ *
+ * Gets the unique IDs of the applications that were installed.
+ *
+ * Returns: (element-type utf8) (transfer none): an array of unique IDs
+ *
+ * Since: 3.24
+ **/
+GPtrArray *
+gs_change_set_get_added (GsChangeSet *change_set)
+{
+	g_return_val_if_fail (GS_IS_CHANGE_SET (change_set), NULL);
+	return change_set->added;
+}
+
+/**
+ * gs_change_set_get_removed:
+ * @change_set: A #GsChangeSet
+ *
+ * Gets the unique IDs of the applications that were removed.
+ *
+ * Returns: (element-type utf8) (transfer none): an array of unique IDs
+ *
+ * Since: 3.24
+ **/
+GPtrArray *
+gs_change_set_get_removed (GsChangeSet *change_set)
+{
+	g_return_val_if_fail (GS_IS_CHANGE_SET (change_set), NULL);
+	return change_set->removed;
+}
+
+/**
+ * gs_change_set_get_changed:
+ * @change_set: A #GsChangeSet
+ *
+ * Gets the unique IDs of the applications that were changed.
+ *
+ * Returns: (element-type utf8) (transfer none): an array of unique IDs
+ *
+ * Since: 3.24
+ **/
+GPtrArray *
+gs_change_set_get_changed (GsChangeSet *change_set)
+{
+	g_return_val_if_fail (GS_IS_CHANGE_SET (change_set), NULL);
+	return change_set->changed;
+}
+
+/**
+ * gs_change_set_has_unique_id:
+ * @change_set: A #GsChangeSet
+ * @unique_id: A unique ID, e.g. "system/package/fedora/desktop/gimp.desktop/i386/master"
+ *
+ * Finds out if a specific application was added, removed or changed.
+ *
+ * Returns: %TRUE if the application is part of the change set
+ *
+ * Since: 3.24
+ **/
+gboolean
+gs_change_set_has_unique_id (GsChangeSet *change_set, const gchar *unique_id)
+{
+	g_return_val_if_fail (GS_IS_CHANGE_SET (change_set), FALSE);
+	if (unique_id == NULL)
+		return FALSE;
+	return gs_change_set_array_find (change_set->added, unique_id) ||
+		gs_change_set_array_find (change_set->removed, unique_id) ||
+		gs_change_set_array_find (change_set->changed, unique_id);
+}
+
+/**
+ * gs_change_set_merge:
+ * @change_set: A #GsChangeSet
+ * @donor: Another #GsChangeSet
+ *
+ * Adds all the changes in @donor to @change_set, as if the added, then the
+ * removed and then the changed applications of @donor had been recorded in
+ * turn. An application added or removed in @donor replaces what was recorded
+ * for it in @change_set, and the relative order of the changes is not kept.
+ *
+ * Since: 3.24
+ **/
+void
+gs_change_set_merge (GsChangeSet *change_set, GsChangeSet *donor)
+{
+	guint i;
+
+	g_return_if_fail (GS_IS_CHANGE_SET (change_set));
+	g_return_if_fail (GS_IS_CHANGE_SET (donor));
+	change_set->kind |= donor->kind;
+	for (i = 0; i < donor->added->len; i++)
+		gs_change_set_add_added (change_set, g_ptr_array_index (donor->added, i));
+	for (i = 0; i < donor->removed->len; i++)
+		gs_change_set_add_removed (change_set, g_ptr_array_index (donor->removed, i));
+	for (i = 0; i < donor->changed->len; i++)
+		gs_change_set_add_changed (change_set, g_ptr_array_index (donor->changed, i));
+}
+
+static void
+gs_change_set_finalize (GObject *object)
+{
+	GsChangeSet *change_set = GS_CHANGE_SET (object);
+	g_ptr_array_unref (change_set->added);
+	g_ptr_array_unref (change_set->removed);
+	g_ptr_array_unref (change_set->changed);
+	G_OBJECT_CLASS (gs_change_set_parent_class)->finalize (object);
+}
+
+static void
+gs_change_set_class_init (GsChangeSetClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	object_class->finalize = gs_change_set_finalize;
+}
+
+static void
+gs_change_set_init (GsChangeSet *change_set)
+{
+	change_set->added = g_ptr_array_new_with_free_func (g_free);
+	change_set->removed = g_ptr_array_new_with_free_func (g_free);
+	change_set->changed = g_ptr_array_new_with_free_func (g_free);
+}
+
+/**
+ * gs_change_set_new:
+ *
+ * Creates a new, empty change set.
+ *
+ * Returns: A newly allocated #GsChangeSet
+ *
+ * Since: 3.24
+ **/
+GsChangeSet *
+gs_change_set_new (void)
+{
+	GsChangeSet *change_set;
+	change_set = g_object_new (GS_TYPE_CHANGE_SET, NULL);
+	return GS_CHANGE_SET (change_set);
+}
+
+/* vim: set noexpandtab: */
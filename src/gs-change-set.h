@@ -0,0 +1,76 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __GS_CHANGE_SET
+#define __GS_CHANGE_SET
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define GS_TYPE_CHANGE_SET (gs_change_set_get_type ())
+
+G_DECLARE_FINAL_TYPE (GsChangeSet, gs_change_set, GS, CHANGE_SET, GObject)
+
+/**
+ * GsChangeSetKind:
+ * @GS_CHANGE_SET_KIND_NONE:		Nothing changed
+ * @GS_CHANGE_SET_KIND_APPS:		Specific applications were added, removed or changed
+ * @GS_CHANGE_SET_KIND_CATALOG:		The metadata changed, so any result may be stale
+ *
+ * The kinds of change a change set can describe.
+ **/
+typedef enum {
+	GS_CHANGE_SET_KIND_NONE		= 0,
+	GS_CHANGE_SET_KIND_APPS		= 1 << 0,
+	GS_CHANGE_SET_KIND_CATALOG	= 1 << 1,
+	/*< private >*/
+	GS_CHANGE_SET_KIND_LAST
+} GsChangeSetKind;
+
+GsChangeSet		*gs_change_set_new		(void);
+
+void			 gs_change_set_add_kind		(GsChangeSet		*change_set,
+							 GsChangeSetKind	 kind);
+gboolean		 gs_change_set_has_kind		(GsChangeSet		*change_set,
+							 GsChangeSetKind	 kind);
+gboolean		 gs_change_set_is_empty		(GsChangeSet		*change_set);
+
+void			 gs_change_set_add_added	(GsChangeSet		*change_set,
+							 const gchar		*unique_id);
+void			 gs_change_set_add_removed	(GsChangeSet		*change_set,
+							 const gchar		*unique_id);
+void			 gs_change_set_add_changed	(GsChangeSet		*change_set,
+							 const gchar		*unique_id);
+GPtrArray		*gs_change_set_get_added	(GsChangeSet		*change_set);
+GPtrArray		*gs_change_set_get_removed	(GsChangeSet		*change_set);
+GPtrArray		*gs_change_set_get_changed	(GsChangeSet		*change_set);
+gboolean		 gs_change_set_has_unique_id	(GsChangeSet		*change_set,
+							 const gchar		*unique_id);
+
+void			 gs_change_set_merge		(GsChangeSet		*change_set,
+							 GsChangeSet		*donor);
+
+G_END_DECLS
+
+#endif /* __GS_CHANGE_SET */
+
+/* vim: set noexpandtab: */
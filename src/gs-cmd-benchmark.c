@@ -0,0 +1,466 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <appstream-glib.h>
+#include <json-glib/json-glib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef HAVE_MALLINFO2
+#include <malloc.h>
+#endif
+
+#include "gs-cmd-benchmark.h"
+#include "gs-plugin-loader-sync.h"
+
+/* the generated catalogue groups this many components per search keyword */
+#define GS_CMD_BENCHMARK_GROUP_SIZE	100
+
+/* number of components looked up in the refine scenario */
+#define GS_CMD_BENCHMARK_REFINE_SIZE	50
+
+static const gchar *benchmark_categories[] = {
+	"AudioVideo", "Development", "Education", "Game", "Graphics",
+	"Network", "Office", "Science", "System", "Utility", NULL };
+
+static const gchar *benchmark_words[] = {
+	"photo", "music", "editor", "terminal", "browser", "chess", "paint",
+	"mail", "calendar", "notes", "video", "player", "viewer", "manager",
+	"studio", "reader", "monitor", "maps", "weather", "archive", NULL };
+
+static gchar *
+gs_cmd_benchmark_get_id (guint idx)
+{
+	return g_strdup_printf ("org.example.Benchmark%06u.desktop", idx);
+}
+
+static const gchar *
+gs_cmd_benchmark_random_word (GRand *rand)
+{
+	guint len = g_strv_length ((gchar **) benchmark_words);
+	return benchmark_words[g_rand_int_range (rand, 0, (gint32) len)];
+}
+
+static AsApp *
+gs_cmd_benchmark_create_app (GRand *rand, guint idx)
+{
+	AsApp *app = as_app_new ();
+	const gchar *word1 = gs_cmd_benchmark_random_word (rand);
+	const gchar *word2 = gs_cmd_benchmark_random_word (rand);
+	guint i;
+	guint ncategories;
+	g_autofree gchar *description = NULL;
+	g_autofree gchar *group = NULL;
+	g_autofree gchar *id = gs_cmd_benchmark_get_id (idx);
+	g_autofree gchar *name = NULL;
+	g_autofree gchar *pkgname = NULL;
+	g_autofree gchar *summary = NULL;
+	g_autoptr(AsIcon) ic = as_icon_new ();
+
+	name = g_strdup_printf ("%s %s %u", word1, word2, idx);
+	summary = g_strdup_printf ("A synthetic %s for %s", word2, word1);
+	description = g_strdup_printf ("<p>This %s %s is generated for "
+				       "benchmarking and does nothing.</p>"
+				       "<p>It is component number %u.</p>",
+				       word1, word2, idx);
+	pkgname = g_strdup_printf ("benchmark-%06u", idx);
+	group = g_strdup_printf ("group%04u", idx / GS_CMD_BENCHMARK_GROUP_SIZE);
+
+	as_app_set_id (app, id);
+	as_app_set_kind (app, AS_APP_KIND_DESKTOP);
+	as_app_set_name (app, NULL, name);
+	as_app_set_summary (app, NULL, summary);
+	as_app_set_description (app, NULL, description);
+	as_app_set_project_license (app, "GPL-2.0+");
+	as_app_add_pkgname (app, pkgname);
+	as_app_add_keyword (app, NULL, word1);
+	as_app_add_keyword (app, NULL, group);
+
+	/* one or two categories */
+	ncategories = (guint) g_rand_int_range (rand, 1, 3);
+	for (i = 0; i < ncategories; i++) {
+		guint len = g_strv_length ((gchar **) benchmark_categories);
+		guint j = (guint) g_rand_int_range (rand, 0, (gint32) len);
+		if (!as_app_has_category (app, benchmark_categories[j]))
+			as_app_add_category (app, benchmark_categories[j]);
+	}
+
+	/* a stock icon means no pixbuf loading is benchmarked */
+	as_icon_set_kind (ic, AS_ICON_KIND_STOCK);
+	as_icon_set_name (ic, "application-x-executable");
+	as_app_add_icon (app, ic);
+
+	/* two screenshots each */
+	for (i = 0; i < 2; i++) {
+		g_autofree gchar *url = NULL;
+		g_autoptr(AsImage) im = as_image_new ();
+		g_autoptr(AsScreenshot) ss = as_screenshot_new ();
+		url = g_strdup_printf ("https://screenshots.example.org/%06u-%u.png",
+				       idx, i);
+		as_image_set_kind (im, AS_IMAGE_KIND_SOURCE);
+		as_image_set_url (im, url);
+		as_image_set_width (im, 1600);
+		as_image_set_height (im, 900);
+		as_screenshot_add_image (ss, im);
+		as_screenshot_set_kind (ss, i == 0 ? AS_SCREENSHOT_KIND_DEFAULT :
+						     AS_SCREENSHOT_KIND_NORMAL);
+		as_app_add_screenshot (app, ss);
+	}
+
+	/* some are popular */
+	if (idx % 20 == 0)
+		as_app_add_kudo (app, "GnomeSoftware::popular");
+
+	return app;
+}
+
+static AsApp *
+gs_cmd_benchmark_create_addon (guint idx, guint parent_idx)
+{
+	AsApp *app = as_app_new ();
+	g_autofree gchar *id = NULL;
+	g_autofree gchar *name = NULL;
+	g_autofree gchar *parent_id = gs_cmd_benchmark_get_id (parent_idx);
+	g_autofree gchar *pkgname = NULL;
+
+	id = g_strdup_printf ("org.example.Benchmark%06u.addon", idx);
+	name = g_strdup_printf ("Addon %u", idx);
+	pkgname = g_strdup_printf ("benchmark-addon-%06u", idx);
+	as_app_set_id (app, id);
+	as_app_set_kind (app, AS_APP_KIND_ADDON);
+	as_app_set_name (app, NULL, name);
+	as_app_set_summary (app, NULL, "A synthetic addon");
+	as_app_add_pkgname (app, pkgname);
+	as_app_add_extends (app, parent_id);
+	return app;
+}
+
+/**
+ * gs_cmd_benchmark_generate:
+ * @filename: the AppStream XML file to write
+ * @size: number of components to generate
+ * @error: a #GError, or %NULL
+ *
+ * Writes a reproducible synthetic AppStream catalogue. Every tenth
+ * component is an addon extending the application before it, every
+ * twentieth application is marked as popular and each block of
+ * %GS_CMD_BENCHMARK_GROUP_SIZE components shares a "groupNNNN" keyword so
+ * that searches return a bounded number of results at any catalogue size.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+gs_cmd_benchmark_generate (const gchar *filename, guint size, GError **error)
+{
+	guint i;
+	g_autoptr(AsStore) store = as_store_new ();
+	g_autoptr(GFile) file = g_file_new_for_path (filename);
+	g_autoptr(GRand) rand = g_rand_new_with_seed (size);
+
+	as_store_set_origin (store, "benchmark");
+	for (i = 0; i < size; i++) {
+		g_autoptr(AsApp) app = NULL;
+		if (i % 10 == 9)
+			app = gs_cmd_benchmark_create_addon (i, i - 1);
+		else
+			app = gs_cmd_benchmark_create_app (rand, i);
+		as_store_add_app (store, app);
+	}
+	return as_store_to_file (store, file,
+				 AS_NODE_TO_XML_FLAG_ADD_HEADER |
+				 AS_NODE_TO_XML_FLAG_FORMAT_INDENT |
+				 AS_NODE_TO_XML_FLAG_FORMAT_MULTILINE,
+				 NULL, error);
+}
+
+/******************************************************************************/
+
+typedef GsAppList *(*GsCmdBenchmarkFunc)	(GsPluginLoader	*plugin_loader,
+						 GsPluginRefineFlags refine_flags,
+						 GError		**error);
+
+static GsAppList *
+gs_cmd_benchmark_search (GsPluginLoader *plugin_loader,
+			 GsPluginRefineFlags refine_flags,
+			 GError **error)
+{
+	return gs_plugin_loader_search (plugin_loader, "group0000",
+					refine_flags, NULL, error);
+}
+
+static GsAppList *
+gs_cmd_benchmark_installed (GsPluginLoader *plugin_loader,
+			    GsPluginRefineFlags refine_flags,
+			    GError **error)
+{
+	return gs_plugin_loader_get_installed (plugin_loader,
+					       refine_flags, NULL, error);
+}
+
+static GsAppList *
+gs_cmd_benchmark_category (GsPluginLoader *plugin_loader,
+			   GsPluginRefineFlags refine_flags,
+			   GError **error)
+{
+	g_autoptr(GsCategory) parent = gs_category_new ("develop");
+	g_autoptr(GsCategory) category = gs_category_new ("all");
+	gs_category_add_desktop_group (category, "Development");
+	gs_category_add_child (parent, category);
+	return gs_plugin_loader_get_category_apps (plugin_loader, category,
+						   refine_flags, NULL, error);
+}
+
+static GsAppList *
+gs_cmd_benchmark_popular (GsPluginLoader *plugin_loader,
+			  GsPluginRefineFlags refine_flags,
+			  GError **error)
+{
+	return gs_plugin_loader_get_popular (plugin_loader,
+					     refine_flags, NULL, error);
+}
+
+static GsAppList *
+gs_cmd_benchmark_refine (GsPluginLoader *plugin_loader,
+			 GsPluginRefineFlags refine_flags,
+			 GError **error)
+{
+	guint i;
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+
+	/* fresh objects every time so nothing is already refined */
+	for (i = 0; i < GS_CMD_BENCHMARK_REFINE_SIZE; i++) {
+		g_autofree gchar *id = gs_cmd_benchmark_get_id (i * 10);
+		g_autoptr(GsApp) app = gs_app_new (id);
+		gs_app_list_add (list, app);
+	}
+	return gs_plugin_loader_refine (plugin_loader, list,
+					refine_flags, NULL, error);
+}
+
+typedef struct {
+	const gchar		*id;
+	GsCmdBenchmarkFunc	 func;
+} GsCmdBenchmarkScenario;
+
+static const GsCmdBenchmarkScenario benchmark_scenarios[] = {
+	{ "search",	gs_cmd_benchmark_search },
+	{ "installed",	gs_cmd_benchmark_installed },
+	{ "category",	gs_cmd_benchmark_category },
+	{ "popular",	gs_cmd_benchmark_popular },
+	{ "refine",	gs_cmd_benchmark_refine },
+	{ NULL,		NULL }
+};
+
+static gint
+gs_cmd_benchmark_sort_cb (gconstpointer a, gconstpointer b)
+{
+	gint64 v1 = *((const gint64 *) a);
+	gint64 v2 = *((const gint64 *) b);
+	if (v1 < v2)
+		return -1;
+	if (v1 > v2)
+		return 1;
+	return 0;
+}
+
+/* nearest-rank percentile of a sorted array */
+static gint64
+gs_cmd_benchmark_percentile (GArray *samples, guint pct)
+{
+	guint idx = (samples->len * pct + 99) / 100;
+	if (idx == 0)
+		idx = 1;
+	return g_array_index (samples, gint64, idx - 1);
+}
+
+static gint64
+gs_cmd_benchmark_get_rss (void)
+{
+	gint64 pages;
+	g_auto(GStrv) split = NULL;
+	g_autofree gchar *data = NULL;
+
+	if (!g_file_get_contents ("/proc/self/statm", &data, NULL, NULL))
+		return -1;
+	split = g_strsplit (data, " ", -1);
+	if (g_strv_length (split) < 2)
+		return -1;
+	pages = g_ascii_strtoll (split[1], NULL, 10);
+	return pages * sysconf (_SC_PAGESIZE) / 1024;
+}
+
+static gint64
+gs_cmd_benchmark_get_heap (void)
+{
+#ifdef HAVE_MALLINFO2
+	struct mallinfo2 mi = mallinfo2 ();
+	return (gint64) mi.uordblks;
+#else
+	return -1;
+#endif
+}
+
+static gboolean
+gs_cmd_benchmark_run_scenario (GsPluginLoader *plugin_loader,
+			       const GsCmdBenchmarkScenario *scenario,
+			       guint iterations,
+			       GsPluginRefineFlags refine_flags,
+			       JsonBuilder *builder,
+			       GError **error)
+{
+	gint64 heap_start;
+	gint64 total = 0;
+	guint i;
+	guint results = 0;
+	g_autoptr(GArray) samples = g_array_new (FALSE, FALSE, sizeof (gint64));
+	g_autoptr(GsAppList) list = NULL;
+
+	/* warm up any caches, this is not counted */
+	list = scenario->func (plugin_loader, refine_flags, error);
+	if (list == NULL) {
+		g_prefix_error (error, "%s failed: ", scenario->id);
+		return FALSE;
+	}
+	g_clear_object (&list);
+
+	heap_start = gs_cmd_benchmark_get_heap ();
+	for (i = 0; i < iterations; i++) {
+		gint64 start = g_get_monotonic_time ();
+		gint64 elapsed;
+		list = scenario->func (plugin_loader, refine_flags, error);
+		if (list == NULL) {
+			g_prefix_error (error, "%s failed: ", scenario->id);
+			return FALSE;
+		}
+		elapsed = g_get_monotonic_time () - start;
+		g_array_append_val (samples, elapsed);
+		total += elapsed;
+		results = gs_app_list_length (list);
+		g_clear_object (&list);
+	}
+	g_array_sort (samples, gs_cmd_benchmark_sort_cb);
+
+	json_builder_begin_object (builder);
+	json_builder_set_member_name (builder, "name");
+	json_builder_add_string_value (builder, scenario->id);
+	json_builder_set_member_name (builder, "results");
+	json_builder_add_int_value (builder, results);
+	json_builder_set_member_name (builder, "min_us");
+	json_builder_add_int_value (builder, g_array_index (samples, gint64, 0));
+	json_builder_set_member_name (builder, "mean_us");
+	json_builder_add_int_value (builder, total / samples->len);
+	json_builder_set_member_name (builder, "p50_us");
+	json_builder_add_int_value (builder, gs_cmd_benchmark_percentile (samples, 50));
+	json_builder_set_member_name (builder, "p95_us");
+	json_builder_add_int_value (builder, gs_cmd_benchmark_percentile (samples, 95));
+	json_builder_set_member_name (builder, "p99_us");
+	json_builder_add_int_value (builder, gs_cmd_benchmark_percentile (samples, 99));
+	json_builder_set_member_name (builder, "max_us");
+	json_builder_add_int_value (builder, g_array_index (samples, gint64, samples->len - 1));
+	if (heap_start >= 0) {
+		json_builder_set_member_name (builder, "heap_delta_bytes");
+		json_builder_add_int_value (builder, gs_cmd_benchmark_get_heap () - heap_start);
+	}
+	json_builder_set_member_name (builder, "rss_kb");
+	json_builder_add_int_value (builder, gs_cmd_benchmark_get_rss ());
+	json_builder_end_object (builder);
+	return TRUE;
+}
+
+/**
+ * gs_cmd_benchmark_run:
+ * @plugin_loader: a #GsPluginLoader that has already been set up
+ * @scenarios: (nullable): scenario names to run, or %NULL for all of them
+ * @iterations: number of timed runs of each scenario
+ * @refine_flags: the #GsPluginRefineFlags used for each action
+ * @error: a #GError, or %NULL
+ *
+ * Runs each scenario once to warm up and then @iterations times, timing
+ * each run. Latency percentiles are in microseconds.
+ *
+ * Returns: a JSON document describing the results, or %NULL on error
+ **/
+gchar *
+gs_cmd_benchmark_run (GsPluginLoader *plugin_loader,
+		      gchar **scenarios,
+		      guint iterations,
+		      GsPluginRefineFlags refine_flags,
+		      GError **error)
+{
+	guint i;
+	struct rusage usage;
+	g_autoptr(JsonBuilder) builder = json_builder_new ();
+	g_autoptr(JsonGenerator) generator = json_generator_new ();
+	g_autoptr(JsonNode) root = NULL;
+
+	/* check the scenarios exist before spending time running any */
+	for (i = 0; scenarios != NULL && scenarios[i] != NULL; i++) {
+		guint j;
+		for (j = 0; benchmark_scenarios[j].id != NULL; j++) {
+			if (g_strcmp0 (scenarios[i], benchmark_scenarios[j].id) == 0)
+				break;
+		}
+		if (benchmark_scenarios[j].id == NULL) {
+			g_set_error (error,
+				     GS_PLUGIN_ERROR,
+				     GS_PLUGIN_ERROR_NOT_SUPPORTED,
+				     "no benchmark scenario %s, use 'search', "
+				     "'installed', 'category', 'popular' or 'refine'",
+				     scenarios[i]);
+			return NULL;
+		}
+	}
+	if (iterations == 0)
+		iterations = 1;
+
+	json_builder_begin_object (builder);
+	json_builder_set_member_name (builder, "iterations");
+	json_builder_add_int_value (builder, iterations);
+	json_builder_set_member_name (builder, "scenarios");
+	json_builder_begin_array (builder);
+	for (i = 0; benchmark_scenarios[i].id != NULL; i++) {
+		const GsCmdBenchmarkScenario *scenario = &benchmark_scenarios[i];
+		if (scenarios != NULL &&
+		    !g_strv_contains ((const gchar * const *) scenarios, scenario->id))
+			continue;
+		if (!gs_cmd_benchmark_run_scenario (plugin_loader, scenario,
+						    iterations, refine_flags,
+						    builder, error))
+			return NULL;
+	}
+	json_builder_end_array (builder);
+
+	/* ru_maxrss is in kilobytes on Linux */
+	if (getrusage (RUSAGE_SELF, &usage) == 0) {
+		json_builder_set_member_name (builder, "peak_rss_kb");
+		json_builder_add_int_value (builder, usage.ru_maxrss);
+	}
+	json_builder_end_object (builder);
+
+	root = json_builder_get_root (builder);
+	json_generator_set_pretty (generator, TRUE);
+	json_generator_set_root (generator, root);
+	return json_generator_to_data (generator, NULL);
+}
+
+/* vim: set noexpandtab: */
@@ -0,0 +1,44 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __GS_CMD_BENCHMARK_H
+#define __GS_CMD_BENCHMARK_H
+
+#include <glib-object.h>
+
+#include "gs-plugin-loader.h"
+
+G_BEGIN_DECLS
+
+gboolean	 gs_cmd_benchmark_generate	(const gchar	*filename,
+						 guint		 size,
+						 GError		**error);
+gchar		*gs_cmd_benchmark_run		(GsPluginLoader	*plugin_loader,
+						 gchar		**scenarios,
+						 guint		 iterations,
+						 GsPluginRefineFlags refine_flags,
+						 GError		**error);
+
+G_END_DECLS
+
+#endif /* __GS_CMD_BENCHMARK_H */
+
+/* vim: set noexpandtab: */
@@ -26,6 +26,7 @@
 #include <gtk/gtk.h>
 #include <locale.h>
 
+#include "gs-cmd-benchmark.h"
 #include "gs-debug.h"
 #include "gs-plugin-loader.h"
 #include "gs-plugin-loader-sync.h"
@@ -144,6 +145,8 @@ gs_cmd_refine_flag_from_string (const gchar *flag, GError **error)
 		return GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME;
 	if (g_strcmp0 (flag, "origin-ui") == 0)
 		return GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_UI;
+	if (g_strcmp0 (flag, "screenshots") == 0)
+		return GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS;
 	g_set_error (error,
 		     GS_PLUGIN_ERROR,
 		     GS_PLUGIN_ERROR_NOT_SUPPORTED,
@@ -197,6 +200,7 @@ main (int argc, char **argv)
 	gint i;
 	guint cache_age = 0;
 	gint repeat = 1;
+	gint latency = 0;
 	int status = 0;
 	g_auto(GStrv) plugin_blacklist = NULL;
 	g_auto(GStrv) plugin_whitelist = NULL;
@@ -207,6 +211,9 @@ main (int argc, char **argv)
 	g_autofree gchar *plugin_blacklist_str = NULL;
 	g_autofree gchar *plugin_whitelist_str = NULL;
 	g_autofree gchar *refine_flags_str = NULL;
+	g_autofree gchar *catalog = NULL;
+	g_autofree gchar *locale = NULL;
+	g_autofree gchar *benchmark_json = NULL;
 	g_autoptr(GsApp) app = NULL;
 	g_autoptr(GFile) file = NULL;
 	g_autoptr(GsPluginLoader) plugin_loader = NULL;
@@ -228,6 +235,12 @@ main (int argc, char **argv)
 		  "Only load specific plugins", NULL },
 		{ "verbose", '\0', 0, G_OPTION_ARG_NONE, &verbose,
 		  "Show verbose debugging information", NULL },
+		{ "catalog", '\0', 0, G_OPTION_ARG_FILENAME, &catalog,
+		  "Use this AppStream collection file (.xml or .xml.gz) instead of the system metadata", NULL },
+		{ "latency", '\0', 0, G_OPTION_ARG_INT, &latency,
+		  "Enable the dummy plugin with this per-call latency in ms", NULL },
+		{ "locale", '\0', 0, G_OPTION_ARG_STRING, &locale,
+		  "Use this locale for the metadata, e.g. fr_FR", NULL },
 		{ NULL}
 	};
 
@@ -263,6 +276,26 @@ main (int argc, char **argv)
 		goto out;
 	}
 
+	/* this does not need any plugins */
+	if (argc == 4 && g_strcmp0 (argv[1], "generate-catalog") == 0) {
+		guint64 size = g_ascii_strtoull (argv[3], NULL, 10);
+		ret = gs_cmd_benchmark_generate (argv[2], (guint) size, &error);
+		if (!ret)
+			g_print ("Failed to generate: %s\n", error->message);
+		goto out;
+	}
+
+	/* use synthetic metadata */
+	if (catalog != NULL)
+		g_setenv ("GNOME_SOFTWARE_APPSTREAM_FILE", catalog, TRUE);
+
+	/* emulate a slow backend */
+	if (latency > 0) {
+		g_autofree gchar *tmp = g_strdup_printf ("%i", latency);
+		g_setenv ("GS_SELF_TEST_DUMMY_ENABLE", "1", TRUE);
+		g_setenv ("GS_SELF_TEST_DUMMY_LATENCY", tmp, TRUE);
+	}
+
 	/* load plugins */
 	plugin_loader = gs_plugin_loader_new ();
 	profile = gs_plugin_loader_get_profile (plugin_loader);
@@ -280,6 +313,14 @@ main (int argc, char **argv)
 		g_print ("Failed to setup plugins: %s\n", error->message);
 		goto out;
 	}
+	if (locale != NULL) {
+		ret = gs_plugin_loader_set_locale (plugin_loader, locale,
+						   NULL, &error);
+		if (!ret) {
+			g_print ("Failed to set locale: %s\n", error->message);
+			goto out;
+		}
+	}
 	gs_plugin_loader_dump_state (plugin_loader);
 
 	/* do action */
@@ -453,6 +494,14 @@ main (int argc, char **argv)
 				break;
 			}
 		}
+	} else if (argc >= 2 && g_strcmp0 (argv[1], "benchmark") == 0) {
+		benchmark_json = gs_cmd_benchmark_run (plugin_loader,
+						       argc > 2 ? &argv[2] : NULL,
+						       (guint) repeat,
+						       refine_flags,
+						       &error);
+		if (benchmark_json == NULL)
+			ret = FALSE;
 	} else if (argc >= 2 && g_strcmp0 (argv[1], "refresh") == 0) {
 		GsPluginRefreshFlags refresh_flags;
 		refresh_flags = gs_cmd_refresh_flag_from_string (argv[2]);
@@ -466,7 +515,8 @@ main (int argc, char **argv)
 				     "Did not recognise option, use 'installed', "
 				     "'updates', 'popular', 'get-categories', "
 				     "'get-category-apps', 'filename-to-app', "
-				     "'sources', 'refresh', 'launch' or 'search'");
+				     "'sources', 'refresh', 'launch', 'benchmark', "
+				     "'generate-catalog' or 'search'");
 	}
 	if (!ret) {
 		g_print ("Failed: %s\n", error->message);
@@ -480,7 +530,10 @@ main (int argc, char **argv)
 			gs_cmd_show_results_categories (categories);
 	}
 out:
-	if (profile != NULL)
+	/* keep the output machine readable */
+	if (benchmark_json != NULL)
+		g_print ("%s\n", benchmark_json);
+	else if (profile != NULL)
 		as_profile_dump (profile);
 	g_option_context_free (context);
 	return status;
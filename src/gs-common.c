@@ -109,6 +109,134 @@ gs_container_remove_all (GtkContainer *container)
 	gtk_container_foreach (container, remove_all_cb, container);
 }
 
+static GsApp *
+gs_container_child_get_app (GtkWidget *child)
+{
+	/* flow boxes wrap each widget in a child of their own */
+	if (GTK_IS_FLOW_BOX_CHILD (child))
+		child = gtk_bin_get_child (GTK_BIN (child));
+	if (child == NULL)
+		return NULL;
+	return g_object_get_data (G_OBJECT (child), "GsContainer::app");
+}
+
+static void
+gs_container_insert (GtkContainer *container, GtkWidget *widget, gint position)
+{
+	if (GTK_IS_FLOW_BOX (container)) {
+		gtk_flow_box_insert (GTK_FLOW_BOX (container), widget, position);
+		return;
+	}
+	gtk_container_add (container, widget);
+	if (GTK_IS_BOX (container))
+		gtk_box_reorder_child (GTK_BOX (container), widget, position);
+}
+
+/**
+ * gs_container_set_apps:
+ * @container: a #GtkContainer
+ * @list: a #GsAppList
+ * @create_func: a #GsContainerCreateFunc
+ * @user_data: user data for @create_func
+ *
+ * Makes @container show one widget for each application in @list.
+ *
+ * Widgets created by an earlier call for the same #GsApp are kept, and
+ * @create_func is only called for the applications that are new. Any other
+ * widget in the container is removed.
+ *
+ * The widgets are ordered as in @list, apart from in a #GtkListBox where the
+ * sort function of the list box decides.
+ **/
+void
+gs_container_set_apps (GtkContainer *container,
+		       GsAppList *list,
+		       GsContainerCreateFunc create_func,
+		       gpointer user_data)
+{
+	GList *l;
+	guint i;
+	guint len = gs_app_list_length (list);
+	g_autofree GtkWidget **wanted = NULL;
+	g_autoptr(GHashTable) existing = NULL;
+	g_autoptr(GHashTable) kept = NULL;
+	g_autoptr(GList) children = NULL;
+	g_autoptr(GPtrArray) order = NULL;
+
+	/* index the widgets by the app they show */
+	existing = g_hash_table_new (g_str_hash, g_str_equal);
+	children = gtk_container_get_children (container);
+	for (l = children; l != NULL; l = l->next) {
+		GsApp *app = gs_container_child_get_app (l->data);
+		if (app == NULL || gs_app_get_unique_id (app) == NULL)
+			continue;
+		g_hash_table_insert (existing,
+				     (gpointer) gs_app_get_unique_id (app),
+				     l->data);
+	}
+
+	/* find the widgets that can be kept */
+	kept = g_hash_table_new (g_direct_hash, g_direct_equal);
+	wanted = g_new0 (GtkWidget *, len + 1);
+	for (i = 0; i < len; i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GtkWidget *child;
+		if (gs_app_get_unique_id (app) == NULL)
+			continue;
+		child = g_hash_table_lookup (existing, gs_app_get_unique_id (app));
+		if (child == NULL || gs_container_child_get_app (child) != app)
+			continue;
+		if (g_hash_table_contains (kept, child))
+			continue;
+		g_hash_table_add (kept, child);
+		wanted[i] = child;
+	}
+
+	/* remove everything else */
+	order = g_ptr_array_new ();
+	for (l = children; l != NULL; l = l->next) {
+		if (g_hash_table_contains (kept, l->data))
+			g_ptr_array_add (order, l->data);
+		else
+			gtk_container_remove (container, l->data);
+	}
+
+	/* add the new widgets and move any kept ones into place */
+	for (i = 0; i < len; i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GtkWidget *child = wanted[i];
+
+		if (child == NULL) {
+			GtkWidget *widget = create_func (app, user_data);
+			g_object_set_data_full (G_OBJECT (widget),
+						"GsContainer::app",
+						g_object_ref (app),
+						(GDestroyNotify) g_object_unref);
+			gs_container_insert (container, widget, (gint) i);
+			if (GTK_IS_FLOW_BOX (container))
+				widget = gtk_widget_get_parent (widget);
+			g_ptr_array_insert (order, (gint) i, widget);
+			continue;
+		}
+		if (GTK_IS_LIST_BOX (container))
+			continue;
+		if (i < order->len && g_ptr_array_index (order, i) == child)
+			continue;
+		g_object_ref (child);
+		g_ptr_array_remove (order, child);
+		gtk_container_remove (container, child);
+		gs_container_insert (container, child, (gint) i);
+		g_ptr_array_insert (order, (gint) i, child);
+		g_object_unref (child);
+	}
+
+	/* the kept rows may have moved */
+	if (GTK_IS_LIST_BOX (container)) {
+		gtk_list_box_invalidate_sort (GTK_LIST_BOX (container));
+		gtk_list_box_invalidate_headers (GTK_LIST_BOX (container));
+	}
+}
+
 static void
 grab_focus (GtkWidget *widget)
 {
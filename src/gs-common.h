@@ -32,7 +32,14 @@ G_BEGIN_DECLS
 
 void	 gs_start_spinner		(GtkSpinner	*spinner);
 void	 gs_stop_spinner		(GtkSpinner	*spinner);
+typedef GtkWidget *(*GsContainerCreateFunc)	(GsApp		*app,
+						 gpointer	 user_data);
+
 void	 gs_container_remove_all	(GtkContainer	*container);
+void	 gs_container_set_apps		(GtkContainer	*container,
+					 GsAppList	*list,
+					 GsContainerCreateFunc create_func,
+					 gpointer	 user_data);
 void	 gs_grab_focus_when_mapped	(GtkWidget	*widget);
 
 void	 gs_app_notify_installed	(GsApp		*app);
@@ -21,6 +21,8 @@
 
 #include "config.h"
 
+#include <stdlib.h>
+#include <string.h>
 #include <glib/gi18n.h>
 
 #include "gs-content-rating.h"
@@ -61,222 +63,252 @@ gs_content_rating_system_to_str (GsContentRatingSystem system)
 	return NULL;
 }
 
+/* one entry for each OARS attribute, sorted by ID, with the descriptions
+ * indexed by AsContentRatingValue */
+typedef struct {
+	const gchar		*id;
+	const gchar		*desc[AS_CONTENT_RATING_VALUE_LAST];
+} GsContentRatingKey;
+
+static const GsContentRatingKey content_rating_keys[] = {
+	{ "drugs-alcohol", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No references to alcohol"),
+		/* TRANSLATORS: content rating description */
+		N_("References to alcoholic beverages"),
+		/* TRANSLATORS: content rating description */
+		N_("Use of alcoholic beverages"),
+		NULL,
+	} },
+	{ "drugs-narcotics", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No references to illicit drugs"),
+		/* TRANSLATORS: content rating description */
+		N_("References to illicit drugs"),
+		/* TRANSLATORS: content rating description */
+		N_("Use of illicit drugs"),
+		NULL,
+	} },
+	{ "drugs-tobacco", {
+		NULL,
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("References to tobacco products"),
+		/* TRANSLATORS: content rating description */
+		N_("Use of tobacco products"),
+		NULL,
+	} },
+	{ "language-discrimination", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No discriminatory language of any kind"),
+		/* TRANSLATORS: content rating description */
+		N_("Negativity towards a specific group of people"),
+		/* TRANSLATORS: content rating description */
+		N_("Discrimination designed to cause emotional harm"),
+		/* TRANSLATORS: content rating description */
+		N_("Explicit discrimination based on gender, sexuality, race or religion"),
+	} },
+	{ "language-humor", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No innappropriate humor"),
+		/* TRANSLATORS: content rating description */
+		N_("Slapstick humor"),
+		/* TRANSLATORS: content rating description */
+		N_("Vulgar or bathroom humor"),
+		/* TRANSLATORS: content rating description */
+		N_("Mature or sexual humor"),
+	} },
+	{ "language-profanity", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No profanity of any kind"),
+		/* TRANSLATORS: content rating description */
+		N_("Mild or infrequent use of profanity"),
+		/* TRANSLATORS: content rating description */
+		N_("Moderate use of profanity"),
+		/* TRANSLATORS: content rating description */
+		N_("Strong or frequent use of profanity"),
+	} },
+	{ "money-advertising", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No advertising of any kind"),
+		/* TRANSLATORS: content rating description */
+		N_("Product placement"),
+		/* TRANSLATORS: content rating description */
+		N_("Explicit references to specific brands or trademarked products"),
+		/* TRANSLATORS: content rating description */
+		N_("Players are encouraged to purchase specific real-world items"),
+	} },
+	{ "money-gambling", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No gambling of any kind"),
+		/* TRANSLATORS: content rating description */
+		N_("Gambling on random events using tokens or credits"),
+		/* TRANSLATORS: content rating description */
+		N_("Gambling using \"play\" money"),
+		/* TRANSLATORS: content rating description */
+		N_("Gambling using real money"),
+	} },
+	{ "money-purchasing", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No ability to spend money"),
+		NULL,
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("Ability to spend real money in-game"),
+	} },
+	{ "sex-nudity", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No nudity of any sort"),
+		/* TRANSLATORS: content rating description */
+		N_("Brief artistic nudity"),
+		/* TRANSLATORS: content rating description */
+		N_("Prolonged nudity"),
+		NULL,
+	} },
+	{ "sex-themes", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No references or depictions of sexual nature"),
+		/* TRANSLATORS: content rating description */
+		N_("Provocative references or depictions"),
+		/* TRANSLATORS: content rating description */
+		N_("Sexual references or depictions"),
+		/* TRANSLATORS: content rating description */
+		N_("Graphic sexual behavior"),
+	} },
+	{ "social-audio", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No way to talk with other players"),
+		NULL,
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("Uncontrolled audio or video chat functionality between players"),
+	} },
+	{ "social-chat", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No way to chat with other players"),
+		/* TRANSLATORS: content rating description */
+		N_("Player-to-player game interactions without chat functionality"),
+		/* TRANSLATORS: content rating description */
+		N_("Player-to-player preset interactions without chat functionality"),
+		/* TRANSLATORS: content rating description */
+		N_("Uncontrolled chat functionality between players"),
+	} },
+	{ "social-contacts", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No sharing of social network usernames or email addresses"),
+		NULL,
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("Sharing social network usernames or email addresses"),
+	} },
+	{ "social-info", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No sharing of user information with 3rd parties"),
+		NULL,
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("Sharing user information with 3rd parties"),
+	} },
+	{ "social-location", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No sharing of physical location to other users"),
+		NULL,
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("Sharing physical location to other users"),
+	} },
+	{ "violence-bloodshed", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No bloodshed"),
+		/* TRANSLATORS: content rating description */
+		N_("Unrealistic bloodshed"),
+		/* TRANSLATORS: content rating description */
+		N_("Realistic bloodshed"),
+		/* TRANSLATORS: content rating description */
+		N_("Depictions of bloodshed and the mutilation of body parts"),
+	} },
+	{ "violence-cartoon", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No cartoon violence"),
+		/* TRANSLATORS: content rating description */
+		N_("Cartoon characters in unsafe situations"),
+		/* TRANSLATORS: content rating description */
+		N_("Cartoon characters in aggressive conflict"),
+		/* TRANSLATORS: content rating description */
+		N_("Graphic violence involving cartoon characters"),
+	} },
+	{ "violence-fantasy", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No fantasy violence"),
+		/* TRANSLATORS: content rating description */
+		N_("Characters in unsafe situations easily distinguishable from reality"),
+		/* TRANSLATORS: content rating description */
+		N_("Characters in aggressive conflict easily distinguishable from reality"),
+		/* TRANSLATORS: content rating description */
+		N_("Graphic violence easily distinguishable from reality"),
+	} },
+	{ "violence-realistic", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No realistic violence"),
+		/* TRANSLATORS: content rating description */
+		N_("Mildly realistic characters in unsafe situations"),
+		/* TRANSLATORS: content rating description */
+		N_("Depictions of realistic characters in aggressive conflict"),
+		/* TRANSLATORS: content rating description */
+		N_("Graphic violence involving realistic characters"),
+	} },
+	{ "violence-sexual", {
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("No sexual violence"),
+		NULL,
+		NULL,
+		/* TRANSLATORS: content rating description */
+		N_("Rape or other violent sexual behavior"),
+	} },
+};
+
+static gint
+gs_content_rating_key_cmp (gconstpointer a, gconstpointer b)
+{
+	const gchar *id = (const gchar *) a;
+	const GsContentRatingKey *key = (const GsContentRatingKey *) b;
+	return g_strcmp0 (id, key->id);
+}
+
 const gchar *
 gs_content_rating_key_value_to_str (const gchar *id, AsContentRatingValue value)
 {
-	guint i;
-	struct {
-		const gchar		*id;
-		AsContentRatingValue	 value;
-		const gchar		*desc;
-	} tab[] =  {
-	{ "violence-cartoon",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No cartoon violence") },
-	{ "violence-cartoon",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Cartoon characters in unsafe situations") },
-	{ "violence-cartoon",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Cartoon characters in aggressive conflict") },
-	{ "violence-cartoon",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Graphic violence involving cartoon characters") },
-	{ "violence-fantasy",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No fantasy violence") },
-	{ "violence-fantasy",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Characters in unsafe situations easily distinguishable from reality") },
-	{ "violence-fantasy",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Characters in aggressive conflict easily distinguishable from reality") },
-	{ "violence-fantasy",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Graphic violence easily distinguishable from reality") },
-	{ "violence-realistic",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No realistic violence") },
-	{ "violence-realistic",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Mildly realistic characters in unsafe situations") },
-	{ "violence-realistic",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Depictions of realistic characters in aggressive conflict") },
-	{ "violence-realistic",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Graphic violence involving realistic characters") },
-	{ "violence-bloodshed",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No bloodshed") },
-	{ "violence-bloodshed",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Unrealistic bloodshed") },
-	{ "violence-bloodshed",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Realistic bloodshed") },
-	{ "violence-bloodshed",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Depictions of bloodshed and the mutilation of body parts") },
-	{ "violence-sexual",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No sexual violence") },
-	{ "violence-sexual",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Rape or other violent sexual behavior") },
-	{ "drugs-alcohol",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No references to alcohol") },
-	{ "drugs-alcohol",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("References to alcoholic beverages") },
-	{ "drugs-alcohol",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Use of alcoholic beverages") },
-	{ "drugs-narcotics",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No references to illicit drugs") },
-	{ "drugs-narcotics",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("References to illicit drugs") },
-	{ "drugs-narcotics",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Use of illicit drugs") },
-	{ "drugs-tobacco",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("References to tobacco products") },
-	{ "drugs-tobacco",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Use of tobacco products") },
-	{ "sex-nudity",		AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No nudity of any sort") },
-	{ "sex-nudity",		AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Brief artistic nudity") },
-	{ "sex-nudity",		AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Prolonged nudity") },
-	{ "sex-themes",		AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No references or depictions of sexual nature") },
-	{ "sex-themes",		AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Provocative references or depictions") },
-	{ "sex-themes",		AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Sexual references or depictions") },
-	{ "sex-themes",		AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Graphic sexual behavior") },
-	{ "language-profanity",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No profanity of any kind") },
-	{ "language-profanity",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Mild or infrequent use of profanity") },
-	{ "language-profanity",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Moderate use of profanity") },
-	{ "language-profanity",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Strong or frequent use of profanity") },
-	{ "language-humor",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No innappropriate humor") },
-	{ "language-humor",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Slapstick humor") },
-	{ "language-humor",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Vulgar or bathroom humor") },
-	{ "language-humor",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Mature or sexual humor") },
-	{ "language-discrimination", AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No discriminatory language of any kind") },
-	{ "language-discrimination", AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Negativity towards a specific group of people") },
-	{ "language-discrimination", AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Discrimination designed to cause emotional harm") },
-	{ "language-discrimination", AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Explicit discrimination based on gender, sexuality, race or religion") },
-	{ "money-advertising", AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No advertising of any kind") },
-	{ "money-advertising", AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Product placement") },
-	{ "money-advertising", AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Explicit references to specific brands or trademarked products") },
-	{ "money-advertising", AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Players are encouraged to purchase specific real-world items") },
-	{ "money-gambling",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No gambling of any kind") },
-	{ "money-gambling",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Gambling on random events using tokens or credits") },
-	{ "money-gambling",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Gambling using \"play\" money") },
-	{ "money-gambling",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Gambling using real money") },
-	{ "money-purchasing",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No ability to spend money") },
-	{ "money-purchasing",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Ability to spend real money in-game") },
-	{ "social-chat",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No way to chat with other players") },
-	{ "social-chat",	AS_CONTENT_RATING_VALUE_MILD,
-	/* TRANSLATORS: content rating description */
-	_("Player-to-player game interactions without chat functionality") },
-	{ "social-chat",	AS_CONTENT_RATING_VALUE_MODERATE,
-	/* TRANSLATORS: content rating description */
-	_("Player-to-player preset interactions without chat functionality") },
-	{ "social-chat",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Uncontrolled chat functionality between players") },
-	{ "social-audio",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No way to talk with other players") },
-	{ "social-audio",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Uncontrolled audio or video chat functionality between players") },
-	{ "social-contacts",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No sharing of social network usernames or email addresses") },
-	{ "social-contacts",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Sharing social network usernames or email addresses") },
-	{ "social-info",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No sharing of user information with 3rd parties") },
-	{ "social-info",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Sharing user information with 3rd parties") },
-	{ "social-location",	AS_CONTENT_RATING_VALUE_NONE,
-	/* TRANSLATORS: content rating description */
-	_("No sharing of physical location to other users") },
-	{ "social-location",	AS_CONTENT_RATING_VALUE_INTENSE,
-	/* TRANSLATORS: content rating description */
-	_("Sharing physical location to other users") },
-	{ NULL, 0, NULL } };
-	for (i = 0; tab[i].id != NULL; i++) {
-		if (g_strcmp0 (tab[i].id, id) == 0 && tab[i].value == value)
-			return tab[i].desc;
-	}
-	return NULL;
+	const GsContentRatingKey *key;
+
+	if (id == NULL || value >= AS_CONTENT_RATING_VALUE_LAST)
+		return NULL;
+	key = bsearch (id, content_rating_keys,
+		       G_N_ELEMENTS (content_rating_keys),
+		       sizeof (GsContentRatingKey),
+		       gs_content_rating_key_cmp);
+	if (key == NULL || key->desc[value] == NULL)
+		return NULL;
+	return _(key->desc[value]);
 }
 
 /* data obtained from https://en.wikipedia.org/wiki/Video_game_rating_system */
@@ -447,123 +479,117 @@ gs_utils_content_rating_age_to_str (GsContentRatingSystem system, guint age)
 	return NULL;
 }
 
-/* data obtained from https://en.wikipedia.org/wiki/Video_game_rating_system */
-GsContentRatingSystem
-gs_utils_content_rating_system_from_locale (const gchar *locale)
-{
-	g_auto(GStrv) split = g_strsplit (locale, "_", -1);
+/* data obtained from https://en.wikipedia.org/wiki/Video_game_rating_system,
+ * sorted by the first part of the locale */
+typedef struct {
+	const gchar		*code;
+	GsContentRatingSystem	 system;
+} GsContentRatingLocale;
 
-	/* Argentina */
-	if (g_strcmp0 (split[0], "ar") == 0)
-		return GS_CONTENT_RATING_SYSTEM_INCAA;
+static const GsContentRatingLocale content_rating_locales[] = {
+	{ "ad",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "al",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "am",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ar",	GS_CONTENT_RATING_SYSTEM_INCAA },
+	{ "at",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "au",	GS_CONTENT_RATING_SYSTEM_ACB },
+	{ "az",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ba",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "be",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "bg",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "br",	GS_CONTENT_RATING_SYSTEM_DJCTQ },
+	{ "by",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ca",	GS_CONTENT_RATING_SYSTEM_ESRB },
+	{ "ch",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "cy",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "cz",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "de",	GS_CONTENT_RATING_SYSTEM_USK },
+	{ "dk",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ee",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "es",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "fi",	GS_CONTENT_RATING_SYSTEM_KAVI },
+	{ "fl",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "fr",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "gb",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ge",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "gr",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "hr",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "hu",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "il",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "in",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ir",	GS_CONTENT_RATING_SYSTEM_ESRA },
+	{ "is",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "it",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "jp",	GS_CONTENT_RATING_SYSTEM_CERO },
+	{ "kr",	GS_CONTENT_RATING_SYSTEM_GRAC },
+	{ "kz",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "lt",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "lu",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "lv",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "mc",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "md",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "me",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "mk",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "mt",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "mx",	GS_CONTENT_RATING_SYSTEM_ESRB },
+	{ "nl",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "no",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "nz",	GS_CONTENT_RATING_SYSTEM_OFLCNZ },
+	{ "pk",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "pl",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "pt",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ro",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "rs",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ru",	GS_CONTENT_RATING_SYSTEM_RUSSIA },
+	{ "se",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "sg",	GS_CONTENT_RATING_SYSTEM_MDA },
+	{ "si",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "sk",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "sm",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "tr",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "ua",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "us",	GS_CONTENT_RATING_SYSTEM_ESRB },
+	{ "va",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "xk",	GS_CONTENT_RATING_SYSTEM_PEGI },
+	{ "za",	GS_CONTENT_RATING_SYSTEM_PEGI },
+};
 
-	/* Australia */
-	if (g_strcmp0 (split[0], "au") == 0)
-		return GS_CONTENT_RATING_SYSTEM_ACB;
+static gint
+gs_content_rating_locale_cmp (gconstpointer a, gconstpointer b)
+{
+	const gchar *code = (const gchar *) a;
+	const GsContentRatingLocale *item = (const GsContentRatingLocale *) b;
+	return g_strcmp0 (code, item->code);
+}
 
-	/* Brazil */
-	if (g_strcmp0 (split[0], "br") == 0)
-		return GS_CONTENT_RATING_SYSTEM_DJCTQ;
+GsContentRatingSystem
+gs_utils_content_rating_system_from_locale (const gchar *locale)
+{
+	const GsContentRatingLocale *item;
+	gchar code[4];
+	gsize len;
 
-	/* Taiwan */
+	/* Taiwan, and the English locales that would otherwise be IARC */
 	if (g_strcmp0 (locale, "zh_TW") == 0)
 		return GS_CONTENT_RATING_SYSTEM_GSRR;
-
-	/* Europe (but not Finland or Germany), India, Israel,
-	 * Pakistan, Quebec, South Africa */
-	if (g_strcmp0 (locale, "en_GB") == 0 ||
-	    g_strcmp0 (split[0], "gb") == 0 ||
-	    g_strcmp0 (split[0], "al") == 0 ||
-	    g_strcmp0 (split[0], "ad") == 0 ||
-	    g_strcmp0 (split[0], "am") == 0 ||
-	    g_strcmp0 (split[0], "at") == 0 ||
-	    g_strcmp0 (split[0], "az") == 0 ||
-	    g_strcmp0 (split[0], "by") == 0 ||
-	    g_strcmp0 (split[0], "be") == 0 ||
-	    g_strcmp0 (split[0], "ba") == 0 ||
-	    g_strcmp0 (split[0], "bg") == 0 ||
-	    g_strcmp0 (split[0], "hr") == 0 ||
-	    g_strcmp0 (split[0], "cy") == 0 ||
-	    g_strcmp0 (split[0], "cz") == 0 ||
-	    g_strcmp0 (split[0], "dk") == 0 ||
-	    g_strcmp0 (split[0], "ee") == 0 ||
-	    g_strcmp0 (split[0], "fr") == 0 ||
-	    g_strcmp0 (split[0], "ge") == 0 ||
-	    g_strcmp0 (split[0], "gr") == 0 ||
-	    g_strcmp0 (split[0], "hu") == 0 ||
-	    g_strcmp0 (split[0], "is") == 0 ||
-	    g_strcmp0 (split[0], "it") == 0 ||
-	    g_strcmp0 (split[0], "kz") == 0 ||
-	    g_strcmp0 (split[0], "xk") == 0 ||
-	    g_strcmp0 (split[0], "lv") == 0 ||
-	    g_strcmp0 (split[0], "fl") == 0 ||
-	    g_strcmp0 (split[0], "lu") == 0 ||
-	    g_strcmp0 (split[0], "lt") == 0 ||
-	    g_strcmp0 (split[0], "mk") == 0 ||
-	    g_strcmp0 (split[0], "mt") == 0 ||
-	    g_strcmp0 (split[0], "md") == 0 ||
-	    g_strcmp0 (split[0], "mc") == 0 ||
-	    g_strcmp0 (split[0], "me") == 0 ||
-	    g_strcmp0 (split[0], "nl") == 0 ||
-	    g_strcmp0 (split[0], "no") == 0 ||
-	    g_strcmp0 (split[0], "pl") == 0 ||
-	    g_strcmp0 (split[0], "pt") == 0 ||
-	    g_strcmp0 (split[0], "ro") == 0 ||
-	    g_strcmp0 (split[0], "sm") == 0 ||
-	    g_strcmp0 (split[0], "rs") == 0 ||
-	    g_strcmp0 (split[0], "sk") == 0 ||
-	    g_strcmp0 (split[0], "si") == 0 ||
-	    g_strcmp0 (split[0], "es") == 0 ||
-	    g_strcmp0 (split[0], "se") == 0 ||
-	    g_strcmp0 (split[0], "ch") == 0 ||
-	    g_strcmp0 (split[0], "tr") == 0 ||
-	    g_strcmp0 (split[0], "ua") == 0 ||
-	    g_strcmp0 (split[0], "va") == 0 ||
-	    g_strcmp0 (split[0], "in") == 0 ||
-	    g_strcmp0 (split[0], "il") == 0 ||
-	    g_strcmp0 (split[0], "pk") == 0 ||
-	    g_strcmp0 (split[0], "za") == 0)
+	if (g_strcmp0 (locale, "en_GB") == 0)
 		return GS_CONTENT_RATING_SYSTEM_PEGI;
-
-	/* Finland */
-	if (g_strcmp0 (split[0], "fi") == 0)
-		return GS_CONTENT_RATING_SYSTEM_KAVI;
-
-	/* Germany */
-	if (g_strcmp0 (split[0], "de") == 0)
-		return GS_CONTENT_RATING_SYSTEM_USK;
-
-	/* Iran */
-	if (g_strcmp0 (split[0], "ir") == 0)
-		return GS_CONTENT_RATING_SYSTEM_ESRA;
-
-	/* Japan */
-	if (g_strcmp0 (split[0], "jp") == 0)
-		return GS_CONTENT_RATING_SYSTEM_CERO;
-
-	/* New Zealand */
-	if (g_strcmp0 (split[0], "nz") == 0)
-		return GS_CONTENT_RATING_SYSTEM_OFLCNZ;
-
-	/* Russia: Content rating law */
-	if (g_strcmp0 (split[0], "ru") == 0)
-		return GS_CONTENT_RATING_SYSTEM_RUSSIA;
-
-	/* Singapore */
-	if (g_strcmp0 (split[0], "sg") == 0)
-		return GS_CONTENT_RATING_SYSTEM_MDA;
-
-	/* South Korea */
-	if (g_strcmp0 (split[0], "kr") == 0)
-		return GS_CONTENT_RATING_SYSTEM_GRAC;
-
-	/* USA, Canada, Mexico */
-	if (g_strcmp0 (locale, "en_US") == 0 ||
-	    g_strcmp0 (split[0], "us") == 0 ||
-	    g_strcmp0 (split[0], "ca") == 0 ||
-	    g_strcmp0 (split[0], "mx") == 0)
+	if (g_strcmp0 (locale, "en_US") == 0)
 		return GS_CONTENT_RATING_SYSTEM_ESRB;
 
-	/* everything else is IARC */
-	return GS_CONTENT_RATING_SYSTEM_IARC;
+	/* everything that is not in the table is IARC */
+	if (locale == NULL)
+		return GS_CONTENT_RATING_SYSTEM_IARC;
+	len = strcspn (locale, "_");
+	if (len >= sizeof (code))
+		return GS_CONTENT_RATING_SYSTEM_IARC;
+	memcpy (code, locale, len);
+	code[len] = '\0';
+	item = bsearch (code, content_rating_locales,
+			G_N_ELEMENTS (content_rating_locales),
+			sizeof (GsContentRatingLocale),
+			gs_content_rating_locale_cmp);
+	if (item == NULL)
+		return GS_CONTENT_RATING_SYSTEM_IARC;
+	return item->system;
 }
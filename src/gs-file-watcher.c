@@ -0,0 +1,382 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * SECTION:gs-file-watcher
+ * @title: GsFileWatcher
+ * @stability: Unstable
+ * @short_description: File watches shared by all the plugins
+ *
+ * The plugin loader owns one file watcher that plugins use through
+ * gs_plugin_watch_file() rather than creating their own #GFileMonitor.
+ *
+ * Only one monitor is created for each file, however many plugins watch
+ * it, and the events are not passed on straight away. Package manager
+ * transactions can touch hundreds of files, so each plugin callback is only
+ * run once the events have stopped for a short time, or after a longer
+ * time if they keep on coming.
+ */
+
+#include "config.h"
+
+#include "gs-file-watcher.h"
+#include "gs-utils.h"
+
+#define GS_FILE_WATCHER_DELAY		500	/* ms */
+#define GS_FILE_WATCHER_DELAY_MAX	5000	/* ms */
+
+typedef struct {
+	GsFileWatcher		*watcher;
+	GsPlugin		*plugin;
+	GsPluginWatchFunc	 func;
+	gpointer		 user_data;
+	guint			 timeout_id;
+	gint64			 first_event;	/* of the current burst */
+	guint			 events;
+} GsFileWatcherClient;
+
+typedef struct {
+	GsFileWatcher		*watcher;
+	GFileMonitor		*monitor;
+	GPtrArray		*clients;	/* of GsFileWatcherClient, no ref */
+} GsFileWatcherItem;
+
+struct _GsFileWatcher
+{
+	GObject			 parent_instance;
+	GMutex			 mutex;
+	GHashTable		*items;		/* uri : GsFileWatcherItem */
+	GPtrArray		*clients;	/* of GsFileWatcherClient */
+};
+
+G_DEFINE_TYPE (GsFileWatcher, gs_file_watcher, G_TYPE_OBJECT)
+
+static void
+gs_file_watcher_client_free (GsFileWatcherClient *client)
+{
+	if (client->timeout_id != 0)
+		g_source_remove (client->timeout_id);
+	g_slice_free (GsFileWatcherClient, client);
+}
+
+static void
+gs_file_watcher_item_free (GsFileWatcherItem *item)
+{
+	g_signal_handlers_disconnect_by_data (item->monitor, item);
+	g_file_monitor_cancel (item->monitor);
+	g_object_unref (item->monitor);
+	g_ptr_array_unref (item->clients);
+	g_slice_free (GsFileWatcherItem, item);
+}
+
+static gboolean
+gs_file_watcher_client_timeout_cb (gpointer user_data)
+{
+	GsFileWatcherClient *client = (GsFileWatcherClient *) user_data;
+	GsFileWatcher *watcher = client->watcher;
+	guint events;
+
+	/* a newer timeout replaced this one while it was being dispatched */
+	g_mutex_lock (&watcher->mutex);
+	if (g_source_get_id (g_main_current_source ()) != client->timeout_id) {
+		g_mutex_unlock (&watcher->mutex);
+		return G_SOURCE_REMOVE;
+	}
+	events = client->events;
+	client->timeout_id = 0;
+	client->events = 0;
+	g_mutex_unlock (&watcher->mutex);
+
+	/* clients are only removed in the main thread, like this */
+	g_debug ("notifying %s about %u changes",
+		 gs_plugin_get_name (client->plugin), events);
+	client->func (client->plugin, client->user_data);
+	return G_SOURCE_REMOVE;
+}
+
+/* call with the mutex held */
+static void
+gs_file_watcher_client_queue (GsFileWatcherClient *client)
+{
+	gint64 now = g_get_monotonic_time ();
+
+	client->events++;
+	if (client->timeout_id == 0) {
+		client->first_event = now;
+	} else {
+		/* let the pending timeout fire if the burst is taking too long */
+		if (now - client->first_event > GS_FILE_WATCHER_DELAY_MAX * 1000)
+			return;
+		g_source_remove (client->timeout_id);
+	}
+	client->timeout_id = g_timeout_add (GS_FILE_WATCHER_DELAY,
+					    gs_file_watcher_client_timeout_cb,
+					    client);
+}
+
+/* call with the mutex held */
+static GsFileWatcherClient *
+gs_file_watcher_client_ensure (GsFileWatcher *watcher,
+			       GsPlugin *plugin,
+			       GsPluginWatchFunc func,
+			       gpointer user_data)
+{
+	GsFileWatcherClient *client;
+	guint i;
+
+	/* all the watches with the same callback share one notification */
+	for (i = 0; i < watcher->clients->len; i++) {
+		client = g_ptr_array_index (watcher->clients, i);
+		if (client->plugin == plugin &&
+		    client->func == func &&
+		    client->user_data == user_data)
+			return client;
+	}
+	client = g_slice_new0 (GsFileWatcherClient);
+	client->watcher = watcher;
+	client->plugin = plugin;
+	client->func = func;
+	client->user_data = user_data;
+	g_ptr_array_add (watcher->clients, client);
+	return client;
+}
+
+static void
+gs_file_watcher_changed_cb (GFileMonitor *monitor,
+			    GFile *file,
+			    GFile *other_file,
+			    GFileMonitorEvent event_type,
+			    GsFileWatcherItem *item)
+{
+	guint i;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&item->watcher->mutex);
+
+	for (i = 0; i < item->clients->len; i++) {
+		GsFileWatcherClient *client = g_ptr_array_index (item->clients, i);
+		gs_file_watcher_client_queue (client);
+	}
+}
+
+/**
+ * gs_file_watcher_add:
+ * @watcher: a #GsFileWatcher
+ * @plugin: the #GsPlugin that wants to know about changes
+ * @file: a #GFile, either a file or a directory
+ * @func: a #GsPluginWatchFunc
+ * @user_data: user data to pass to @func
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Starts watching @file, reusing the existing monitor if anything else is
+ * already watching it.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+gs_file_watcher_add (GsFileWatcher *watcher,
+		     GsPlugin *plugin,
+		     GFile *file,
+		     GsPluginWatchFunc func,
+		     gpointer user_data,
+		     GCancellable *cancellable,
+		     GError **error)
+{
+	GsFileWatcherClient *client;
+	GsFileWatcherItem *item;
+	guint i;
+	g_autofree gchar *uri = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail (GS_IS_FILE_WATCHER (watcher), FALSE);
+	g_return_val_if_fail (GS_IS_PLUGIN (plugin), FALSE);
+	g_return_val_if_fail (G_IS_FILE (file), FALSE);
+	g_return_val_if_fail (func != NULL, FALSE);
+
+	uri = g_file_get_uri (file);
+	locker = g_mutex_locker_new (&watcher->mutex);
+	item = g_hash_table_lookup (watcher->items, uri);
+	if (item == NULL) {
+		g_autoptr(GFileMonitor) monitor = NULL;
+		monitor = g_file_monitor (file, G_FILE_MONITOR_NONE,
+					  cancellable, error);
+		if (monitor == NULL) {
+			gs_utils_error_convert_gio (error);
+			return FALSE;
+		}
+		item = g_slice_new0 (GsFileWatcherItem);
+		item->watcher = watcher;
+		item->monitor = g_steal_pointer (&monitor);
+		item->clients = g_ptr_array_new ();
+		g_signal_connect (item->monitor, "changed",
+				  G_CALLBACK (gs_file_watcher_changed_cb), item);
+		g_hash_table_insert (watcher->items, g_strdup (uri), item);
+	} else {
+		g_debug ("%s is sharing the watch on %s",
+			 gs_plugin_get_name (plugin), uri);
+	}
+
+	/* the same callback only needs to be told once */
+	client = gs_file_watcher_client_ensure (watcher, plugin, func, user_data);
+	for (i = 0; i < item->clients->len; i++) {
+		if (g_ptr_array_index (item->clients, i) == client)
+			return TRUE;
+	}
+	g_ptr_array_add (item->clients, client);
+	return TRUE;
+}
+
+/**
+ * gs_file_watcher_queue:
+ * @watcher: a #GsFileWatcher
+ * @plugin: a #GsPlugin
+ * @func: a #GsPluginWatchFunc
+ * @user_data: user data to pass to @func
+ *
+ * Schedules @func to be called as if a watched file had changed. This is
+ * useful when something other than a #GFileMonitor tells the plugin about
+ * changes, so that a burst of them is coalesced in the same way.
+ **/
+void
+gs_file_watcher_queue (GsFileWatcher *watcher,
+		       GsPlugin *plugin,
+		       GsPluginWatchFunc func,
+		       gpointer user_data)
+{
+	GsFileWatcherClient *client;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_FILE_WATCHER (watcher));
+	g_return_if_fail (GS_IS_PLUGIN (plugin));
+	g_return_if_fail (func != NULL);
+
+	locker = g_mutex_locker_new (&watcher->mutex);
+	client = gs_file_watcher_client_ensure (watcher, plugin, func, user_data);
+	gs_file_watcher_client_queue (client);
+}
+
+/**
+ * gs_file_watcher_remove_plugin:
+ * @watcher: a #GsFileWatcher
+ * @plugin: a #GsPlugin
+ *
+ * Stops all the watches for @plugin, and cancels any pending callbacks.
+ * Monitors that are no longer used by any plugin are destroyed.
+ *
+ * This must be called from the main thread.
+ **/
+void
+gs_file_watcher_remove_plugin (GsFileWatcher *watcher, GsPlugin *plugin)
+{
+	GHashTableIter iter;
+	GsFileWatcherItem *item;
+	guint i;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_FILE_WATCHER (watcher));
+
+	locker = g_mutex_locker_new (&watcher->mutex);
+	g_hash_table_iter_init (&iter, watcher->items);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &item)) {
+		for (i = 0; i < item->clients->len; ) {
+			GsFileWatcherClient *client = g_ptr_array_index (item->clients, i);
+			if (client->plugin == plugin) {
+				g_ptr_array_remove_index (item->clients, i);
+				continue;
+			}
+			i++;
+		}
+		if (item->clients->len == 0)
+			g_hash_table_iter_remove (&iter);
+	}
+	for (i = 0; i < watcher->clients->len; ) {
+		GsFileWatcherClient *client = g_ptr_array_index (watcher->clients, i);
+		if (client->plugin == plugin) {
+			g_ptr_array_remove_index (watcher->clients, i);
+			continue;
+		}
+		i++;
+	}
+}
+
+/**
+ * gs_file_watcher_get_size:
+ * @watcher: a #GsFileWatcher
+ *
+ * Gets the number of monitors, which is the number of different files that
+ * are being watched.
+ *
+ * Returns: integer
+ **/
+guint
+gs_file_watcher_get_size (GsFileWatcher *watcher)
+{
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail (GS_IS_FILE_WATCHER (watcher), 0);
+
+	locker = g_mutex_locker_new (&watcher->mutex);
+	return g_hash_table_size (watcher->items);
+}
+
+static void
+gs_file_watcher_finalize (GObject *object)
+{
+	GsFileWatcher *watcher = GS_FILE_WATCHER (object);
+
+	g_hash_table_unref (watcher->items);
+	g_ptr_array_unref (watcher->clients);
+	g_mutex_clear (&watcher->mutex);
+
+	G_OBJECT_CLASS (gs_file_watcher_parent_class)->finalize (object);
+}
+
+static void
+gs_file_watcher_class_init (GsFileWatcherClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	object_class->finalize = gs_file_watcher_finalize;
+}
+
+static void
+gs_file_watcher_init (GsFileWatcher *watcher)
+{
+	g_mutex_init (&watcher->mutex);
+	watcher->items = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+						(GDestroyNotify) gs_file_watcher_item_free);
+	watcher->clients = g_ptr_array_new_with_free_func ((GDestroyNotify) gs_file_watcher_client_free);
+}
+
+/**
+ * gs_file_watcher_new:
+ *
+ * Creates a new file watcher.
+ *
+ * Returns: a #GsFileWatcher
+ **/
+GsFileWatcher *
+gs_file_watcher_new (void)
+{
+	GsFileWatcher *watcher;
+	watcher = g_object_new (GS_TYPE_FILE_WATCHER, NULL);
+	return GS_FILE_WATCHER (watcher);
+}
+
+/* vim: set noexpandtab: */
@@ -0,0 +1,55 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2016 Richard Hughes <richard@hughsie.com>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __GS_FILE_WATCHER_H
+#define __GS_FILE_WATCHER_H
+
+#include <gio/gio.h>
+
+#include "gs-plugin.h"
+
+G_BEGIN_DECLS
+
+#define GS_TYPE_FILE_WATCHER (gs_file_watcher_get_type ())
+
+G_DECLARE_FINAL_TYPE (GsFileWatcher, gs_file_watcher, GS, FILE_WATCHER, GObject)
+
+GsFileWatcher		*gs_file_watcher_new		(void);
+gboolean		 gs_file_watcher_add		(GsFileWatcher		*watcher,
+							 GsPlugin		*plugin,
+							 GFile			*file,
+							 GsPluginWatchFunc	 func,
+							 gpointer		 user_data,
+							 GCancellable		*cancellable,
+							 GError			**error);
+void			 gs_file_watcher_queue		(GsFileWatcher		*watcher,
+							 GsPlugin		*plugin,
+							 GsPluginWatchFunc	 func,
+							 gpointer		 user_data);
+void			 gs_file_watcher_remove_plugin	(GsFileWatcher		*watcher,
+							 GsPlugin		*plugin);
+guint			 gs_file_watcher_get_size	(GsFileWatcher		*watcher);
+
+G_END_DECLS
+
+#endif /* __GS_FILE_WATCHER_H */
+
+/* vim: set noexpandtab: */
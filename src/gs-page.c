@@ -37,6 +37,7 @@ typedef struct
 	GsShell			*shell;
 	GtkWidget		*header_start_widget;
 	GtkWidget		*header_end_widget;
+	GsChangeSet		*changes_pending;	/* while unmapped, or NULL */
 } GsPagePrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GsPage, gs_page, GTK_TYPE_BIN)
@@ -610,6 +611,63 @@ gs_page_reload (GsPage *page)
 	klass->reload (page);
 }
 
+static void
+gs_page_apply_changes (GsPage *page, GsChangeSet *changes)
+{
+	GsPageClass *klass = GS_PAGE_GET_CLASS (page);
+
+	/* the page knows how to update itself in place */
+	if (!gs_change_set_has_kind (changes, GS_CHANGE_SET_KIND_CATALOG) &&
+	    klass->changed != NULL &&
+	    klass->changed (page, changes))
+		return;
+
+	/* no idea what is affected, so load everything again */
+	gs_page_reload (page);
+}
+
+/**
+ * gs_page_changed:
+ *
+ * Tells the page about apps that have been installed, removed or changed,
+ * or about the catalog changing. Subclasses can override the changed method
+ * to update in place and return %FALSE to fall back to a full reload.
+ *
+ * Pages that are not shown just remember the changes and act on all of them
+ * at once when they are next mapped.
+ */
+void
+gs_page_changed (GsPage *page, GsChangeSet *changes)
+{
+	GsPagePrivate *priv = gs_page_get_instance_private (page);
+
+	g_return_if_fail (GS_IS_PAGE (page));
+	g_return_if_fail (GS_IS_CHANGE_SET (changes));
+
+	if (!gtk_widget_get_mapped (GTK_WIDGET (page))) {
+		if (priv->changes_pending == NULL)
+			priv->changes_pending = gs_change_set_new ();
+		gs_change_set_merge (priv->changes_pending, changes);
+		return;
+	}
+	gs_page_apply_changes (page, changes);
+}
+
+static void
+gs_page_map (GtkWidget *widget)
+{
+	GsPage *page = GS_PAGE (widget);
+	GsPagePrivate *priv = gs_page_get_instance_private (page);
+
+	GTK_WIDGET_CLASS (gs_page_parent_class)->map (widget);
+
+	/* catch up with whatever changed while hidden */
+	if (priv->changes_pending != NULL) {
+		g_autoptr(GsChangeSet) changes = g_steal_pointer (&priv->changes_pending);
+		gs_page_apply_changes (page, changes);
+	}
+}
+
 void
 gs_page_setup (GsPage *page,
                GsShell *shell,
@@ -633,6 +691,7 @@ gs_page_dispose (GObject *object)
 	g_clear_object (&priv->plugin_loader);
 	g_clear_object (&priv->header_start_widget);
 	g_clear_object (&priv->header_end_widget);
+	g_clear_object (&priv->changes_pending);
 
 	G_OBJECT_CLASS (gs_page_parent_class)->dispose (object);
 }
@@ -646,8 +705,10 @@ static void
 gs_page_class_init (GsPageClass *klass)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
 	object_class->dispose = gs_page_dispose;
+	widget_class->map = gs_page_map;
 }
 
 GsPage *
@@ -45,6 +45,8 @@ struct _GsPageClass
 	void		(*switch_to)		(GsPage		 *page,
 						 gboolean	  scroll_up);
 	void		(*reload)		(GsPage		 *page);
+	gboolean	(*changed)		(GsPage		 *page,
+						 GsChangeSet	 *changes);
 };
 
 GsPage		*gs_page_new				(void);
@@ -75,6 +77,8 @@ void		 gs_page_shortcut_remove		(GsPage		*page,
 void		 gs_page_switch_to			(GsPage		*page,
 							 gboolean	 scroll_up);
 void		 gs_page_reload				(GsPage		*page);
+void		 gs_page_changed			(GsPage		*page,
+							 GsChangeSet	*changes);
 void		 gs_page_setup				(GsPage		*page,
 							 GsShell	*shell,
 							 GsPluginLoader	*plugin_loader,
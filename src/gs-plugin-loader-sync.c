@@ -33,7 +33,10 @@ gs_plugin_loader_get_app_by_id (GsPluginLoader *plugin_loader,
 	GsApp *app;
 	gboolean ret;
 
-	app = gs_app_new (id);
+	/* share the object with the pages still showing the app */
+	app = gs_plugin_loader_app_lookup_by_id (plugin_loader, id);
+	if (app == NULL)
+		app = gs_app_new (id);
 	ret = gs_plugin_loader_app_refine (plugin_loader, app, flags,
 					   cancellable, error);
 	if (!ret)
@@ -138,6 +141,52 @@ gs_plugin_loader_search (GsPluginLoader *plugin_loader,
 	return helper.list;
 }
 
+static void
+gs_plugin_loader_search_narrow_finish_sync (GsPluginLoader *plugin_loader,
+					    GAsyncResult *res,
+					    GsPluginLoaderHelper *helper)
+{
+	helper->list = gs_plugin_loader_search_narrow_finish (plugin_loader,
+							      res,
+							      helper->error);
+	g_main_loop_quit (helper->loop);
+}
+
+GsAppList *
+gs_plugin_loader_search_narrow (GsPluginLoader *plugin_loader,
+				GsAppList *list,
+				const gchar *value,
+				GsPluginRefineFlags flags,
+				GCancellable *cancellable,
+				GError **error)
+{
+	GsPluginLoaderHelper helper;
+
+	/* create temp object */
+	helper.context = g_main_context_new ();
+	helper.loop = g_main_loop_new (helper.context, FALSE);
+	helper.error = error;
+
+	g_main_context_push_thread_default (helper.context);
+
+	/* run async method */
+	gs_plugin_loader_search_narrow_async (plugin_loader,
+					      list,
+					      value,
+					      flags,
+					      cancellable,
+					      (GAsyncReadyCallback) gs_plugin_loader_search_narrow_finish_sync,
+					      &helper);
+	g_main_loop_run (helper.loop);
+
+	g_main_context_pop_thread_default (helper.context);
+
+	g_main_loop_unref (helper.loop);
+	g_main_context_unref (helper.context);
+
+	return helper.list;
+}
+
 static void
 gs_plugin_loader_get_updates_finish_sync (GsPluginLoader *plugin_loader,
 					  GAsyncResult *res,
@@ -478,6 +527,50 @@ gs_plugin_loader_app_refine (GsPluginLoader *plugin_loader,
 	return helper.ret;
 }
 
+static void
+gs_plugin_loader_refine_finish_sync (GsPluginLoader *plugin_loader,
+				     GAsyncResult *res,
+				     GsPluginLoaderHelper *helper)
+{
+	helper->list = gs_plugin_loader_refine_finish (plugin_loader,
+						       res,
+						       helper->error);
+	g_main_loop_quit (helper->loop);
+}
+
+GsAppList *
+gs_plugin_loader_refine (GsPluginLoader *plugin_loader,
+			 GsAppList *list,
+			 GsPluginRefineFlags flags,
+			 GCancellable *cancellable,
+			 GError **error)
+{
+	GsPluginLoaderHelper helper;
+
+	/* create temp object */
+	helper.context = g_main_context_new ();
+	helper.loop = g_main_loop_new (helper.context, FALSE);
+	helper.error = error;
+
+	g_main_context_push_thread_default (helper.context);
+
+	/* run async method */
+	gs_plugin_loader_refine_async (plugin_loader,
+				       list,
+				       flags,
+				       cancellable,
+				       (GAsyncReadyCallback) gs_plugin_loader_refine_finish_sync,
+				       &helper);
+	g_main_loop_run (helper.loop);
+
+	g_main_context_pop_thread_default (helper.context);
+
+	g_main_loop_unref (helper.loop);
+	g_main_context_unref (helper.context);
+
+	return helper.list;
+}
+
 static void
 gs_plugin_loader_app_action_finish_sync (GsPluginLoader *plugin_loader,
 					 GAsyncResult *res,
@@ -656,6 +749,48 @@ gs_plugin_loader_refresh (GsPluginLoader *plugin_loader,
 	return helper.ret;
 }
 
+static void
+gs_plugin_loader_set_locale_finish_sync (GsPluginLoader *plugin_loader,
+					 GAsyncResult *res,
+					 GsPluginLoaderHelper *helper)
+{
+	helper->ret = gs_plugin_loader_set_locale_finish (plugin_loader,
+							  res,
+							  helper->error);
+	g_main_loop_quit (helper->loop);
+}
+
+gboolean
+gs_plugin_loader_set_locale (GsPluginLoader *plugin_loader,
+			     const gchar *locale,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	GsPluginLoaderHelper helper;
+
+	/* create temp object */
+	helper.context = g_main_context_new ();
+	helper.loop = g_main_loop_new (helper.context, FALSE);
+	helper.error = error;
+
+	g_main_context_push_thread_default (helper.context);
+
+	/* run async method */
+	gs_plugin_loader_set_locale_async (plugin_loader,
+					   locale,
+					   cancellable,
+					   (GAsyncReadyCallback) gs_plugin_loader_set_locale_finish_sync,
+					   &helper);
+	g_main_loop_run (helper.loop);
+
+	g_main_context_pop_thread_default (helper.context);
+
+	g_main_loop_unref (helper.loop);
+	g_main_context_unref (helper.context);
+
+	return helper.ret;
+}
+
 static void
 gs_plugin_loader_file_to_app_finish_sync (GObject *source_object,
 					  GAsyncResult *res,
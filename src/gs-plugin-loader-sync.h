@@ -37,6 +37,12 @@ GsAppList	*gs_plugin_loader_search		(GsPluginLoader	*plugin_loader,
 							 GsPluginRefineFlags flags,
 							 GCancellable	*cancellable,
 							 GError		**error);
+GsAppList	*gs_plugin_loader_search_narrow		(GsPluginLoader	*plugin_loader,
+							 GsAppList	*list,
+							 const gchar	*value,
+							 GsPluginRefineFlags flags,
+							 GCancellable	*cancellable,
+							 GError		**error);
 GsAppList	*gs_plugin_loader_get_updates		(GsPluginLoader	*plugin_loader,
 							 GsPluginRefineFlags flags,
 							 GCancellable	*cancellable,
@@ -92,6 +98,15 @@ gboolean	 gs_plugin_loader_refresh		(GsPluginLoader	*plugin_loader,
 							 GsPluginRefreshFlags flags,
 							 GCancellable	*cancellable,
 							 GError		**error);
+gboolean	 gs_plugin_loader_set_locale		(GsPluginLoader	*plugin_loader,
+							 const gchar	*locale,
+							 GCancellable	*cancellable,
+							 GError		**error);
+GsAppList	*gs_plugin_loader_refine		(GsPluginLoader	*plugin_loader,
+							 GsAppList	*list,
+							 GsPluginRefineFlags flags,
+							 GCancellable	*cancellable,
+							 GError		**error);
 GsApp		*gs_plugin_loader_get_app_by_id		(GsPluginLoader	*plugin_loader,
 							 const gchar	*id,
 							 GsPluginRefineFlags flags,
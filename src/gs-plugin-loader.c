@@ -28,6 +28,7 @@
 #include "gs-app-private.h"
 #include "gs-app-list-private.h"
 #include "gs-category-private.h"
+#include "gs-change-set.h"
 #include "gs-plugin-loader.h"
 #include "gs-plugin.h"
 #include "gs-plugin-event.h"
@@ -37,6 +38,10 @@
 
 #define GS_PLUGIN_LOADER_UPDATES_CHANGED_DELAY	3	/* s */
 #define GS_PLUGIN_LOADER_RELOAD_DELAY		5	/* s */
+#define GS_PLUGIN_LOADER_CHANGED_DELAY		1	/* s */
+#define GS_PLUGIN_LOADER_INSTALL_QUEUE_SLACK	16	/* lines */
+#define GS_PLUGIN_LOADER_APP_MAP_PRUNE_MIN	256	/* entries */
+#define GS_PLUGIN_LOADER_SEARCH_CANDIDATES	(GS_PLUGIN_LOADER_SEARCH_MAX_RESULTS * 2)
 
 typedef struct
 {
@@ -46,6 +51,7 @@ typedef struct
 	gchar			*language;
 	GsPluginStatus		 status_last;
 	GsAppList		*global_cache;
+	GsFileWatcher		*file_watcher;
 	AsProfile		*profile;
 	SoupSession		*soup_session;
 	GPtrArray		*auth_array;
@@ -53,12 +59,35 @@ typedef struct
 	GMutex			 pending_apps_mutex;
 	GPtrArray		*pending_apps;
 
+	GMutex			 install_queue_mutex;
+	guint			 install_queue_live;
+	guint			 install_queue_journal_len;
+
 	GSettings		*settings;
 
 	GMutex			 events_by_id_mutex;
 	GHashTable		*events_by_id;		/* unique-id : GsPluginEvent */
 
-	gchar			**compatible_projects;
+	GMutex			 stats_mutex;
+	GHashTable		*stats;			/* plugin:function : GsPluginLoaderStat */
+
+	GMutex			 setup_mutex;
+	GPtrArray		*setup_queue;		/* of GsPluginLoaderQueued, or NULL */
+	GMutex			 setup_lazy_mutex;
+	GPtrArray		*setup_lazy;		/* of GsPlugin not yet set up */
+
+	GMutex			 app_map_mutex;
+	GHashTable		*app_map;		/* unique-id : GsPluginLoaderAppMapItem */
+	GHashTable		*app_map_ids;		/* id : unique-id */
+	guint			 app_map_prune;
+
+	GMutex			 changes_mutex;
+	GsChangeSet		*changes;		/* not yet emitted, or NULL */
+	guint			 changes_id;
+
+
+	const gchar		**compatible_projects;	/* interned */
+	gint			 content_age_limit;	/* atomic, 0 for none */
 	guint			 scale;
 
 	guint			 updates_changed_id;
@@ -73,6 +102,7 @@ enum {
 	SIGNAL_PENDING_APPS_CHANGED,
 	SIGNAL_UPDATES_CHANGED,
 	SIGNAL_RELOAD,
+	SIGNAL_CHANGED,
 	SIGNAL_LAST
 };
 
@@ -93,6 +123,12 @@ typedef gboolean	 (*GsPluginSearchFunc)		(GsPlugin	*plugin,
 							 GsAppList	*list,
 							 GCancellable	*cancellable,
 							 GError		**error);
+typedef gboolean	 (*GsPluginSearchNarrowFunc)	(GsPlugin	*plugin,
+							 gchar		**value,
+							 GsAppList	*previous,
+							 GsAppList	*list,
+							 GCancellable	*cancellable,
+							 GError		**error);
 typedef gboolean	 (*GsPluginCategoryFunc)	(GsPlugin	*plugin,
 							 GsCategory	*category,
 							 GsAppList	*list,
@@ -166,6 +202,14 @@ typedef struct {
 	AsReview			*review;
 	GsAuth				*auth;
 	GsPluginAction			 action;
+	GsAppList			*list_featured;
+	GsAppList			*list_popular;
+	GPtrArray			*catlist_featured;
+	GPtrArray			*category_apps;
+	GsPluginRefineFlags		 flags_featured;
+	GsPluginLoaderResultsFunc	 results_func;
+	gpointer			 results_user_data;
+	GMainContext			*context;
 } GsPluginLoaderAsyncState;
 
 static void
@@ -185,11 +229,45 @@ gs_plugin_loader_free_async_state (GsPluginLoaderAsyncState *state)
 		g_object_unref (state->list);
 	if (state->catlist != NULL)
 		g_ptr_array_unref (state->catlist);
+	if (state->list_featured != NULL)
+		g_object_unref (state->list_featured);
+	if (state->list_popular != NULL)
+		g_object_unref (state->list_popular);
+	if (state->catlist_featured != NULL)
+		g_ptr_array_unref (state->catlist_featured);
+	if (state->category_apps != NULL)
+		g_ptr_array_unref (state->category_apps);
+	if (state->context != NULL)
+		g_main_context_unref (state->context);
 
 	g_free (state->value);
 	g_slice_free (GsPluginLoaderAsyncState, state);
 }
 
+/* log-linear latency histogram, four buckets per power of two microseconds */
+#define GS_PLUGIN_LOADER_STATS_BUCKETS		(4 * 40)
+
+typedef struct {
+	gchar				*plugin_name;
+	const gchar			*function_name;
+	guint				 calls;
+	guint				 errors;
+	guint				 cancelled;
+	guint64				 total_us;
+	guint64				 max_us;
+	guint32				 histogram[GS_PLUGIN_LOADER_STATS_BUCKETS];
+} GsPluginLoaderStat;
+
+static void
+gs_plugin_loader_stat_free (GsPluginLoaderStat *stat)
+{
+	g_free (stat->plugin_name);
+	g_slice_free (GsPluginLoaderStat, stat);
+}
+
+/* plugin vfuncs never nest, so one start time per thread is enough */
+static GPrivate gs_plugin_loader_action_start_time = G_PRIVATE_INIT (g_free);
+
 static gint
 gs_plugin_loader_app_sort_name_cb (GsApp *app1, GsApp *app2, gpointer user_data)
 {
@@ -203,6 +281,66 @@ gs_plugin_loader_app_sort_id_cb (GsApp *app1, GsApp *app2, gpointer user_data)
 	return g_strcmp0 (gs_app_get_id (app1), gs_app_get_id (app2));
 }
 
+/* scores @app on the same fields, with the same tokenizing and stemming, as
+ * libappstream-glib uses for the match value of the AppStream search results */
+static guint
+gs_plugin_loader_app_search_matches (GsApp *app, gchar **values)
+{
+	GPtrArray *array;
+	const gchar *tmp;
+	guint i;
+	g_autoptr(AsApp) item = as_app_new ();
+
+	if (gs_app_get_id (app) != NULL)
+		as_app_set_id (item, gs_app_get_id (app));
+	if (gs_app_get_name (app) != NULL)
+		as_app_set_name (item, NULL, gs_app_get_name (app));
+	if (gs_app_get_summary (app) != NULL)
+		as_app_set_comment (item, NULL, gs_app_get_summary (app));
+	tmp = gs_app_get_description (app);
+	if (tmp != NULL) {
+		g_autofree gchar *markup = g_markup_printf_escaped ("<p>%s</p>", tmp);
+		as_app_set_description (item, NULL, markup);
+	}
+	array = gs_app_get_keywords (app);
+	for (i = 0; array != NULL && i < array->len; i++)
+		as_app_add_keyword (item, NULL, g_ptr_array_index (array, i));
+	array = gs_app_get_sources (app);
+	for (i = 0; i < array->len; i++)
+		as_app_add_pkgname (item, g_ptr_array_index (array, i));
+	return as_app_search_matches_all (item, values);
+}
+
+/* the match value is a bitmask of the fields that matched, where the more
+ * important fields such as the ID and name have the higher bits, so it always
+ * outweighs how popular the application is */
+static guint
+gs_plugin_loader_app_get_search_score (GsApp *app)
+{
+	guint score = gs_app_get_match_value (app) << 8;
+	gint rating = gs_app_get_rating (app);
+
+	if (rating > 0)
+		score += (guint) rating;
+	score += gs_app_get_kudos_percentage (app);
+	if (gs_app_is_installed (app))
+		score += 50;
+	return score;
+}
+
+static gint
+gs_plugin_loader_app_sort_search_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+{
+	guint score1 = gs_plugin_loader_app_get_search_score (app1);
+	guint score2 = gs_plugin_loader_app_get_search_score (app2);
+
+	if (score1 > score2)
+		return -1;
+	if (score1 < score2)
+		return 1;
+	return 0;
+}
+
 static GsPlugin *
 gs_plugin_loader_find_plugin (GsPluginLoader *plugin_loader,
 			      const gchar *plugin_name)
@@ -219,14 +357,169 @@ gs_plugin_loader_find_plugin (GsPluginLoader *plugin_loader,
 	return NULL;
 }
 
+static guint
+gs_plugin_loader_stats_bucket (guint64 value)
+{
+	guint msb;
+	if (value < 4)
+		return (guint) value;
+	msb = g_bit_storage (value) - 1;
+	return MIN ((msb - 1) * 4 + ((value >> (msb - 2)) & 3),
+		    GS_PLUGIN_LOADER_STATS_BUCKETS - 1);
+}
+
+static guint64
+gs_plugin_loader_stats_bucket_value (guint idx)
+{
+	if (idx < 4)
+		return idx;
+	return ((guint64) (4 | (idx & 3))) << (idx / 4 - 1);
+}
+
+static void
+gs_plugin_loader_stats_add (GsPluginLoader *plugin_loader,
+			    GsPlugin *plugin,
+			    const gchar *function_name,
+			    guint64 elapsed_us,
+			    gboolean ret,
+			    const GError *error)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderStat *stat;
+	g_autofree gchar *key = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->stats_mutex);
+
+	key = g_strdup_printf ("%s:%s", gs_plugin_get_name (plugin), function_name);
+	stat = g_hash_table_lookup (priv->stats, key);
+	if (stat == NULL) {
+		stat = g_slice_new0 (GsPluginLoaderStat);
+		stat->plugin_name = g_strdup (gs_plugin_get_name (plugin));
+		stat->function_name = g_intern_string (function_name);
+		g_hash_table_insert (priv->stats, g_steal_pointer (&key), stat);
+	}
+	stat->calls++;
+	stat->total_us += elapsed_us;
+	stat->max_us = MAX (stat->max_us, elapsed_us);
+	stat->histogram[gs_plugin_loader_stats_bucket (elapsed_us)]++;
+	if (ret)
+		return;
+	if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED) ||
+	    g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		stat->cancelled++;
+	else
+		stat->errors++;
+}
+
+static gint
+gs_plugin_loader_stats_sort_cb (gconstpointer a, gconstpointer b)
+{
+	GsPluginLoaderStat *stat1 = *((GsPluginLoaderStat **) a);
+	GsPluginLoaderStat *stat2 = *((GsPluginLoaderStat **) b);
+	gint rc = g_strcmp0 (stat1->plugin_name, stat2->plugin_name);
+	if (rc != 0)
+		return rc;
+	return g_strcmp0 (stat1->function_name, stat2->function_name);
+}
+
+/**
+ * gs_plugin_loader_get_stats:
+ * @plugin_loader: a #GsPluginLoader
+ *
+ * Gets the statistics for every plugin function that has been called.
+ * Each entry has the plugin name, the function name, the number of calls,
+ * failed calls and cancelled calls, the total and maximum latency in
+ * microseconds and a latency histogram.
+ *
+ * The histogram is an array of (lower bound in microseconds, count)
+ * pairs with the empty buckets omitted.
+ *
+ * Returns: (transfer full): a #GVariant of type a(ssuuutta(tu))
+ **/
+GVariant *
+gs_plugin_loader_get_stats (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GList *l;
+	GVariantBuilder builder;
+	guint i;
+	g_autoptr(GList) values = NULL;
+	g_autoptr(GPtrArray) stats = g_ptr_array_new ();
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->stats_mutex);
+
+	/* sort so the output is stable */
+	values = g_hash_table_get_values (priv->stats);
+	for (l = values; l != NULL; l = l->next)
+		g_ptr_array_add (stats, l->data);
+	g_ptr_array_sort (stats, gs_plugin_loader_stats_sort_cb);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ssuuutta(tu))"));
+	for (i = 0; i < stats->len; i++) {
+		GsPluginLoaderStat *stat = g_ptr_array_index (stats, i);
+		GVariantBuilder histogram;
+		guint j;
+
+		g_variant_builder_init (&histogram, G_VARIANT_TYPE ("a(tu)"));
+		for (j = 0; j < GS_PLUGIN_LOADER_STATS_BUCKETS; j++) {
+			if (stat->histogram[j] == 0)
+				continue;
+			g_variant_builder_add (&histogram, "(tu)",
+					       gs_plugin_loader_stats_bucket_value (j),
+					       stat->histogram[j]);
+		}
+		g_variant_builder_add (&builder, "(ssuuutta(tu))",
+				       stat->plugin_name,
+				       stat->function_name,
+				       stat->calls,
+				       stat->errors,
+				       stat->cancelled,
+				       stat->total_us,
+				       stat->max_us,
+				       &histogram);
+	}
+	return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
+typedef struct {
+	GTask			*task;
+	GTaskThreadFunc		 func;
+} GsPluginLoaderQueued;
+
+/* actions started while the plugins are being set up wait until it is done */
+static void
+gs_plugin_loader_run_in_thread (GsPluginLoader *plugin_loader,
+				GTask *task,
+				GTaskThreadFunc func)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->setup_mutex);
+
+	if (priv->setup_queue != NULL) {
+		GsPluginLoaderQueued *queued = g_new0 (GsPluginLoaderQueued, 1);
+		queued->task = g_object_ref (task);
+		queued->func = func;
+		g_ptr_array_add (priv->setup_queue, queued);
+		return;
+	}
+	g_task_run_in_thread (task, func);
+}
+
 static void
 gs_plugin_loader_action_start (GsPluginLoader *plugin_loader,
 			       GsPlugin *plugin,
 			       gboolean exclusive)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	gint64 *start_time;
 	guint i;
 
+	/* record when the vfunc started */
+	start_time = g_private_get (&gs_plugin_loader_action_start_time);
+	if (start_time == NULL) {
+		start_time = g_new0 (gint64, 1);
+		g_private_set (&gs_plugin_loader_action_start_time, start_time);
+	}
+	*start_time = g_get_monotonic_time ();
+
 	/* set plugin as SELF and all plugins as OTHER */
 	gs_plugin_action_start (plugin, exclusive);
 	for (i = 0; i < priv->plugins->len; i++) {
@@ -239,11 +532,24 @@ gs_plugin_loader_action_start (GsPluginLoader *plugin_loader,
 }
 
 static void
-gs_plugin_loader_action_stop (GsPluginLoader *plugin_loader, GsPlugin *plugin)
+gs_plugin_loader_action_stop (GsPluginLoader *plugin_loader,
+			      GsPlugin *plugin,
+			      const gchar *function_name,
+			      gboolean ret,
+			      const GError *error)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	gint64 *start_time;
 	guint i;
 
+	/* add to the per-plugin statistics */
+	start_time = g_private_get (&gs_plugin_loader_action_start_time);
+	if (start_time != NULL) {
+		gs_plugin_loader_stats_add (plugin_loader, plugin, function_name,
+					    (guint64) (g_get_monotonic_time () - *start_time),
+					    ret, error);
+	}
+
 	/* clear plugin as SELF and all plugins as OTHER */
 	gs_plugin_action_stop (plugin);
 	for (i = 0; i < priv->plugins->len; i++) {
@@ -351,7 +657,9 @@ gs_plugin_loader_run_adopt (GsPluginLoader *plugin_loader, GsAppList *list)
 				continue;
 			gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 			adopt_app_func (plugin, app);
-			gs_plugin_loader_action_stop (plugin_loader, plugin);
+			gs_plugin_loader_action_stop (plugin_loader, plugin,
+						      "gs_plugin_adopt_app",
+						      TRUE, NULL);
 			if (gs_app_get_management_plugin (app) != NULL) {
 				g_debug ("%s adopted %s",
 					 gs_plugin_get_name (plugin),
@@ -381,6 +689,73 @@ gs_plugin_loader_review_score_sort_cb (gconstpointer a, gconstpointer b)
 	return 0;
 }
 
+static void
+gs_plugin_loader_setup_plugin (GsPluginLoader *plugin_loader,
+			       GsPlugin *plugin,
+			       GCancellable *cancellable)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginSetupFunc plugin_func = NULL;
+	const gchar *function_name = "gs_plugin_setup";
+	gboolean ret;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* run setup() if it exists */
+	ret = g_module_symbol (gs_plugin_get_module (plugin),
+			       function_name,
+			       (gpointer *) &plugin_func);
+	if (!ret)
+		return;
+	ptask = as_profile_start (priv->profile,
+				  "GsPlugin::%s(%s)",
+				  gs_plugin_get_name (plugin),
+				  function_name);
+	g_assert (ptask != NULL);
+	gs_plugin_loader_action_start (plugin_loader, plugin, TRUE);
+	ret = plugin_func (plugin, cancellable, &error_local);
+	gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+				      ret, error_local);
+	if (!ret) {
+		/* badly behaved plugin */
+		if (error_local == NULL) {
+			g_critical ("%s did not set error for %s",
+				    gs_plugin_get_name (plugin),
+				    function_name);
+		} else {
+			g_debug ("disabling %s as setup failed: %s",
+				 gs_plugin_get_name (plugin),
+				 error_local->message);
+			gs_plugin_loader_create_event_from_error (plugin_loader,
+								  GS_PLUGIN_ACTION_SETUP,
+								  plugin,
+								  NULL, /* app */
+								  error_local);
+		}
+		gs_plugin_set_enabled (plugin, FALSE);
+	}
+}
+
+/* plugins with GS_PLUGIN_FLAGS_SETUP_ON_DEMAND are set up on first use */
+static gboolean
+gs_plugin_loader_setup_lazy (GsPluginLoader *plugin_loader, GsPlugin *plugin)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (!gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_SETUP_ON_DEMAND))
+		return TRUE;
+	locker = g_mutex_locker_new (&priv->setup_lazy_mutex);
+	if (g_ptr_array_remove (priv->setup_lazy, plugin)) {
+		g_debug ("setting up %s on first use",
+			 gs_plugin_get_name (plugin));
+
+		/* not the cancellable of the action that happened to be first */
+		gs_plugin_loader_setup_plugin (plugin_loader, plugin, NULL);
+	}
+	return gs_plugin_get_enabled (plugin);
+}
+
 static void
 gs_plugin_loader_run_refine_wildcard (GsPluginLoader *plugin_loader,
 				      GsPlugin *plugin,
@@ -401,10 +776,13 @@ gs_plugin_loader_run_refine_wildcard (GsPluginLoader *plugin_loader,
 	if (plugin_func == NULL)
 		return;
 
+	if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+		return;
 	gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 	ret = plugin_func (plugin, app, list, flags,
 			   cancellable, &error_local);
-	gs_plugin_loader_action_stop (plugin_loader, plugin);
+	gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+				      ret, error_local);
 	if (!ret) {
 		/* badly behaved plugin */
 		if (error_local == NULL) {
@@ -444,10 +822,13 @@ gs_plugin_loader_run_refine_app (GsPluginLoader *plugin_loader,
 	if (plugin_func == NULL)
 		return;
 
+	if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+		return;
 	gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 	ret = plugin_func (plugin, app, flags,
 				     cancellable, &error_local);
-	gs_plugin_loader_action_stop (plugin_loader, plugin);
+	gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+				      ret, error_local);
 	if (!ret) {
 		/* badly behaved plugin */
 		if (error_local == NULL) {
@@ -530,10 +911,13 @@ gs_plugin_loader_run_refine_internal (GsPluginLoader *plugin_loader,
 			g_autoptr(GError) error_local = NULL;
 			gboolean ret_local;
 
+			if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+				continue;
 			gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 			ret_local = plugin_func (plugin, list, flags,
 			                         cancellable, &error_local);
-			gs_plugin_loader_action_stop (plugin_loader, plugin);
+			gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+						      ret_local, error_local);
 			if (!ret_local) {
 				/* badly behaved plugin */
 				if (error_local == NULL) {
@@ -672,6 +1056,310 @@ gs_plugin_loader_run_refine_internal (GsPluginLoader *plugin_loader,
 	return TRUE;
 }
 
+/* a weak entry in the identity map, so only the pages keep apps alive */
+typedef struct {
+	GWeakRef		 app;
+	GsPluginRefineFlags	 refine_flags;
+	gboolean		 refined;
+} GsPluginLoaderAppMapItem;
+
+static void
+gs_plugin_loader_app_map_item_free (GsPluginLoaderAppMapItem *item)
+{
+	g_weak_ref_clear (&item->app);
+	g_slice_free (GsPluginLoaderAppMapItem, item);
+}
+
+static const gchar *
+gs_plugin_loader_app_map_get_key (GsApp *app)
+{
+	const gchar *unique_id;
+
+	/* wildcards get resolved into other apps */
+	if (gs_app_has_quirk (app, AS_APP_QUIRK_MATCH_ANY_PREFIX))
+		return NULL;
+
+	/* a partial unique ID could be any of several components */
+	unique_id = gs_app_get_unique_id (app);
+	if (unique_id == NULL || strchr (unique_id, '*') != NULL)
+		return NULL;
+	return unique_id;
+}
+
+static gboolean
+gs_plugin_loader_app_map_item_is_dead (gpointer key,
+				       gpointer value,
+				       gpointer user_data)
+{
+	GsPluginLoaderAppMapItem *item = (GsPluginLoaderAppMapItem *) value;
+	g_autoptr(GsApp) app = g_weak_ref_get (&item->app);
+	return app == NULL;
+}
+
+static gboolean
+gs_plugin_loader_app_map_id_is_dead (gpointer key,
+				     gpointer value,
+				     gpointer user_data)
+{
+	GHashTable *app_map = (GHashTable *) user_data;
+	return !g_hash_table_contains (app_map, value);
+}
+
+/* must be called with app_map_mutex held */
+static GsPluginLoaderAppMapItem *
+gs_plugin_loader_app_map_insert_locked (GsPluginLoader *plugin_loader,
+					const gchar *key,
+					GsApp *app)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderAppMapItem *item;
+
+	/* drop the entries of finalized apps every so often */
+	if (g_hash_table_size (priv->app_map) >= priv->app_map_prune) {
+		g_hash_table_foreach_remove (priv->app_map,
+					     gs_plugin_loader_app_map_item_is_dead,
+					     NULL);
+		g_hash_table_foreach_remove (priv->app_map_ids,
+					     gs_plugin_loader_app_map_id_is_dead,
+					     priv->app_map);
+		priv->app_map_prune = MAX (GS_PLUGIN_LOADER_APP_MAP_PRUNE_MIN,
+					   g_hash_table_size (priv->app_map) * 2);
+	}
+
+	item = g_slice_new0 (GsPluginLoaderAppMapItem);
+	g_weak_ref_init (&item->app, app);
+	g_hash_table_insert (priv->app_map, g_strdup (key), item);
+	if (gs_app_get_id (app) != NULL) {
+		g_hash_table_insert (priv->app_map_ids,
+				     g_strdup (gs_app_get_id (app)),
+				     g_strdup (key));
+	}
+	return item;
+}
+
+/* must be called with app_map_mutex held; returns the live app for
+ * the component, which is @app itself if it was not already known */
+static GsApp *
+gs_plugin_loader_app_map_add_locked (GsPluginLoader *plugin_loader, GsApp *app)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderAppMapItem *item;
+	const gchar *key;
+	g_autoptr(GsApp) app_live = NULL;
+
+	key = gs_plugin_loader_app_map_get_key (app);
+	if (key == NULL)
+		return g_object_ref (app);
+	item = g_hash_table_lookup (priv->app_map, key);
+	if (item == NULL) {
+		gs_plugin_loader_app_map_insert_locked (plugin_loader, key, app);
+		return g_object_ref (app);
+	}
+	app_live = g_weak_ref_get (&item->app);
+	if (app_live == app)
+		return g_steal_pointer (&app_live);
+
+	/* only share objects that agree, so that e.g. an updatable app from
+	 * the updates list does not get swapped for the installed one */
+	if (app_live != NULL &&
+	    gs_app_get_state (app_live) == gs_app_get_state (app))
+		return g_steal_pointer (&app_live);
+
+	/* the newest object wins */
+	g_weak_ref_set (&item->app, app);
+	item->refine_flags = GS_PLUGIN_REFINE_FLAGS_DEFAULT;
+	item->refined = FALSE;
+	return g_object_ref (app);
+}
+
+/* swaps each app in @list for the live object of the same component, so
+ * that there is one GsApp shared by all the plugins and pages */
+static void
+gs_plugin_loader_app_map_add_list (GsPluginLoader *plugin_loader, GsAppList *list)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	gboolean changed = FALSE;
+	guint i;
+	g_autoptr(GPtrArray) apps = NULL;
+
+	apps = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	g_mutex_lock (&priv->app_map_mutex);
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GsApp *app_live = gs_plugin_loader_app_map_add_locked (plugin_loader, app);
+		if (app_live != app)
+			changed = TRUE;
+		g_ptr_array_add (apps, app_live);
+	}
+	g_mutex_unlock (&priv->app_map_mutex);
+	if (!changed)
+		return;
+	gs_app_list_remove_all (list);
+	for (i = 0; i < apps->len; i++)
+		gs_app_list_add (list, g_ptr_array_index (apps, i));
+}
+
+/* returns %TRUE if this exact object has already been refined with @flags */
+static gboolean
+gs_plugin_loader_app_map_is_refined (GsPluginLoader *plugin_loader,
+				     GsApp *app,
+				     GsPluginRefineFlags flags)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderAppMapItem *item;
+	const gchar *key;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->app_map_mutex);
+	g_autoptr(GsApp) app_live = NULL;
+
+	key = gs_plugin_loader_app_map_get_key (app);
+	if (key == NULL)
+		return FALSE;
+	item = g_hash_table_lookup (priv->app_map, key);
+	if (item == NULL || !item->refined)
+		return FALSE;
+	if ((item->refine_flags & flags) != flags)
+		return FALSE;
+	app_live = g_weak_ref_get (&item->app);
+	return app_live == app;
+}
+
+static void
+gs_plugin_loader_app_map_set_refined (GsPluginLoader *plugin_loader,
+				      GsAppList *list,
+				      GsPluginRefineFlags flags)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	guint i;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->app_map_mutex);
+
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GsPluginLoaderAppMapItem *item;
+		const gchar *key;
+		g_autoptr(GsApp) app_live = NULL;
+
+		/* the unique ID may well have changed when refining */
+		key = gs_plugin_loader_app_map_get_key (app);
+		if (key == NULL)
+			continue;
+		item = g_hash_table_lookup (priv->app_map, key);
+		if (item == NULL) {
+			item = gs_plugin_loader_app_map_insert_locked (plugin_loader,
+								       key, app);
+		} else {
+			app_live = g_weak_ref_get (&item->app);
+			if (app_live == NULL) {
+				g_weak_ref_set (&item->app, app);
+				item->refine_flags = GS_PLUGIN_REFINE_FLAGS_DEFAULT;
+			} else if (app_live != app) {
+				continue;
+			}
+		}
+		item->refine_flags |= flags;
+		item->refined = TRUE;
+	}
+}
+
+/* the app is about to change, so it has to be refined again */
+static void
+gs_plugin_loader_app_map_forget (GsPluginLoader *plugin_loader, GsApp *app)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderAppMapItem *item;
+	const gchar *key;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->app_map_mutex);
+
+	key = gs_plugin_loader_app_map_get_key (app);
+	if (key == NULL)
+		return;
+	item = g_hash_table_lookup (priv->app_map, key);
+	if (item == NULL)
+		return;
+	item->refine_flags = GS_PLUGIN_REFINE_FLAGS_DEFAULT;
+	item->refined = FALSE;
+}
+
+static void
+gs_plugin_loader_app_map_forget_list (GsPluginLoader *plugin_loader, GsAppList *list)
+{
+	guint i;
+	for (i = 0; i < gs_app_list_length (list); i++)
+		gs_plugin_loader_app_map_forget (plugin_loader, gs_app_list_index (list, i));
+}
+
+/* keep the identities, but refine everything again */
+static void
+gs_plugin_loader_app_map_invalidate (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GHashTableIter iter;
+	gpointer value;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->app_map_mutex);
+
+	g_hash_table_iter_init (&iter, priv->app_map);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		GsPluginLoaderAppMapItem *item = (GsPluginLoaderAppMapItem *) value;
+		item->refine_flags = GS_PLUGIN_REFINE_FLAGS_DEFAULT;
+		item->refined = FALSE;
+	}
+}
+
+/**
+ * gs_plugin_loader_app_lookup:
+ * @plugin_loader: a #GsPluginLoader
+ * @unique_id: a unique ID, e.g. "system/flatpak/gnome/desktop/org.gnome.Maps.desktop/master"
+ *
+ * Looks up the live application object for a component, if any plugin or
+ * page is still using it.
+ *
+ * Returns: (transfer full): a #GsApp, or %NULL
+ **/
+GsApp *
+gs_plugin_loader_app_lookup (GsPluginLoader *plugin_loader, const gchar *unique_id)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderAppMapItem *item;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->app_map_mutex);
+
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), NULL);
+	g_return_val_if_fail (unique_id != NULL, NULL);
+
+	item = g_hash_table_lookup (priv->app_map, unique_id);
+	if (item == NULL)
+		return NULL;
+	return g_weak_ref_get (&item->app);
+}
+
+/**
+ * gs_plugin_loader_app_lookup_by_id:
+ * @plugin_loader: a #GsPluginLoader
+ * @id: an application ID, e.g. "org.gnome.Maps.desktop"
+ *
+ * Looks up the live application object most recently added for an
+ * application ID, if any plugin or page is still using it.
+ *
+ * Returns: (transfer full): a #GsApp, or %NULL
+ **/
+GsApp *
+gs_plugin_loader_app_lookup_by_id (GsPluginLoader *plugin_loader, const gchar *id)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderAppMapItem *item;
+	const gchar *unique_id;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->app_map_mutex);
+
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), NULL);
+	g_return_val_if_fail (id != NULL, NULL);
+
+	unique_id = g_hash_table_lookup (priv->app_map_ids, id);
+	if (unique_id == NULL)
+		return NULL;
+	item = g_hash_table_lookup (priv->app_map, unique_id);
+	if (item == NULL)
+		return NULL;
+	return g_weak_ref_get (&item->app);
+}
+
 static gboolean
 gs_plugin_loader_run_refine (GsPluginLoader *plugin_loader,
 			     const gchar *function_name_parent,
@@ -683,12 +1371,29 @@ gs_plugin_loader_run_refine (GsPluginLoader *plugin_loader,
 	gboolean has_match_any_prefix = FALSE;
 	gboolean ret;
 	guint i;
+	GsAppList *list_orig = NULL;
 	g_autoptr(GsAppList) freeze_list = NULL;
+	g_autoptr(GsAppList) list_todo = NULL;
 
 	/* nothing to do */
 	if (gs_app_list_length (list) == 0)
 		return TRUE;
 
+	/* skip the apps that have already been refined with these flags,
+	 * e.g. when the user goes back to a page they have already seen */
+	list_todo = gs_app_list_new ();
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		if (!gs_plugin_loader_app_map_is_refined (plugin_loader, app, flags))
+			gs_app_list_add (list_todo, app);
+	}
+	if (gs_app_list_length (list_todo) == 0)
+		return TRUE;
+	if (gs_app_list_length (list_todo) < gs_app_list_length (list)) {
+		list_orig = list;
+		list = list_todo;
+	}
+
 	/* freeze all apps */
 	freeze_list = gs_app_list_copy (list);
 	for (i = 0; i < gs_app_list_length (freeze_list); i++) {
@@ -726,27 +1431,44 @@ gs_plugin_loader_run_refine (GsPluginLoader *plugin_loader,
 			goto out;
 	}
 
+	/* remember these so they do not get refined again */
+	gs_plugin_loader_app_map_set_refined (plugin_loader, list, flags);
+
 out:
 	/* now emit all the changed signals */
 	for (i = 0; i < gs_app_list_length (freeze_list); i++) {
 		GsApp *app = gs_app_list_index (freeze_list, i);
 		g_object_thaw_notify (G_OBJECT (app));
 	}
+
+	/* the apps were refined in place, so only add the apps that the
+	 * refine added, keeping the order of all the others */
+	if (list_orig != NULL) {
+		g_autoptr(GHashTable) apps_orig = NULL;
+		apps_orig = g_hash_table_new (g_direct_hash, g_direct_equal);
+		for (i = 0; i < gs_app_list_length (list_orig); i++)
+			g_hash_table_add (apps_orig, gs_app_list_index (list_orig, i));
+		for (i = 0; i < gs_app_list_length (list_todo); i++) {
+			GsApp *app = gs_app_list_index (list_todo, i);
+			if (!g_hash_table_contains (apps_orig, app))
+				gs_app_list_add (list_orig, app);
+		}
+	}
 	return ret;
 }
 
 static void gs_plugin_loader_add_os_update_item (GsAppList *list);
 
-static GsAppList *
-gs_plugin_loader_run_results (GsPluginLoader *plugin_loader,
-			      GsPluginAction action,
-			      const gchar *function_name,
-			      GsPluginRefineFlags flags,
-			      GCancellable *cancellable,
-			      GError **error)
+/* runs @function_name on each plugin without refining the results */
+static gboolean
+gs_plugin_loader_run_results_internal (GsPluginLoader *plugin_loader,
+				       GsPluginAction action,
+				       const gchar *function_name,
+				       GsAppList *list,
+				       GCancellable *cancellable,
+				       GError **error)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
-	g_autoptr(GsAppList) list = NULL;
 	GsPluginResultsFunc plugin_func = NULL;
 	GsPlugin *plugin;
 	gboolean exists;
@@ -754,17 +1476,11 @@ gs_plugin_loader_run_results (GsPluginLoader *plugin_loader,
 	guint i;
 	g_autoptr(AsProfileTask) ptask = NULL;
 
-	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), NULL);
-	g_return_val_if_fail (function_name != NULL, NULL);
-	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
-	g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
-
 	/* profile */
 	ptask = as_profile_start (priv->profile, "GsPlugin::*(%s)", function_name);
 	g_assert (ptask != NULL);
 
 	/* run each plugin */
-	list = gs_app_list_new ();
 	for (i = 0; i < priv->plugins->len; i++) {
 		g_autoptr(GError) error_local = NULL;
 		g_autoptr(AsProfileTask) ptask2 = NULL;
@@ -774,7 +1490,7 @@ gs_plugin_loader_run_results (GsPluginLoader *plugin_loader,
 			continue;
 		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
 			gs_utils_error_convert_gio (error);
-			return NULL;
+			return FALSE;
 		}
 
 		/* get symbol */
@@ -790,9 +1506,12 @@ gs_plugin_loader_run_results (GsPluginLoader *plugin_loader,
 					   gs_plugin_get_name (plugin),
 					   function_name);
 		g_assert (ptask2 != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, list, cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -815,6 +1534,37 @@ gs_plugin_loader_run_results (GsPluginLoader *plugin_loader,
 		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
 
+	/* share one object for each component */
+	gs_plugin_loader_app_map_add_list (plugin_loader, list);
+	return TRUE;
+}
+
+static GsAppList *
+gs_plugin_loader_run_results (GsPluginLoader *plugin_loader,
+			      GsPluginAction action,
+			      const gchar *function_name,
+			      GsPluginRefineFlags flags,
+			      GCancellable *cancellable,
+			      GError **error)
+{
+	gboolean ret;
+	g_autoptr(GsAppList) list = NULL;
+
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), NULL);
+	g_return_val_if_fail (function_name != NULL, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+	g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+
+	/* run each plugin */
+	list = gs_app_list_new ();
+	if (!gs_plugin_loader_run_results_internal (plugin_loader,
+						    action,
+						    function_name,
+						    list,
+						    cancellable,
+						    error))
+		return NULL;
+
 	/* run refine() on each one */
 	ret = gs_plugin_loader_run_refine (plugin_loader,
 					   function_name,
@@ -1042,6 +1792,25 @@ gs_plugin_loader_app_is_non_installed (GsApp *app, gpointer user_data)
 	return TRUE;
 }
 
+static gboolean
+gs_plugin_loader_app_is_age_appropriate (GsApp *app, gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (user_data);
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	guint limit = (guint) g_atomic_int_get (&priv->content_age_limit);
+	guint age;
+
+	/* the age is worked out once when the content rating is set */
+	if (limit == 0)
+		return TRUE;
+	age = gs_app_get_content_age (app);
+	if (age == G_MAXUINT || age <= limit)
+		return TRUE;
+	g_debug ("removing %s as content rated for age %u",
+		 gs_app_get_id (app), age);
+	return FALSE;
+}
+
 static gboolean
 gs_plugin_loader_get_app_is_compatible (GsApp *app, gpointer user_data)
 {
@@ -1055,7 +1824,7 @@ gs_plugin_loader_get_app_is_compatible (GsApp *app, gpointer user_data)
 	if (tmp == NULL)
 		return TRUE;
 	for (i = 0; priv->compatible_projects[i] != NULL; i++) {
-		if (g_strcmp0 (tmp,  priv->compatible_projects[i]) == 0)
+		if (tmp == priv->compatible_projects[i])
 			return TRUE;
 	}
 	g_debug ("removing incompatible %s from project group %s",
@@ -1063,6 +1832,18 @@ gs_plugin_loader_get_app_is_compatible (GsApp *app, gpointer user_data)
 	return FALSE;
 }
 
+/* copy the plugin priorities and remove duplicates in one pass */
+static void
+gs_plugin_loader_filter_duplicates (GsPluginLoader *plugin_loader,
+				    GsAppList *list,
+				    GsAppListFilterFlags flags)
+{
+	g_autoptr(GsAppListQuery) query = gs_app_list_query_new ();
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, flags);
+	gs_app_list_query_run (query, list);
+}
+
 /**
  * gs_plugin_loader_get_event_by_id:
  * @list: A #GsAppList
@@ -1107,6 +1888,9 @@ gs_plugin_loader_run_action (GsPluginLoader *plugin_loader,
 	gboolean ret;
 	guint i;
 
+	/* the app is about to change */
+	gs_plugin_loader_app_map_forget (plugin_loader, app);
+
 	/* run each plugin */
 	for (i = 0; i < priv->plugins->len; i++) {
 		g_autoptr(AsProfileTask) ptask = NULL;
@@ -1129,9 +1913,12 @@ gs_plugin_loader_run_action (GsPluginLoader *plugin_loader,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, app, cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -1250,6 +2037,7 @@ gs_plugin_loader_get_updates_thread_cb (GTask *task,
 	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
 	GError *error = NULL;
+	g_autoptr(GsAppListQuery) query = NULL;
 
 	/* do things that would block */
 	if ((state->flags & GS_PLUGIN_REFINE_FLAGS_USE_HISTORY) > 0)
@@ -1268,14 +2056,16 @@ gs_plugin_loader_get_updates_thread_cb (GTask *task,
 
 	/* remove any packages that are not proper applications or
 	 * OS updates */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
+	query = gs_app_list_query_new ();
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
 
 	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_NONE);
 
 	/* predictable return order */
-	gs_app_list_sort (state->list, gs_plugin_loader_app_sort_id_cb, NULL);
+	gs_app_list_query_set_sort (query, gs_plugin_loader_app_sort_id_cb, NULL);
+	gs_app_list_query_run (query, state->list);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -1324,7 +2114,7 @@ gs_plugin_loader_get_updates_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_updates_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_updates_thread_cb);
 }
 
 /**
@@ -1370,8 +2160,8 @@ gs_plugin_loader_get_distro_upgrades_thread_cb (GTask *task,
 	}
 
 	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_plugin_loader_filter_duplicates (plugin_loader, state->list,
+					    GS_APP_LIST_FILTER_FLAG_NONE);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -1404,7 +2194,7 @@ gs_plugin_loader_get_distro_upgrades_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_distro_upgrades_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_distro_upgrades_thread_cb);
 }
 
 /**
@@ -1450,8 +2240,8 @@ gs_plugin_loader_get_unvoted_reviews_thread_cb (GTask *task,
 	}
 
 	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_plugin_loader_filter_duplicates (plugin_loader, state->list,
+					    GS_APP_LIST_FILTER_FLAG_NONE);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -1484,7 +2274,7 @@ gs_plugin_loader_get_unvoted_reviews_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_unvoted_reviews_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_unvoted_reviews_thread_cb);
 }
 
 /**
@@ -1530,8 +2320,8 @@ gs_plugin_loader_get_sources_thread_cb (GTask *task,
 	}
 
 	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_plugin_loader_filter_duplicates (plugin_loader, state->list,
+					    GS_APP_LIST_FILTER_FLAG_NONE);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -1567,7 +2357,7 @@ gs_plugin_loader_get_sources_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_sources_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_sources_thread_cb);
 }
 
 /**
@@ -1600,6 +2390,7 @@ gs_plugin_loader_get_installed_thread_cb (GTask *task,
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
 	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
 	GError *error = NULL;
+	g_autoptr(GsAppListQuery) query = NULL;
 
 	/* do things that would block */
 	state->list = gs_plugin_loader_run_results (plugin_loader,
@@ -1614,9 +2405,11 @@ gs_plugin_loader_get_installed_thread_cb (GTask *task,
 	}
 
 	/* filter package list */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid_installed, state);
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
+	query = gs_app_list_query_new ();
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid_installed, state);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_run (query, state->list);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -1663,7 +2456,7 @@ gs_plugin_loader_get_installed_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_installed_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_installed_thread_cb);
 }
 
 /**
@@ -1687,16 +2480,13 @@ gs_plugin_loader_get_installed_finish (GsPluginLoader *plugin_loader,
 
 /******************************************************************************/
 
-static void
-gs_plugin_loader_get_popular_thread_cb (GTask *task,
-					gpointer object,
-					gpointer task_data,
-					GCancellable *cancellable)
+/* returns the corporate or debugging list of popular apps, if any */
+static GsAppList *
+gs_plugin_loader_get_popular_overrides (GsPluginLoader *plugin_loader)
 {
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
-	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
-	GError *error = NULL;
+	GsAppList *list;
+	guint i;
 	g_auto(GStrv) apps = NULL;
 
 	/* debugging only */
@@ -1706,15 +2496,49 @@ gs_plugin_loader_get_popular_thread_cb (GTask *task,
 	/* are we using a corporate build */
 	if (apps == NULL)
 		apps = g_settings_get_strv (priv->settings, "popular-overrides");
-	if (apps != NULL && g_strv_length (apps) > 0) {
-		guint i;
-		state->list = gs_app_list_new ();
-		for (i = 0; apps[i] != NULL; i++) {
-			g_autoptr(GsApp) app = gs_app_new (apps[i]);
-			gs_app_add_quirk (app, AS_APP_QUIRK_MATCH_ANY_PREFIX);
-			gs_app_list_add (state->list, app);
-		}
-	} else {
+	if (apps == NULL || g_strv_length (apps) == 0)
+		return NULL;
+	list = gs_app_list_new ();
+	for (i = 0; apps[i] != NULL; i++) {
+		g_autoptr(GsApp) app = gs_app_new (apps[i]);
+		gs_app_add_quirk (app, AS_APP_QUIRK_MATCH_ANY_PREFIX);
+		gs_app_list_add (list, app);
+	}
+	return list;
+}
+
+static void
+gs_plugin_loader_filter_popular (GsPluginLoader *plugin_loader,
+				 GsPluginLoaderAsyncState *state,
+				 GsAppList *list)
+{
+	g_autoptr(GsAppListQuery) query = gs_app_list_query_new ();
+
+	/* filter package list */
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_filter_qt_for_gtk, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_get_app_is_compatible, plugin_loader);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_age_appropriate, plugin_loader);
+
+	/* filter duplicates with priority */
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+	gs_app_list_query_run (query, list);
+}
+
+static void
+gs_plugin_loader_get_popular_thread_cb (GTask *task,
+					gpointer object,
+					gpointer task_data,
+					GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
+	GError *error = NULL;
+
+	/* are we using a corporate build */
+	state->list = gs_plugin_loader_get_popular_overrides (plugin_loader);
+	if (state->list == NULL) {
 		/* do things that would block */
 		state->list = gs_plugin_loader_run_results (plugin_loader,
 							    state->action,
@@ -1729,13 +2553,7 @@ gs_plugin_loader_get_popular_thread_cb (GTask *task,
 	}
 
 	/* filter package list */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
-	gs_app_list_filter (state->list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-
-	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+	gs_plugin_loader_filter_popular (plugin_loader, state, state->list);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -1762,7 +2580,7 @@ gs_plugin_loader_get_popular_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_popular_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_popular_thread_cb);
 }
 
 /**
@@ -1795,6 +2613,28 @@ gs_plugin_loader_featured_debug (GsApp *app, gpointer user_data)
 	return FALSE;
 }
 
+static void
+gs_plugin_loader_filter_featured (GsPluginLoader *plugin_loader,
+				  GsPluginLoaderAsyncState *state,
+				  GsAppList *list)
+{
+	g_autoptr(GsAppListQuery) query = gs_app_list_query_new ();
+
+	/* filter package list */
+	if (g_getenv ("GNOME_SOFTWARE_FEATURED") != NULL) {
+		gs_app_list_query_add_filter (query, gs_plugin_loader_featured_debug, NULL);
+	} else {
+		gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
+		gs_app_list_query_add_filter (query, gs_plugin_loader_get_app_is_compatible, plugin_loader);
+		gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_age_appropriate, plugin_loader);
+	}
+
+	/* filter duplicates with priority */
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+	gs_app_list_query_run (query, list);
+}
+
 static void
 gs_plugin_loader_get_featured_thread_cb (GTask *task,
 					 gpointer object,
@@ -1818,16 +2658,7 @@ gs_plugin_loader_get_featured_thread_cb (GTask *task,
 	}
 
 	/* filter package list */
-	if (g_getenv ("GNOME_SOFTWARE_FEATURED") != NULL) {
-		gs_app_list_filter (state->list, gs_plugin_loader_featured_debug, NULL);
-	} else {
-		gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
-		gs_app_list_filter (state->list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-	}
-
-	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+	gs_plugin_loader_filter_featured (plugin_loader, state, state->list);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -1875,7 +2706,7 @@ gs_plugin_loader_get_featured_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_featured_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_featured_thread_cb);
 }
 
 /**
@@ -1957,112 +2788,468 @@ gs_plugin_loader_convert_unavailable (GsAppList *list, const gchar *search)
 	}
 }
 
-static void
-gs_plugin_loader_search_thread_cb (GTask *task,
-				   gpointer object,
-				   gpointer task_data,
-				   GCancellable *cancellable)
+/* returns FALSE if the plugin does not search or failed */
+static gboolean
+gs_plugin_loader_run_search_plugin (GsPluginLoader *plugin_loader,
+				    GsPlugin *plugin,
+				    gchar **values,
+				    GsAppList *list,
+				    GCancellable *cancellable)
 {
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	const gchar *function_name = "gs_plugin_add_search";
-	gboolean ret = TRUE;
-	GError *error = NULL;
-	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
-	GsPlugin *plugin;
-	GsPluginSearchFunc plugin_func = NULL;
+	gboolean ret;
 	guint i;
-	g_auto(GStrv) values = NULL;
+	guint len = gs_app_list_length (list);
+	GsPluginSearchFunc plugin_func = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GError) error_local = NULL;
 
-	/* run each plugin */
-	values = as_utils_search_tokenize (state->value);
-	if (values == NULL) {
-		g_task_return_new_error (task,
-					 GS_PLUGIN_ERROR,
-					 GS_PLUGIN_ERROR_NOT_SUPPORTED,
-					 "no valid search terms");
-		return;
+	ret = g_module_symbol (gs_plugin_get_module (plugin),
+			       function_name,
+			       (gpointer *) &plugin_func);
+	if (!ret)
+		return FALSE;
+	ptask = as_profile_start (priv->profile,
+				  "GsPlugin::%s(%s)",
+				  gs_plugin_get_name (plugin),
+				  function_name);
+	g_assert (ptask != NULL);
+	if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+		return FALSE;
+	gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
+	ret = plugin_func (plugin, values, list,
+			   cancellable, &error_local);
+	gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+				      ret, error_local);
+	if (!ret) {
+		/* badly behaved plugin */
+		if (error_local == NULL) {
+			g_critical ("%s did not set error for %s",
+				    gs_plugin_get_name (plugin),
+				    function_name);
+			return FALSE;
+		}
+		g_warning ("failed to call %s on %s: %s",
+			   function_name,
+			   gs_plugin_get_name (plugin),
+			   error_local->message);
+		return FALSE;
 	}
-	for (i = 0; i < priv->plugins->len; i++) {
-		g_autoptr(AsProfileTask) ptask = NULL;
-		g_autoptr(GError) error_local = NULL;
-		plugin = g_ptr_array_index (priv->plugins, i);
-		if (!gs_plugin_get_enabled (plugin))
-			continue;
-		ret = g_task_return_error_if_cancelled (task);
-		if (ret)
-			return;
-		ret = g_module_symbol (gs_plugin_get_module (plugin),
-				       function_name,
-				       (gpointer *) &plugin_func);
-		if (!ret)
-			continue;
-		ptask = as_profile_start (priv->profile,
-					  "GsPlugin::%s(%s)",
-					  gs_plugin_get_name (plugin),
-					  function_name);
-		g_assert (ptask != NULL);
-		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
-		ret = plugin_func (plugin, values, state->list,
-				   cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
-		if (!ret) {
-			/* badly behaved plugin */
-			if (error_local == NULL) {
-				g_critical ("%s did not set error for %s",
-					    gs_plugin_get_name (plugin),
-					    function_name);
-				continue;
-			}
-			g_warning ("failed to call %s on %s: %s",
-				   function_name,
-				   gs_plugin_get_name (plugin),
-				   error_local->message);
-			continue;
+	gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
+
+	/* only the plugins searching AppStream metadata, which are the ones
+	 * with GS_PLUGIN_FLAGS_NARROWABLE_SEARCH, set the match value, so
+	 * score the other results on the same fields to rank them fairly;
+	 * this also replaces any value left from a previous search */
+	if (!gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_NARROWABLE_SEARCH)) {
+		for (i = len; i < gs_app_list_length (list); i++) {
+			GsApp *app = gs_app_list_index (list, i);
+			gs_app_set_match_value (app, gs_plugin_loader_app_search_matches (app, values));
 		}
-		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
+	return TRUE;
+}
 
-	/* run refine() on each one */
-	ret = gs_plugin_loader_run_refine (plugin_loader,
-					   function_name,
-					   state->list,
-					   state->flags,
-					   cancellable,
-					   &error);
+/* only looks at the apps in @previous, falling back to a full search if
+ * the plugin cannot do that */
+static void
+gs_plugin_loader_run_search_narrow_plugin (GsPluginLoader *plugin_loader,
+					   GsPlugin *plugin,
+					   gchar **values,
+					   GsAppList *previous,
+					   GsAppList *list,
+					   GCancellable *cancellable)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	const gchar *function_name = "gs_plugin_add_search_narrow";
+	gboolean ret;
+	GsPluginSearchNarrowFunc plugin_func = NULL;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	ret = g_module_symbol (gs_plugin_get_module (plugin),
+			       function_name,
+			       (gpointer *) &plugin_func);
 	if (!ret) {
-		g_task_return_error (task, error);
+		gs_plugin_loader_run_search_plugin (plugin_loader, plugin,
+						    values, list, cancellable);
 		return;
 	}
-
-	/* convert any unavailables */
-	gs_plugin_loader_convert_unavailable (state->list, state->value);
-
-	/* filter package list */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
-	gs_app_list_filter (state->list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-
-	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_NONE);
-
-	/* too many */
-	if (gs_app_list_length (state->list) > 500) {
-		g_task_return_new_error (task,
-					 GS_PLUGIN_ERROR,
-					 GS_PLUGIN_ERROR_NOT_SUPPORTED,
-					 "Too many search results returned");
+	ptask = as_profile_start (priv->profile,
+				  "GsPlugin::%s(%s)",
+				  gs_plugin_get_name (plugin),
+				  function_name);
+	g_assert (ptask != NULL);
+	if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+		return;
+	gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
+	ret = plugin_func (plugin, values, previous, list,
+			   cancellable, &error_local);
+	gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+				      ret, error_local);
+	if (!ret) {
+		/* badly behaved plugin */
+		if (error_local == NULL) {
+			g_critical ("%s did not set error for %s",
+				    gs_plugin_get_name (plugin),
+				    function_name);
+			return;
+		}
+		g_warning ("failed to call %s on %s: %s",
+			   function_name,
+			   gs_plugin_get_name (plugin),
+			   error_local->message);
 		return;
 	}
-
-	/* success */
-	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
+	gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 }
 
-/**
- * gs_plugin_loader_search_async:
- *
+/* if @previous is set, the plugins that set GS_PLUGIN_FLAGS_NARROWABLE_SEARCH
+ * only look at the apps in it, and their results are added to
+ * @list_narrowable rather than @list */
+static gboolean
+gs_plugin_loader_run_search (GsPluginLoader *plugin_loader,
+			     gchar **values,
+			     GsAppList *list,
+			     GsAppList *previous,
+			     GsAppList *list_narrowable,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPlugin *plugin;
+	guint i;
+
+	for (i = 0; i < priv->plugins->len; i++) {
+		plugin = g_ptr_array_index (priv->plugins, i);
+		if (!gs_plugin_get_enabled (plugin))
+			continue;
+		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+			gs_utils_error_convert_gio (error);
+			return FALSE;
+		}
+
+		if (previous != NULL &&
+		    gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_NARROWABLE_SEARCH)) {
+			gs_plugin_loader_run_search_narrow_plugin (plugin_loader,
+								   plugin,
+								   values,
+								   previous,
+								   list_narrowable,
+								   cancellable);
+			continue;
+		}
+		gs_plugin_loader_run_search_plugin (plugin_loader, plugin,
+						    values, list, cancellable);
+	}
+
+	/* the results are not swapped for the shared objects, as they
+	 * carry the match value of this search */
+	return TRUE;
+}
+
+static gint
+gs_plugin_loader_match_value_sort_cb (gconstpointer a, gconstpointer b)
+{
+	guint value1 = *((const guint *) a);
+	guint value2 = *((const guint *) b);
+
+	if (value1 > value2)
+		return -1;
+	if (value1 < value2)
+		return 1;
+	return 0;
+}
+
+static gboolean
+gs_plugin_loader_search_candidate_filter (GsApp *app, gpointer user_data)
+{
+	return gs_app_get_match_value (app) >= GPOINTER_TO_UINT (user_data);
+}
+
+/* the match value always outweighs the rating, kudos and installed state in
+ * the search score, so only the results with the best match values can end
+ * up in the final list; the others are dropped before they get refined, and
+ * twice as many as needed are kept in case some are filtered out later */
+static void
+gs_plugin_loader_search_candidates (GsAppList *list)
+{
+	guint i;
+	guint len = gs_app_list_length (list);
+	guint match_value_min;
+	g_autoptr(GArray) match_values = NULL;
+
+	if (len <= GS_PLUGIN_LOADER_SEARCH_CANDIDATES)
+		return;
+	match_values = g_array_sized_new (FALSE, FALSE, sizeof (guint), len);
+	for (i = 0; i < len; i++) {
+		guint match_value = gs_app_get_match_value (gs_app_list_index (list, i));
+		g_array_append_val (match_values, match_value);
+	}
+	g_array_sort (match_values, gs_plugin_loader_match_value_sort_cb);
+	match_value_min = g_array_index (match_values, guint,
+					 GS_PLUGIN_LOADER_SEARCH_CANDIDATES - 1);
+
+	/* the results tying with the last candidate are all kept */
+	gs_app_list_filter (list,
+			    gs_plugin_loader_search_candidate_filter,
+			    GUINT_TO_POINTER (match_value_min));
+	g_debug ("kept %u of %u search results to refine",
+		 gs_app_list_length (list), len);
+}
+
+static void
+gs_plugin_loader_search_filter (GsPluginLoader *plugin_loader,
+				GsPluginLoaderAsyncState *state,
+				GsAppList *list)
+{
+	g_autoptr(GsAppListQuery) query = gs_app_list_query_new ();
+
+	/* convert any unavailables */
+	gs_plugin_loader_convert_unavailable (list, state->value);
+
+	/* filter package list */
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_filter_qt_for_gtk, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_get_app_is_compatible, plugin_loader);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_age_appropriate, plugin_loader);
+
+	/* filter duplicates with priority */
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_NONE);
+
+	/* only keep the best results for broad searches */
+	gs_app_list_query_set_sort (query, gs_plugin_loader_app_sort_search_cb, NULL);
+	gs_app_list_query_set_max_results (query, GS_PLUGIN_LOADER_SEARCH_MAX_RESULTS);
+	gs_app_list_query_run (query, list);
+}
+
+typedef struct {
+	GsPluginLoader			*plugin_loader;
+	GsAppList			*list;
+	gboolean			 narrowable_done;
+	GsPluginLoaderResultsFunc	 func;
+	gpointer			 user_data;
+	GCancellable			*cancellable;
+} GsPluginLoaderResultsHelper;
+
+static void
+gs_plugin_loader_results_helper_free (GsPluginLoaderResultsHelper *helper)
+{
+	g_object_unref (helper->plugin_loader);
+	g_object_unref (helper->list);
+	if (helper->cancellable != NULL)
+		g_object_unref (helper->cancellable);
+	g_slice_free (GsPluginLoaderResultsHelper, helper);
+}
+
+static gboolean
+gs_plugin_loader_results_cb (gpointer user_data)
+{
+	GsPluginLoaderResultsHelper *helper = (GsPluginLoaderResultsHelper *) user_data;
+
+	/* the caller has already started another search */
+	if (g_cancellable_is_cancelled (helper->cancellable))
+		return FALSE;
+	helper->func (helper->plugin_loader, helper->list,
+		      helper->narrowable_done, helper->user_data);
+	return FALSE;
+}
+
+/* passes @list to the results function in the context of the caller; this is
+ * queued there before the task result, so the final list always comes last */
+static void
+gs_plugin_loader_emit_results (GsPluginLoader *plugin_loader,
+			       GsPluginLoaderAsyncState *state,
+			       GsAppList *list,
+			       gboolean narrowable_done,
+			       GCancellable *cancellable)
+{
+	GsPluginLoaderResultsHelper *helper;
+
+	helper = g_slice_new0 (GsPluginLoaderResultsHelper);
+	helper->plugin_loader = g_object_ref (plugin_loader);
+	helper->list = g_object_ref (list);
+	helper->narrowable_done = narrowable_done;
+	helper->func = state->results_func;
+	helper->user_data = state->results_user_data;
+	if (cancellable != NULL)
+		helper->cancellable = g_object_ref (cancellable);
+	g_main_context_invoke_full (state->context,
+				    G_PRIORITY_DEFAULT,
+				    gs_plugin_loader_results_cb,
+				    helper,
+				    (GDestroyNotify) gs_plugin_loader_results_helper_free);
+}
+
+/* like gs_plugin_loader_run_search() followed by a refine, but the results
+ * found so far are passed to the caller after each plugin has finished */
+static gboolean
+gs_plugin_loader_run_search_incremental (GsPluginLoader *plugin_loader,
+					 GsPluginLoaderAsyncState *state,
+					 gchar **values,
+					 GCancellable *cancellable,
+					 GError **error)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	guint i;
+	guint j;
+	guint last_narrowable = G_MAXUINT;
+	guint pass;
+	g_autoptr(GPtrArray) batches = NULL;
+
+	/* the results are kept in plugin order so the final list is the
+	 * same as when not searching incrementally */
+	batches = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	for (i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		g_ptr_array_add (batches, gs_app_list_new ());
+		if (gs_plugin_get_enabled (plugin) &&
+		    gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_NARROWABLE_SEARCH))
+			last_narrowable = i;
+	}
+
+	/* nothing to wait for before the first complete result */
+	if (last_narrowable == G_MAXUINT) {
+		g_autoptr(GsAppList) list = gs_app_list_new ();
+		gs_plugin_loader_emit_results (plugin_loader, state,
+					       list, TRUE, cancellable);
+	}
+
+	/* plugins that search local metadata go first, so that their
+	 * results are not held back by the ones using the network */
+	for (pass = 0; pass < 2; pass++) {
+		for (i = 0; i < priv->plugins->len; i++) {
+			GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+			GsAppList *batch = g_ptr_array_index (batches, i);
+			gboolean local;
+			gboolean narrowable_done;
+			g_autoptr(GsAppList) list = NULL;
+
+			if (!gs_plugin_get_enabled (plugin))
+				continue;
+			local = gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_NARROWABLE_SEARCH);
+			if (local != (pass == 0))
+				continue;
+			if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+				gs_utils_error_convert_gio (error);
+				return FALSE;
+			}
+
+			/* the last local plugin always emits, even if it
+			 * found nothing, so the caller knows the local
+			 * results are complete */
+			narrowable_done = pass == 1 || i == last_narrowable;
+			if (gs_plugin_loader_run_search_plugin (plugin_loader,
+								plugin,
+								values,
+								batch,
+								cancellable) &&
+			    gs_app_list_length (batch) > 0) {
+				/* the results are not swapped for the shared
+				 * objects, as they carry the match value of
+				 * this search */
+				gs_plugin_loader_search_candidates (batch);
+				if (!gs_plugin_loader_run_refine (plugin_loader,
+								  "gs_plugin_add_search",
+								  batch,
+								  state->flags |
+								  GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+								  cancellable,
+								  error))
+					return FALSE;
+			} else if (i != last_narrowable) {
+				continue;
+			}
+
+			/* show everything found so far */
+			list = gs_app_list_new ();
+			for (j = 0; j < batches->len; j++)
+				gs_app_list_add_list (list, g_ptr_array_index (batches, j));
+			gs_plugin_loader_search_filter (plugin_loader, state, list);
+			if (gs_app_list_length (list) == 0 && i != last_narrowable)
+				continue;
+			gs_plugin_loader_emit_results (plugin_loader, state,
+						       list, narrowable_done,
+						       cancellable);
+		}
+	}
+	for (j = 0; j < batches->len; j++)
+		gs_app_list_add_list (state->list, g_ptr_array_index (batches, j));
+	return TRUE;
+}
+
+static void
+gs_plugin_loader_search_thread_cb (GTask *task,
+				   gpointer object,
+				   gpointer task_data,
+				   GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	gboolean ret = TRUE;
+	GError *error = NULL;
+	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
+	g_auto(GStrv) values = NULL;
+
+	/* run each plugin */
+	values = as_utils_search_tokenize (state->value);
+	if (values == NULL) {
+		g_task_return_new_error (task,
+					 GS_PLUGIN_ERROR,
+					 GS_PLUGIN_ERROR_NOT_SUPPORTED,
+					 "no valid search terms");
+		return;
+	}
+	if (state->results_func != NULL) {
+		ret = gs_plugin_loader_run_search_incremental (plugin_loader,
+							       state,
+							       values,
+							       cancellable,
+							       &error);
+		if (!ret) {
+			g_task_return_error (task, error);
+			return;
+		}
+	} else {
+		ret = gs_plugin_loader_run_search (plugin_loader,
+						   values,
+						   state->list,
+						   NULL,
+						   NULL,
+						   cancellable,
+						   &error);
+		if (!ret) {
+			g_task_return_error (task, error);
+			return;
+		}
+
+		/* run refine() on the results that can make the cut, with
+		 * the rating that is used to rank them */
+		gs_plugin_loader_search_candidates (state->list);
+		ret = gs_plugin_loader_run_refine (plugin_loader,
+						   "gs_plugin_add_search",
+						   state->list,
+						   state->flags |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+						   cancellable,
+						   &error);
+		if (!ret) {
+			g_task_return_error (task, error);
+			return;
+		}
+	}
+
+	/* filter package list */
+	gs_plugin_loader_search_filter (plugin_loader, state, state->list);
+
+	/* success */
+	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
+}
+
+/**
+ * gs_plugin_loader_search_async:
+ *
  * This method calls all plugins that implement the gs_plugin_add_search()
  * function. The plugins can either return #GsApp objects of kind
  * %AS_APP_KIND_DESKTOP for bonafide applications, or #GsApp's of kind
@@ -2080,6 +3267,10 @@ gs_plugin_loader_search_thread_cb (GTask *task,
  *
  * The #GsApps may be in state %AS_APP_STATE_INSTALLED or %AS_APP_STATE_AVAILABLE
  * and the UI may want to filter the two classes of applications differently.
+ *
+ * The results are ranked by the fields that matched, then by the rating,
+ * kudos and whether the application is installed. Only the best
+ * %GS_PLUGIN_LOADER_SEARCH_MAX_RESULTS results are returned, in that order.
  **/
 void
 gs_plugin_loader_search_async (GsPluginLoader *plugin_loader,
@@ -2105,7 +3296,63 @@ gs_plugin_loader_search_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_search_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_search_thread_cb);
+}
+
+/**
+ * gs_plugin_loader_search_incremental_async:
+ * @plugin_loader: a #GsPluginLoader
+ * @value: a search string
+ * @flags: some #GsPluginRefineFlags
+ * @results_func: a #GsPluginLoaderResultsFunc
+ * @results_user_data: user data for @results_func
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: function to call when complete
+ * @user_data: user data
+ *
+ * Searches in the same way as gs_plugin_loader_search_async(), but also calls
+ * @results_func in the thread-default main context each time a plugin has
+ * returned results. The list passed to @results_func holds everything found so
+ * far, already refined with @flags and filtered, and is not called once
+ * @cancellable has been cancelled.
+ *
+ * Plugins that search local metadata are asked first. @results_func is always
+ * called once every plugin with %GS_PLUGIN_FLAGS_NARROWABLE_SEARCH has
+ * finished, with @narrowable_done set to %TRUE, even if nothing was found.
+ * Once complete, use gs_plugin_loader_search_finish() to get the final list,
+ * which is the same as from gs_plugin_loader_search_async().
+ **/
+void
+gs_plugin_loader_search_incremental_async (GsPluginLoader *plugin_loader,
+					   const gchar *value,
+					   GsPluginRefineFlags flags,
+					   GsPluginLoaderResultsFunc results_func,
+					   gpointer results_user_data,
+					   GCancellable *cancellable,
+					   GAsyncReadyCallback callback,
+					   gpointer user_data)
+{
+	GsPluginLoaderAsyncState *state;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+	g_return_if_fail (results_func != NULL);
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	/* save state */
+	state = g_slice_new0 (GsPluginLoaderAsyncState);
+	state->flags = flags;
+	state->list = gs_app_list_new ();
+	state->value = g_strdup (value);
+	state->action = GS_PLUGIN_ACTION_SEARCH;
+	state->results_func = results_func;
+	state->results_user_data = results_user_data;
+	state->context = g_main_context_ref_thread_default ();
+
+	/* run in a thread */
+	task = g_task_new (plugin_loader, cancellable, callback, user_data);
+	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_search_thread_cb);
 }
 
 /**
@@ -2129,6 +3376,171 @@ gs_plugin_loader_search_finish (GsPluginLoader *plugin_loader,
 
 /******************************************************************************/
 
+/* keeps the apps the plugins with GS_PLUGIN_FLAGS_NARROWABLE_SEARCH still
+ * match, with the match value for the new search */
+static gboolean
+gs_plugin_loader_search_narrow_filter (GsApp *app, gpointer user_data)
+{
+	GHashTable *matches = (GHashTable *) user_data;
+	gpointer value;
+
+	if (gs_app_get_id (app) == NULL)
+		return FALSE;
+	if (!g_hash_table_lookup_extended (matches, gs_app_get_id (app), NULL, &value))
+		return FALSE;
+	gs_app_set_match_value (app, GPOINTER_TO_UINT (value));
+	return TRUE;
+}
+
+static void
+gs_plugin_loader_search_narrow_thread_cb (GTask *task,
+					  gpointer object,
+					  gpointer task_data,
+					  GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	gboolean ret = TRUE;
+	GError *error = NULL;
+	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
+	guint i;
+	g_auto(GStrv) values = NULL;
+	g_autoptr(GHashTable) matches = NULL;
+	g_autoptr(GsAppList) list_new = gs_app_list_new ();
+	g_autoptr(GsAppList) list_narrowable = gs_app_list_new ();
+
+	values = as_utils_search_tokenize (state->value);
+	if (values == NULL) {
+		g_task_return_new_error (task,
+					 GS_PLUGIN_ERROR,
+					 GS_PLUGIN_ERROR_NOT_SUPPORTED,
+					 "no valid search terms");
+		return;
+	}
+
+	/* the plugins that can narrow the previous results only match them
+	 * again against their token cache, so the cost depends on the number
+	 * of previous results rather than the size of the catalogue; they
+	 * are not refined again but match on the same fields, with the same
+	 * stemming, as a full search, even without a description */
+	ret = gs_plugin_loader_run_search (plugin_loader,
+					   values,
+					   list_new,
+					   state->list,
+					   list_narrowable,
+					   cancellable,
+					   &error);
+	if (!ret) {
+		g_task_return_error (task, error);
+		return;
+	}
+	gs_plugin_loader_search_candidates (list_new);
+	ret = gs_plugin_loader_run_refine (plugin_loader,
+					   "gs_plugin_add_search",
+					   list_new,
+					   state->flags |
+					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+					   cancellable,
+					   &error);
+	if (!ret) {
+		g_task_return_error (task, error);
+		return;
+	}
+
+	/* the previous results are already refined and filtered */
+	matches = g_hash_table_new (g_str_hash, g_str_equal);
+	for (i = 0; i < gs_app_list_length (list_narrowable); i++) {
+		GsApp *app = gs_app_list_index (list_narrowable, i);
+		guint match_value;
+		if (gs_app_get_id (app) == NULL)
+			continue;
+		match_value = GPOINTER_TO_UINT (g_hash_table_lookup (matches, gs_app_get_id (app)));
+		g_hash_table_insert (matches,
+				     (gpointer) gs_app_get_id (app),
+				     GUINT_TO_POINTER (match_value | gs_app_get_match_value (app)));
+	}
+	gs_app_list_filter (state->list,
+			    gs_plugin_loader_search_narrow_filter,
+			    matches);
+	gs_app_list_add_list (state->list, list_new);
+
+	/* filter package list */
+	gs_plugin_loader_search_filter (plugin_loader, state, state->list);
+
+	/* success */
+	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
+}
+
+/**
+ * gs_plugin_loader_search_narrow_async:
+ * @plugin_loader: a #GsPluginLoader
+ * @list: the results of a previous search
+ * @value: a search string that is more specific than the one used for @list
+ * @flags: some #GsPluginRefineFlags
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: function to call when complete
+ * @user_data: user data
+ *
+ * Searches for applications matching @value by filtering @list rather than
+ * refining new results. Plugins that set %GS_PLUGIN_FLAGS_NARROWABLE_SEARCH
+ * are only used to find out which apps in @list still match, using
+ * gs_plugin_add_search_narrow() where the plugin provides it, and the results
+ * of the other plugins are refined and merged with the narrowed list.
+ *
+ * If @list was cut short at %GS_PLUGIN_LOADER_SEARCH_MAX_RESULTS then it may
+ * not contain the best results for @value, and a full search should be used.
+ *
+ * The result has the same form as gs_plugin_loader_search_async().
+ **/
+void
+gs_plugin_loader_search_narrow_async (GsPluginLoader *plugin_loader,
+				      GsAppList *list,
+				      const gchar *value,
+				      GsPluginRefineFlags flags,
+				      GCancellable *cancellable,
+				      GAsyncReadyCallback callback,
+				      gpointer user_data)
+{
+	GsPluginLoaderAsyncState *state;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+	g_return_if_fail (GS_IS_APP_LIST (list));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	/* save state */
+	state = g_slice_new0 (GsPluginLoaderAsyncState);
+	state->flags = flags;
+	state->list = gs_app_list_copy (list);
+	state->value = g_strdup (value);
+	state->action = GS_PLUGIN_ACTION_SEARCH;
+
+	/* run in a thread */
+	task = g_task_new (plugin_loader, cancellable, callback, user_data);
+	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_search_narrow_thread_cb);
+}
+
+/**
+ * gs_plugin_loader_search_narrow_finish:
+ *
+ * Return value: (element-type GsApp) (transfer full): A list of applications
+ **/
+GsAppList *
+gs_plugin_loader_search_narrow_finish (GsPluginLoader *plugin_loader,
+				       GAsyncResult *res,
+				       GError **error)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), NULL);
+	g_return_val_if_fail (G_IS_TASK (res), NULL);
+	g_return_val_if_fail (g_task_is_valid (res, plugin_loader), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	gs_utils_error_convert_gio (error);
+	return g_task_propagate_pointer (G_TASK (res), error);
+}
+
+/******************************************************************************/
+
 static void
 gs_plugin_loader_search_files_thread_cb (GTask *task,
                                          gpointer object,
@@ -2145,6 +3557,7 @@ gs_plugin_loader_search_files_thread_cb (GTask *task,
 	GsPluginSearchFunc plugin_func = NULL;
 	guint i;
 	g_auto(GStrv) values = NULL;
+	g_autoptr(GsAppListQuery) query = NULL;
 
 	values = g_new0 (gchar *, 2);
 	values[0] = g_strdup (state->value);
@@ -2169,10 +3582,13 @@ gs_plugin_loader_search_files_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, values, state->list,
 				   cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -2206,14 +3622,16 @@ gs_plugin_loader_search_files_thread_cb (GTask *task,
 	gs_plugin_loader_convert_unavailable (state->list, state->value);
 
 	/* filter package list */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_non_installed, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
+	query = gs_app_list_query_new ();
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_non_installed, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_filter_qt_for_gtk, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_get_app_is_compatible, plugin_loader);
 
 	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_app_list_query_run (query, state->list);
 
 	/* too many */
 	if (gs_app_list_length (state->list) > 500) {
@@ -2273,7 +3691,7 @@ gs_plugin_loader_search_files_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_search_files_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_search_files_thread_cb);
 }
 
 /**
@@ -2313,6 +3731,7 @@ gs_plugin_loader_search_what_provides_thread_cb (GTask *task,
 	GsPluginSearchFunc plugin_func = NULL;
 	guint i;
 	g_auto(GStrv) values = NULL;
+	g_autoptr(GsAppListQuery) query = NULL;
 
 	values = g_new0 (gchar *, 2);
 	values[0] = g_strdup (state->value);
@@ -2337,10 +3756,13 @@ gs_plugin_loader_search_what_provides_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, values, state->list,
 				   cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -2374,14 +3796,16 @@ gs_plugin_loader_search_what_provides_thread_cb (GTask *task,
 	gs_plugin_loader_convert_unavailable (state->list, state->value);
 
 	/* filter package list */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_non_installed, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
+	query = gs_app_list_query_new ();
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_non_installed, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_filter_qt_for_gtk, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_get_app_is_compatible, plugin_loader);
 
 	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_NONE);
+	gs_app_list_query_run (query, state->list);
 
 	/* too many */
 	if (gs_app_list_length (state->list) > 500) {
@@ -2441,7 +3865,7 @@ gs_plugin_loader_search_what_provides_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_search_what_provides_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_search_what_provides_thread_cb);
 }
 
 /**
@@ -2511,17 +3935,17 @@ gs_plugin_loader_fix_category_all (GsCategory *category)
 	}
 }
 
-static void
-gs_plugin_loader_get_categories_thread_cb (GTask *task,
-					   gpointer object,
-					   gpointer task_data,
-					   GCancellable *cancellable)
+/* runs gs_plugin_add_categories() on each plugin and fixes up the results */
+static gboolean
+gs_plugin_loader_run_categories (GsPluginLoader *plugin_loader,
+				 GsPluginAction action,
+				 GPtrArray *catlist,
+				 GCancellable *cancellable,
+				 GError **error)
 {
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	const gchar *function_name = "gs_plugin_add_categories";
 	gboolean ret = TRUE;
-	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
 	GsPlugin *plugin;
 	GsPluginCategoriesFunc plugin_func = NULL;
 	guint i;
@@ -2533,9 +3957,10 @@ gs_plugin_loader_get_categories_thread_cb (GTask *task,
 		plugin = g_ptr_array_index (priv->plugins, i);
 		if (!gs_plugin_get_enabled (plugin))
 			continue;
-		ret = g_task_return_error_if_cancelled (task);
-		if (ret)
-			return;
+		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+			gs_utils_error_convert_gio (error);
+			return FALSE;
+		}
 		ret = g_module_symbol (gs_plugin_get_module (plugin),
 				       function_name,
 				       (gpointer *) &plugin_func);
@@ -2546,10 +3971,12 @@ gs_plugin_loader_get_categories_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
-		ret = plugin_func (plugin, state->catlist,
-				   cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		ret = plugin_func (plugin, catlist, cancellable, &error_local);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -2563,7 +3990,7 @@ gs_plugin_loader_get_categories_thread_cb (GTask *task,
 				   gs_plugin_get_name (plugin),
 				   error_local->message);
 			gs_plugin_loader_create_event_from_error (plugin_loader,
-								  state->action,
+								  action,
 								  plugin,
 								  NULL, /* app */
 								  error_local);
@@ -2573,17 +4000,39 @@ gs_plugin_loader_get_categories_thread_cb (GTask *task,
 	}
 
 	/* make sure 'All' has the right categories */
-	for (i = 0; i < state->catlist->len; i++) {
-		GsCategory *cat = g_ptr_array_index (state->catlist, i);
+	for (i = 0; i < catlist->len; i++) {
+		GsCategory *cat = g_ptr_array_index (catlist, i);
 		gs_plugin_loader_fix_category_all (cat);
 	}
 
 	/* sort by name */
-	g_ptr_array_sort (state->catlist, gs_plugin_loader_category_sort_cb);
-	for (i = 0; i < state->catlist->len; i++) {
-		GsCategory *cat = GS_CATEGORY (g_ptr_array_index (state->catlist, i));
+	g_ptr_array_sort (catlist, gs_plugin_loader_category_sort_cb);
+	for (i = 0; i < catlist->len; i++) {
+		GsCategory *cat = GS_CATEGORY (g_ptr_array_index (catlist, i));
 		gs_category_sort_children (cat);
 	}
+	return TRUE;
+}
+
+static void
+gs_plugin_loader_get_categories_thread_cb (GTask *task,
+					   gpointer object,
+					   gpointer task_data,
+					   GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	GError *error = NULL;
+	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
+
+	/* run each plugin */
+	if (!gs_plugin_loader_run_categories (plugin_loader,
+					      state->action,
+					      state->catlist,
+					      cancellable,
+					      &error)) {
+		g_task_return_error (task, error);
+		return;
+	}
 
 	/* success */
 	if (state->catlist->len == 0) {
@@ -2626,7 +4075,7 @@ gs_plugin_loader_get_categories_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_categories_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_categories_thread_cb);
 }
 
 /**
@@ -2650,18 +4099,18 @@ gs_plugin_loader_get_categories_finish (GsPluginLoader *plugin_loader,
 
 /******************************************************************************/
 
-static void
-gs_plugin_loader_get_category_apps_thread_cb (GTask *task,
-					      gpointer object,
-					      gpointer task_data,
-					      GCancellable *cancellable)
+/* runs gs_plugin_add_category_apps() on each plugin without refining */
+static gboolean
+gs_plugin_loader_run_category_apps (GsPluginLoader *plugin_loader,
+				    GsPluginAction action,
+				    GsCategory *category,
+				    GsAppList *list,
+				    GCancellable *cancellable,
+				    GError **error)
 {
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	const gchar *function_name = "gs_plugin_add_category_apps";
 	gboolean ret = TRUE;
-	GError *error = NULL;
-	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
 	GsPlugin *plugin;
 	GsPluginCategoryFunc plugin_func = NULL;
 	guint i;
@@ -2673,9 +4122,10 @@ gs_plugin_loader_get_category_apps_thread_cb (GTask *task,
 		plugin = g_ptr_array_index (priv->plugins, i);
 		if (!gs_plugin_get_enabled (plugin))
 			continue;
-		ret = g_task_return_error_if_cancelled (task);
-		if (ret)
-			return;
+		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+			gs_utils_error_convert_gio (error);
+			return FALSE;
+		}
 		ret = g_module_symbol (gs_plugin_get_module (plugin),
 				       function_name,
 				       (gpointer *) &plugin_func);
@@ -2686,10 +4136,13 @@ gs_plugin_loader_get_category_apps_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
-		ret = plugin_func (plugin, state->category, state->list,
+		ret = plugin_func (plugin, category, list,
 				   cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -2703,7 +4156,7 @@ gs_plugin_loader_get_category_apps_thread_cb (GTask *task,
 				   gs_plugin_get_name (plugin),
 				   error_local->message);
 			gs_plugin_loader_create_event_from_error (plugin_loader,
-								  state->action,
+								  action,
 								  plugin,
 								  NULL, /* app */
 								  error_local);
@@ -2712,9 +4165,59 @@ gs_plugin_loader_get_category_apps_thread_cb (GTask *task,
 		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
 
+	/* share one object for each component */
+	gs_plugin_loader_app_map_add_list (plugin_loader, list);
+	return TRUE;
+}
+
+static void
+gs_plugin_loader_filter_category_apps (GsPluginLoader *plugin_loader,
+				       GsPluginLoaderAsyncState *state,
+				       GsAppList *list)
+{
+	g_autoptr(GsAppListQuery) query = gs_app_list_query_new ();
+
+	/* filter package list */
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_non_compulsory, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_valid, state);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_filter_qt_for_gtk, NULL);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_get_app_is_compatible, plugin_loader);
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_is_age_appropriate, plugin_loader);
+
+	/* filter duplicates with priority */
+	gs_app_list_query_add_filter (query, gs_plugin_loader_app_set_prio, plugin_loader);
+	gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+
+	/* sort, just in case the UI doesn't do this */
+	gs_app_list_query_set_sort (query, gs_plugin_loader_app_sort_name_cb, NULL);
+	gs_app_list_query_run (query, list);
+}
+
+static void
+gs_plugin_loader_get_category_apps_thread_cb (GTask *task,
+					      gpointer object,
+					      gpointer task_data,
+					      GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	gboolean ret;
+	GError *error = NULL;
+	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
+
+	/* run each plugin */
+	if (!gs_plugin_loader_run_category_apps (plugin_loader,
+						 state->action,
+						 state->category,
+						 state->list,
+						 cancellable,
+						 &error)) {
+		g_task_return_error (task, error);
+		return;
+	}
+
 	/* run refine() on each one */
 	ret = gs_plugin_loader_run_refine (plugin_loader,
-					   function_name,
+					   "gs_plugin_add_category_apps",
 					   state->list,
 					   state->flags,
 					   cancellable,
@@ -2725,17 +4228,7 @@ gs_plugin_loader_get_category_apps_thread_cb (GTask *task,
 	}
 
 	/* filter package list */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_non_compulsory, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_app_is_valid, state);
-	gs_app_list_filter (state->list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-	gs_app_list_filter (state->list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-
-	/* filter duplicates with priority */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_PRIORITY);
-
-	/* sort, just in case the UI doesn't do this */
-	gs_app_list_sort (state->list, gs_plugin_loader_app_sort_name_cb, NULL);
+	gs_plugin_loader_filter_category_apps (plugin_loader, state, state->list);
 
 	/* success */
 	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
@@ -2786,7 +4279,7 @@ gs_plugin_loader_get_category_apps_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_get_category_apps_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_category_apps_thread_cb);
 }
 
 /**
@@ -2810,6 +4303,377 @@ gs_plugin_loader_get_category_apps_finish (GsPluginLoader *plugin_loader,
 
 /******************************************************************************/
 
+/* swaps each app in @list for the object in @list_refine with the same
+ * unique ID, so that only @list_refine needs to be refined */
+static void
+gs_plugin_loader_overview_share (GsAppList *list_refine, GsAppList *list)
+{
+	gboolean changed = FALSE;
+	guint i;
+	g_autoptr(GPtrArray) apps = NULL;
+
+	apps = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GsApp *app_shared = NULL;
+		const gchar *unique_id = gs_app_get_unique_id (app);
+		if (unique_id != NULL)
+			app_shared = gs_app_list_lookup (list_refine, unique_id);
+		if (app_shared == NULL ||
+		    gs_app_has_quirk (app_shared, AS_APP_QUIRK_MATCH_ANY_PREFIX))
+			app_shared = app;
+		if (app_shared != app)
+			changed = TRUE;
+		g_ptr_array_add (apps, g_object_ref (app_shared));
+	}
+	if (!changed)
+		return;
+	gs_app_list_remove_all (list);
+	for (i = 0; i < apps->len; i++)
+		gs_app_list_add (list, g_ptr_array_index (apps, i));
+}
+
+typedef enum {
+	GS_PLUGIN_LOADER_OVERVIEW_FEATURED,
+	GS_PLUGIN_LOADER_OVERVIEW_POPULAR,
+	GS_PLUGIN_LOADER_OVERVIEW_CATEGORIES,
+	GS_PLUGIN_LOADER_OVERVIEW_CATEGORY_APPS
+} GsPluginLoaderOverviewKind;
+
+typedef struct {
+	GsPluginLoaderOverviewKind	 kind;
+	GsCategory			*category;	/* for CATEGORY_APPS */
+	GsAppList			*list;
+	GPtrArray			*catlist;	/* for CATEGORIES */
+	gboolean			 ret;
+	GError				*error;
+} GsPluginLoaderOverviewSection;
+
+typedef struct {
+	GsPluginLoader			*plugin_loader;
+	GsPluginAction			 action;
+	GCancellable			*cancellable;
+} GsPluginLoaderOverviewHelper;
+
+static GsPluginLoaderOverviewSection *
+gs_plugin_loader_overview_section_new (GsPluginLoaderOverviewKind kind)
+{
+	GsPluginLoaderOverviewSection *section;
+	section = g_slice_new0 (GsPluginLoaderOverviewSection);
+	section->kind = kind;
+	section->list = gs_app_list_new ();
+	return section;
+}
+
+static void
+gs_plugin_loader_overview_section_free (GsPluginLoaderOverviewSection *section)
+{
+	if (section->category != NULL)
+		g_object_unref (section->category);
+	if (section->catlist != NULL)
+		g_ptr_array_unref (section->catlist);
+	if (section->error != NULL)
+		g_error_free (section->error);
+	g_object_unref (section->list);
+	g_slice_free (GsPluginLoaderOverviewSection, section);
+}
+
+static const gchar *
+gs_plugin_loader_overview_section_to_string (GsPluginLoaderOverviewSection *section)
+{
+	switch (section->kind) {
+	case GS_PLUGIN_LOADER_OVERVIEW_FEATURED:
+		return "featured";
+	case GS_PLUGIN_LOADER_OVERVIEW_POPULAR:
+		return "popular";
+	case GS_PLUGIN_LOADER_OVERVIEW_CATEGORIES:
+		return "categories";
+	case GS_PLUGIN_LOADER_OVERVIEW_CATEGORY_APPS:
+		return gs_category_get_id (section->category);
+	default:
+		break;
+	}
+	return NULL;
+}
+
+/* runs the plugins for one part of the overview page, in the thread pool */
+static void
+gs_plugin_loader_overview_section_cb (gpointer data, gpointer user_data)
+{
+	GsPluginLoaderOverviewSection *section = (GsPluginLoaderOverviewSection *) data;
+	GsPluginLoaderOverviewHelper *helper = (GsPluginLoaderOverviewHelper *) user_data;
+
+	switch (section->kind) {
+	case GS_PLUGIN_LOADER_OVERVIEW_FEATURED:
+		section->ret = gs_plugin_loader_run_results_internal (helper->plugin_loader,
+								      helper->action,
+								      "gs_plugin_add_featured",
+								      section->list,
+								      helper->cancellable,
+								      &section->error);
+		break;
+	case GS_PLUGIN_LOADER_OVERVIEW_POPULAR:
+		section->ret = gs_plugin_loader_run_results_internal (helper->plugin_loader,
+								      helper->action,
+								      "gs_plugin_add_popular",
+								      section->list,
+								      helper->cancellable,
+								      &section->error);
+		break;
+	case GS_PLUGIN_LOADER_OVERVIEW_CATEGORIES:
+		section->ret = gs_plugin_loader_run_categories (helper->plugin_loader,
+								helper->action,
+								section->catlist,
+								helper->cancellable,
+								&section->error);
+		break;
+	case GS_PLUGIN_LOADER_OVERVIEW_CATEGORY_APPS:
+		section->ret = gs_plugin_loader_run_category_apps (helper->plugin_loader,
+								   helper->action,
+								   section->category,
+								   section->list,
+								   helper->cancellable,
+								   &section->error);
+		break;
+	default:
+		g_assert_not_reached ();
+	}
+}
+
+static void
+gs_plugin_loader_get_overview_thread_cb (GTask *task,
+					 gpointer object,
+					 gpointer task_data,
+					 GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
+	GsPluginLoaderOverviewHelper helper;
+	GsPluginLoaderOverviewSection *section;
+	const gchar *function_name = "gs_plugin_loader_get_overview";
+	GError *error = NULL;
+	GThreadPool *pool;
+	guint i;
+	g_autoptr(GPtrArray) sections = NULL;
+	g_autoptr(GsAppList) list_featured = NULL;
+	g_autoptr(GsAppList) list_popular = NULL;
+	g_autoptr(GsAppList) list_refine = NULL;
+
+	/* each part of the page is got in parallel, as the single actions
+	 * used to be, but the apps are then refined together */
+	sections = g_ptr_array_new_with_free_func ((GDestroyNotify) gs_plugin_loader_overview_section_free);
+	g_ptr_array_add (sections, gs_plugin_loader_overview_section_new (GS_PLUGIN_LOADER_OVERVIEW_FEATURED));
+
+	/* the popular overrides are not refined, just like
+	 * gs_plugin_loader_get_popular_async() */
+	list_popular = gs_plugin_loader_get_popular_overrides (plugin_loader);
+	if (list_popular == NULL)
+		g_ptr_array_add (sections, gs_plugin_loader_overview_section_new (GS_PLUGIN_LOADER_OVERVIEW_POPULAR));
+	section = gs_plugin_loader_overview_section_new (GS_PLUGIN_LOADER_OVERVIEW_CATEGORIES);
+	section->catlist = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	g_ptr_array_add (sections, section);
+	for (i = 0; i < state->catlist_featured->len; i++) {
+		GsCategory *category = g_ptr_array_index (state->catlist_featured, i);
+		section = gs_plugin_loader_overview_section_new (GS_PLUGIN_LOADER_OVERVIEW_CATEGORY_APPS);
+		section->category = g_object_ref (category);
+		g_ptr_array_add (sections, section);
+	}
+	helper.plugin_loader = plugin_loader;
+	helper.action = state->action;
+	helper.cancellable = cancellable;
+	pool = g_thread_pool_new (gs_plugin_loader_overview_section_cb,
+				  &helper, (gint) sections->len, FALSE, NULL);
+	for (i = 0; i < sections->len; i++)
+		g_thread_pool_push (pool, g_ptr_array_index (sections, i), NULL);
+	g_thread_pool_free (pool, FALSE, TRUE);
+	if (g_cancellable_set_error_if_cancelled (cancellable, &error)) {
+		gs_utils_error_convert_gio (&error);
+		g_task_return_error (task, error);
+		return;
+	}
+
+	/* a part that failed is left out, rather than failing the page */
+	list_refine = gs_app_list_new ();
+	for (i = 0; i < sections->len; i++) {
+		section = g_ptr_array_index (sections, i);
+		if (!section->ret) {
+			g_warning ("failed to get %s for the overview: %s",
+				   gs_plugin_loader_overview_section_to_string (section),
+				   section->error != NULL ? section->error->message : "unknown");
+			continue;
+		}
+		switch (section->kind) {
+		case GS_PLUGIN_LOADER_OVERVIEW_FEATURED:
+			list_featured = g_object_ref (section->list);
+			break;
+		case GS_PLUGIN_LOADER_OVERVIEW_POPULAR:
+			list_popular = g_object_ref (section->list);
+			break;
+		default:
+			break;
+		}
+		gs_app_list_add_list (list_refine, section->list);
+	}
+
+	/* an app in more than one part is the same object in all of them */
+	for (i = 0; i < sections->len; i++) {
+		section = g_ptr_array_index (sections, i);
+		if (section->ret)
+			gs_plugin_loader_overview_share (list_refine, section->list);
+	}
+
+	/* run refine() once on the union of all the results */
+	if (!gs_plugin_loader_run_refine (plugin_loader,
+					  function_name,
+					  list_refine,
+					  state->flags | state->flags_featured,
+					  cancellable,
+					  &error)) {
+		g_task_return_error (task, error);
+		return;
+	}
+
+	/* filter each package list as the single actions would */
+	if (list_featured != NULL) {
+		gs_plugin_loader_filter_featured (plugin_loader, state, list_featured);
+		state->list_featured = g_steal_pointer (&list_featured);
+	}
+	if (list_popular != NULL) {
+		gs_plugin_loader_filter_popular (plugin_loader, state, list_popular);
+		state->list_popular = g_steal_pointer (&list_popular);
+	}
+	for (i = 0; i < sections->len; i++) {
+		section = g_ptr_array_index (sections, i);
+		switch (section->kind) {
+		case GS_PLUGIN_LOADER_OVERVIEW_CATEGORIES:
+			if (section->ret)
+				state->catlist = g_ptr_array_ref (section->catlist);
+			break;
+		case GS_PLUGIN_LOADER_OVERVIEW_CATEGORY_APPS:
+			/* too few apps, so the page hides the section */
+			if (!section->ret)
+				gs_app_list_remove_all (section->list);
+			gs_plugin_loader_filter_category_apps (plugin_loader, state, section->list);
+			g_ptr_array_add (state->category_apps, g_object_ref (section->list));
+			break;
+		default:
+			break;
+		}
+	}
+
+	/* success */
+	g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * gs_plugin_loader_get_overview_async:
+ * @plugin_loader: a #GsPluginLoader
+ * @categories: (element-type GsCategory): categories to get apps for
+ * @flags_featured: #GsPluginRefineFlags for the featured applications
+ * @flags: #GsPluginRefineFlags for all the other returned applications
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: the function to run on completion
+ * @user_data: the data to pass to @callback
+ *
+ * This method gets everything shown on the overview page in one go: the
+ * featured and popular applications, the list of categories and the
+ * applications in each of @categories.
+ *
+ * The plugins are called for each part of the page in parallel, and then all
+ * the applications are refined together with both @flags_featured and @flags,
+ * so an application appearing in more than one result only gets refined once.
+ * Each result is filtered in the same way as the equivalent single action,
+ * e.g. gs_plugin_loader_get_popular_async().
+ *
+ * If getting one part fails, the others are still returned.
+ **/
+void
+gs_plugin_loader_get_overview_async (GsPluginLoader *plugin_loader,
+				     GPtrArray *categories,
+				     GsPluginRefineFlags flags_featured,
+				     GsPluginRefineFlags flags,
+				     GCancellable *cancellable,
+				     GAsyncReadyCallback callback,
+				     gpointer user_data)
+{
+	GsPluginLoaderAsyncState *state;
+	guint i;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+	g_return_if_fail (categories != NULL);
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	/* save state */
+	state = g_slice_new0 (GsPluginLoaderAsyncState);
+	state->flags = flags;
+	state->flags_featured = flags_featured;
+	state->catlist_featured = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	for (i = 0; i < categories->len; i++) {
+		GsCategory *category = g_ptr_array_index (categories, i);
+		g_ptr_array_add (state->catlist_featured, g_object_ref (category));
+	}
+	state->category_apps = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	state->action = GS_PLUGIN_ACTION_GET_OVERVIEW;
+
+	/* run in a thread */
+	task = g_task_new (plugin_loader, cancellable, callback, user_data);
+	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_get_overview_thread_cb);
+}
+
+/**
+ * gs_plugin_loader_get_overview_finish:
+ * @plugin_loader: a #GsPluginLoader
+ * @res: a #GAsyncResult
+ * @featured: (out) (transfer full) (optional) (nullable): the featured
+ *  applications, or %NULL if they could not be got
+ * @popular: (out) (transfer full) (optional) (nullable): the popular
+ *  applications, or %NULL if they could not be got
+ * @categories: (out) (transfer full) (optional) (nullable) (element-type GsCategory):
+ *  all the categories, which may be empty, or %NULL if they could not be got
+ * @category_apps: (out) (transfer full) (optional) (element-type GsAppList):
+ *  the applications for each category passed to
+ *  gs_plugin_loader_get_overview_async(), in the same order, which are
+ *  empty if they could not be got
+ * @error: a #GError, or %NULL
+ *
+ * Return value: %TRUE for success
+ **/
+gboolean
+gs_plugin_loader_get_overview_finish (GsPluginLoader *plugin_loader,
+				      GAsyncResult *res,
+				      GsAppList **featured,
+				      GsAppList **popular,
+				      GPtrArray **categories,
+				      GPtrArray **category_apps,
+				      GError **error)
+{
+	GsPluginLoaderAsyncState *state;
+
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), FALSE);
+	g_return_val_if_fail (G_IS_TASK (res), FALSE);
+	g_return_val_if_fail (g_task_is_valid (res, plugin_loader), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (!g_task_propagate_boolean (G_TASK (res), error)) {
+		gs_utils_error_convert_gio (error);
+		return FALSE;
+	}
+	state = g_task_get_task_data (G_TASK (res));
+	if (featured != NULL && state->list_featured != NULL)
+		*featured = g_object_ref (state->list_featured);
+	if (popular != NULL && state->list_popular != NULL)
+		*popular = g_object_ref (state->list_popular);
+	if (categories != NULL && state->catlist != NULL)
+		*categories = g_ptr_array_ref (state->catlist);
+	if (category_apps != NULL)
+		*category_apps = g_ptr_array_ref (state->category_apps);
+	return TRUE;
+}
+
+/******************************************************************************/
+
 static void
 gs_plugin_loader_app_refine_thread_cb (GTask *task,
 				       gpointer object,
@@ -2842,29 +4706,114 @@ out:
 }
 
 /**
- * gs_plugin_loader_app_refine_async:
+ * gs_plugin_loader_app_refine_async:
+ *
+ * This method calls all plugins that implement the gs_plugin_refine()
+ * function.
+ **/
+void
+gs_plugin_loader_app_refine_async (GsPluginLoader *plugin_loader,
+				   GsApp *app,
+				   GsPluginRefineFlags flags,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer user_data)
+{
+	GsPluginLoaderAsyncState *state;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+	g_return_if_fail (GS_IS_APP (app));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	/* save state */
+	state = g_slice_new0 (GsPluginLoaderAsyncState);
+	state->app = g_object_ref (app);
+	state->flags = flags;
+	state->action = GS_PLUGIN_ACTION_REFINE;
+
+	/* enforce this */
+	if (state->flags & GS_PLUGIN_REFINE_FLAGS_REQUIRE_KEY_COLORS)
+		state->flags |= GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON;
+
+	/* run in a thread */
+	task = g_task_new (plugin_loader, cancellable, callback, user_data);
+	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_app_refine_thread_cb);
+}
+
+/**
+ * gs_plugin_loader_app_refine_finish:
+ *
+ * Return value: success
+ **/
+gboolean
+gs_plugin_loader_app_refine_finish (GsPluginLoader *plugin_loader,
+				    GAsyncResult *res,
+				    GError **error)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), FALSE);
+	g_return_val_if_fail (G_IS_TASK (res), FALSE);
+	g_return_val_if_fail (g_task_is_valid (res, plugin_loader), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+/******************************************************************************/
+
+static void
+gs_plugin_loader_refine_thread_cb (GTask *task,
+				   gpointer object,
+				   gpointer task_data,
+				   GCancellable *cancellable)
+{
+	GError *error = NULL;
+	GsPluginLoaderAsyncState *state = (GsPluginLoaderAsyncState *) task_data;
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	gboolean ret;
+
+	ret = gs_plugin_loader_run_refine (plugin_loader,
+					   NULL,
+					   state->list,
+					   state->flags,
+					   cancellable,
+					   &error);
+	if (!ret) {
+		g_task_return_error (task, error);
+		return;
+	}
+
+	/* success */
+	g_task_return_pointer (task, g_object_ref (state->list), (GDestroyNotify) g_object_unref);
+}
+
+/**
+ * gs_plugin_loader_refine_async:
  *
  * This method calls all plugins that implement the gs_plugin_refine()
- * function.
+ * function for every application in the list in one batch, which is
+ * much cheaper than calling gs_plugin_loader_app_refine_async() for
+ * each application in turn.
  **/
 void
-gs_plugin_loader_app_refine_async (GsPluginLoader *plugin_loader,
-				   GsApp *app,
-				   GsPluginRefineFlags flags,
-				   GCancellable *cancellable,
-				   GAsyncReadyCallback callback,
-				   gpointer user_data)
+gs_plugin_loader_refine_async (GsPluginLoader *plugin_loader,
+			       GsAppList *list,
+			       GsPluginRefineFlags flags,
+			       GCancellable *cancellable,
+			       GAsyncReadyCallback callback,
+			       gpointer user_data)
 {
 	GsPluginLoaderAsyncState *state;
 	g_autoptr(GTask) task = NULL;
 
 	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
-	g_return_if_fail (GS_IS_APP (app));
+	g_return_if_fail (GS_IS_APP_LIST (list));
 	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
 
 	/* save state */
 	state = g_slice_new0 (GsPluginLoaderAsyncState);
-	state->app = g_object_ref (app);
+	state->list = gs_app_list_copy (list);
 	state->flags = flags;
 	state->action = GS_PLUGIN_ACTION_REFINE;
 
@@ -2875,29 +4824,108 @@ gs_plugin_loader_app_refine_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_app_refine_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_refine_thread_cb);
 }
 
 /**
- * gs_plugin_loader_app_refine_finish:
+ * gs_plugin_loader_refine_finish:
  *
- * Return value: success
+ * Return value: (element-type GsApp) (transfer full): A list of applications
  **/
-gboolean
-gs_plugin_loader_app_refine_finish (GsPluginLoader *plugin_loader,
-				    GAsyncResult *res,
-				    GError **error)
+GsAppList *
+gs_plugin_loader_refine_finish (GsPluginLoader *plugin_loader,
+				GAsyncResult *res,
+				GError **error)
 {
-	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), FALSE);
-	g_return_val_if_fail (G_IS_TASK (res), FALSE);
-	g_return_val_if_fail (g_task_is_valid (res, plugin_loader), FALSE);
-	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), NULL);
+	g_return_val_if_fail (G_IS_TASK (res), NULL);
+	g_return_val_if_fail (g_task_is_valid (res, plugin_loader), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	return g_task_propagate_boolean (G_TASK (res), error);
+	gs_utils_error_convert_gio (error);
+	return g_task_propagate_pointer (G_TASK (res), error);
 }
 
 /******************************************************************************/
 
+static gboolean
+gs_plugin_loader_changed_delay_cb (gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (user_data);
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GsChangeSet) changes = NULL;
+
+	/* take everything queued so far */
+	g_mutex_lock (&priv->changes_mutex);
+	changes = priv->changes;
+	priv->changes = NULL;
+	priv->changes_id = 0;
+	g_mutex_unlock (&priv->changes_mutex);
+
+	/* notify shells */
+	if (changes != NULL && !gs_change_set_is_empty (changes)) {
+		g_debug ("emitting ::changed");
+		g_signal_emit (plugin_loader, signals[SIGNAL_CHANGED], 0, changes);
+	}
+
+	g_object_unref (plugin_loader);
+	return FALSE;
+}
+
+/* merge the changes into those not yet emitted, so that a burst of actions
+ * only causes the shell to update once; this can be called from any thread */
+static void
+gs_plugin_loader_queue_changes (GsPluginLoader *plugin_loader,
+				GsChangeSet *changes)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (gs_change_set_is_empty (changes))
+		return;
+	locker = g_mutex_locker_new (&priv->changes_mutex);
+	if (priv->changes == NULL)
+		priv->changes = gs_change_set_new ();
+	gs_change_set_merge (priv->changes, changes);
+	if (priv->changes_id != 0)
+		return;
+	priv->changes_id =
+		g_timeout_add_seconds (GS_PLUGIN_LOADER_CHANGED_DELAY,
+				       gs_plugin_loader_changed_delay_cb,
+				       g_object_ref (plugin_loader));
+}
+
+/* record which apps were changed by a successful action */
+static void
+gs_plugin_loader_queue_app_changes (GsPluginLoader *plugin_loader,
+				    GsPluginAction action,
+				    GsAppList *list)
+{
+	guint i;
+	g_autoptr(GsChangeSet) changes = gs_change_set_new ();
+
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		const gchar *unique_id = gs_app_get_unique_id (app);
+		if (unique_id == NULL)
+			continue;
+		switch (action) {
+		case GS_PLUGIN_ACTION_INSTALL:
+			gs_change_set_add_added (changes, unique_id);
+			break;
+		case GS_PLUGIN_ACTION_REMOVE:
+			gs_change_set_add_removed (changes, unique_id);
+			break;
+		case GS_PLUGIN_ACTION_UPDATE:
+			gs_change_set_add_changed (changes, unique_id);
+			break;
+		default:
+			break;
+		}
+	}
+	gs_plugin_loader_queue_changes (plugin_loader, changes);
+}
+
 static gboolean
 emit_pending_apps_idle (gpointer loader)
 {
@@ -2954,6 +4982,9 @@ gs_plugin_loader_app_action_thread_cb (GTask *task,
 						   cancellable,
 						   &error);
 		if (ret) {
+			gs_plugin_loader_queue_app_changes (plugin_loader,
+							    state->action,
+							    list);
 			g_task_return_boolean (task, TRUE);
 		} else {
 			g_task_return_error (task, error);
@@ -3000,6 +5031,9 @@ gs_plugin_loader_review_action_thread_cb (GTask *task,
 	gboolean ret;
 	guint i;
 
+	/* the reviews are about to change */
+	gs_plugin_loader_app_map_forget (plugin_loader, state->app);
+
 	/* run each plugin */
 	for (i = 0; i < priv->plugins->len; i++) {
 		g_autoptr(AsProfileTask) ptask = NULL;
@@ -3023,10 +5057,13 @@ gs_plugin_loader_review_action_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  state->function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, state->app, state->review,
 				   cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, state->function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -3078,36 +5115,166 @@ gs_plugin_loader_review_action_thread_cb (GTask *task,
 	g_task_return_boolean (task, TRUE);
 }
 
+/* the install queue is a journal of "+app-id" and "-app-id" lines, where a
+ * line without a prefix is an app-id written before the journal was added */
+static gchar *
+gs_plugin_loader_install_queue_filename (void)
+{
+	return g_build_filename (g_get_user_data_dir (),
+				 "gnome-software",
+				 "install-queue",
+				 NULL);
+}
+
+/* rewrite the journal to only contain the queued apps, oldest first */
+static void
+gs_plugin_loader_install_queue_compact (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	guint i;
+	guint live = 0;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GString) s = NULL;
+	g_autofree gchar *file = NULL;
+
+	s = g_string_new ("");
+	g_mutex_lock (&priv->pending_apps_mutex);
+	for (i = 0; i < priv->pending_apps->len; i++) {
+		GsApp *app = g_ptr_array_index (priv->pending_apps, i);
+		if (gs_app_get_state (app) == AS_APP_STATE_QUEUED_FOR_INSTALL) {
+			g_string_append (s, gs_app_get_id (app));
+			g_string_append_c (s, '\n');
+			live++;
+		}
+	}
+	g_mutex_unlock (&priv->pending_apps_mutex);
+
+	/* save file */
+	file = gs_plugin_loader_install_queue_filename ();
+	if (!gs_mkdir_parent (file, &error)) {
+		g_warning ("failed to create dir for %s: %s",
+			   file, error->message);
+		return;
+	}
+	g_debug ("saving install queue to %s", file);
+	if (!g_file_set_contents (file, s->str, (gssize) s->len, &error)) {
+		g_warning ("failed to save install queue: %s", error->message);
+		return;
+	}
+	priv->install_queue_live = live;
+	priv->install_queue_journal_len = live;
+}
+
+static void
+gs_plugin_loader_install_queue_journal (GsPluginLoader *plugin_loader,
+					GsApp *app,
+					gboolean add)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFileOutputStream) stream = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *line = NULL;
+
+	locker = g_mutex_locker_new (&priv->install_queue_mutex);
+	if (add)
+		priv->install_queue_live++;
+	else if (priv->install_queue_live > 0)
+		priv->install_queue_live--;
+
+	/* most of the journal is stale */
+	if (priv->install_queue_journal_len >= 2 * priv->install_queue_live +
+					       GS_PLUGIN_LOADER_INSTALL_QUEUE_SLACK) {
+		gs_plugin_loader_install_queue_compact (plugin_loader);
+		return;
+	}
+
+	/* append one line rather than writing out the whole queue */
+	filename = gs_plugin_loader_install_queue_filename ();
+	if (!gs_mkdir_parent (filename, &error)) {
+		g_warning ("failed to create dir for %s: %s",
+			   filename, error->message);
+		return;
+	}
+	file = g_file_new_for_path (filename);
+	stream = g_file_append_to (file, G_FILE_CREATE_NONE, NULL, &error);
+	if (stream == NULL) {
+		g_warning ("failed to open install queue: %s", error->message);
+		return;
+	}
+	line = g_strdup_printf ("%c%s\n", add ? '+' : '-', gs_app_get_id (app));
+	if (!g_output_stream_write_all (G_OUTPUT_STREAM (stream),
+					line, strlen (line),
+					NULL, NULL, &error)) {
+		g_warning ("failed to save install queue: %s", error->message);
+		return;
+	}
+	priv->install_queue_journal_len++;
+}
+
+static void
+gs_plugin_loader_install_queue_replay (GPtrArray *ids,
+				       const gchar *id,
+				       gboolean add)
+{
+	guint i;
+
+	for (i = 0; i < ids->len; i++) {
+		if (g_strcmp0 (g_ptr_array_index (ids, i), id) == 0) {
+			g_ptr_array_remove_index (ids, i);
+			break;
+		}
+	}
+	if (add)
+		g_ptr_array_add (ids, g_strdup (id));
+}
+
 static gboolean
 load_install_queue (GsPluginLoader *plugin_loader, GError **error)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	gboolean ret = TRUE;
 	guint i;
+	guint journal_len = 0;
 	g_autofree gchar *contents = NULL;
 	g_autofree gchar *file = NULL;
 	g_auto(GStrv) names = NULL;
+	g_autoptr(GPtrArray) ids = NULL;
 	g_autoptr(GsAppList) list = NULL;
 
 	/* load from file */
-	file = g_build_filename (g_get_user_data_dir (),
-				 "gnome-software",
-				 "install-queue",
-				 NULL);
+	file = gs_plugin_loader_install_queue_filename ();
 	if (!g_file_test (file, G_FILE_TEST_EXISTS))
 		return TRUE;
 	g_debug ("loading install queue from %s", file);
 	if (!g_file_get_contents (file, &contents, NULL, error))
 		return FALSE;
 
-	/* add each app-id */
-	list = gs_app_list_new ();
+	/* replay the journal */
+	ids = g_ptr_array_new_with_free_func (g_free);
 	names = g_strsplit (contents, "\n", 0);
 	for (i = 0; names[i]; i++) {
-		g_autoptr(GsApp) app = NULL;
-		if (strlen (names[i]) == 0)
+		const gchar *id = names[i];
+		gboolean add = TRUE;
+		if (id[0] == '+') {
+			id++;
+		} else if (id[0] == '-') {
+			add = FALSE;
+			id++;
+		}
+		if (strlen (id) == 0)
 			continue;
-		app = gs_app_new (names[i]);
+		gs_plugin_loader_install_queue_replay (ids, id, add);
+		journal_len++;
+	}
+
+	/* add each app-id */
+	list = gs_app_list_new ();
+	for (i = 0; i < ids->len; i++) {
+		g_autoptr(GsApp) app = NULL;
+		app = gs_app_new (g_ptr_array_index (ids, i));
 		gs_app_set_state (app, AS_APP_STATE_QUEUED_FOR_INSTALL);
 
 		g_mutex_lock (&priv->pending_apps_mutex);
@@ -3119,6 +5286,14 @@ load_install_queue (GsPluginLoader *plugin_loader, GError **error)
 		gs_app_list_add (list, app);
 	}
 
+	/* start the next session with a short journal */
+	g_mutex_lock (&priv->install_queue_mutex);
+	priv->install_queue_live = ids->len;
+	priv->install_queue_journal_len = journal_len;
+	if (journal_len > ids->len)
+		gs_plugin_loader_install_queue_compact (plugin_loader);
+	g_mutex_unlock (&priv->install_queue_mutex);
+
 	/* refine */
 	if (gs_app_list_length (list) > 0) {
 		ret = gs_plugin_loader_run_refine (plugin_loader,
@@ -3133,46 +5308,6 @@ load_install_queue (GsPluginLoader *plugin_loader, GError **error)
 	return TRUE;
 }
 
-static void
-save_install_queue (GsPluginLoader *plugin_loader)
-{
-	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
-	GPtrArray *pending_apps;
-	gboolean ret;
-	gint i;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GString) s = NULL;
-	g_autofree gchar *file = NULL;
-
-	s = g_string_new ("");
-	pending_apps = priv->pending_apps;
-	g_mutex_lock (&priv->pending_apps_mutex);
-	for (i = (gint) pending_apps->len - 1; i >= 0; i--) {
-		GsApp *app;
-		app = g_ptr_array_index (pending_apps, i);
-		if (gs_app_get_state (app) == AS_APP_STATE_QUEUED_FOR_INSTALL) {
-			g_string_append (s, gs_app_get_id (app));
-			g_string_append_c (s, '\n');
-		}
-	}
-	g_mutex_unlock (&priv->pending_apps_mutex);
-
-	/* save file */
-	file = g_build_filename (g_get_user_data_dir (),
-				 "gnome-software",
-				 "install-queue",
-				 NULL);
-	if (!gs_mkdir_parent (file, &error)) {
-		g_warning ("failed to create dir for %s: %s",
-			   file, error->message);
-		return;
-	}
-	g_debug ("saving install queue to %s", file);
-	ret = g_file_set_contents (file, s->str, (gssize) s->len, &error);
-	if (!ret)
-		g_warning ("failed to save install queue: %s", error->message);
-}
-
 static void
 add_app_to_install_queue (GsPluginLoader *plugin_loader, GsApp *app)
 {
@@ -3189,7 +5324,7 @@ add_app_to_install_queue (GsPluginLoader *plugin_loader, GsApp *app)
 	gs_app_set_state (app, AS_APP_STATE_QUEUED_FOR_INSTALL);
 	id = g_idle_add (emit_pending_apps_idle, g_object_ref (plugin_loader));
 	g_source_set_name_by_id (id, "[gnome-software] emit_pending_apps_idle");
-	save_install_queue (plugin_loader);
+	gs_plugin_loader_install_queue_journal (plugin_loader, app, TRUE);
 
 	/* recursively queue any addons */
 	addons = gs_app_get_addons (app);
@@ -3217,7 +5352,7 @@ remove_app_from_install_queue (GsPluginLoader *plugin_loader, GsApp *app)
 		gs_app_set_state (app, AS_APP_STATE_AVAILABLE);
 		id = g_idle_add (emit_pending_apps_idle, g_object_ref (plugin_loader));
 		g_source_set_name_by_id (id, "[gnome-software] emit_pending_apps_idle");
-		save_install_queue (plugin_loader);
+		gs_plugin_loader_install_queue_journal (plugin_loader, app, FALSE);
 
 		/* recursively remove any queued addons */
 		addons = gs_app_get_addons (app);
@@ -3319,7 +5454,7 @@ gs_plugin_loader_app_action_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_app_action_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_app_action_thread_cb);
 }
 
 void
@@ -3371,7 +5506,7 @@ gs_plugin_loader_review_action_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_review_action_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_review_action_thread_cb);
 }
 
 gboolean
@@ -3428,9 +5563,12 @@ gs_plugin_loader_auth_action_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  state->function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, state->auth, cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, state->function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -3492,7 +5630,7 @@ gs_plugin_loader_auth_action_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_auth_action_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_auth_action_thread_cb);
 }
 
 gboolean
@@ -3573,7 +5711,8 @@ gs_plugin_loader_run (GsPluginLoader *plugin_loader, const gchar *function_name)
 		g_assert (ptask != NULL);
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		plugin_func (plugin);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      TRUE, NULL);
 		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
 }
@@ -3703,6 +5842,9 @@ gs_plugin_loader_updates_changed_delay_cb (gpointer user_data)
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (user_data);
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 
+	/* everything has to be refined again */
+	gs_plugin_loader_app_map_invalidate (plugin_loader);
+
 	/* notify shells */
 	g_debug ("updates-changed");
 	g_signal_emit (plugin_loader, signals[SIGNAL_UPDATES_CHANGED], 0);
@@ -3730,12 +5872,21 @@ gs_plugin_loader_reload_delay_cb (gpointer user_data)
 {
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (user_data);
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GsChangeSet) changes = NULL;
+
+	/* everything has to be refined again */
+	gs_plugin_loader_app_map_invalidate (plugin_loader);
 
 	/* notify shells */
 	g_debug ("emitting ::reload");
 	g_signal_emit (plugin_loader, signals[SIGNAL_RELOAD], 0);
 	priv->reload_id = 0;
 
+	/* plugins do not say what changed, so assume everything did */
+	changes = gs_change_set_new ();
+	gs_change_set_add_kind (changes, GS_CHANGE_SET_KIND_CATALOG);
+	gs_plugin_loader_queue_changes (plugin_loader, changes);
+
 	g_object_unref (plugin_loader);
 	return FALSE;
 }
@@ -3758,57 +5909,243 @@ gs_plugin_loader_open_plugin (GsPluginLoader *plugin_loader,
 			      const gchar *filename)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
-	GsPlugin *plugin;
+	GsPlugin *plugin;
+	g_autoptr(GError) error = NULL;
+
+	/* create plugin from file */
+	plugin = gs_plugin_create (filename, &error);
+	if (plugin == NULL) {
+		g_warning ("Failed to load %s: %s", filename, error->message);
+		return;
+	}
+	g_signal_connect (plugin, "updates-changed",
+			  G_CALLBACK (gs_plugin_loader_updates_changed_cb),
+			  plugin_loader);
+	g_signal_connect (plugin, "reload",
+			  G_CALLBACK (gs_plugin_loader_reload_cb),
+			  plugin_loader);
+	g_signal_connect (plugin, "status-changed",
+			  G_CALLBACK (gs_plugin_loader_status_changed_cb),
+			  plugin_loader);
+	gs_plugin_set_soup_session (plugin, priv->soup_session);
+	gs_plugin_set_auth_array (plugin, priv->auth_array);
+	gs_plugin_set_profile (plugin, priv->profile);
+	gs_plugin_set_locale (plugin, priv->locale);
+	gs_plugin_set_language (plugin, priv->language);
+	gs_plugin_set_scale (plugin, gs_plugin_loader_get_scale (plugin_loader));
+	gs_plugin_set_global_cache (plugin, priv->global_cache);
+	gs_plugin_set_file_watcher (plugin, priv->file_watcher);
+	g_debug ("opened plugin %s: %s", filename, gs_plugin_get_name (plugin));
+
+	/* add to array */
+	g_ptr_array_add (priv->plugins, plugin);
+}
+
+void
+gs_plugin_loader_set_scale (GsPluginLoader *plugin_loader, guint scale)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPlugin *plugin;
+	guint i;
+
+	/* save globally, and update each plugin */
+	priv->scale = scale;
+	for (i = 0; i < priv->plugins->len; i++) {
+		plugin = g_ptr_array_index (priv->plugins, i);
+		gs_plugin_set_scale (plugin, scale);
+	}
+}
+
+guint
+gs_plugin_loader_get_scale (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	return priv->scale;
+}
+
+static gboolean
+gs_plugin_loader_is_setup_pending (GsPluginLoader *plugin_loader,
+				   GsPlugin *plugin)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	guint i;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->setup_lazy_mutex);
+
+	for (i = 0; i < priv->setup_lazy->len; i++) {
+		if (g_ptr_array_index (priv->setup_lazy, i) == plugin)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+gs_plugin_loader_locale_changed_thread_cb (GTask *task,
+					   gpointer object,
+					   gpointer task_data,
+					   GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginSetupFunc plugin_func = NULL;
+	const gchar *function_name = "gs_plugin_locale_changed";
+	gboolean ret;
+	guint i;
 	g_autoptr(GError) error = NULL;
 
-	/* create plugin from file */
-	plugin = gs_plugin_create (filename, &error);
-	if (plugin == NULL) {
-		g_warning ("Failed to load %s: %s", filename, error->message);
-		return;
+	for (i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		g_autoptr(AsProfileTask) ptask = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		if (!gs_plugin_get_enabled (plugin))
+			continue;
+
+		/* not set up yet, so it will use the new locale anyway */
+		if (gs_plugin_loader_is_setup_pending (plugin_loader, plugin))
+			continue;
+
+		ret = g_module_symbol (gs_plugin_get_module (plugin),
+				       function_name,
+				       (gpointer *) &plugin_func);
+		if (!ret)
+			continue;
+		ptask = as_profile_start (priv->profile,
+					  "GsPlugin::%s(%s)",
+					  gs_plugin_get_name (plugin),
+					  function_name);
+		g_assert (ptask != NULL);
+
+		/* nothing else can use the metadata while it is reloaded */
+		gs_plugin_loader_action_start (plugin_loader, plugin, TRUE);
+		ret = plugin_func (plugin, cancellable, &error_local);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
+		if (!ret) {
+			/* badly behaved plugin */
+			if (error_local == NULL) {
+				g_critical ("%s did not set error for %s",
+					    gs_plugin_get_name (plugin),
+					    function_name);
+				continue;
+			}
+			g_warning ("failed to change locale for %s: %s",
+				   gs_plugin_get_name (plugin),
+				   error_local->message);
+
+			/* try the other plugins, but report the first error */
+			if (error == NULL)
+				error = g_steal_pointer (&error_local);
+		}
 	}
-	g_signal_connect (plugin, "updates-changed",
-			  G_CALLBACK (gs_plugin_loader_updates_changed_cb),
-			  plugin_loader);
-	g_signal_connect (plugin, "reload",
-			  G_CALLBACK (gs_plugin_loader_reload_cb),
-			  plugin_loader);
-	g_signal_connect (plugin, "status-changed",
-			  G_CALLBACK (gs_plugin_loader_status_changed_cb),
-			  plugin_loader);
-	gs_plugin_set_soup_session (plugin, priv->soup_session);
-	gs_plugin_set_auth_array (plugin, priv->auth_array);
-	gs_plugin_set_profile (plugin, priv->profile);
-	gs_plugin_set_locale (plugin, priv->locale);
-	gs_plugin_set_language (plugin, priv->language);
-	gs_plugin_set_scale (plugin, gs_plugin_loader_get_scale (plugin_loader));
-	gs_plugin_set_global_cache (plugin, priv->global_cache);
-	g_debug ("opened plugin %s: %s", filename, gs_plugin_get_name (plugin));
 
-	/* add to array */
-	g_ptr_array_add (priv->plugins, plugin);
+	/* the refined apps have the old translations */
+	gs_plugin_loader_app_map_invalidate (plugin_loader);
+
+	if (error != NULL) {
+		g_task_return_error (task, g_steal_pointer (&error));
+		return;
+	}
+	g_task_return_boolean (task, TRUE);
 }
 
+/**
+ * gs_plugin_loader_set_locale_async:
+ * @plugin_loader: a #GsPluginLoader
+ * @locale: a locale string, e.g. "en_GB"
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: function to call when complete
+ * @user_data: user data
+ *
+ * Changes the locale used by all the plugins. Plugins that only keep the
+ * translations for the current locale load their metadata again in a
+ * thread, and ask for the shells to be reloaded when done.
+ **/
 void
-gs_plugin_loader_set_scale (GsPluginLoader *plugin_loader, guint scale)
+gs_plugin_loader_set_locale_async (GsPluginLoader *plugin_loader,
+				   const gchar *locale,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer user_data)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	GsPlugin *plugin;
+	gchar *match;
 	guint i;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+	g_return_if_fail (locale != NULL);
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	task = g_task_new (plugin_loader, cancellable, callback, user_data);
+	if (g_strcmp0 (priv->locale, locale) == 0) {
+		g_task_return_boolean (task, TRUE);
+		return;
+	}
 
 	/* save globally, and update each plugin */
-	priv->scale = scale;
+	g_free (priv->locale);
+	priv->locale = g_strdup (locale);
+	g_free (priv->language);
+	priv->language = g_strdup (locale);
+	match = g_strrstr (priv->language, "_");
+	if (match != NULL)
+		*match = '\0';
+	g_debug ("changing locale to %s [%s]", priv->locale, priv->language);
 	for (i = 0; i < priv->plugins->len; i++) {
 		plugin = g_ptr_array_index (priv->plugins, i);
-		gs_plugin_set_scale (plugin, scale);
+		gs_plugin_set_locale (plugin, priv->locale);
+		gs_plugin_set_language (plugin, priv->language);
 	}
+
+	/* reload any metadata in the background */
+	gs_plugin_loader_run_in_thread (plugin_loader, task,
+					gs_plugin_loader_locale_changed_thread_cb);
 }
 
+/**
+ * gs_plugin_loader_set_locale_finish:
+ *
+ * Return value: success
+ **/
+gboolean
+gs_plugin_loader_set_locale_finish (GsPluginLoader *plugin_loader,
+				    GAsyncResult *res,
+				    GError **error)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), FALSE);
+	g_return_val_if_fail (G_IS_TASK (res), FALSE);
+	g_return_val_if_fail (g_task_is_valid (res, plugin_loader), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	gs_utils_error_convert_gio (error);
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+/**
+ * gs_plugin_loader_get_updates_serial:
+ * @plugin_loader: a #GsPluginLoader
+ *
+ * Gets a number that changes every time any plugin says the list of
+ * updates may have changed. Comparing it with an earlier value is a very
+ * cheap way to find out if gs_plugin_loader_get_updates_async() would
+ * return anything different.
+ *
+ * Returns: an integer
+ **/
 guint
-gs_plugin_loader_get_scale (GsPluginLoader *plugin_loader)
+gs_plugin_loader_get_updates_serial (GsPluginLoader *plugin_loader)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
-	return priv->scale;
+	guint serial = 0;
+	guint i;
+
+	/* each plugin counter only ever goes up */
+	for (i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		serial += gs_plugin_get_updates_serial (plugin);
+	}
+	return serial;
 }
 
 GsAuth *
@@ -3869,11 +6206,12 @@ gs_plugin_loader_plugin_sort_fn (gconstpointer a, gconstpointer b)
  *
  * Returns: %TRUE for success
  */
-gboolean
-gs_plugin_loader_setup (GsPluginLoader *plugin_loader,
-			gchar **whitelist,
-			gchar **blacklist,
-			GError **error)
+/* open and order the plugins, which is quick enough for the main thread */
+static gboolean
+gs_plugin_loader_setup_prepare (GsPluginLoader *plugin_loader,
+				gchar **whitelist,
+				gchar **blacklist,
+				GError **error)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	const gchar *filename_tmp;
@@ -4082,50 +6420,94 @@ gs_plugin_loader_setup (GsPluginLoader *plugin_loader,
 		}
 	} while (changes);
 
-	/* run setup */
-	for (i = 0; i < priv->plugins->len; i++) {
-		GsPluginSetupFunc plugin_func = NULL;
-		const gchar *function_name = "gs_plugin_setup";
-		gboolean ret;
-		g_autoptr(AsProfileTask) ptask2 = NULL;
-		g_autoptr(GError) error_local = NULL;
+	return TRUE;
+}
 
-		/* run setup() if it exists */
-		plugin = g_ptr_array_index (priv->plugins, i);
-		if (!gs_plugin_get_enabled (plugin))
+typedef struct {
+	GsPluginLoader		*plugin_loader;
+	GCancellable		*cancellable;
+} GsPluginLoaderSetupHelper;
+
+static void
+gs_plugin_loader_setup_plugin_cb (gpointer data, gpointer user_data)
+{
+	GsPluginLoaderSetupHelper *helper = (GsPluginLoaderSetupHelper *) user_data;
+	gs_plugin_loader_setup_plugin (helper->plugin_loader,
+				       GS_PLUGIN (data),
+				       helper->cancellable);
+}
+
+/* plugins with the same order do not depend on each other, and so each
+ * group of them is set up in parallel, one group after another */
+static void
+gs_plugin_loader_setup_plugins (GsPluginLoader *plugin_loader,
+				GCancellable *cancellable)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderSetupHelper helper;
+	guint i = 0;
+	guint j;
+
+	helper.plugin_loader = plugin_loader;
+	helper.cancellable = cancellable;
+	while (i < priv->plugins->len) {
+		GThreadPool *pool;
+		guint order = gs_plugin_get_order (g_ptr_array_index (priv->plugins, i));
+		g_autoptr(GPtrArray) group = g_ptr_array_new ();
+
+		for (; i < priv->plugins->len; i++) {
+			GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+			if (gs_plugin_get_order (plugin) != order)
+				break;
+			if (!gs_plugin_get_enabled (plugin))
+				continue;
+			if (gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_SETUP_ON_DEMAND)) {
+				g_debug ("not setting up %s until first use",
+					 gs_plugin_get_name (plugin));
+				g_mutex_lock (&priv->setup_lazy_mutex);
+				g_ptr_array_add (priv->setup_lazy, plugin);
+				g_mutex_unlock (&priv->setup_lazy_mutex);
+				continue;
+			}
+			g_ptr_array_add (group, plugin);
+		}
+		if (group->len == 0)
 			continue;
-		ret = g_module_symbol (gs_plugin_get_module (plugin),
-				       function_name,
-				       (gpointer *) &plugin_func);
-		if (!ret)
+		if (group->len == 1) {
+			gs_plugin_loader_setup_plugin_cb (g_ptr_array_index (group, 0),
+							  &helper);
 			continue;
-		ptask2 = as_profile_start (priv->profile,
-					   "GsPlugin::%s(%s)",
-					   gs_plugin_get_name (plugin),
-					   function_name);
-		g_assert (ptask2 != NULL);
-		gs_plugin_loader_action_start (plugin_loader, plugin, TRUE);
-		ret = plugin_func (plugin, NULL, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
-		if (!ret) {
-			/* badly behaved plugin */
-			if (error_local == NULL) {
-				g_critical ("%s did not set error for %s",
-					    gs_plugin_get_name (plugin),
-					    function_name);
-			} else {
-				g_debug ("disabling %s as setup failed: %s",
-					 gs_plugin_get_name (plugin),
-					 error_local->message);
-				gs_plugin_loader_create_event_from_error (plugin_loader,
-									  GS_PLUGIN_ACTION_SETUP,
-									  plugin,
-									  NULL, /* app */
-									  error_local);
-			}
-			gs_plugin_set_enabled (plugin, FALSE);
 		}
+		pool = g_thread_pool_new (gs_plugin_loader_setup_plugin_cb,
+					  &helper, (gint) group->len,
+					  FALSE, NULL);
+		for (j = 0; j < group->len; j++)
+			g_thread_pool_push (pool, g_ptr_array_index (group, j), NULL);
+		g_thread_pool_free (pool, FALSE, TRUE);
 	}
+}
+
+/**
+ * gs_plugin_loader_setup:
+ * @plugin_loader: a #GsPluginLoader
+ * @whitelist: (allow-none): plugin names to use, or %NULL
+ * @blacklist: (allow-none): plugin names to disable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Loads and sets up all the plugins, blocking until they are ready.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+gs_plugin_loader_setup (GsPluginLoader *plugin_loader,
+			gchar **whitelist,
+			gchar **blacklist,
+			GError **error)
+{
+	if (!gs_plugin_loader_setup_prepare (plugin_loader, whitelist,
+					     blacklist, error))
+		return FALSE;
+	gs_plugin_loader_setup_plugins (plugin_loader, NULL);
 
 	/* now we can load the install-queue */
 	if (!load_install_queue (plugin_loader, error))
@@ -4133,6 +6515,105 @@ gs_plugin_loader_setup (GsPluginLoader *plugin_loader,
 	return TRUE;
 }
 
+static void
+gs_plugin_loader_setup_thread_cb (GTask *task,
+				  gpointer object,
+				  gpointer task_data,
+				  GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GError *error = NULL;
+	guint i;
+	g_autoptr(GPtrArray) queue = NULL;
+
+	gs_plugin_loader_setup_plugins (plugin_loader, cancellable);
+	if (!load_install_queue (plugin_loader, &error))
+		g_warning ("failed to load install queue: %s", error->message);
+
+	/* start anything that was waiting for the plugins */
+	g_mutex_lock (&priv->setup_mutex);
+	queue = g_steal_pointer (&priv->setup_queue);
+	g_mutex_unlock (&priv->setup_mutex);
+	for (i = 0; i < queue->len; i++) {
+		GsPluginLoaderQueued *queued = g_ptr_array_index (queue, i);
+		g_task_run_in_thread (queued->task, queued->func);
+		g_object_unref (queued->task);
+		g_free (queued);
+	}
+
+	if (error != NULL) {
+		g_task_return_error (task, error);
+		return;
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * gs_plugin_loader_setup_async:
+ * @plugin_loader: a #GsPluginLoader
+ * @whitelist: (allow-none): plugin names to use, or %NULL
+ * @blacklist: (allow-none): plugin names to disable, or %NULL
+ * @cancellable: a #GCancellable, or %NULL
+ * @callback: function to call when complete
+ * @user_data: user data to pass to @callback
+ *
+ * Loads the plugins and orders them straight away, then sets them up in
+ * a thread. Other actions can be started as soon as this returns, and
+ * will be run when the plugins are ready.
+ **/
+void
+gs_plugin_loader_setup_async (GsPluginLoader *plugin_loader,
+			      gchar **whitelist,
+			      gchar **blacklist,
+			      GCancellable *cancellable,
+			      GAsyncReadyCallback callback,
+			      gpointer user_data)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GError *error = NULL;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+	g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+	task = g_task_new (plugin_loader, cancellable, callback, user_data);
+	if (!gs_plugin_loader_setup_prepare (plugin_loader, whitelist,
+					     blacklist, &error)) {
+		g_task_return_error (task, error);
+		return;
+	}
+
+	/* hold back other actions until the plugins are set up */
+	g_mutex_lock (&priv->setup_mutex);
+	priv->setup_queue = g_ptr_array_new ();
+	g_mutex_unlock (&priv->setup_mutex);
+	g_task_run_in_thread (task, gs_plugin_loader_setup_thread_cb);
+}
+
+/**
+ * gs_plugin_loader_setup_finish:
+ * @plugin_loader: a #GsPluginLoader
+ * @res: a #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Gets the result from gs_plugin_loader_setup_async().
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+gs_plugin_loader_setup_finish (GsPluginLoader *plugin_loader,
+			       GAsyncResult *res,
+			       GError **error)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), FALSE);
+	g_return_val_if_fail (G_IS_TASK (res), FALSE);
+	g_return_val_if_fail (g_task_is_valid (res, plugin_loader), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
 void
 gs_plugin_loader_dump_state (GsPluginLoader *plugin_loader)
 {
@@ -4183,8 +6664,14 @@ gs_plugin_loader_dispose (GObject *object)
 {
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	guint i;
 
 	if (priv->plugins != NULL) {
+		/* no callbacks once the plugin data has been freed */
+		for (i = 0; i < priv->plugins->len; i++) {
+			GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+			gs_file_watcher_remove_plugin (priv->file_watcher, plugin);
+		}
 		gs_plugin_loader_run (plugin_loader, "gs_plugin_destroy");
 		g_clear_pointer (&priv->plugins, g_ptr_array_unref);
 	}
@@ -4192,6 +6679,11 @@ gs_plugin_loader_dispose (GObject *object)
 		g_source_remove (priv->updates_changed_id);
 		priv->updates_changed_id = 0;
 	}
+	if (priv->changes_id != 0) {
+		g_source_remove (priv->changes_id);
+		priv->changes_id = 0;
+	}
+	g_clear_object (&priv->changes);
 	g_clear_object (&priv->soup_session);
 	g_clear_object (&priv->profile);
 	g_clear_object (&priv->settings);
@@ -4207,15 +6699,26 @@ gs_plugin_loader_finalize (GObject *object)
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 
-	g_strfreev (priv->compatible_projects);
+	g_free (priv->compatible_projects);
 	g_free (priv->location);
 	g_free (priv->locale);
 	g_free (priv->language);
 	g_object_unref (priv->global_cache);
+	g_object_unref (priv->file_watcher);
 	g_hash_table_unref (priv->events_by_id);
 
 	g_mutex_clear (&priv->pending_apps_mutex);
+	g_mutex_clear (&priv->install_queue_mutex);
 	g_mutex_clear (&priv->events_by_id_mutex);
+	g_hash_table_unref (priv->stats);
+	g_mutex_clear (&priv->stats_mutex);
+	g_ptr_array_unref (priv->setup_lazy);
+	g_mutex_clear (&priv->setup_mutex);
+	g_mutex_clear (&priv->setup_lazy_mutex);
+	g_hash_table_unref (priv->app_map);
+	g_hash_table_unref (priv->app_map_ids);
+	g_mutex_clear (&priv->app_map_mutex);
+	g_mutex_clear (&priv->changes_mutex);
 
 	G_OBJECT_CLASS (gs_plugin_loader_parent_class)->finalize (object);
 }
@@ -4260,6 +6763,31 @@ gs_plugin_loader_class_init (GsPluginLoaderClass *klass)
 			      G_STRUCT_OFFSET (GsPluginLoaderClass, reload),
 			      NULL, NULL, g_cclosure_marshal_VOID__VOID,
 			      G_TYPE_NONE, 0);
+	signals [SIGNAL_CHANGED] =
+		g_signal_new ("changed",
+			      G_TYPE_FROM_CLASS (object_class), G_SIGNAL_RUN_LAST,
+			      G_STRUCT_OFFSET (GsPluginLoaderClass, changed),
+			      NULL, NULL, g_cclosure_marshal_VOID__OBJECT,
+			      G_TYPE_NONE, 1, GS_TYPE_CHANGE_SET);
+}
+
+static void
+gs_plugin_loader_settings_changed_cb (GSettings *settings,
+				      const gchar *key,
+				      GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GsChangeSet) changes = NULL;
+
+	if (g_strcmp0 (key, "content-age-limit") == 0) {
+		g_atomic_int_set (&priv->content_age_limit,
+				  (gint) g_settings_get_uint (settings, key));
+
+		/* results already shown were filtered with the old limit */
+		changes = gs_change_set_new ();
+		gs_change_set_add_kind (changes, GS_CHANGE_SET_KIND_CATALOG);
+		gs_plugin_loader_queue_changes (plugin_loader, changes);
+	}
 }
 
 static void
@@ -4268,21 +6796,35 @@ gs_plugin_loader_init (GsPluginLoader *plugin_loader)
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	const gchar *tmp;
 	gchar *match;
-	gchar **projects;
 	guint i;
+	g_auto(GStrv) projects = NULL;
 
 	priv->scale = 1;
 	priv->global_cache = gs_app_list_new ();
+	priv->file_watcher = gs_file_watcher_new ();
 	priv->plugins = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
 	priv->status_last = GS_PLUGIN_STATUS_LAST;
 	priv->pending_apps = g_ptr_array_new_with_free_func ((GFreeFunc) g_object_unref);
 	priv->auth_array = g_ptr_array_new_with_free_func ((GFreeFunc) g_object_unref);
 	priv->profile = as_profile_new ();
 	priv->settings = g_settings_new ("org.gnome.software");
+	priv->content_age_limit = (gint) g_settings_get_uint (priv->settings,
+							      "content-age-limit");
+	g_signal_connect (priv->settings, "changed",
+			  G_CALLBACK (gs_plugin_loader_settings_changed_cb),
+			  plugin_loader);
 	priv->events_by_id = g_hash_table_new_full ((GHashFunc) as_utils_unique_id_hash,
 					            (GEqualFunc) as_utils_unique_id_equal,
 						    g_free,
 						    (GDestroyNotify) g_object_unref);
+	priv->stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+					     (GDestroyNotify) gs_plugin_loader_stat_free);
+	priv->setup_lazy = g_ptr_array_new ();
+	priv->app_map = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+					       (GDestroyNotify) gs_plugin_loader_app_map_item_free);
+	priv->app_map_ids = g_hash_table_new_full (g_str_hash, g_str_equal,
+						   g_free, g_free);
+	priv->app_map_prune = GS_PLUGIN_LOADER_APP_MAP_PRUNE_MIN;
 
 	/* share a soup session (also disable the double-compression) */
 	priv->soup_session = soup_session_new_with_options (SOUP_SESSION_USER_AGENT, gs_user_agent (),
@@ -4313,7 +6855,11 @@ gs_plugin_loader_init (GsPluginLoader *plugin_loader)
 		*match = '\0';
 
 	g_mutex_init (&priv->pending_apps_mutex);
+	g_mutex_init (&priv->install_queue_mutex);
 	g_mutex_init (&priv->events_by_id_mutex);
+	g_mutex_init (&priv->stats_mutex);
+	g_mutex_init (&priv->app_map_mutex);
+	g_mutex_init (&priv->changes_mutex);
 
 	/* by default we only show project-less apps or compatible projects */
 	tmp = g_getenv ("GNOME_SOFTWARE_COMPATIBLE_PROJECTS");
@@ -4323,9 +6869,11 @@ gs_plugin_loader_init (GsPluginLoader *plugin_loader)
 	} else {
 		projects = g_strsplit (tmp, ",", -1);
 	}
-	for (i = 0; projects[i] != NULL; i++)
+	priv->compatible_projects = g_new0 (const gchar *, g_strv_length (projects) + 1);
+	for (i = 0; projects[i] != NULL; i++) {
 		g_debug ("compatible-project: %s", projects[i]);
-	priv->compatible_projects = projects;
+		priv->compatible_projects[i] = g_intern_string (projects[i]);
+	}
 }
 
 /**
@@ -4341,24 +6889,309 @@ gs_plugin_loader_new (void)
 	return GS_PLUGIN_LOADER (plugin_loader);
 }
 
+typedef struct {
+	GsPlugin		*plugin;	/* with gs_plugin_install_apps(), or NULL */
+	GsAppList		*list;
+} GsPluginLoaderInstallGroup;
+
+typedef struct {
+	GsPluginLoader		*plugin_loader;
+	GCancellable		*cancellable;
+} GsPluginLoaderInstallHelper;
+
+static void
+gs_plugin_loader_install_group_free (GsPluginLoaderInstallGroup *group)
+{
+	g_object_unref (group->list);
+	g_free (group);
+}
+
+static void
+gs_plugin_loader_install_queue_batch (GsPluginLoader *plugin_loader,
+				      GsPlugin *plugin,
+				      GsAppList *list,
+				      GCancellable *cancellable)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginUpdateFunc plugin_func = NULL;
+	const gchar *function_name = "gs_plugin_install_apps";
+	gboolean ret;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	if (!g_module_symbol (gs_plugin_get_module (plugin),
+			      function_name,
+			      (gpointer *) &plugin_func))
+		return;
+	ptask = as_profile_start (priv->profile,
+				  "GsPlugin::%s(%s)",
+				  gs_plugin_get_name (plugin),
+				  function_name);
+	g_assert (ptask != NULL);
+	if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+		return;
+	gs_plugin_loader_app_map_forget_list (plugin_loader, list);
+	gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
+	ret = plugin_func (plugin, list, cancellable, &error_local);
+	gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+				      ret, error_local);
+	gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
+	if (!ret) {
+		/* badly behaved plugin */
+		if (error_local == NULL) {
+			g_critical ("%s did not set error for %s",
+				    gs_plugin_get_name (plugin),
+				    function_name);
+			return;
+		}
+		g_warning ("failed to call %s on %s, retrying each app: %s",
+			   function_name,
+			   gs_plugin_get_name (plugin),
+			   error_local->message);
+	}
+}
+
+static gboolean
+gs_plugin_loader_has_event_for_app (GsPluginLoader *plugin_loader, GsApp *app)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->events_by_id_mutex);
+	return g_hash_table_contains (priv->events_by_id, gs_app_get_unique_id (app));
+}
+
+static void
+gs_plugin_loader_install_queue_app (GsPluginLoader *plugin_loader,
+				    GsApp *app,
+				    GCancellable *cancellable)
+{
+	GsPlugin *plugin;
+	g_autoptr(GError) error_local = NULL;
+
+	/* a failed transaction may have left the app mid-install */
+	if (gs_app_get_state (app) == AS_APP_STATE_INSTALLING)
+		gs_app_set_state_recover (app);
+	if (gs_app_get_state (app) == AS_APP_STATE_INSTALLED)
+		return;
+	if (gs_plugin_loader_run_action (plugin_loader,
+					 app,
+					 GS_PLUGIN_ACTION_INSTALL,
+					 "gs_plugin_app_install",
+					 cancellable,
+					 &error_local)) {
+		if (gs_app_get_state (app) == AS_APP_STATE_INSTALLED)
+			return;
+		g_set_error (&error_local,
+			     GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_FAILED,
+			     "no plugin installed %s",
+			     gs_app_get_unique_id (app));
+	}
+	if (gs_app_get_state (app) == AS_APP_STATE_INSTALLING)
+		gs_app_set_state_recover (app);
+	if (g_error_matches (error_local, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
+		return;
+	g_warning ("failed to install %s: %s",
+		   gs_app_get_unique_id (app),
+		   error_local->message);
+
+	/* the plugins that failed have already added their own event */
+	if (error_local->domain != GS_PLUGIN_ERROR)
+		return;
+	if (g_error_matches (error_local, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_NOT_SUPPORTED) &&
+	    gs_plugin_loader_has_event_for_app (plugin_loader, app))
+		return;
+	plugin = gs_plugin_loader_find_plugin (plugin_loader,
+					       gs_app_get_management_plugin (app));
+	if (plugin == NULL)
+		return;
+	gs_plugin_loader_create_event_from_error (plugin_loader,
+						  GS_PLUGIN_ACTION_INSTALL,
+						  plugin,
+						  app,
+						  error_local);
+}
+
+static void
+gs_plugin_loader_install_queue_group_cb (gpointer data, gpointer user_data)
+{
+	GsPluginLoaderInstallGroup *group = (GsPluginLoaderInstallGroup *) data;
+	GsPluginLoaderInstallHelper *helper = (GsPluginLoaderInstallHelper *) user_data;
+	GsPluginLoader *plugin_loader = helper->plugin_loader;
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	guint i;
+	guint j;
+
+	/* the plugins only know how to install available apps */
+	for (i = 0; i < gs_app_list_length (group->list); i++) {
+		GsApp *app = gs_app_list_index (group->list, i);
+		if (gs_app_get_state (app) == AS_APP_STATE_QUEUED_FOR_INSTALL)
+			gs_app_set_state (app, AS_APP_STATE_AVAILABLE);
+	}
+
+	/* one transaction for all the apps the plugin can batch, then one
+	 * per app for the rest, or for all of them if the transaction
+	 * failed, so that a single broken app does not fail the group */
+	if (group->plugin != NULL) {
+		gs_plugin_loader_install_queue_batch (plugin_loader,
+						      group->plugin,
+						      group->list,
+						      helper->cancellable);
+	}
+	for (i = 0; i < gs_app_list_length (group->list); i++) {
+		GsApp *app = gs_app_list_index (group->list, i);
+		if (g_cancellable_is_cancelled (helper->cancellable))
+			break;
+		gs_plugin_loader_install_queue_app (plugin_loader,
+						    app,
+						    helper->cancellable);
+	}
+
+	for (i = 0; i < gs_app_list_length (group->list); i++) {
+		GsApp *app = gs_app_list_index (group->list, i);
+		GPtrArray *addons;
+
+		/* keep the failed apps queued for the next time we are online */
+		if (gs_app_get_state (app) != AS_APP_STATE_INSTALLED) {
+			if (gs_app_get_state (app) == AS_APP_STATE_INSTALLING) {
+				g_warning ("application %s left in %s state",
+					   gs_app_get_unique_id (app),
+					   as_app_state_to_string (gs_app_get_state (app)));
+				gs_app_set_state (app, AS_APP_STATE_UNKNOWN);
+			}
+			if (gs_app_get_state (app) == AS_APP_STATE_AVAILABLE ||
+			    gs_app_get_state (app) == AS_APP_STATE_UNKNOWN) {
+				gs_app_set_state (app, AS_APP_STATE_QUEUED_FOR_INSTALL);
+				continue;
+			}
+			g_debug ("%s is now %s, so no longer queued",
+				 gs_app_get_unique_id (app),
+				 as_app_state_to_string (gs_app_get_state (app)));
+		} else {
+			addons = gs_app_get_addons (app);
+			for (j = 0; j < addons->len; j++) {
+				GsApp *addon = g_ptr_array_index (addons, j);
+				if (gs_app_get_to_be_installed (addon))
+					gs_app_set_to_be_installed (addon, FALSE);
+			}
+		}
+		g_mutex_lock (&priv->pending_apps_mutex);
+		g_ptr_array_remove (priv->pending_apps, app);
+		g_mutex_unlock (&priv->pending_apps_mutex);
+		gs_plugin_loader_install_queue_journal (plugin_loader, app, FALSE);
+	}
+	g_idle_add (emit_pending_apps_idle, g_object_ref (plugin_loader));
+}
+
+/* install the apps queued while offline, grouped by the plugin managing them
+ * so that each group can be installed in one transaction, and the groups in
+ * parallel */
+static void
+gs_plugin_loader_install_queue_thread_cb (GTask *task,
+					  gpointer object,
+					  gpointer task_data,
+					  GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderInstallHelper helper;
+	GHashTableIter iter;
+	GThreadPool *pool;
+	gpointer value;
+	guint i;
+	guint max_threads;
+	g_autoptr(GHashTable) groups = NULL;
+	g_autoptr(GsAppList) queue = gs_app_list_new ();
+	g_autoptr(GsAppList) installed = gs_app_list_new ();
+	g_autoptr(GError) error = NULL;
+
+	g_mutex_lock (&priv->pending_apps_mutex);
+	for (i = 0; i < priv->pending_apps->len; i++) {
+		GsApp *app = g_ptr_array_index (priv->pending_apps, i);
+		if (gs_app_get_state (app) == AS_APP_STATE_QUEUED_FOR_INSTALL)
+			gs_app_list_add (queue, app);
+	}
+	g_mutex_unlock (&priv->pending_apps_mutex);
+	if (gs_app_list_length (queue) == 0) {
+		g_task_return_boolean (task, TRUE);
+		return;
+	}
+
+	/* split by management plugin */
+	groups = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+					(GDestroyNotify) gs_plugin_loader_install_group_free);
+	for (i = 0; i < gs_app_list_length (queue); i++) {
+		GsApp *app = gs_app_list_index (queue, i);
+		GsPluginLoaderInstallGroup *group;
+		const gchar *name = gs_app_get_management_plugin (app);
+
+		if (name == NULL)
+			name = "";
+		group = g_hash_table_lookup (groups, name);
+		if (group == NULL) {
+			GsPlugin *plugin = gs_plugin_loader_find_plugin (plugin_loader, name);
+			gpointer func = NULL;
+			group = g_new0 (GsPluginLoaderInstallGroup, 1);
+			group->list = gs_app_list_new ();
+			if (plugin != NULL &&
+			    gs_plugin_get_enabled (plugin) &&
+			    g_module_symbol (gs_plugin_get_module (plugin),
+					     "gs_plugin_install_apps",
+					     &func))
+				group->plugin = plugin;
+			g_hash_table_insert (groups, g_strdup (name), group);
+		}
+		gs_app_list_add (group->list, app);
+	}
+
+	/* each group uses its own transaction so the downloads overlap */
+	max_threads = g_settings_get_uint (priv->settings,
+					   "download-updates-parallel");
+	helper.plugin_loader = plugin_loader;
+	helper.cancellable = cancellable;
+	pool = g_thread_pool_new (gs_plugin_loader_install_queue_group_cb,
+				  &helper,
+				  (gint) CLAMP (max_threads, 1, g_hash_table_size (groups)),
+				  FALSE, NULL);
+	g_hash_table_iter_init (&iter, groups);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+		g_thread_pool_push (pool, value, NULL);
+	g_thread_pool_free (pool, FALSE, TRUE);
+
+	/* refine again to make sure we pick up new source id */
+	for (i = 0; i < gs_app_list_length (queue); i++) {
+		GsApp *app = gs_app_list_index (queue, i);
+		if (gs_app_get_state (app) == AS_APP_STATE_INSTALLED)
+			gs_app_list_add (installed, app);
+	}
+	if (gs_app_list_length (installed) > 0 &&
+	    !gs_plugin_loader_run_refine (plugin_loader,
+					  "gs_plugin_install_apps",
+					  installed,
+					  GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN,
+					  cancellable,
+					  &error)) {
+		g_warning ("failed to refine installed apps: %s",
+			   error->message);
+	}
+	gs_plugin_loader_queue_app_changes (plugin_loader,
+					    GS_PLUGIN_ACTION_INSTALL,
+					    installed);
+	g_task_return_boolean (task, TRUE);
+}
+
 static void
-gs_plugin_loader_app_installed_cb (GObject *source,
+gs_plugin_loader_install_queue_cb (GObject *source,
 				   GAsyncResult *res,
 				   gpointer user_data)
 {
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
-	gboolean ret;
 	g_autoptr(GError) error = NULL;
-	g_autoptr(GsApp) app = GS_APP (user_data);
 
-	ret = gs_plugin_loader_app_action_finish (plugin_loader,
-						  res,
-						  &error);
-	if (!ret) {
-		remove_app_from_install_queue (plugin_loader, app);
-		g_warning ("failed to install %s: %s",
-			   gs_app_get_unique_id (app), error->message);
+	if (!g_task_propagate_boolean (G_TASK (res), &error)) {
+		g_warning ("failed to install queued apps: %s",
+			   error->message);
+		return;
 	}
+	g_debug ("finished installing queued apps");
 }
 
 void
@@ -4366,9 +7199,7 @@ gs_plugin_loader_set_network_status (GsPluginLoader *plugin_loader,
 				     gboolean online)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
-	GsApp *app;
-	guint i;
-	g_autoptr(GsAppList) queue = NULL;
+	g_autoptr(GTask) task = NULL;
 
 	if (priv->online == online)
 		return;
@@ -4380,23 +7211,11 @@ gs_plugin_loader_set_network_status (GsPluginLoader *plugin_loader,
 	if (!online)
 		return;
 
-	g_mutex_lock (&priv->pending_apps_mutex);
-	queue = gs_app_list_new ();
-	for (i = 0; i < priv->pending_apps->len; i++) {
-		app = g_ptr_array_index (priv->pending_apps, i);
-		if (gs_app_get_state (app) == AS_APP_STATE_QUEUED_FOR_INSTALL)
-			gs_app_list_add (queue, app);
-	}
-	g_mutex_unlock (&priv->pending_apps_mutex);
-	for (i = 0; i < gs_app_list_length (queue); i++) {
-		app = gs_app_list_index (queue, i);
-		gs_plugin_loader_app_action_async (plugin_loader,
-						   app,
-						   GS_PLUGIN_ACTION_INSTALL,
-						   NULL,
-						   gs_plugin_loader_app_installed_cb,
-						   g_object_ref (app));
-	}
+	/* install anything queued while offline */
+	task = g_task_new (plugin_loader, NULL,
+			   gs_plugin_loader_install_queue_cb, NULL);
+	gs_plugin_loader_run_in_thread (plugin_loader, task,
+					gs_plugin_loader_install_queue_thread_cb);
 }
 
 /******************************************************************************/
@@ -4440,9 +7259,12 @@ gs_plugin_loader_run_refresh (GsPluginLoader *plugin_loader,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, TRUE);
 		ret = plugin_func (plugin, cache_age, flags, cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -4538,7 +7360,7 @@ gs_plugin_loader_refresh_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_refresh_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_refresh_thread_cb);
 }
 
 /**
@@ -4611,10 +7433,13 @@ gs_plugin_loader_file_to_app_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, state->list, state->file,
 				   cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -4657,8 +7482,8 @@ gs_plugin_loader_file_to_app_thread_cb (GTask *task,
 	}
 
 	/* filter package list */
-	gs_app_list_filter (state->list, gs_plugin_loader_app_set_prio, plugin_loader);
-	gs_app_list_filter_duplicates (state->list, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+	gs_plugin_loader_filter_duplicates (plugin_loader, state->list,
+					    GS_APP_LIST_FILTER_FLAG_PRIORITY);
 
 	/* check the apps have an icon set */
 	for (j = 0; j < gs_app_list_length (state->list); j++) {
@@ -4677,6 +7502,7 @@ gs_plugin_loader_file_to_app_thread_cb (GTask *task,
 	}
 
 	/* run refine() on each one again to pick up any icons */
+	gs_plugin_loader_app_map_forget_list (plugin_loader, state->list);
 	ret = gs_plugin_loader_run_refine (plugin_loader,
 					   function_name,
 					   state->list,
@@ -4739,7 +7565,7 @@ gs_plugin_loader_file_to_app_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_file_to_app_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_file_to_app_thread_cb);
 }
 
 /**
@@ -4763,6 +7589,148 @@ gs_plugin_loader_file_to_app_finish (GsPluginLoader *plugin_loader,
 
 /******************************************************************************/
 
+typedef struct {
+	GsPluginLoader		*plugin_loader;
+	GsPluginAction		 action;
+	GCancellable		*cancellable;
+	GAsyncQueue		*ready;
+} GsPluginLoaderUpdateHelper;
+
+/* run one per-app function on the plugin that manages the app */
+static void
+gs_plugin_loader_update_app_run (GsPluginLoader *plugin_loader,
+				 GsPluginAction action,
+				 GsApp *app,
+				 const gchar *function_name,
+				 gboolean exclusive,
+				 GCancellable *cancellable)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginActionFunc plugin_func = NULL;
+	const gchar *management_plugin;
+	gboolean ret;
+	guint i;
+
+	management_plugin = gs_app_get_management_plugin (app);
+	for (i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		g_autoptr(AsProfileTask) ptask = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		if (!gs_plugin_get_enabled (plugin))
+			continue;
+		if (g_cancellable_is_cancelled (cancellable))
+			return;
+
+		/* no other plugin will do anything with this app */
+		if (management_plugin != NULL &&
+		    g_strcmp0 (management_plugin, gs_plugin_get_name (plugin)) != 0)
+			continue;
+		ret = g_module_symbol (gs_plugin_get_module (plugin),
+		                       function_name,
+		                       (gpointer *) &plugin_func);
+		if (!ret)
+			continue;
+		ptask = as_profile_start (priv->profile,
+					  "GsPlugin::%s(%s){%s}",
+					  gs_plugin_get_name (plugin),
+					  function_name,
+					  gs_app_get_id (app));
+		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
+		gs_plugin_loader_action_start (plugin_loader, plugin, exclusive);
+		ret = plugin_func (plugin, app, cancellable, &error_local);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
+		if (!ret) {
+			/* badly behaved plugin */
+			if (error_local == NULL) {
+				g_critical ("%s did not set error for %s",
+					    gs_plugin_get_name (plugin),
+					    function_name);
+				continue;
+			}
+			g_warning ("failed to call %s on %s: %s",
+				   function_name,
+				   gs_plugin_get_name (plugin),
+				   error_local->message);
+			gs_plugin_loader_create_event_from_error (plugin_loader,
+								  action,
+								  plugin,
+								  app,
+								  error_local);
+			continue;
+		}
+	}
+}
+
+static void
+gs_plugin_loader_update_download_cb (gpointer data, gpointer user_data)
+{
+	GsApp *app = GS_APP (data);
+	GsPluginLoaderUpdateHelper *helper = (GsPluginLoaderUpdateHelper *) user_data;
+
+	/* a failed download is retried by gs_plugin_update_app() */
+	gs_plugin_loader_update_app_run (helper->plugin_loader,
+					 helper->action,
+					 app,
+					 "gs_plugin_download_app",
+					 FALSE,
+					 helper->cancellable);
+	g_async_queue_push (helper->ready, app);
+}
+
+/* the payloads are downloaded in parallel, but each app is applied on its own
+ * with the plugin locked exclusively, in the order the downloads finish */
+static gboolean
+gs_plugin_loader_update_pipeline (GsPluginLoader *plugin_loader,
+				  GsPluginLoaderAsyncState *state,
+				  GCancellable *cancellable,
+				  GError **error)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderUpdateHelper helper;
+	GThreadPool *pool;
+	guint i;
+	guint len = gs_app_list_length (state->list);
+	guint max_threads;
+
+	if (len == 0)
+		return TRUE;
+	max_threads = g_settings_get_uint (priv->settings,
+					   "download-updates-parallel");
+	helper.plugin_loader = plugin_loader;
+	helper.action = state->action;
+	helper.cancellable = cancellable;
+	helper.ready = g_async_queue_new ();
+	pool = g_thread_pool_new (gs_plugin_loader_update_download_cb,
+				  &helper,
+				  (gint) CLAMP (max_threads, 1, len),
+				  FALSE, NULL);
+	for (i = 0; i < len; i++) {
+		GsApp *app = gs_app_list_index (state->list, i);
+		g_thread_pool_push (pool, g_object_ref (app), NULL);
+	}
+
+	/* apply in the order the downloads finish */
+	for (i = 0; i < len; i++) {
+		g_autoptr(GsApp) app = g_async_queue_pop (helper.ready);
+		g_debug ("downloaded %u of %u updates", i + 1, len);
+		gs_plugin_loader_update_app_run (plugin_loader,
+						 state->action,
+						 app,
+						 "gs_plugin_update_app",
+						 TRUE,
+						 cancellable);
+	}
+	g_thread_pool_free (pool, FALSE, TRUE);
+	g_async_queue_unref (helper.ready);
+	if (g_cancellable_set_error_if_cancelled (cancellable, error))
+		return FALSE;
+	return TRUE;
+}
+
 static void
 gs_plugin_loader_update_thread_cb (GTask *task,
 				   gpointer object,
@@ -4777,8 +7745,12 @@ gs_plugin_loader_update_thread_cb (GTask *task,
 	GsPlugin *plugin;
 	GsPluginUpdateFunc plugin_func = NULL;
 	GsPluginActionFunc plugin_app_func = NULL;
+	GError *error = NULL;
 	guint i;
 
+	/* the apps are about to change */
+	gs_plugin_loader_app_map_forget_list (plugin_loader, state->list);
+
 	/* run each plugin */
 	for (i = 0; i < priv->plugins->len; i++) {
 		g_autoptr(AsProfileTask) ptask = NULL;
@@ -4799,9 +7771,12 @@ gs_plugin_loader_update_thread_cb (GTask *task,
 					  gs_plugin_get_name (plugin),
 					  function_name);
 		g_assert (ptask != NULL);
+		if (!gs_plugin_loader_setup_lazy (plugin_loader, plugin))
+			continue;
 		gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
 		ret = plugin_func (plugin, state->list, cancellable, &error_local);
-		gs_plugin_loader_action_stop (plugin_loader, plugin);
+		gs_plugin_loader_action_stop (plugin_loader, plugin, function_name,
+					      ret, error_local);
 		if (!ret) {
 			/* badly behaved plugin */
 			if (error_local == NULL) {
@@ -4824,63 +7799,28 @@ gs_plugin_loader_update_thread_cb (GTask *task,
 		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
 
-	/* run each plugin, per-app version */
-	function_name = "gs_plugin_update_app";
-	for (i = 0; i < priv->plugins->len; i++) {
-		guint j;
+	/* download everything, applying each app as soon as it is ready */
+	if (!gs_plugin_loader_update_pipeline (plugin_loader, state,
+					       cancellable, &error)) {
+		g_task_return_error (task, error);
+		return;
+	}
 
+	/* the per-app updates are all done */
+	for (i = 0; i < priv->plugins->len; i++) {
 		plugin = g_ptr_array_index (priv->plugins, i);
 		if (!gs_plugin_get_enabled (plugin))
 			continue;
-		ret = g_task_return_error_if_cancelled (task);
-		if (ret)
-			return;
-		ret = g_module_symbol (gs_plugin_get_module (plugin),
-		                       function_name,
-		                       (gpointer *) &plugin_app_func);
-		if (!ret)
+		if (!g_module_symbol (gs_plugin_get_module (plugin),
+				      "gs_plugin_update_app",
+				      (gpointer *) &plugin_app_func))
 			continue;
-
-		/* for each app */
-		for (j = 0; j < gs_app_list_length (state->list); j++) {
-			GsApp *app = gs_app_list_index (state->list, j);
-			g_autoptr(AsProfileTask) ptask = NULL;
-			g_autoptr(GError) error_local = NULL;
-
-			ptask = as_profile_start (priv->profile,
-						  "GsPlugin::%s(%s){%s}",
-						  gs_plugin_get_name (plugin),
-						  function_name,
-						  gs_app_get_id (app));
-			g_assert (ptask != NULL);
-			gs_plugin_loader_action_start (plugin_loader, plugin, FALSE);
-			ret = plugin_app_func (plugin, app,
-					       cancellable,
-					       &error_local);
-			gs_plugin_loader_action_stop (plugin_loader, plugin);
-			if (!ret) {
-				/* badly behaved plugin */
-				if (error_local == NULL) {
-					g_critical ("%s did not set error for %s",
-						    gs_plugin_get_name (plugin),
-						    function_name);
-					continue;
-				}
-				g_warning ("failed to call %s on %s: %s",
-					   function_name,
-					   gs_plugin_get_name (plugin),
-					   error_local->message);
-				gs_plugin_loader_create_event_from_error (plugin_loader,
-									  state->action,
-									  plugin,
-									  app,
-									  error_local);
-				continue;
-			}
-		}
 		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
 
+	gs_plugin_loader_queue_app_changes (plugin_loader,
+					    GS_PLUGIN_ACTION_UPDATE,
+					    state->list);
 	g_task_return_boolean (task, TRUE);
 }
 
@@ -4889,6 +7829,9 @@ gs_plugin_loader_update_thread_cb (GTask *task,
  *
  * This method calls all plugins that implement the gs_plugin_update()
  * or gs_plugin_update_app() functions.
+ *
+ * The payloads are first fetched in parallel using gs_plugin_download_app()
+ * and each application is then updated as soon as its download completes.
  **/
 void
 gs_plugin_loader_update_async (GsPluginLoader *plugin_loader,
@@ -4911,7 +7854,7 @@ gs_plugin_loader_update_async (GsPluginLoader *plugin_loader,
 	/* run in a thread */
 	task = g_task_new (plugin_loader, cancellable, callback, user_data);
 	g_task_set_task_data (task, state, (GDestroyNotify) gs_plugin_loader_free_async_state);
-	g_task_run_in_thread (task, gs_plugin_loader_update_thread_cb);
+	gs_plugin_loader_run_in_thread (plugin_loader, task, gs_plugin_loader_update_thread_cb);
 }
 
 gboolean
@@ -27,6 +27,7 @@
 #include "gs-app.h"
 #include "gs-auth.h"
 #include "gs-category.h"
+#include "gs-change-set.h"
 #include "gs-plugin-event.h"
 #include "gs-plugin-private.h"
 
@@ -34,6 +35,9 @@ G_BEGIN_DECLS
 
 #define GS_TYPE_PLUGIN_LOADER		(gs_plugin_loader_get_type ())
 
+/* the number of results kept for a search, with the most relevant first */
+#define GS_PLUGIN_LOADER_SEARCH_MAX_RESULTS	100
+
 G_DECLARE_DERIVABLE_TYPE (GsPluginLoader, gs_plugin_loader, GS, PLUGIN_LOADER, GObject)
 
 struct _GsPluginLoaderClass
@@ -45,11 +49,17 @@ struct _GsPluginLoaderClass
 	void			(*pending_apps_changed)	(GsPluginLoader	*plugin_loader);
 	void			(*updates_changed)	(GsPluginLoader	*plugin_loader);
 	void			(*reload)		(GsPluginLoader	*plugin_loader);
+	void			(*changed)		(GsPluginLoader	*plugin_loader,
+							 GsChangeSet	*changes);
 };
 
 typedef void	 (*GsPluginLoaderFinishedFunc)		(GsPluginLoader	*plugin_loader,
 							 GsApp		*app,
 							 gpointer	 user_data);
+typedef void	 (*GsPluginLoaderResultsFunc)		(GsPluginLoader	*plugin_loader,
+							 GsAppList	*list,
+							 gboolean	 narrowable_done,
+							 gpointer	 user_data);
 
 GsPluginLoader	*gs_plugin_loader_new			(void);
 void		 gs_plugin_loader_get_installed_async	(GsPluginLoader	*plugin_loader,
@@ -125,15 +135,47 @@ void		 gs_plugin_loader_get_category_apps_async (GsPluginLoader	*plugin_loader,
 GsAppList	*gs_plugin_loader_get_category_apps_finish (GsPluginLoader	*plugin_loader,
 							 GAsyncResult	*res,
 							 GError		**error);
+void		 gs_plugin_loader_get_overview_async	(GsPluginLoader	*plugin_loader,
+							 GPtrArray	*categories,
+							 GsPluginRefineFlags flags_featured,
+							 GsPluginRefineFlags flags,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gboolean	 gs_plugin_loader_get_overview_finish	(GsPluginLoader	*plugin_loader,
+							 GAsyncResult	*res,
+							 GsAppList	**featured,
+							 GsAppList	**popular,
+							 GPtrArray	**categories,
+							 GPtrArray	**category_apps,
+							 GError		**error);
 void		 gs_plugin_loader_search_async		(GsPluginLoader	*plugin_loader,
 							 const gchar	*value,
 							 GsPluginRefineFlags flags,
 							 GCancellable	*cancellable,
 							 GAsyncReadyCallback callback,
 							 gpointer	 user_data);
+void		 gs_plugin_loader_search_incremental_async (GsPluginLoader	*plugin_loader,
+							 const gchar	*value,
+							 GsPluginRefineFlags flags,
+							 GsPluginLoaderResultsFunc results_func,
+							 gpointer	 results_user_data,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
 GsAppList	*gs_plugin_loader_search_finish		(GsPluginLoader	*plugin_loader,
 							 GAsyncResult	*res,
 							 GError		**error);
+void		 gs_plugin_loader_search_narrow_async	(GsPluginLoader	*plugin_loader,
+							 GsAppList	*list,
+							 const gchar	*value,
+							 GsPluginRefineFlags flags,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+GsAppList	*gs_plugin_loader_search_narrow_finish	(GsPluginLoader	*plugin_loader,
+							 GAsyncResult	*res,
+							 GError		**error);
 void		 gs_plugin_loader_search_files_async	(GsPluginLoader	*plugin_loader,
 							 const gchar	*value,
 							 GsPluginRefineFlags flags,
@@ -173,6 +215,15 @@ gboolean	 gs_plugin_loader_setup			(GsPluginLoader	*plugin_loader,
 							 gchar		**whitelist,
 							 gchar		**blacklist,
 							 GError		**error);
+void		 gs_plugin_loader_setup_async		(GsPluginLoader	*plugin_loader,
+							 gchar		**whitelist,
+							 gchar		**blacklist,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gboolean	 gs_plugin_loader_setup_finish		(GsPluginLoader	*plugin_loader,
+							 GAsyncResult	*res,
+							 GError		**error);
 void		 gs_plugin_loader_dump_state		(GsPluginLoader	*plugin_loader);
 gboolean	 gs_plugin_loader_get_enabled		(GsPluginLoader	*plugin_loader,
 							 const gchar	*plugin_name);
@@ -183,6 +234,19 @@ GsAuth		*gs_plugin_loader_get_auth_by_id	(GsPluginLoader	*plugin_loader,
 guint		 gs_plugin_loader_get_scale		(GsPluginLoader	*plugin_loader);
 void		 gs_plugin_loader_set_scale		(GsPluginLoader	*plugin_loader,
 							 guint		 scale);
+void		 gs_plugin_loader_set_locale_async	(GsPluginLoader	*plugin_loader,
+							 const gchar	*locale,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+gboolean	 gs_plugin_loader_set_locale_finish	(GsPluginLoader	*plugin_loader,
+							 GAsyncResult	*res,
+							 GError		**error);
+guint		 gs_plugin_loader_get_updates_serial	(GsPluginLoader	*plugin_loader);
+GsApp		*gs_plugin_loader_app_lookup		(GsPluginLoader	*plugin_loader,
+							 const gchar	*unique_id);
+GsApp		*gs_plugin_loader_app_lookup_by_id	(GsPluginLoader	*plugin_loader,
+							 const gchar	*id);
 void		 gs_plugin_loader_app_refine_async	(GsPluginLoader	*plugin_loader,
 							 GsApp		*app,
 							 GsPluginRefineFlags flags,
@@ -192,6 +256,15 @@ void		 gs_plugin_loader_app_refine_async	(GsPluginLoader	*plugin_loader,
 gboolean	 gs_plugin_loader_app_refine_finish	(GsPluginLoader	*plugin_loader,
 							 GAsyncResult	*res,
 							 GError		**error);
+void		 gs_plugin_loader_refine_async		(GsPluginLoader	*plugin_loader,
+							 GsAppList	*list,
+							 GsPluginRefineFlags flags,
+							 GCancellable	*cancellable,
+							 GAsyncReadyCallback callback,
+							 gpointer	 user_data);
+GsAppList	*gs_plugin_loader_refine_finish		(GsPluginLoader	*plugin_loader,
+							 GAsyncResult	*res,
+							 GError		**error);
 void		 gs_plugin_loader_app_action_async	(GsPluginLoader	*plugin_loader,
 							 GsApp		*app,
 							 GsPluginAction	 a,
@@ -242,6 +315,7 @@ GsPluginEvent	*gs_plugin_loader_get_event_default	(GsPluginLoader	*plugin_loader
 void		 gs_plugin_loader_remove_events		(GsPluginLoader	*plugin_loader);
 
 AsProfile	*gs_plugin_loader_get_profile		(GsPluginLoader	*plugin_loader);
+GVariant	*gs_plugin_loader_get_stats		(GsPluginLoader	*plugin_loader);
 
 G_END_DECLS
 
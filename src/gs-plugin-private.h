@@ -27,6 +27,7 @@
 #include <gmodule.h>
 #include <libsoup/soup.h>
 
+#include "gs-file-watcher.h"
 #include "gs-plugin.h"
 
 G_BEGIN_DECLS
@@ -63,6 +64,7 @@ G_BEGIN_DECLS
  * @GS_PLUGIN_ACTION_SEARCH_PROVIDES:		Get the search results for a provide query
  * @GS_PLUGIN_ACTION_GET_CATEGORIES:		Get the list of categories
  * @GS_PLUGIN_ACTION_GET_CATEGORY_APPS:		Get the apps for a specific category
+ * @GS_PLUGIN_ACTION_GET_OVERVIEW:		Get everything shown on the overview page
  * @GS_PLUGIN_ACTION_REFINE:			Refine the application
  * @GS_PLUGIN_ACTION_REFRESH:			Refresh all the sources
  * @GS_PLUGIN_ACTION_FILE_TO_APP:		Convert the file to an application
@@ -104,6 +106,7 @@ typedef enum {
 	GS_PLUGIN_ACTION_SEARCH_PROVIDES,
 	GS_PLUGIN_ACTION_GET_CATEGORIES,
 	GS_PLUGIN_ACTION_GET_CATEGORY_APPS,
+	GS_PLUGIN_ACTION_GET_OVERVIEW,
 	GS_PLUGIN_ACTION_REFINE,
 	GS_PLUGIN_ACTION_REFRESH,
 	GS_PLUGIN_ACTION_FILE_TO_APP,
@@ -132,6 +135,7 @@ void		 gs_plugin_set_order			(GsPlugin	*plugin,
 guint		 gs_plugin_get_priority			(GsPlugin	*plugin);
 void		 gs_plugin_set_priority			(GsPlugin	*plugin,
 							 guint		 priority);
+guint		 gs_plugin_get_updates_serial		(GsPlugin	*plugin);
 void		 gs_plugin_set_locale			(GsPlugin	*plugin,
 							 const gchar	*locale);
 void		 gs_plugin_set_language			(GsPlugin	*plugin,
@@ -144,6 +148,8 @@ void		 gs_plugin_set_soup_session		(GsPlugin	*plugin,
 							 SoupSession	*soup_session);
 void		 gs_plugin_set_global_cache		(GsPlugin	*plugin,
 							 GsAppList	*global_cache);
+void		 gs_plugin_set_file_watcher		(GsPlugin	*plugin,
+							 GsFileWatcher	*file_watcher);
 void		 gs_plugin_set_running_other		(GsPlugin	*plugin,
 							 gboolean	 running_other);
 GPtrArray	*gs_plugin_get_rules			(GsPlugin	*plugin,
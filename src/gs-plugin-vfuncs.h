@@ -103,6 +103,32 @@ gboolean	 gs_plugin_add_search			(GsPlugin	*plugin,
 							 GCancellable	*cancellable,
 							 GError		**error);
 
+/**
+ * gs_plugin_add_search_narrow:
+ * @plugin: a #GsPlugin
+ * @values: a NULL terminated list of search terms, e.g. [ "gnome", "software" ]
+ * @previous: a #GsAppList of the results of a less specific search
+ * @list: a #GsAppList
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Get search results for a specific query, only considering the apps in
+ * @previous. This is only used for plugins that set
+ * %GS_PLUGIN_FLAGS_NARROWABLE_SEARCH, and gs_plugin_add_search() is used
+ * instead if it is not implemented.
+ *
+ * Plugins are expected to add the apps that still match using
+ * gs_app_list_add().
+ *
+ * Returns: %TRUE for success or if not relevant
+ **/
+gboolean	 gs_plugin_add_search_narrow		(GsPlugin	*plugin,
+							 gchar		**values,
+							 GsAppList	*previous,
+							 GsAppList	*list,
+							 GCancellable	*cancellable,
+							 GError		**error);
+
 /**
  * gs_plugin_add_search_files:
  * @plugin: a #GsPlugin
@@ -166,6 +192,22 @@ gboolean	 gs_plugin_setup			(GsPlugin	*plugin,
 							 GCancellable	*cancellable,
 							 GError		**error);
 
+/**
+ * gs_plugin_locale_changed:
+ * @plugin: a #GsPlugin
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Called in a thread when the locale returned by gs_plugin_get_locale() has
+ * been changed at runtime. Plugins that only keep the translations for the
+ * current locale should load their metadata again.
+ *
+ * Returns: %TRUE for success or if not relevant
+ **/
+gboolean	 gs_plugin_locale_changed		(GsPlugin	*plugin,
+							 GCancellable	*cancellable,
+							 GError		**error);
+
 /**
  * gs_plugin_add_installed:
  * @plugin: a #GsPlugin
@@ -549,6 +591,35 @@ gboolean	 gs_plugin_app_install			(GsPlugin	*plugin,
 							 GCancellable	*cancellable,
 							 GError		**error);
 
+/**
+ * gs_plugin_install_apps:
+ * @plugin: a #GsPlugin
+ * @list: a #GsAppList
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Install several applications at once, for instance when the queue of apps
+ * saved while offline is processed. The plugin should only handle apps where
+ * it is the management plugin, and should use as few transactions as it can.
+ *
+ * If this function is not implemented then gs_plugin_app_install() is called
+ * for each application in turn.
+ *
+ * The apps are in the %AS_APP_STATE_AVAILABLE state when this is called.
+ * Apps the plugin cannot install together can be left alone, as
+ * gs_plugin_app_install() is called for each application that is not
+ * installed afterwards.
+ *
+ * NOTE: Once the action is complete, the plugin must set the new state of
+ * each installed app to %AS_APP_STATE_INSTALLED.
+ *
+ * Returns: %TRUE for success or if not relevant
+ **/
+gboolean	 gs_plugin_install_apps			(GsPlugin	*plugin,
+							 GsAppList	*list,
+							 GCancellable	*cancellable,
+							 GError		**error);
+
 /**
  * gs_plugin_app_remove:
  * @plugin: a #GsPlugin
@@ -615,6 +686,10 @@ gboolean	 gs_plugin_app_set_rating		(GsPlugin	*plugin,
  * On failure the error message returned will usually only be shown on the
  * console, but they can also be retrieved using gs_plugin_loader_get_events().
  *
+ * When updating several applications this is called with the plugin
+ * locked exclusively, so it never runs at the same time as
+ * gs_plugin_download_app() or another update.
+ *
  * NOTE: Once the action is complete, the plugin must set the new state of @app
  * to %AS_APP_STATE_INSTALLED or %AS_APP_STATE_UNKNOWN if not known.
  *
@@ -625,6 +700,32 @@ gboolean	 gs_plugin_update_app			(GsPlugin	*plugin,
 							 GCancellable	*cancellable,
 							 GError		**error);
 
+/**
+ * gs_plugin_download_app:
+ * @plugin: a #GsPlugin
+ * @app: a #GsApp
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Downloads the update for the application without applying it, so that
+ * a later call to gs_plugin_update_app() only has to deploy it.
+ *
+ * This function is called for several applications at the same time, and
+ * so it must not modify any state shared between them.
+ *
+ * Plugins are expected to send progress notifications to the UI using
+ * gs_app_set_progress() using the passed in @app.
+ *
+ * On failure the error message returned will usually only be shown on the
+ * console, but they can also be retrieved using gs_plugin_loader_get_events().
+ *
+ * Returns: %TRUE for success or if not relevant
+ **/
+gboolean	 gs_plugin_download_app			(GsPlugin	*plugin,
+							 GsApp		*app,
+							 GCancellable	*cancellable,
+							 GError		**error);
+
 /**
  * gs_plugin_app_upgrade_download:
  * @plugin: a #GsPlugin
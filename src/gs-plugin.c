@@ -64,16 +64,18 @@ typedef struct
 	GsPluginFlags		 flags;
 	SoupSession		*soup_session;
 	GsAppList		*global_cache;
+	GsFileWatcher		*file_watcher;
 	GPtrArray		*rules[GS_PLUGIN_RULE_LAST];
 	gboolean		 enabled;
-	gchar			*locale;		/* allow-none */
-	gchar			*language;		/* allow-none */
+	const gchar		*locale;		/* interned, allow-none */
+	const gchar		*language;		/* interned, allow-none */
 	gchar			*name;
 	guint			 scale;
 	guint			 order;
 	guint			 priority;
 	guint			 timer_id;
 	GMutex			 timer_mutex;
+	gint			 updates_serial;	/* atomic */
 } GsPluginPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (GsPlugin, gs_plugin, G_TYPE_OBJECT)
@@ -189,8 +191,6 @@ gs_plugin_finalize (GObject *object)
 		g_source_remove (priv->timer_id);
 	g_free (priv->name);
 	g_free (priv->data);
-	g_free (priv->locale);
-	g_free (priv->language);
 	g_rw_lock_clear (&priv->rwlock);
 	g_object_unref (priv->profile);
 	if (priv->auth_array != NULL)
@@ -199,6 +199,10 @@ gs_plugin_finalize (GObject *object)
 		g_object_unref (priv->soup_session);
 	if (priv->global_cache != NULL)
 		g_object_unref (priv->global_cache);
+	if (priv->file_watcher != NULL) {
+		gs_file_watcher_remove_plugin (priv->file_watcher, plugin);
+		g_object_unref (priv->file_watcher);
+	}
 	g_hash_table_unref (priv->cache);
 	g_mutex_clear (&priv->cache_mutex);
 	g_mutex_clear (&priv->timer_mutex);
@@ -533,14 +537,16 @@ gs_plugin_get_language (GsPlugin *plugin)
  *
  * Sets the plugin locale.
  *
+ * The string is interned so that threads that are still using the old
+ * locale are not affected if this is changed at runtime.
+ *
  * Since: 3.22
  **/
 void
 gs_plugin_set_locale (GsPlugin *plugin, const gchar *locale)
 {
 	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
-	g_free (priv->locale);
-	priv->locale = g_strdup (locale);
+	priv->locale = g_intern_string (locale);
 }
 
 /**
@@ -556,8 +562,7 @@ void
 gs_plugin_set_language (GsPlugin *plugin, const gchar *language)
 {
 	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
-	g_free (priv->language);
-	priv->language = g_strdup (language);
+	priv->language = g_intern_string (language);
 }
 
 /**
@@ -702,6 +707,20 @@ gs_plugin_set_global_cache (GsPlugin *plugin, GsAppList *global_cache)
 	g_set_object (&priv->global_cache, global_cache);
 }
 
+/**
+ * gs_plugin_set_file_watcher:
+ * @plugin: a #GsPlugin
+ * @file_watcher: a #GsFileWatcher
+ *
+ * Sets the file watcher shared by all the plugins.
+ **/
+void
+gs_plugin_set_file_watcher (GsPlugin *plugin, GsFileWatcher *file_watcher)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	g_set_object (&priv->file_watcher, file_watcher);
+}
+
 /**
  * gs_plugin_has_flags:
  * @plugin: a #GsPlugin
@@ -964,14 +983,107 @@ gs_plugin_updates_changed_cb (gpointer user_data)
  * Emit a signal that tells the plugin loader that the list of updates
  * may have changed.
  *
+ * This also increments the value returned by gs_plugin_get_updates_serial()
+ * straight away, so this can be called from any thread.
+ *
  * Since: 3.22
  **/
 void
 gs_plugin_updates_changed (GsPlugin *plugin)
 {
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	g_atomic_int_inc (&priv->updates_serial);
 	g_idle_add (gs_plugin_updates_changed_cb, plugin);
 }
 
+/**
+ * gs_plugin_get_updates_serial:
+ * @plugin: a #GsPlugin
+ *
+ * Gets a counter that is incremented every time the plugin calls
+ * gs_plugin_updates_changed(). If the value is the same as before then the
+ * list of updates from the plugin has not changed, which is much cheaper
+ * to find out than getting the list again.
+ *
+ * Returns: an integer
+ **/
+guint
+gs_plugin_get_updates_serial (GsPlugin *plugin)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	return (guint) g_atomic_int_get (&priv->updates_serial);
+}
+
+/**
+ * gs_plugin_watch_file:
+ * @plugin: a #GsPlugin
+ * @file: a #GFile, which can be a file or a directory
+ * @func: a #GsPluginWatchFunc
+ * @user_data: user data to pass to @func
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Watches @file for changes using a monitor shared with all other plugins.
+ *
+ * Rather than being told about every event, @func is called once when the
+ * changes have stopped for a short time. If the same @func and @user_data
+ * are used to watch more than one file then changes to any of them are
+ * coalesced into one call.
+ *
+ * The watch is removed when the plugin is destroyed.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 3.24
+ **/
+gboolean
+gs_plugin_watch_file (GsPlugin *plugin,
+		      GFile *file,
+		      GsPluginWatchFunc func,
+		      gpointer user_data,
+		      GCancellable *cancellable,
+		      GError **error)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	if (priv->file_watcher == NULL) {
+		g_set_error (error,
+			     GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_NOT_SUPPORTED,
+			     "no file watcher for %s",
+			     priv->name);
+		return FALSE;
+	}
+	return gs_file_watcher_add (priv->file_watcher, plugin, file,
+				    func, user_data, cancellable, error);
+}
+
+/**
+ * gs_plugin_watch_queue:
+ * @plugin: a #GsPlugin
+ * @func: a #GsPluginWatchFunc
+ * @user_data: user data to pass to @func
+ *
+ * Schedules @func to be called in the same way as if a watched file had
+ * changed. This allows bursts of change notifications from other sources,
+ * for instance a signal from a library, to be coalesced too.
+ *
+ * Since: 3.24
+ **/
+void
+gs_plugin_watch_queue (GsPlugin *plugin,
+		       GsPluginWatchFunc func,
+		       gpointer user_data)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+
+	/* not being run by the plugin loader */
+	if (priv->file_watcher == NULL) {
+		func (plugin, user_data);
+		return;
+	}
+	gs_file_watcher_queue (priv->file_watcher, plugin, func, user_data);
+}
+
 static gboolean
 gs_plugin_reload_cb (gpointer user_data)
 {
@@ -1388,6 +1500,8 @@ gs_plugin_action_to_string (GsPluginAction action)
 		return "get-categories";
 	if (action == GS_PLUGIN_ACTION_GET_CATEGORY_APPS)
 		return "get-category-apps";
+	if (action == GS_PLUGIN_ACTION_GET_OVERVIEW)
+		return "get-overview";
 	if (action == GS_PLUGIN_ACTION_REFINE)
 		return "refine";
 	if (action == GS_PLUGIN_ACTION_REFRESH)
@@ -52,6 +52,16 @@ struct _GsPluginClass
 
 typedef struct	GsPluginData	GsPluginData;
 
+/**
+ * GsPluginWatchFunc:
+ * @plugin: a #GsPlugin
+ * @user_data: the user data passed to gs_plugin_watch_file()
+ *
+ * Called in the main thread once a burst of changes is over.
+ **/
+typedef void	(*GsPluginWatchFunc)		(GsPlugin	*plugin,
+						 gpointer	 user_data);
+
 /**
  * GsPluginStatus:
  * @GS_PLUGIN_STATUS_UNKNOWN:		Unknown status
@@ -86,6 +96,8 @@ typedef enum {
  * @GS_PLUGIN_FLAGS_EXCLUSIVE:		An exclusive action is running
  * @GS_PLUGIN_FLAGS_RECENT:		This plugin recently ran
  * @GS_PLUGIN_FLAGS_GLOBAL_CACHE:	Use the global app cache
+ * @GS_PLUGIN_FLAGS_NARROWABLE_SEARCH:	Search results for a more specific query are always a subset
+ * @GS_PLUGIN_FLAGS_SETUP_ON_DEMAND:	Only run gs_plugin_setup() when the plugin is first used
  *
  * The flags for the plugin at this point in time.
  **/
@@ -95,6 +107,8 @@ typedef enum {
 #define GS_PLUGIN_FLAGS_EXCLUSIVE	(1u << 2)
 #define GS_PLUGIN_FLAGS_RECENT		(1u << 3)
 #define GS_PLUGIN_FLAGS_GLOBAL_CACHE	(1u << 4)
+#define GS_PLUGIN_FLAGS_NARROWABLE_SEARCH	(1u << 5)
+#define GS_PLUGIN_FLAGS_SETUP_ON_DEMAND	(1u << 6)
 typedef guint64 GsPluginFlags;
 
 /**
@@ -167,8 +181,12 @@ typedef enum {
  * @GS_PLUGIN_REFINE_FLAGS_REQUIRE_PERMISSIONS:		Require the needed permissions
  * @GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME:	Require the origin hostname
  * @GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_UI:		Require the origin for UI
+ * @GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS:		Require the screenshots
  *
  * The refine flags.
+ *
+ * The screenshots are only shown for a single application, so plugins may
+ * leave them unset unless %GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS is used.
  **/
 #define GS_PLUGIN_REFINE_FLAGS_DEFAULT			(0u)
 #define GS_PLUGIN_REFINE_FLAGS_USE_HISTORY		(1u << 0)
@@ -196,6 +214,7 @@ typedef enum {
 #define GS_PLUGIN_REFINE_FLAGS_REQUIRE_PERMISSIONS	(1u << 22)
 #define GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME	(1u << 23)
 #define GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_UI	(1u << 24)
+#define GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS	(1u << 25)
 typedef guint64 GsPluginRefineFlags;
 
 /**
@@ -302,6 +321,15 @@ gboolean	 gs_plugin_app_launch			(GsPlugin	*plugin,
 							 GError		**error);
 void		 gs_plugin_updates_changed		(GsPlugin	*plugin);
 void		 gs_plugin_reload			(GsPlugin	*plugin);
+gboolean	 gs_plugin_watch_file			(GsPlugin	*plugin,
+							 GFile		*file,
+							 GsPluginWatchFunc func,
+							 gpointer	 user_data,
+							 GCancellable	*cancellable,
+							 GError		**error);
+void		 gs_plugin_watch_queue			(GsPlugin	*plugin,
+							 GsPluginWatchFunc func,
+							 gpointer	 user_data);
 const gchar	*gs_plugin_status_to_string		(GsPluginStatus	 status);
 
 G_END_DECLS
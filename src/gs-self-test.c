@@ -28,6 +28,8 @@
 
 #include "gs-app-private.h"
 #include "gs-app-list-private.h"
+#include "gs-change-set.h"
+#include "gs-content-rating.h"
 #include "gs-os-release.h"
 #include "gs-plugin-private.h"
 #include "gs-plugin-loader.h"
@@ -88,6 +90,41 @@ gs_os_release_func (void)
 	g_assert_cmpstr (gs_os_release_get_pretty_name (os_release), ==, "Fedora 25 (Workstation Edition)");
 }
 
+static void
+gs_change_set_func (void)
+{
+	g_autoptr(GsChangeSet) changes = gs_change_set_new ();
+	g_autoptr(GsChangeSet) donor = gs_change_set_new ();
+
+	/* empty */
+	g_assert (gs_change_set_is_empty (changes));
+	g_assert (!gs_change_set_has_kind (changes, GS_CHANGE_SET_KIND_APPS));
+
+	/* an updated app is only changed */
+	gs_change_set_add_changed (changes, "system/package/*/*/gimp.desktop/*");
+	g_assert (!gs_change_set_is_empty (changes));
+	g_assert (gs_change_set_has_kind (changes, GS_CHANGE_SET_KIND_APPS));
+	g_assert_cmpint (gs_change_set_get_changed (changes)->len, ==, 1);
+
+	/* installing it supersedes the change */
+	gs_change_set_add_added (changes, "system/package/*/*/gimp.desktop/*");
+	gs_change_set_add_added (changes, "system/package/*/*/gimp.desktop/*");
+	g_assert_cmpint (gs_change_set_get_added (changes)->len, ==, 1);
+	g_assert_cmpint (gs_change_set_get_changed (changes)->len, ==, 0);
+	gs_change_set_add_changed (changes, "system/package/*/*/gimp.desktop/*");
+	g_assert_cmpint (gs_change_set_get_changed (changes)->len, ==, 0);
+
+	/* removing it again in another set is merged as removed */
+	gs_change_set_add_removed (donor, "system/package/*/*/gimp.desktop/*");
+	gs_change_set_add_kind (donor, GS_CHANGE_SET_KIND_CATALOG);
+	gs_change_set_merge (changes, donor);
+	g_assert_cmpint (gs_change_set_get_added (changes)->len, ==, 0);
+	g_assert_cmpint (gs_change_set_get_removed (changes)->len, ==, 1);
+	g_assert (gs_change_set_has_kind (changes, GS_CHANGE_SET_KIND_CATALOG));
+	g_assert (gs_change_set_has_unique_id (changes, "system/package/*/*/gimp.desktop/*"));
+	g_assert (!gs_change_set_has_unique_id (changes, "system/package/*/*/inkscape.desktop/*"));
+}
+
 static void
 gs_utils_error_func (void)
 {
@@ -110,6 +147,47 @@ gs_utils_error_func (void)
 	g_assert_cmpstr (error->message, ==, "failed");
 }
 
+static void
+gs_content_rating_func (void)
+{
+	/* descriptions */
+	g_assert_cmpstr (gs_content_rating_key_value_to_str ("drugs-alcohol",
+							     AS_CONTENT_RATING_VALUE_NONE),
+			 ==, "No references to alcohol");
+	g_assert_cmpstr (gs_content_rating_key_value_to_str ("violence-sexual",
+							     AS_CONTENT_RATING_VALUE_INTENSE),
+			 ==, "Rape or other violent sexual behavior");
+	g_assert_cmpstr (gs_content_rating_key_value_to_str ("drugs-tobacco",
+							     AS_CONTENT_RATING_VALUE_NONE),
+			 ==, NULL);
+	g_assert_cmpstr (gs_content_rating_key_value_to_str ("violence-bloodshed",
+							     AS_CONTENT_RATING_VALUE_UNKNOWN),
+			 ==, NULL);
+	g_assert_cmpstr (gs_content_rating_key_value_to_str ("xxx",
+							     AS_CONTENT_RATING_VALUE_MILD),
+			 ==, NULL);
+
+	/* rating systems */
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("de_DE"),
+			 ==, GS_CONTENT_RATING_SYSTEM_USK);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("za"),
+			 ==, GS_CONTENT_RATING_SYSTEM_PEGI);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("ad_AD"),
+			 ==, GS_CONTENT_RATING_SYSTEM_PEGI);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("en_GB"),
+			 ==, GS_CONTENT_RATING_SYSTEM_PEGI);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("en_US"),
+			 ==, GS_CONTENT_RATING_SYSTEM_ESRB);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("zh_TW"),
+			 ==, GS_CONTENT_RATING_SYSTEM_GSRR);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("zh_CN"),
+			 ==, GS_CONTENT_RATING_SYSTEM_IARC);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale ("ca@valencia"),
+			 ==, GS_CONTENT_RATING_SYSTEM_IARC);
+	g_assert_cmpint (gs_utils_content_rating_system_from_locale (""),
+			 ==, GS_CONTENT_RATING_SYSTEM_IARC);
+}
+
 static void
 gs_plugin_global_cache_func (void)
 {
@@ -146,12 +224,110 @@ gs_plugin_global_cache_func (void)
 	g_assert (app2 != NULL);
 }
 
+static void
+gs_plugin_file_watcher_cb (GsPlugin *plugin, gpointer user_data)
+{
+	guint *cnt = (guint *) user_data;
+	(*cnt)++;
+}
+
+static gboolean
+gs_plugin_file_watcher_timeout_cb (gpointer user_data)
+{
+	GMainLoop *loop = (GMainLoop *) user_data;
+	g_main_loop_quit (loop);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+gs_plugin_file_watcher_func (void)
+{
+	guint cnt1 = 0;
+	guint cnt2 = 0;
+	g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+	g_autoptr(GsFileWatcher) watcher = gs_file_watcher_new ();
+	g_autoptr(GsPlugin) plugin1 = gs_plugin_new ();
+	g_autoptr(GsPlugin) plugin2 = gs_plugin_new ();
+
+	gs_plugin_set_file_watcher (plugin1, watcher);
+	gs_plugin_set_file_watcher (plugin2, watcher);
+
+	/* a burst of changes only notifies each plugin once */
+	gs_plugin_watch_queue (plugin1, gs_plugin_file_watcher_cb, &cnt1);
+	gs_plugin_watch_queue (plugin1, gs_plugin_file_watcher_cb, &cnt1);
+	gs_plugin_watch_queue (plugin1, gs_plugin_file_watcher_cb, &cnt1);
+	gs_plugin_watch_queue (plugin2, gs_plugin_file_watcher_cb, &cnt2);
+	g_assert_cmpint (cnt1, ==, 0);
+	g_timeout_add (1500, gs_plugin_file_watcher_timeout_cb, loop);
+	g_main_loop_run (loop);
+	g_assert_cmpint (cnt1, ==, 1);
+	g_assert_cmpint (cnt2, ==, 1);
+
+	/* nothing is delivered once the plugin has gone */
+	gs_plugin_watch_queue (plugin1, gs_plugin_file_watcher_cb, &cnt1);
+	gs_plugin_watch_queue (plugin2, gs_plugin_file_watcher_cb, &cnt2);
+	gs_file_watcher_remove_plugin (watcher, plugin1);
+	g_timeout_add (1500, gs_plugin_file_watcher_timeout_cb, loop);
+	g_main_loop_run (loop);
+	g_assert_cmpint (cnt1, ==, 1);
+	g_assert_cmpint (cnt2, ==, 2);
+}
+
+static void
+gs_plugin_file_watcher_shared_func (void)
+{
+	gboolean ret;
+	guint cnt1 = 0;
+	guint cnt2 = 0;
+	const gchar *fn = "/var/tmp/self-test/file-watcher";
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path (fn);
+	g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+	g_autoptr(GsFileWatcher) watcher = gs_file_watcher_new ();
+	g_autoptr(GsPlugin) plugin1 = gs_plugin_new ();
+	g_autoptr(GsPlugin) plugin2 = gs_plugin_new ();
+
+	g_mkdir_with_parents ("/var/tmp/self-test", 0755);
+	ret = g_file_set_contents (fn, "1", -1, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	gs_plugin_set_file_watcher (plugin1, watcher);
+	gs_plugin_set_file_watcher (plugin2, watcher);
+
+	/* both plugins watching the same file share one monitor */
+	ret = gs_plugin_watch_file (plugin1, file, gs_plugin_file_watcher_cb,
+				    &cnt1, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	ret = gs_plugin_watch_file (plugin2, file, gs_plugin_file_watcher_cb,
+				    &cnt2, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpint (gs_file_watcher_get_size (watcher), ==, 1);
+
+	/* a change is delivered to each of them once */
+	ret = g_file_set_contents (fn, "2", -1, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_timeout_add (2000, gs_plugin_file_watcher_timeout_cb, loop);
+	g_main_loop_run (loop);
+	g_assert_cmpint (cnt1, ==, 1);
+	g_assert_cmpint (cnt2, ==, 1);
+
+	/* the monitor is kept until the last plugin has gone */
+	gs_file_watcher_remove_plugin (watcher, plugin1);
+	g_assert_cmpint (gs_file_watcher_get_size (watcher), ==, 1);
+	gs_file_watcher_remove_plugin (watcher, plugin2);
+	g_assert_cmpint (gs_file_watcher_get_size (watcher), ==, 0);
+}
+
 static void
 gs_plugin_func (void)
 {
 	GsAppList *list;
 	GsAppList *list_dup;
 	GsAppList *list_remove;
+	GsAppListIter iter;
 	GsApp *app;
 	guint i;
 
@@ -171,6 +347,7 @@ gs_plugin_func (void)
 	g_object_unref (list);
 	g_assert_cmpint (gs_app_list_length (list_dup), ==, 1);
 	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list_dup, 0)), ==, "a");
+	g_assert (gs_app_list_index (list_dup, 1) == NULL);
 	g_object_unref (list_dup);
 
 	/* test removing obects */
@@ -238,6 +415,53 @@ gs_plugin_func (void)
 	g_assert_cmpstr (gs_app_get_unique_id (gs_app_list_index (list, 0)), ==, "user/bar/*/*/e/*");
 	g_object_unref (list);
 
+	/* keep the order of the first duplicate when deduplicating */
+	list = gs_app_list_new ();
+	app = gs_app_new ("f");
+	gs_app_set_unique_id (app, "user/foo/*/*/f/*");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	app = gs_app_new ("g");
+	gs_app_set_unique_id (app, "user/foo/*/*/g/*");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	app = gs_app_new ("f");
+	gs_app_set_unique_id (app, "user/bar/*/*/f/*");
+	gs_app_set_priority (app, 99);
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	gs_app_list_filter_duplicates (list, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+	g_assert_cmpint (gs_app_list_length (list), ==, 2);
+	g_assert_cmpstr (gs_app_get_unique_id (gs_app_list_index (list, 0)), ==, "user/bar/*/*/f/*");
+	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list, 1)), ==, "g");
+	g_assert (gs_app_list_lookup (list, "user/foo/*/*/f/*") == NULL);
+
+	/* iterate a snapshot while the list is modified */
+	gs_app_list_iter_init (&iter, list);
+	app = gs_app_new ("h");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	gs_app_list_remove_all (list);
+	for (i = 0; gs_app_list_iter_next (&iter, &app); i++)
+		g_assert (GS_IS_APP (app));
+	g_assert_cmpint (i, ==, 2);
+	gs_app_list_iter_clear (&iter);
+
+	/* add another list in bulk */
+	list_dup = gs_app_list_new ();
+	app = gs_app_new ("i");
+	gs_app_list_add (list_dup, app);
+	g_object_unref (app);
+	app = gs_app_new ("j");
+	gs_app_list_add (list_dup, app);
+	g_object_unref (app);
+	gs_app_list_add_list (list, list_dup);
+	gs_app_list_add_list (list, list_dup);
+	g_assert_cmpint (gs_app_list_length (list), ==, 2);
+	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list, 1)), ==, "j");
+	g_object_unref (list_dup);
+	g_object_unref (list);
+
 	/* use globs when adding */
 	list = gs_app_list_new ();
 	app = gs_app_new ("b");
@@ -278,6 +502,78 @@ gs_plugin_func (void)
 	g_object_unref (list);
 }
 
+static gboolean
+gs_app_list_query_filter_cb (GsApp *app, gpointer user_data)
+{
+	return g_strcmp0 (gs_app_get_name (app), "z") != 0;
+}
+
+static gint
+gs_app_list_query_sort_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+{
+	return g_strcmp0 (gs_app_get_name (app1), gs_app_get_name (app2));
+}
+
+static void
+gs_app_list_query_func (void)
+{
+	const gchar *names[] = { "a", "b", "c", "z", NULL };
+	guint i;
+	guint max_results;
+	g_autoptr(GRand) rand = g_rand_new_with_seed (42);
+	g_autoptr(GsAppList) list_all = gs_app_list_new ();
+
+	/* lots of duplicate IDs with different priorities and equal names */
+	for (i = 0; i < 200; i++) {
+		g_autoptr(GsApp) app = NULL;
+		g_autofree gchar *id = NULL;
+		g_autofree gchar *unique_id = NULL;
+
+		id = g_strdup_printf ("app%02u", g_rand_int_range (rand, 0, 50));
+		unique_id = g_strdup_printf ("user/origin%u/*/*/%s/*", i, id);
+		app = gs_app_new (id);
+		gs_app_set_unique_id (app, unique_id);
+		gs_app_set_name (app, GS_APP_QUALITY_NORMAL,
+				 names[g_rand_int_range (rand, 0, 4)]);
+		gs_app_set_priority (app, (guint) g_rand_int_range (rand, 0, 10));
+		gs_app_list_add (list_all, app);
+	}
+	g_assert_cmpint (gs_app_list_length (list_all), ==, 200);
+
+	/* the fused pass gives the same results as one pass for each step */
+	for (max_results = 0; max_results < 60; max_results += 7) {
+		g_autoptr(GsAppList) list1 = gs_app_list_copy (list_all);
+		g_autoptr(GsAppList) list2 = gs_app_list_copy (list_all);
+		g_autoptr(GsAppListQuery) query = gs_app_list_query_new ();
+		guint len;
+
+		gs_app_list_filter (list1, gs_app_list_query_filter_cb, NULL);
+		gs_app_list_filter_duplicates (list1, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+		gs_app_list_sort (list1, gs_app_list_query_sort_cb, NULL);
+
+		gs_app_list_query_add_filter (query, gs_app_list_query_filter_cb, NULL);
+		gs_app_list_query_set_dedupe (query, GS_APP_LIST_FILTER_FLAG_PRIORITY);
+		gs_app_list_query_set_sort (query, gs_app_list_query_sort_cb, NULL);
+		gs_app_list_query_set_max_results (query, max_results);
+		gs_app_list_query_run (query, list2);
+
+		len = gs_app_list_length (list1);
+		if (max_results > 0 && max_results < len)
+			len = max_results;
+		g_assert_cmpint (gs_app_list_length (list2), ==, len);
+		for (i = 0; i < len; i++) {
+			g_assert (gs_app_list_index (list1, i) ==
+				  gs_app_list_index (list2, i));
+		}
+
+		/* the dropped apps can no longer be looked up */
+		for (i = len; i < gs_app_list_length (list1); i++) {
+			GsApp *app = gs_app_list_index (list1, i);
+			g_assert (gs_app_list_lookup (list2, gs_app_get_unique_id (app)) == NULL);
+		}
+	}
+}
+
 static void
 gs_app_unique_id_func (void)
 {
@@ -298,7 +594,9 @@ gs_app_unique_id_func (void)
 static void
 gs_app_func (void)
 {
+	g_autofree gchar *origin = NULL;
 	g_autoptr(GsApp) app = NULL;
+	g_autoptr(GsApp) app2 = NULL;
 
 	app = gs_app_new ("gnome-software.desktop");
 	g_assert (GS_IS_APP (app));
@@ -338,6 +636,23 @@ gs_app_func (void)
 	/* correctly parse URL */
 	gs_app_set_origin_hostname (app, "https://mirrors.fedoraproject.org/metalink");
 	g_assert_cmpstr (gs_app_get_origin_hostname (app), ==, "fedoraproject.org");
+
+	/* low-cardinality fields are shared between apps */
+	app2 = gs_app_new ("gnome-boxes.desktop");
+	gs_app_set_origin_hostname (app2, "https://download.fedoraproject.org/pub");
+	g_assert (gs_app_get_origin_hostname (app) == gs_app_get_origin_hostname (app2));
+	origin = g_strdup ("fedora");
+	gs_app_set_origin (app, origin);
+	gs_app_set_origin (app2, "fedora");
+	g_assert (gs_app_get_origin (app) == gs_app_get_origin (app2));
+
+	/* shared values are still valid when the other app goes away */
+	g_clear_object (&app2);
+	g_assert_cmpstr (gs_app_get_origin (app), ==, "fedora");
+	g_assert_cmpstr (gs_app_get_origin_hostname (app), ==, "fedoraproject.org");
+	gs_app_add_category (app, "Utility");
+	g_assert (gs_app_has_category (app, "Utility"));
+	g_assert (!gs_app_has_category (app, "NoSuchCategoryAnywhere"));
 }
 
 static guint _status_changed_cnt = 0;
@@ -381,6 +696,45 @@ gs_plugin_loader_install_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpint (gs_app_get_state (app), ==, AS_APP_STATE_INSTALLED);
 }
 
+static void
+gs_plugin_loader_install_queue_func (GsPluginLoader *plugin_loader)
+{
+	gboolean ret;
+	guint i;
+	g_autoptr(GsApp) app1 = NULL;
+	g_autoptr(GsApp) app2 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new ();
+
+	/* queue one app the dummy plugin batches and one it does not */
+	gs_plugin_loader_set_network_status (plugin_loader, FALSE);
+	app1 = gs_app_new ("chiron.desktop");
+	app2 = gs_app_new ("queued.desktop");
+	for (i = 0; i < 2; i++) {
+		GsApp *app = i == 0 ? app1 : app2;
+		gs_app_set_management_plugin (app, "dummy");
+		gs_app_set_state (app, AS_APP_STATE_AVAILABLE);
+		ret = gs_plugin_loader_app_action (plugin_loader, app,
+						   GS_PLUGIN_ACTION_INSTALL,
+						   NULL,
+						   &error);
+		g_assert_no_error (error);
+		g_assert (ret);
+		g_assert_cmpint (gs_app_get_state (app), ==, AS_APP_STATE_QUEUED_FOR_INSTALL);
+	}
+
+	/* going online installs the queue in the background */
+	gs_plugin_loader_set_network_status (plugin_loader, TRUE);
+	while (gs_app_get_state (app1) != AS_APP_STATE_INSTALLED ||
+	       gs_app_get_state (app2) != AS_APP_STATE_INSTALLED) {
+		g_assert_cmpfloat (g_timer_elapsed (timer, NULL), <, 10.f);
+		g_main_context_iteration (NULL, FALSE);
+		g_usleep (10000);
+	}
+	g_assert_cmpint (gs_app_get_state (app1), ==, AS_APP_STATE_INSTALLED);
+	g_assert_cmpint (gs_app_get_state (app2), ==, AS_APP_STATE_INSTALLED);
+}
+
 static void
 gs_plugin_loader_error_func (GsPluginLoader *plugin_loader)
 {
@@ -435,6 +789,76 @@ gs_plugin_loader_error_func (GsPluginLoader *plugin_loader)
 			GS_PLUGIN_ERROR_DOWNLOAD_FAILED);
 }
 
+typedef struct {
+	GMainLoop	*loop;
+	GsApp		*app_first;	/* the first app to be applied */
+} GsSelfTestUpdateHelper;
+
+static void
+gs_plugin_loader_update_pipeline_state_cb (GsApp *app,
+					   GParamSpec *pspec,
+					   GsSelfTestUpdateHelper *helper)
+{
+	if (gs_app_get_state (app) != AS_APP_STATE_INSTALLED)
+		return;
+	if (helper->app_first == NULL)
+		helper->app_first = app;
+}
+
+static void
+gs_plugin_loader_update_pipeline_cb (GObject *source,
+				     GAsyncResult *res,
+				     gpointer user_data)
+{
+	GsSelfTestUpdateHelper *helper = (GsSelfTestUpdateHelper *) user_data;
+	g_autoptr(GError) error = NULL;
+	gboolean ret;
+
+	ret = gs_plugin_loader_update_finish (GS_PLUGIN_LOADER (source),
+					      res, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_main_loop_quit (helper->loop);
+}
+
+static void
+gs_plugin_loader_update_pipeline_func (GsPluginLoader *plugin_loader)
+{
+	GsSelfTestUpdateHelper helper;
+	g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+	g_autoptr(GsApp) app_fast = gs_app_new ("ares.desktop");
+	g_autoptr(GsApp) app_slow = gs_app_new ("kronos.desktop");
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+
+	/* one app downloads much faster than the other */
+	gs_app_set_management_plugin (app_fast, "dummy");
+	gs_app_set_state (app_fast, AS_APP_STATE_UPDATABLE_LIVE);
+	gs_app_set_management_plugin (app_slow, "dummy");
+	gs_app_set_state (app_slow, AS_APP_STATE_UPDATABLE_LIVE);
+	gs_app_list_add (list, app_slow);
+	gs_app_list_add (list, app_fast);
+
+	/* the downloads run at the same time, so the fast app is applied
+	 * first even though the slow app was queued before it */
+	helper.loop = loop;
+	helper.app_first = NULL;
+	g_signal_connect (app_fast, "notify::state",
+			  G_CALLBACK (gs_plugin_loader_update_pipeline_state_cb),
+			  &helper);
+	g_signal_connect (app_slow, "notify::state",
+			  G_CALLBACK (gs_plugin_loader_update_pipeline_state_cb),
+			  &helper);
+	gs_plugin_loader_update_async (plugin_loader, list, NULL,
+				       gs_plugin_loader_update_pipeline_cb,
+				       &helper);
+	g_main_loop_run (loop);
+	g_signal_handlers_disconnect_by_data (app_fast, &helper);
+	g_signal_handlers_disconnect_by_data (app_slow, &helper);
+	g_assert_cmpint (gs_app_get_state (app_fast), ==, AS_APP_STATE_INSTALLED);
+	g_assert_cmpint (gs_app_get_state (app_slow), ==, AS_APP_STATE_INSTALLED);
+	g_assert (helper.app_first == app_fast);
+}
+
 static void
 gs_plugin_loader_refine_func (GsPluginLoader *plugin_loader)
 {
@@ -459,6 +883,71 @@ gs_plugin_loader_refine_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpstr (gs_app_get_url (app, AS_URL_KIND_HOMEPAGE), ==, "http://www.test.org/");
 }
 
+static void
+gs_plugin_loader_app_map_func (GsPluginLoader *plugin_loader)
+{
+	gboolean ret;
+	g_autofree gchar *unique_id = NULL;
+	g_autoptr(GsApp) app = NULL;
+	g_autoptr(GsApp) app2 = NULL;
+	g_autoptr(GsApp) app_live = NULL;
+	g_autoptr(GsAppList) list = NULL;
+	g_autoptr(GsAppList) list_refined = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* refining makes the app the live object for the component */
+	app = gs_app_new ("gs-self-test-app-map.desktop");
+	gs_app_set_unique_id (app, "system/package/dummy/desktop/"
+			      "gs-self-test-app-map.desktop/master");
+	ret = gs_plugin_loader_app_refine (plugin_loader, app,
+					   GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+					   NULL,
+					   &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	unique_id = g_strdup (gs_app_get_unique_id (app));
+	app_live = gs_plugin_loader_app_lookup (plugin_loader, unique_id);
+	g_assert (app_live == app);
+	g_clear_object (&app_live);
+
+	/* getting the app by ID returns the same object */
+	app_live = gs_plugin_loader_get_app_by_id (plugin_loader,
+						   "gs-self-test-app-map.desktop",
+						   GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+						   NULL,
+						   &error);
+	g_assert_no_error (error);
+	g_assert (app_live == app);
+	g_clear_object (&app_live);
+
+	/* a partial unique ID is never the live object of a component */
+	app_live = gs_plugin_loader_app_lookup (plugin_loader,
+						"*/*/*/*/gs-self-test-app-map.desktop/*");
+	g_assert (app_live == NULL);
+
+	/* refining a mix of refined and new apps keeps the order */
+	list = gs_app_list_new ();
+	app2 = gs_app_new ("gs-self-test-app-map2.desktop");
+	gs_app_list_add (list, app2);
+	gs_app_list_add (list, app);
+	list_refined = gs_plugin_loader_refine (plugin_loader, list,
+						GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+						NULL,
+						&error);
+	g_assert_no_error (error);
+	g_assert (list_refined != NULL);
+	g_assert_cmpint (gs_app_list_length (list_refined), ==, 2);
+	g_assert (gs_app_list_index (list_refined, 0) == app2);
+	g_assert (gs_app_list_index (list_refined, 1) == app);
+	g_clear_object (&list_refined);
+	g_clear_object (&list);
+
+	/* the loader does not keep the app alive */
+	g_clear_object (&app);
+	app_live = gs_plugin_loader_app_lookup (plugin_loader, unique_id);
+	g_assert (app_live == NULL);
+}
+
 static void
 gs_plugin_loader_key_colors_func (GsPluginLoader *plugin_loader)
 {
@@ -663,6 +1152,275 @@ gs_plugin_loader_search_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpint (gs_app_get_kind (app), ==, AS_APP_KIND_DESKTOP);
 }
 
+static void
+gs_plugin_loader_search_narrow_func (GsPluginLoader *plugin_loader)
+{
+	GsApp *app;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+	g_autoptr(GsAppList) list_narrow = NULL;
+
+	/* a less specific search first */
+	list = gs_plugin_loader_search (plugin_loader,
+					"teaching",
+					GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					NULL,
+					&error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	g_assert_cmpint (gs_app_list_length (list), >, 0);
+
+	/* only the app with the spelling addon still matches, and the
+	 * spelling app that was not found before is not added */
+	list_narrow = gs_plugin_loader_search_narrow (plugin_loader,
+						      list,
+						      "teaching spell",
+						      GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+						      NULL,
+						      &error);
+	g_assert_no_error (error);
+	g_assert (list_narrow != NULL);
+	g_assert_cmpint (gs_app_list_length (list_narrow), ==, 1);
+	app = gs_app_list_index (list_narrow, 0);
+	g_assert_cmpstr (gs_app_get_id (app), ==, "zeus.desktop");
+	g_assert_cmpint (gs_app_get_match_value (app), !=, 0);
+}
+
+typedef struct {
+	GMainLoop	*loop;
+	GsAppList	*list;		/* final */
+	guint		 results;	/* calls of the results function */
+	gboolean	 narrowable_done;
+} GsSelfTestSearchHelper;
+
+static void
+gs_plugin_loader_search_incremental_results_cb (GsPluginLoader *plugin_loader,
+						GsAppList *list,
+						gboolean narrowable_done,
+						gpointer user_data)
+{
+	GsSelfTestSearchHelper *helper = (GsSelfTestSearchHelper *) user_data;
+
+	/* nothing is passed after the local results are complete */
+	g_assert (helper->list == NULL);
+	g_assert (list != NULL);
+	helper->results++;
+	if (narrowable_done)
+		helper->narrowable_done = TRUE;
+}
+
+static void
+gs_plugin_loader_search_incremental_cb (GObject *source,
+					GAsyncResult *res,
+					gpointer user_data)
+{
+	GsSelfTestSearchHelper *helper = (GsSelfTestSearchHelper *) user_data;
+	g_autoptr(GError) error = NULL;
+
+	helper->list = gs_plugin_loader_search_finish (GS_PLUGIN_LOADER (source),
+						       res, &error);
+	g_assert_no_error (error);
+	g_assert (helper->list != NULL);
+	g_main_loop_quit (helper->loop);
+}
+
+static void
+gs_plugin_loader_search_incremental_func (GsPluginLoader *plugin_loader)
+{
+	GsApp *app;
+	GsSelfTestSearchHelper helper;
+	guint i;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+	g_autoptr(GsAppList) list = NULL;
+
+	/* the results function is called before the search completes */
+	helper.loop = loop;
+	helper.list = NULL;
+	helper.results = 0;
+	helper.narrowable_done = FALSE;
+	gs_plugin_loader_search_incremental_async (plugin_loader,
+						   "teaching",
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+						   gs_plugin_loader_search_incremental_results_cb,
+						   &helper,
+						   NULL,
+						   gs_plugin_loader_search_incremental_cb,
+						   &helper);
+	g_main_loop_run (loop);
+	g_assert_cmpint (helper.results, >, 0);
+	g_assert (helper.narrowable_done);
+
+	/* the final list is the same as from a normal search */
+	list = gs_plugin_loader_search (plugin_loader,
+					"teaching",
+					GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					NULL,
+					&error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	g_assert_cmpint (gs_app_list_length (helper.list), ==, gs_app_list_length (list));
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		app = gs_app_list_index (list, i);
+		g_assert (gs_app_list_lookup (helper.list, gs_app_get_unique_id (app)) != NULL);
+	}
+	g_object_unref (helper.list);
+}
+
+static void
+gs_plugin_loader_search_rank_func (GsPluginLoader *plugin_loader)
+{
+	GsApp *app;
+	guint i;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	/* the dummy plugin does not set a match value itself */
+	list = gs_plugin_loader_search (plugin_loader,
+					"massive",
+					GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					NULL,
+					&error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+
+	/* only the best results are kept */
+	g_assert_cmpint (gs_app_list_length (list), ==, GS_PLUGIN_LOADER_SEARCH_MAX_RESULTS);
+
+	/* a match in the name outweighs being popular */
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		app = gs_app_list_index (list, i);
+		g_assert_cmpint (gs_app_get_match_value (app), !=, 0);
+		if (i < 50)
+			g_assert (g_str_has_prefix (gs_app_get_name (app), "Massive "));
+		else
+			g_assert (g_str_has_prefix (gs_app_get_name (app), "Item "));
+	}
+	app = gs_app_list_index (list, 0);
+	g_assert_cmpint (gs_app_get_match_value (app), >,
+			 gs_app_get_match_value (gs_app_list_index (list, 50)));
+}
+
+static void
+gs_plugin_loader_locale_func (GsPluginLoader *plugin_loader)
+{
+	GsApp *app_tmp;
+	gboolean ret;
+	guint i;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsApp) app = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	/* only the French and untranslated entries are kept */
+	ret = gs_plugin_loader_set_locale (plugin_loader, "fr_FR", NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	app = gs_plugin_loader_get_app_by_id (plugin_loader, "zeus.desktop",
+					      GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+					      NULL, &error);
+	g_assert_no_error (error);
+	g_assert (app != NULL);
+	g_assert_cmpstr (gs_app_get_name (app), ==, "Zeus le professeur");
+	g_assert_cmpstr (gs_app_get_summary (app), ==, "Une application pour enseigner");
+	g_clear_object (&app);
+
+	/* the untranslated text can still be searched for */
+	list = gs_plugin_loader_search (plugin_loader, "teaching",
+					GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					NULL, &error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		app_tmp = gs_app_list_index (list, i);
+		if (g_strcmp0 (gs_app_get_id (app_tmp), "zeus.desktop") == 0)
+			app = g_object_ref (app_tmp);
+	}
+	g_assert (app != NULL);
+	g_assert_cmpstr (gs_app_get_name (app), ==, "Zeus le professeur");
+	g_clear_object (&app);
+
+	/* falls back to the untranslated entry, which was not overwritten */
+	ret = gs_plugin_loader_set_locale (plugin_loader, "en_GB", NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	app = gs_plugin_loader_get_app_by_id (plugin_loader, "zeus.desktop",
+					      GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+					      NULL, &error);
+	g_assert_no_error (error);
+	g_assert (app != NULL);
+	g_assert_cmpstr (gs_app_get_name (app), ==, "Zeus");
+	g_assert_cmpstr (gs_app_get_summary (app), ==, "A teaching application");
+}
+
+static void
+gs_plugin_loader_compact_func (GsPluginLoader *plugin_loader)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsApp) app = NULL;
+
+	/* the details were dropped from the store when it was loaded */
+	app = gs_plugin_loader_get_app_by_id (plugin_loader, "zeus.desktop",
+					      GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+					      NULL, &error);
+	g_assert_no_error (error);
+	g_assert (app != NULL);
+	g_assert (gs_app_has_kudo (app, GS_APP_KUDO_HAS_SCREENSHOTS));
+	g_assert_cmpint (gs_app_get_screenshots(app)->len, ==, 0);
+	g_clear_object (&app);
+
+	/* but they can be got back for the details page */
+	app = gs_plugin_loader_get_app_by_id (plugin_loader, "zeus.desktop",
+					      GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION |
+					      GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS,
+					      NULL, &error);
+	g_assert_no_error (error);
+	g_assert (app != NULL);
+	g_assert_cmpstr (gs_app_get_description (app), ==, "Zeus helps with teaching.");
+	g_assert_cmpint (gs_app_get_screenshots(app)->len, ==, 1);
+}
+
+static void
+gs_plugin_loader_stats_func (GsPluginLoader *plugin_loader)
+{
+	GVariantIter iter;
+	GVariant *histogram;
+	const gchar *function_name;
+	const gchar *plugin_name;
+	gboolean found = FALSE;
+	guint calls, errors, cancelled;
+	guint64 total_us, max_us;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+	g_autoptr(GVariant) stats = NULL;
+
+	/* call something the dummy plugin implements */
+	list = gs_plugin_loader_get_installed (plugin_loader,
+					       GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+					       NULL,
+					       &error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+
+	/* check it was recorded */
+	stats = gs_plugin_loader_get_stats (plugin_loader);
+	g_assert (g_variant_is_of_type (stats, G_VARIANT_TYPE ("a(ssuuutta(tu))")));
+	g_variant_iter_init (&iter, stats);
+	while (g_variant_iter_loop (&iter, "(&s&suuutt@a(tu))",
+				    &plugin_name, &function_name,
+				    &calls, &errors, &cancelled,
+				    &total_us, &max_us, &histogram)) {
+		if (g_strcmp0 (plugin_name, "dummy") != 0 ||
+		    g_strcmp0 (function_name, "gs_plugin_add_installed") != 0)
+			continue;
+		g_assert_cmpint (calls, >=, 1);
+		g_assert_cmpint (errors, ==, 0);
+		g_assert_cmpint (max_us, <=, total_us);
+		g_assert_cmpint (g_variant_n_children (histogram), >=, 1);
+		found = TRUE;
+	}
+	g_assert (found);
+}
+
 static void
 gs_plugin_loader_modalias_func (GsPluginLoader *plugin_loader)
 {
@@ -1333,7 +2091,16 @@ main (int argc, char **argv)
 		"  <component type=\"desktop\">\n"
 		"    <id>zeus.desktop</id>\n"
 		"    <name>Zeus</name>\n"
+		"    <name xml:lang=\"fr\">Zeus le professeur</name>\n"
+		"    <name xml:lang=\"de\">Zeus der Lehrer</name>\n"
 		"    <summary>A teaching application</summary>\n"
+		"    <summary xml:lang=\"fr\">Une application pour enseigner</summary>\n"
+		"    <description><p>Zeus helps with teaching.</p></description>\n"
+		"    <screenshots>\n"
+		"      <screenshot type=\"default\">\n"
+		"        <image type=\"source\">http://127.0.0.1/zeus.png</image>\n"
+		"      </screenshot>\n"
+		"    </screenshots>\n"
 		"    <pkgname>zeus</pkgname>\n"
 		"    <icon type=\"stock\">drive-harddisk</icon>\n"
 		"    <categories>\n"
@@ -1406,8 +2173,13 @@ main (int argc, char **argv)
 	g_test_add_func ("/gnome-software/app", gs_app_func);
 	g_test_add_func ("/gnome-software/app{unique-id}", gs_app_unique_id_func);
 	g_test_add_func ("/gnome-software/plugin", gs_plugin_func);
+	g_test_add_func ("/gnome-software/app-list{query}", gs_app_list_query_func);
 	g_test_add_func ("/gnome-software/plugin{global-cache}", gs_plugin_global_cache_func);
+	g_test_add_func ("/gnome-software/plugin{file-watcher}", gs_plugin_file_watcher_func);
+	g_test_add_func ("/gnome-software/plugin{file-watcher-shared}", gs_plugin_file_watcher_shared_func);
 	g_test_add_func ("/gnome-software/auth{secret}", gs_auth_secret_func);
+	g_test_add_func ("/gnome-software/change-set", gs_change_set_func);
+	g_test_add_func ("/gnome-software/content-rating", gs_content_rating_func);
 
 	/* we can only load this once per process */
 	plugin_loader = gs_plugin_loader_new ();
@@ -1460,24 +2232,51 @@ main (int argc, char **argv)
 	g_test_add_data_func ("/gnome-software/plugin-loader{search}",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugin_loader_search_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{search-narrow}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_search_narrow_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{search-incremental}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_search_incremental_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{search-rank}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_search_rank_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{locale}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_locale_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{compact}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_compact_func);
 	g_test_add_data_func ("/gnome-software/plugin-loader{install}",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugin_loader_install_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{install-queue}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_install_queue_func);
 	g_test_add_data_func ("/gnome-software/plugin-loader{error}",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugin_loader_error_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{update-pipeline}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_update_pipeline_func);
 	g_test_add_data_func ("/gnome-software/plugin-loader{installed}",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugin_loader_installed_func);
 	g_test_add_data_func ("/gnome-software/plugin-loader{refine}",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugin_loader_refine_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{app-map}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_app_map_func);
 	g_test_add_data_func ("/gnome-software/plugin-loader{updates}",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugin_loader_updates_func);
 	g_test_add_data_func ("/gnome-software/plugin-loader{distro-upgrades}",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugin_loader_distro_upgrades_func);
+	g_test_add_data_func ("/gnome-software/plugin-loader{stats}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugin_loader_stats_func);
 
 	/* done last as it would otherwise try to do downloading in other
 	 * gs_plugin_file_to_app()-using tests */
@@ -71,39 +71,48 @@ app_tile_clicked (GsAppTile *tile, gpointer data)
 	gs_shell_show_app (self->shell, app);
 }
 
+static GtkWidget *
+gs_shell_category_create_tile_cb (GsApp *app, gpointer user_data)
+{
+	GsShellCategory *self = GS_SHELL_CATEGORY (user_data);
+	GtkWidget *tile;
+
+	tile = gs_summary_tile_new (app);
+	g_signal_connect (tile, "clicked",
+			  G_CALLBACK (app_tile_clicked), self);
+	return tile;
+}
+
 static void
 gs_shell_category_get_apps_cb (GObject *source_object,
 			       GAsyncResult *res,
 			       gpointer user_data)
 {
-	guint i;
-	GsApp *app;
-	GtkWidget *tile;
+	GList *l;
 	GsShellCategory *self = GS_SHELL_CATEGORY (user_data);
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GList) children = NULL;
 	g_autoptr(GsAppList) list = NULL;
 
-	/* show an empty space for no results */
-	gs_container_remove_all (GTK_CONTAINER (self->category_detail_box));
-
 	list = gs_plugin_loader_get_category_apps_finish (plugin_loader,
 							  res,
 							  &error);
 	if (list == NULL) {
 		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
 			g_warning ("failed to get apps for category apps: %s", error->message);
+
+		/* show an empty space for no results */
+		gs_container_remove_all (GTK_CONTAINER (self->category_detail_box));
 		return;
 	}
 
-	for (i = 0; i < gs_app_list_length (list); i++) {
-		app = gs_app_list_index (list, i);
-		tile = gs_summary_tile_new (app);
-		g_signal_connect (tile, "clicked",
-				  G_CALLBACK (app_tile_clicked), self);
-		gtk_container_add (GTK_CONTAINER (self->category_detail_box), tile);
-		gtk_widget_set_can_focus (gtk_widget_get_parent (tile), FALSE);
-	}
+	/* this also removes the placeholder tiles */
+	gs_container_set_apps (GTK_CONTAINER (self->category_detail_box), list,
+			       gs_shell_category_create_tile_cb, self);
+	children = gtk_container_get_children (GTK_CONTAINER (self->category_detail_box));
+	for (l = children; l != NULL; l = l->next)
+		gtk_widget_set_can_focus (GTK_WIDGET (l->data), FALSE);
 
 	/* seems a good place */
 	gs_shell_profile_dump (self->shell);
@@ -115,6 +124,7 @@ gs_shell_category_reload (GsPage *page)
 	GsShellCategory *self = GS_SHELL_CATEGORY (page);
 	GtkWidget *tile;
 	guint i, count;
+	g_autoptr(GList) children = NULL;
 
 	if (self->subcategory == NULL)
 		return;
@@ -137,8 +147,10 @@ gs_shell_category_reload (GsPage *page)
 		gtk_widget_set_visible (self->infobar_category_shell_extensions, FALSE);
 	}
 
-	gs_container_remove_all (GTK_CONTAINER (self->category_detail_box));
-	count = MIN(30, gs_category_get_size (self->subcategory));
+	/* show placeholders until the first results arrive, but keep the
+	 * existing tiles on a reload so they can be reused */
+	children = gtk_container_get_children (GTK_CONTAINER (self->category_detail_box));
+	count = children == NULL ? MIN(30, gs_category_get_size (self->subcategory)) : 0;
 	for (i = 0; i < count; i++) {
 		tile = gs_summary_tile_new (NULL);
 		gtk_container_add (GTK_CONTAINER (self->category_detail_box), tile);
@@ -155,10 +167,19 @@ gs_shell_category_reload (GsPage *page)
 						  self);
 }
 
+static gboolean
+gs_shell_category_changed (GsPage *page, GsChangeSet *changes)
+{
+	/* installing or removing an app does not change the category */
+	return TRUE;
+}
+
 static void
 gs_shell_category_populate_filtered (GsShellCategory *self, GsCategory *subcategory)
 {
 	g_assert (subcategory != NULL);
+	if (self->subcategory != subcategory)
+		gs_container_remove_all (GTK_CONTAINER (self->category_detail_box));
 	g_set_object (&self->subcategory, subcategory);
 	gs_shell_category_reload (GS_PAGE (self));
 }
@@ -286,6 +307,7 @@ gs_shell_category_class_init (GsShellCategoryClass *klass)
 	object_class->dispose = gs_shell_category_dispose;
 	page_class->switch_to = gs_shell_category_switch_to;
 	page_class->reload = gs_shell_category_reload;
+	page_class->changed = gs_shell_category_changed;
 
 	gtk_widget_class_set_template_from_resource (widget_class, "/org/gnome/Software/gs-shell-category.ui");
 
@@ -1033,32 +1033,36 @@ list_sort_func (GtkListBoxRow *a,
 
 static void gs_shell_details_addon_selected_cb (GsAppAddonRow *row, GParamSpec *pspec, GsShellDetails *self);
 
+static GtkWidget *
+gs_shell_details_create_addon_row_cb (GsApp *addon, gpointer user_data)
+{
+	GsShellDetails *self = GS_SHELL_DETAILS (user_data);
+	GtkWidget *row;
+
+	row = gs_app_addon_row_new (addon);
+	gtk_widget_show (row);
+	g_signal_connect (row, "notify::selected",
+			  G_CALLBACK (gs_shell_details_addon_selected_cb),
+			  self);
+	return row;
+}
+
 static void
 gs_shell_details_refresh_addons (GsShellDetails *self)
 {
 	GPtrArray *addons;
 	guint i;
-
-	gs_container_remove_all (GTK_CONTAINER (self->list_box_addons));
+	g_autoptr(GsAppList) list = gs_app_list_new ();
 
 	addons = gs_app_get_addons (self->app);
 	for (i = 0; i < addons->len; i++) {
-		GsApp *addon;
-		GtkWidget *row;
-
-		addon = g_ptr_array_index (addons, i);
+		GsApp *addon = g_ptr_array_index (addons, i);
 		if (gs_app_get_state (addon) == AS_APP_STATE_UNAVAILABLE)
 			continue;
-
-		row = gs_app_addon_row_new (addon);
-
-		gtk_container_add (GTK_CONTAINER (self->list_box_addons), row);
-		gtk_widget_show (row);
-
-		g_signal_connect (row, "notify::selected",
-				  G_CALLBACK (gs_shell_details_addon_selected_cb),
-				  self);
+		gs_app_list_add (list, addon);
 	}
+	gs_container_set_apps (GTK_CONTAINER (self->list_box_addons), list,
+			       gs_shell_details_create_addon_row_cb, self);
 }
 
 static void gs_shell_details_refresh_reviews (GsShellDetails *self);
@@ -1336,7 +1340,6 @@ gs_shell_details_content_rating_set_css (GtkWidget *widget, guint age)
 static void
 gs_shell_details_refresh_content_rating (GsShellDetails *self)
 {
-	AsContentRating *content_rating;
 	GsContentRatingSystem system;
 	guint age = 0;
 	gchar *str;
@@ -1357,9 +1360,8 @@ gs_shell_details_refresh_content_rating (GsShellDetails *self)
 		 locale);
 
 	/* only show the button if a game and has a content rating */
-	content_rating = gs_app_get_content_rating (self->app);
-	if (content_rating != NULL) {
-		age = as_content_rating_get_minimum_age (content_rating);
+	if (gs_app_get_content_rating (self->app) != NULL) {
+		age = gs_app_get_content_age (self->app);
 		display = gs_utils_content_rating_age_to_str (system, age);
 	}
 	if (display != NULL) {
@@ -1499,6 +1501,8 @@ gs_shell_details_load (GsShellDetails *self)
 					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
 					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_PERMISSIONS |
 					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE |
+					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION |
+					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS |
 					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_SIZE |
 					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION |
 					   GS_PLUGIN_REFINE_FLAGS_REQUIRE_HISTORY |
@@ -1522,6 +1526,17 @@ gs_shell_details_reload (GsPage *page)
 		gs_shell_details_load (self);
 }
 
+static gboolean
+gs_shell_details_changed (GsPage *page, GsChangeSet *changes)
+{
+	GsShellDetails *self = GS_SHELL_DETAILS (page);
+
+	/* only reload if it is the app being shown */
+	if (self->app == NULL)
+		return TRUE;
+	return !gs_change_set_has_unique_id (changes, gs_app_get_unique_id (self->app));
+}
+
 static void
 settings_changed_cb (GsShellDetails *self,
 		     const gchar *key,
@@ -2072,6 +2087,7 @@ gs_shell_details_class_init (GsShellDetailsClass *klass)
 	page_class->app_removed = gs_shell_details_app_removed;
 	page_class->switch_to = gs_shell_details_switch_to;
 	page_class->reload = gs_shell_details_reload;
+	page_class->changed = gs_shell_details_changed;
 
 	gtk_widget_class_set_template_from_resource (widget_class, "/org/gnome/Software/gs-shell-details.ui");
 
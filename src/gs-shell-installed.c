@@ -263,6 +263,52 @@ gs_shell_installed_reload (GsPage *page)
 	gs_shell_installed_load (self);
 }
 
+static gboolean
+gs_shell_installed_has_app (GsShellInstalled *self, const gchar *unique_id)
+{
+	GList *l;
+	g_autoptr(GList) children = NULL;
+
+	children = gtk_container_get_children (GTK_CONTAINER (self->list_box_install));
+	for (l = children; l; l = l->next) {
+		GsApp *app = gs_app_row_get_app (GS_APP_ROW (l->data));
+		if (g_strcmp0 (gs_app_get_unique_id (app), unique_id) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static gboolean
+gs_shell_installed_changed (GsPage *page, GsChangeSet *changes)
+{
+	GsShellInstalled *self = GS_SHELL_INSTALLED (page);
+	GPtrArray *added = gs_change_set_get_added (changes);
+	guint i;
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+
+	/* the next load will get everything anyway */
+	if (!self->cache_valid || self->waiting)
+		return TRUE;
+
+	/* removed rows are unrevealed when the app state changes, so only
+	 * the newly installed apps need adding */
+	for (i = 0; i < added->len; i++) {
+		const gchar *unique_id = g_ptr_array_index (added, i);
+		g_autoptr(GsApp) app = NULL;
+		if (gs_shell_installed_has_app (self, unique_id))
+			continue;
+		app = gs_plugin_loader_app_lookup (self->plugin_loader, unique_id);
+		if (app == NULL)
+			return FALSE;
+		if (gs_app_get_state (app) != AS_APP_STATE_INSTALLED &&
+		    gs_app_get_state (app) != AS_APP_STATE_UPDATABLE &&
+		    gs_app_get_state (app) != AS_APP_STATE_UPDATABLE_LIVE)
+			continue;
+		gs_shell_installed_add_app (self, list, app);
+	}
+	return TRUE;
+}
+
 static void
 gs_shell_update_button_select_visibility (GsShellInstalled *self)
 {
@@ -784,6 +830,7 @@ gs_shell_installed_class_init (GsShellInstalledClass *klass)
 	page_class->app_removed = gs_shell_installed_app_removed;
 	page_class->switch_to = gs_shell_installed_switch_to;
 	page_class->reload = gs_shell_installed_reload;
+	page_class->changed = gs_shell_installed_changed;
 
 	gtk_widget_class_set_template_from_resource (widget_class, "/org/gnome/Software/gs-shell-installed.ui");
 
@@ -45,10 +45,7 @@ typedef struct
 	gboolean		 cache_valid;
 	GsShell			*shell;
 	gint			 action_cnt;
-	gboolean		 loading_featured;
-	gboolean		 loading_popular;
-	gboolean		 loading_popular_rotating;
-	gboolean		 loading_categories;
+	gboolean		 loading;
 	gboolean		 empty;
 	gchar			*category_of_day;
 	GtkWidget		*search_button;
@@ -81,16 +78,15 @@ enum {
 static guint signals [SIGNAL_LAST] = { 0 };
 
 typedef struct {
-        GsCategory	*category;
+        GPtrArray	*categories;	/* of GsCategory, with a featured child */
         GsShellOverview	*self;
-        const gchar	*title;
 } LoadData;
 
 static void
 load_data_free (LoadData *data)
 {
-        if (data->category != NULL)
-                g_object_unref (data->category);
+        if (data->categories != NULL)
+                g_ptr_array_unref (data->categories);
         if (data->self != NULL)
                 g_object_unref (data->self);
         g_slice_free (LoadData, data);
@@ -145,28 +141,18 @@ gs_shell_overview_decrement_action_cnt (GsShellOverview *self)
 }
 
 static void
-gs_shell_overview_get_popular_cb (GObject *source_object,
-				  GAsyncResult *res,
-				  gpointer user_data)
+gs_shell_overview_set_popular (GsShellOverview *self, GsAppList *list)
 {
-	GsShellOverview *self = GS_SHELL_OVERVIEW (user_data);
 	GsShellOverviewPrivate *priv = gs_shell_overview_get_instance_private (self);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
 	guint i;
 	GsApp *app;
 	GtkWidget *tile;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GsAppList) list = NULL;
 
-	/* get popular apps */
-	list = gs_plugin_loader_get_popular_finish (plugin_loader, res, &error);
 	gtk_widget_set_visible (priv->box_popular, list != NULL);
 	gtk_widget_set_visible (priv->popular_heading, list != NULL);
-	if (list == NULL) {
-		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-			g_warning ("failed to get popular apps: %s", error->message);
-		goto out;
-	}
+	if (list == NULL)
+		return;
+
 	/* Don't show apps from the category that's currently featured as the category of the day */
 	gs_app_list_filter (list, filter_category, priv->category_of_day);
 	gs_app_list_randomize (list);
@@ -182,10 +168,6 @@ gs_shell_overview_get_popular_cb (GObject *source_object,
 	}
 
 	priv->empty = FALSE;
-
-out:
-	priv->loading_popular = FALSE;
-	gs_shell_overview_decrement_action_cnt (self);
 }
 
 static void
@@ -204,15 +186,38 @@ gs_shell_overview_category_more_cb (GtkButton *button, GsShellOverview *self)
 	gs_shell_show_category (priv->shell, cat);
 }
 
+static const gchar *
+gs_shell_overview_get_category_label (const gchar *id)
+{
+	if (g_strcmp0 (id, "audio-video") == 0) {
+		/* TRANSLATORS: this is a heading for audio applications which
+		 * have been featured ('recommended') by the distribution */
+		return _("Recommended Audio & Video Applications");
+	}
+	if (g_strcmp0 (id, "games") == 0) {
+		/* TRANSLATORS: this is a heading for games which have been
+		 * featured ('recommended') by the distribution */
+		return _("Recommended Games");
+	}
+	if (g_strcmp0 (id, "graphics") == 0) {
+		/* TRANSLATORS: this is a heading for graphics applications
+		 * which have been featured ('recommended') by the distribution */
+		return _("Recommended Graphics Applications");
+	}
+	if (g_strcmp0 (id, "productivity") == 0) {
+		/* TRANSLATORS: this is a heading for office applications which
+		 * have been featured ('recommended') by the distribution */
+		return _("Recommended Productivity Applications");
+	}
+	return NULL;
+}
+
 static void
-gs_shell_overview_get_category_apps_cb (GObject *source_object,
-					GAsyncResult *res,
-					gpointer user_data)
+gs_shell_overview_add_category_apps (GsShellOverview *self,
+				     GsCategory *category,
+				     GsAppList *list)
 {
-	LoadData *load_data = (LoadData *) user_data;
-	GsShellOverview *self = load_data->self;
 	GsShellOverviewPrivate *priv = gs_shell_overview_get_instance_private (self);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
 	guint i;
 	GsApp *app;
 	GtkWidget *box;
@@ -220,24 +225,13 @@ gs_shell_overview_get_category_apps_cb (GObject *source_object,
 	GtkWidget *headerbox;
 	GtkWidget *label;
 	GtkWidget *tile;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GsAppList) list = NULL;
 
-	/* get popular apps */
-	list = gs_plugin_loader_get_category_apps_finish (plugin_loader, res, &error);
-	if (list == NULL) {
-		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-			goto out;
-		g_warning ("failed to get category %s featured applications: %s",
-			   gs_category_get_id (load_data->category),
-			   error->message);
-		goto out;
-	} else if (gs_app_list_length (list) < N_TILES) {
+	if (gs_app_list_length (list) < N_TILES) {
 		g_warning ("hiding category %s featured applications: "
 			   "found only %u to show, need at least %d",
-			   gs_category_get_id (load_data->category),
+			   gs_category_get_id (category),
 			   gs_app_list_length (list), N_TILES);
-		goto out;
+		return;
 	}
 	gs_app_list_randomize (list);
 
@@ -246,7 +240,7 @@ gs_shell_overview_get_category_apps_cb (GObject *source_object,
 	gtk_widget_set_visible (headerbox, TRUE);
 
 	/* add label */
-	label = gtk_label_new (load_data->title);
+	label = gtk_label_new (gs_shell_overview_get_category_label (gs_category_get_id (category)));
 	gtk_widget_set_visible (label, TRUE);
 	gtk_label_set_xalign (GTK_LABEL (label), 0.f);
 	gtk_widget_set_margin_top (label, 24);
@@ -261,7 +255,7 @@ gs_shell_overview_get_category_apps_cb (GObject *source_object,
 	gtk_style_context_add_class (gtk_widget_get_style_context (button),
 				     "overview-more-button");
 	g_object_set_data_full (G_OBJECT (button), "GnomeSoftware::CategoryId",
-				g_strdup (gs_category_get_id (load_data->category)),
+				g_strdup (gs_category_get_id (category)),
 				g_free);
 	gtk_widget_set_visible (button, TRUE);
 	gtk_widget_set_valign (button, GTK_ALIGN_END);
@@ -288,29 +282,20 @@ gs_shell_overview_get_category_apps_cb (GObject *source_object,
 	}
 
 	priv->empty = FALSE;
-
-out:
-	load_data_free (load_data);
-	priv->loading_popular_rotating = FALSE;
-	gs_shell_overview_decrement_action_cnt (self);
 }
 
 static void
-gs_shell_overview_get_featured_cb (GObject *source_object,
-				   GAsyncResult *res,
-				   gpointer user_data)
+gs_shell_overview_set_featured (GsShellOverview *self, GsAppList *list)
 {
-	GsShellOverview *self = GS_SHELL_OVERVIEW (user_data);
 	GsShellOverviewPrivate *priv = gs_shell_overview_get_instance_private (self);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
 	GtkWidget *tile;
 	GsApp *app;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GsAppList) list = NULL;
 
-	list = gs_plugin_loader_get_featured_finish (plugin_loader, res, &error);
-	if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-		goto out;
+	/* the loader has already warned about the failure */
+	if (list == NULL) {
+		gs_container_remove_all (GTK_CONTAINER (priv->bin_featured));
+		return;
+	}
 
 	if (g_getenv ("GNOME_SOFTWARE_FEATURED") == NULL) {
 		/* Don't show apps from the category that's currently featured as the category of the day */
@@ -319,15 +304,10 @@ gs_shell_overview_get_featured_cb (GObject *source_object,
 	}
 
 	gs_container_remove_all (GTK_CONTAINER (priv->bin_featured));
-	if (list == NULL) {
-		g_warning ("failed to get featured apps: %s",
-			   error->message);
-		goto out;
-	}
 	if (gs_app_list_length (list) == 0) {
 		g_warning ("failed to get featured apps: "
 			   "no apps to show");
-		goto out;
+		return;
 	}
 
 	/* at the moment, we only care about the first app */
@@ -339,10 +319,6 @@ gs_shell_overview_get_featured_cb (GObject *source_object,
 	gtk_container_add (GTK_CONTAINER (priv->bin_featured), tile);
 
 	priv->empty = FALSE;
-
-out:
-	priv->loading_featured = FALSE;
-	gs_shell_overview_decrement_action_cnt (self);
 }
 
 static void
@@ -357,33 +333,21 @@ category_tile_clicked (GsCategoryTile *tile, gpointer data)
 }
 
 static void
-gs_shell_overview_get_categories_cb (GObject *source_object,
-				     GAsyncResult *res,
-				     gpointer user_data)
+gs_shell_overview_set_categories (GsShellOverview *self, GPtrArray *list)
 {
-	GsShellOverview *self = GS_SHELL_OVERVIEW (user_data);
 	GsShellOverviewPrivate *priv = gs_shell_overview_get_instance_private (self);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
 	guint i;
 	GsCategory *cat;
 	GtkFlowBox *flowbox;
 	GtkWidget *tile;
 	const guint MAX_CATS_PER_SECTION = 6;
 	guint added_cnt = 0;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GPtrArray) list = NULL;
 
-	list = gs_plugin_loader_get_categories_finish (plugin_loader, res, &error);
-	if (list == NULL) {
-		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-			g_warning ("failed to get categories: %s", error->message);
-		goto out;
-	}
 	gs_container_remove_all (GTK_CONTAINER (priv->flowbox_categories));
 	gs_container_remove_all (GTK_CONTAINER (priv->flowbox_categories2));
 
 	/* add categories to the correct flowboxes, the second being hidden */
-	for (i = 0; i < list->len; i++) {
+	for (i = 0; list != NULL && i < list->len; i++) {
 		cat = GS_CATEGORY (g_ptr_array_index (list, i));
 		if (gs_category_get_size (cat) == 0)
 			continue;
@@ -409,39 +373,54 @@ gs_shell_overview_get_categories_cb (GObject *source_object,
 	/* show the expander if we have too many children */
 	gtk_widget_set_visible (priv->categories_expander,
 				added_cnt > MAX_CATS_PER_SECTION);
-out:
 	if (added_cnt > 0)
 		priv->empty = FALSE;
 	gtk_widget_set_visible (priv->category_heading, added_cnt > 0);
-
-	priv->loading_categories = FALSE;
-	gs_shell_overview_decrement_action_cnt (self);
 }
 
-static const gchar *
-gs_shell_overview_get_category_label (const gchar *id)
+static void
+gs_shell_overview_get_overview_cb (GObject *source_object,
+				   GAsyncResult *res,
+				   gpointer user_data)
 {
-	if (g_strcmp0 (id, "audio-video") == 0) {
-		/* TRANSLATORS: this is a heading for audio applications which
-		 * have been featured ('recommended') by the distribution */
-		return _("Recommended Audio & Video Applications");
-	}
-	if (g_strcmp0 (id, "games") == 0) {
-		/* TRANSLATORS: this is a heading for games which have been
-		 * featured ('recommended') by the distribution */
-		return _("Recommended Games");
-	}
-	if (g_strcmp0 (id, "graphics") == 0) {
-		/* TRANSLATORS: this is a heading for graphics applications
-		 * which have been featured ('recommended') by the distribution */
-		return _("Recommended Graphics Applications");
+	LoadData *load_data = (LoadData *) user_data;
+	GsShellOverview *self = load_data->self;
+	GsShellOverviewPrivate *priv = gs_shell_overview_get_instance_private (self);
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
+	guint i;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) categories = NULL;
+	g_autoptr(GPtrArray) category_apps = NULL;
+	g_autoptr(GsAppList) featured = NULL;
+	g_autoptr(GsAppList) popular = NULL;
+
+	/* get everything in one go */
+	if (!gs_plugin_loader_get_overview_finish (plugin_loader, res,
+						   &featured,
+						   &popular,
+						   &categories,
+						   &category_apps,
+						   &error)) {
+		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED)) {
+			g_warning ("failed to get overview: %s", error->message);
+			gs_shell_overview_set_popular (self, NULL);
+		}
+		goto out;
 	}
-	if (g_strcmp0 (id, "productivity") == 0) {
-		/* TRANSLATORS: this is a heading for office applications which
-		 * have been featured ('recommended') by the distribution */
-		return _("Recommended Productivity Applications");
+
+	gs_shell_overview_set_featured (self, featured);
+	gs_shell_overview_set_popular (self, popular);
+	for (i = 0; i < category_apps->len; i++) {
+		GsCategory *category = g_ptr_array_index (load_data->categories, i);
+		GsAppList *list = g_ptr_array_index (category_apps, i);
+		gs_shell_overview_add_category_apps (self, category, list);
 	}
-	return NULL;
+	gs_shell_overview_set_categories (self, categories);
+
+out:
+	load_data_free (load_data);
+	priv->loading = FALSE;
+	gs_shell_overview_decrement_action_cnt (self);
 }
 
 static GPtrArray *
@@ -483,77 +462,51 @@ static void
 gs_shell_overview_load (GsShellOverview *self)
 {
 	GsShellOverviewPrivate *priv = gs_shell_overview_get_instance_private (self);
+	const guint MAX_CATS = 2;
 	guint i;
+	LoadData *load_data;
+	g_autoptr(GPtrArray) cats_featured = NULL;
+	g_autoptr(GPtrArray) cats_random = NULL;
 
 	priv->empty = TRUE;
 
-	if (!priv->loading_featured) {
-		priv->loading_featured = TRUE;
-		gs_plugin_loader_get_featured_async (priv->plugin_loader,
-						     GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
-						     priv->cancellable,
-						     gs_shell_overview_get_featured_cb,
-						     self);
-		priv->action_cnt++;
-	}
-
-	if (!priv->loading_popular) {
-		priv->loading_popular = TRUE;
-		gs_plugin_loader_get_popular_async (priv->plugin_loader,
-						    GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEW_RATINGS |
-						    GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
-						    priv->cancellable,
-						    gs_shell_overview_get_popular_cb,
-						    self);
-		priv->action_cnt++;
-	}
+	if (priv->loading)
+		return;
 
-	if (!priv->loading_popular_rotating) {
-		const guint MAX_CATS = 2;
-		g_autoptr(GPtrArray) cats_random = NULL;
-		cats_random = gs_shell_overview_get_random_categories ();
-
-		/* load all the categories */
-		for (i = 0; i < cats_random->len && i < MAX_CATS; i++) {
-			LoadData *load_data;
-			const gchar *cat_id;
-			g_autoptr(GsCategory) category = NULL;
-			g_autoptr(GsCategory) featured_category = NULL;
-
-			cat_id = g_ptr_array_index (cats_random, i);
-			if (i == 0) {
-				g_free (priv->category_of_day);
-				priv->category_of_day = g_strdup (cat_id);
-			}
-			category = gs_category_new (cat_id);
-			featured_category = gs_category_new ("featured");
-			gs_category_add_child (category, featured_category);
-
-			load_data = g_slice_new0 (LoadData);
-			load_data->category = g_object_ref (category);
-			load_data->self = g_object_ref (self);
-			load_data->title = gs_shell_overview_get_category_label (cat_id);
-			gs_plugin_loader_get_category_apps_async (priv->plugin_loader,
-								  featured_category,
-								  GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEW_RATINGS |
-								  GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
-								  priv->cancellable,
-								  gs_shell_overview_get_category_apps_cb,
-								  load_data);
-			priv->action_cnt++;
+	/* get the featured apps of some random categories */
+	load_data = g_slice_new0 (LoadData);
+	load_data->self = g_object_ref (self);
+	load_data->categories = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	cats_featured = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	cats_random = gs_shell_overview_get_random_categories ();
+	for (i = 0; i < cats_random->len && i < MAX_CATS; i++) {
+		const gchar *cat_id;
+		g_autoptr(GsCategory) category = NULL;
+		g_autoptr(GsCategory) featured_category = NULL;
+
+		cat_id = g_ptr_array_index (cats_random, i);
+		if (i == 0) {
+			g_free (priv->category_of_day);
+			priv->category_of_day = g_strdup (cat_id);
 		}
-		priv->loading_popular_rotating = TRUE;
+		category = gs_category_new (cat_id);
+		featured_category = gs_category_new ("featured");
+		gs_category_add_child (category, featured_category);
+		g_ptr_array_add (load_data->categories, g_object_ref (category));
+		g_ptr_array_add (cats_featured, g_object_ref (featured_category));
 	}
 
-	if (!priv->loading_categories) {
-		priv->loading_categories = TRUE;
-		gs_plugin_loader_get_categories_async (priv->plugin_loader,
-						       GS_PLUGIN_REFINE_FLAGS_DEFAULT,
-						       priv->cancellable,
-						       gs_shell_overview_get_categories_cb,
-						       self);
-		priv->action_cnt++;
-	}
+	/* one plugin pass and one refine for everything on the page */
+	priv->loading = TRUE;
+	gs_plugin_loader_get_overview_async (priv->plugin_loader,
+					     cats_featured,
+					     GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					     GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEW_RATINGS |
+					     GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					     priv->cancellable,
+					     gs_shell_overview_get_overview_cb,
+					     load_data);
+	priv->action_cnt++;
 }
 
 static void
@@ -564,6 +517,14 @@ gs_shell_overview_reload (GsPage *page)
 	gs_shell_overview_load (self);
 }
 
+static gboolean
+gs_shell_overview_changed (GsPage *page, GsChangeSet *changes)
+{
+	/* the tiles share the app objects, so they already show the new
+	 * state and the featured and popular lists do not depend on it */
+	return TRUE;
+}
+
 static void
 gs_shell_overview_switch_to (GsPage *page, gboolean scroll_up)
 {
@@ -856,6 +817,7 @@ gs_shell_overview_class_init (GsShellOverviewClass *klass)
 	object_class->dispose = gs_shell_overview_dispose;
 	page_class->switch_to = gs_shell_overview_switch_to;
 	page_class->reload = gs_shell_overview_reload;
+	page_class->changed = gs_shell_overview_changed;
 	klass->refreshed = gs_shell_overview_refreshed;
 
 	signals [SIGNAL_REFRESHED] =
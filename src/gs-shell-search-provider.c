@@ -28,7 +28,7 @@
 #include <glib/gi18n.h>
 
 #include "gs-app-list-private.h"
-#include "gs-plugin-loader-sync.h"
+#include "gs-plugin-loader.h"
 
 #include "gs-shell-search-provider-generated.h"
 #include "gs-shell-search-provider.h"
@@ -36,6 +36,9 @@
 typedef struct {
 	GsShellSearchProvider *provider;
 	GDBusMethodInvocation *invocation;
+	gchar **results;
+	GsAppList *list;	/* for GetResultMetas */
+	guint refine_pending;
 } PendingSearch;
 
 struct _GsShellSearchProvider {
@@ -45,7 +48,9 @@ struct _GsShellSearchProvider {
 	GsPluginLoader *plugin_loader;
 	GCancellable *cancellable;
 
-	GHashTable *metas_cache;
+	GHashTable *metas_cache;	/* id : GVariant */
+	GHashTable *search_apps;	/* id : GsApp */
+	gboolean search_truncated;
 };
 
 G_DEFINE_TYPE (GsShellSearchProvider, gs_shell_search_provider, G_TYPE_OBJECT)
@@ -53,68 +58,106 @@ G_DEFINE_TYPE (GsShellSearchProvider, gs_shell_search_provider, G_TYPE_OBJECT)
 static void
 pending_search_free (PendingSearch *search)
 {
-	g_object_unref (search->invocation);
+	if (search->invocation != NULL)
+		g_object_unref (search->invocation);
+	g_strfreev (search->results);
+	if (search->list != NULL)
+		g_object_unref (search->list);
 	g_slice_free (PendingSearch, search);
 }
 
-static gint
-search_sort_by_kudo_cb (GsApp *app1, GsApp *app2, gpointer user_data)
-{
-	guint pa, pb;
-	pa = gs_app_get_kudos_percentage (app1);
-	pb = gs_app_get_kudos_percentage (app2);
-	if (pa < pb)
-		return 1;
-	else if (pa > pb)
-		return -1;
-	return 0;
-}
-
+/* the invocation can only be replied to once */
 static void
-search_done_cb (GObject *source,
-		GAsyncResult *res,
-		gpointer user_data)
+reply_search_results (PendingSearch *search, GsAppList *list)
 {
-	PendingSearch *search = user_data;
 	GsShellSearchProvider *self = search->provider;
 	guint i;
 	GVariantBuilder builder;
-	g_autoptr(GsAppList) list = NULL;
 
-	list = gs_plugin_loader_search_finish (self->plugin_loader, res, NULL);
 	if (list == NULL) {
 		g_dbus_method_invocation_return_value (search->invocation, g_variant_new ("(as)", NULL));
-		pending_search_free (search);
-		g_application_release (g_application_get_default ());
-		return;	
+		g_clear_object (&search->invocation);
+		return;
 	}
 
-	/* sort by kudos, as there is no ratings data by default */
-	gs_app_list_sort (list, search_sort_by_kudo_cb, NULL);
+	/* less relevant results were dropped, so they cannot be narrowed */
+	self->search_truncated = gs_app_list_length (list) >= GS_PLUGIN_LOADER_SEARCH_MAX_RESULTS;
 
+	/* the loader has already ranked the results, so keep the order, and
+	 * keep the refined apps around so GetResultMetas and
+	 * GetSubsearchResultSet can reuse them */
+	g_hash_table_remove_all (self->search_apps);
 	g_variant_builder_init (&builder, G_VARIANT_TYPE ("as"));
 	for (i = 0; i < gs_app_list_length (list); i++) {
 		GsApp *app = gs_app_list_index (list, i);
 		if (gs_app_get_state (app) != AS_APP_STATE_AVAILABLE)
 			continue;
 		g_variant_builder_add (&builder, "s", gs_app_get_id (app));
+		g_hash_table_insert (self->search_apps,
+				     g_strdup (gs_app_get_id (app)),
+				     g_object_ref (app));
 	}
 	g_dbus_method_invocation_return_value (search->invocation, g_variant_new ("(as)", &builder));
+	g_clear_object (&search->invocation);
+}
 
+static void
+return_search_results (PendingSearch *search, GsAppList *list)
+{
+	if (search->invocation != NULL)
+		reply_search_results (search, list);
 	pending_search_free (search);
 	g_application_release (g_application_get_default ());
 }
 
 static void
-execute_search (GsShellSearchProvider  *self,
-		GDBusMethodInvocation  *invocation,
-		gchar		 **terms)
+search_results_cb (GsPluginLoader *plugin_loader,
+		   GsAppList *list,
+		   gboolean narrowable_done,
+		   gpointer user_data)
 {
-	PendingSearch *pending_search;
-	g_autofree gchar *string = NULL;
+	PendingSearch *search = user_data;
 
-	string = g_strjoinv (" ", terms);
+	/* the shell cannot be sent more results later, so reply once the
+	 * local metadata has been searched rather than waiting for plugins
+	 * using the network; the cached results are then complete for the
+	 * plugins a subsearch will not ask again */
+	if (search->invocation == NULL || !narrowable_done)
+		return;
+	reply_search_results (search, list);
+}
+
+static void
+search_done_cb (GObject *source,
+		GAsyncResult *res,
+		gpointer user_data)
+{
+	PendingSearch *search = user_data;
+	GsShellSearchProvider *self = search->provider;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_search_finish (self->plugin_loader, res, NULL);
+	return_search_results (search, list);
+}
+
+static void
+search_narrow_done_cb (GObject *source,
+		       GAsyncResult *res,
+		       gpointer user_data)
+{
+	PendingSearch *search = user_data;
+	GsShellSearchProvider *self = search->provider;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_search_narrow_finish (self->plugin_loader, res, NULL);
+	return_search_results (search, list);
+}
 
+static gboolean
+cancel_search (GsShellSearchProvider  *self,
+	       GDBusMethodInvocation  *invocation,
+	       gchar		**terms)
+{
 	if (self->cancellable != NULL) {
 		g_cancellable_cancel (self->cancellable);
 		g_clear_object (&self->cancellable);
@@ -124,21 +167,90 @@ execute_search (GsShellSearchProvider  *self,
 	if (g_strv_length (terms) == 1 &&
 	    g_utf8_strlen (terms[0], -1) == 1) {
 		g_dbus_method_invocation_return_value (invocation, g_variant_new ("(as)", NULL));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void
+execute_search (GsShellSearchProvider  *self,
+		GDBusMethodInvocation  *invocation,
+		gchar		 **terms)
+{
+	PendingSearch *pending_search;
+	g_autofree gchar *string = NULL;
+
+	if (!cancel_search (self, invocation, terms))
+		return;
+
+	string = g_strjoinv (" ", terms);
+	pending_search = g_slice_new0 (PendingSearch);
+	pending_search->provider = self;
+	pending_search->invocation = g_object_ref (invocation);
+
+	g_application_hold (g_application_get_default ());
+	self->cancellable = g_cancellable_new ();
+	gs_plugin_loader_search_incremental_async (self->plugin_loader,
+						   string,
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+						   search_results_cb,
+						   pending_search,
+						   self->cancellable,
+						   search_done_cb,
+						   pending_search);
+}
+
+static void
+execute_subsearch (GsShellSearchProvider  *self,
+		   GDBusMethodInvocation  *invocation,
+		   gchar		**previous_results,
+		   gchar		**terms)
+{
+	PendingSearch *pending_search;
+	guint i;
+	g_autofree gchar *string = NULL;
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+
+	/* the shell only asks for a subsearch when the new terms are
+	 * more specific, so the previous results can be filtered */
+	if (self->search_truncated) {
+		g_debug ("previous results incomplete, doing full search");
+		execute_search (self, invocation, terms);
 		return;
 	}
+	for (i = 0; previous_results[i] != NULL; i++) {
+		GsApp *app = g_hash_table_lookup (self->search_apps,
+						  previous_results[i]);
+		if (app == NULL) {
+			g_debug ("no cached app for %s, doing full search",
+				 previous_results[i]);
+			execute_search (self, invocation, terms);
+			return;
+		}
+		gs_app_list_add (list, app);
+	}
 
-	pending_search = g_slice_new (PendingSearch);
+	if (!cancel_search (self, invocation, terms))
+		return;
+
+	string = g_strjoinv (" ", terms);
+	pending_search = g_slice_new0 (PendingSearch);
 	pending_search->provider = self;
 	pending_search->invocation = g_object_ref (invocation);
 
 	g_application_hold (g_application_get_default ());
 	self->cancellable = g_cancellable_new ();
-	gs_plugin_loader_search_async (self->plugin_loader,
-				       string,
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
-				       self->cancellable,
-				       search_done_cb,
-				       pending_search);
+	gs_plugin_loader_search_narrow_async (self->plugin_loader,
+					      list,
+					      string,
+					      GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+					      GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION |
+					      GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+					      self->cancellable,
+					      search_narrow_done_cb,
+					      pending_search);
 }
 
 static gboolean
@@ -164,10 +276,195 @@ handle_get_subsearch_result_set (GsShellSearchProvider2	*skeleton,
 	GsShellSearchProvider *self = user_data;
 
 	g_debug ("****** GetSubSearchResultSet");
-	execute_search (self, invocation, terms);
+	execute_subsearch (self, invocation, previous_results, terms);
 	return TRUE;
 }
 
+/* the file the cached AppStream icon was installed into, if it exists */
+static gchar *
+get_cached_icon_filename (AsIcon *ic)
+{
+	g_autofree gchar *fn = NULL;
+
+	if (as_icon_get_filename (ic) != NULL &&
+	    g_file_test (as_icon_get_filename (ic), G_FILE_TEST_EXISTS))
+		return g_strdup (as_icon_get_filename (ic));
+	if (as_icon_get_prefix (ic) == NULL || as_icon_get_name (ic) == NULL)
+		return NULL;
+	fn = g_strdup_printf ("%s/%ux%u/%s",
+			      as_icon_get_prefix (ic),
+			      as_icon_get_width (ic),
+			      as_icon_get_height (ic),
+			      as_icon_get_name (ic));
+	if (g_file_test (fn, G_FILE_TEST_EXISTS))
+		return g_steal_pointer (&fn);
+	return NULL;
+}
+
+static GIcon *
+get_app_icon (GsApp *app)
+{
+	GPtrArray *icons;
+	GdkPixbuf *pixbuf;
+	guint i;
+
+	/* prefer something the shell can load itself */
+	icons = gs_app_get_icons (app);
+	for (i = 0; i < icons->len; i++) {
+		AsIcon *ic = g_ptr_array_index (icons, i);
+		const gchar *fn;
+		g_autofree gchar *fn_cached = NULL;
+		g_autoptr(GFile) file = NULL;
+
+		switch (as_icon_get_kind (ic)) {
+		case AS_ICON_KIND_STOCK:
+			/* the shell does not know about any extra theme path */
+			if (as_icon_get_name (ic) == NULL ||
+			    as_icon_get_prefix (ic) != NULL)
+				break;
+			return g_themed_icon_new (as_icon_get_name (ic));
+		case AS_ICON_KIND_LOCAL:
+			fn = as_icon_get_filename (ic);
+			if (fn == NULL || !g_file_test (fn, G_FILE_TEST_EXISTS))
+				break;
+			file = g_file_new_for_path (fn);
+			return g_file_icon_new (file);
+		case AS_ICON_KIND_CACHED:
+			fn_cached = get_cached_icon_filename (ic);
+			if (fn_cached == NULL)
+				break;
+			file = g_file_new_for_path (fn_cached);
+			return g_file_icon_new (file);
+		default:
+			break;
+		}
+	}
+
+	/* fall back to sending the whole image */
+	pixbuf = gs_app_get_pixbuf (app);
+	if (pixbuf != NULL)
+		return G_ICON (g_object_ref (pixbuf));
+	return NULL;
+}
+
+static void
+add_app_meta (GsShellSearchProvider *self, GsApp *app, const gchar *id)
+{
+	GVariantBuilder meta;
+	GVariant *meta_variant;
+	g_autoptr(GIcon) icon = NULL;
+
+	/* not refined successfully */
+	if (gs_app_get_name (app) == NULL) {
+		g_debug ("no name for %s, ignoring", id);
+		return;
+	}
+
+	g_variant_builder_init (&meta, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&meta, "{sv}", "id", g_variant_new_string (id));
+	g_variant_builder_add (&meta, "{sv}", "name", g_variant_new_string (gs_app_get_name (app)));
+	icon = get_app_icon (app);
+	if (icon != NULL)
+		g_variant_builder_add (&meta, "{sv}", "icon", g_icon_serialize (icon));
+	if (gs_app_get_summary (app) != NULL)
+		g_variant_builder_add (&meta, "{sv}", "description", g_variant_new_string (gs_app_get_summary (app)));
+	meta_variant = g_variant_builder_end (&meta);
+	g_hash_table_insert (self->metas_cache, g_strdup (id), g_variant_ref_sink (meta_variant));
+}
+
+static void
+return_result_metas (GsShellSearchProvider *self,
+		     GDBusMethodInvocation *invocation,
+		     gchar **results)
+{
+	GVariantBuilder builder;
+	guint i;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+	for (i = 0; results[i] != NULL; i++) {
+		GVariant *meta_variant;
+		meta_variant = g_hash_table_lookup (self->metas_cache, results[i]);
+		if (meta_variant == NULL)
+			continue;
+		g_variant_builder_add_value (&builder, meta_variant);
+	}
+	g_dbus_method_invocation_return_value (invocation, g_variant_new ("(aa{sv})", &builder));
+}
+
+static void
+add_app_metas (GsShellSearchProvider *self, GsAppList *list)
+{
+	guint i;
+
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		add_app_meta (self, app, gs_app_get_id (app));
+	}
+}
+
+static void
+get_result_metas_refine_app_cb (GObject *source,
+				GAsyncResult *res,
+				gpointer user_data)
+{
+	PendingSearch *search = user_data;
+	GsShellSearchProvider *self = search->provider;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_refine_finish (self->plugin_loader, res, &error);
+	if (list == NULL)
+		g_warning ("failed to refine result: %s", error->message);
+	else
+		add_app_metas (self, list);
+
+	/* wait for the other results */
+	if (--search->refine_pending > 0)
+		return;
+	return_result_metas (self, search->invocation, search->results);
+
+	pending_search_free (search);
+	g_application_release (g_application_get_default ());
+}
+
+static void
+get_result_metas_refine_cb (GObject *source,
+			    GAsyncResult *res,
+			    gpointer user_data)
+{
+	PendingSearch *search = user_data;
+	GsShellSearchProvider *self = search->provider;
+	guint i;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_refine_finish (self->plugin_loader, res, &error);
+	if (list != NULL) {
+		add_app_metas (self, list);
+		return_result_metas (self, search->invocation, search->results);
+		pending_search_free (search);
+		g_application_release (g_application_get_default ());
+		return;
+	}
+
+	/* one bad result should not hide all the others, so try each one
+	 * on its own and return the metas of those that could be refined */
+	g_warning ("failed to refine results, trying each one: %s",
+		   error->message);
+	search->refine_pending = gs_app_list_length (search->list);
+	for (i = 0; i < gs_app_list_length (search->list); i++) {
+		g_autoptr(GsAppList) list_app = gs_app_list_new ();
+		gs_app_list_add (list_app, gs_app_list_index (search->list, i));
+		gs_plugin_loader_refine_async (self->plugin_loader,
+					       list_app,
+					       GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+					       GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION,
+					       NULL,
+					       get_result_metas_refine_app_cb,
+					       search);
+	}
+}
+
 static gboolean
 handle_get_result_metas (GsShellSearchProvider2	*skeleton,
 			 GDBusMethodInvocation	 *invocation,
@@ -175,57 +472,52 @@ handle_get_result_metas (GsShellSearchProvider2	*skeleton,
 			 gpointer		       user_data)
 {
 	GsShellSearchProvider *self = user_data;
-	GVariantBuilder meta;
-	GVariant *meta_variant;
-	GdkPixbuf *pixbuf;
-	gint i;
-	GVariantBuilder builder;
-	GError *error = NULL;
+	PendingSearch *pending_search;
+	guint i;
+	g_autoptr(GsAppList) list = NULL;
 
 	g_debug ("****** GetResultMetas");
 
+	list = gs_app_list_new ();
 	for (i = 0; results[i]; i++) {
-		g_autoptr(GsApp) app = NULL;
+		GsApp *app;
+		g_autoptr(GsApp) app_new = NULL;
 
 		if (g_hash_table_lookup (self->metas_cache, results[i]))
 			continue;
 
-		/* find the application with this ID */
-		app = gs_plugin_loader_get_app_by_id (self->plugin_loader,
-						      results[i],
-						      GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
-						      GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION,
-						      NULL,
-						      &error);
-		if (app == NULL) {
-			g_warning ("failed to refine %s: %s",
-				   results[i], error->message);
-			g_clear_error (&error);
+		/* already refined by the search */
+		app = g_hash_table_lookup (self->search_apps, results[i]);
+		if (app != NULL) {
+			add_app_meta (self, app, results[i]);
 			continue;
 		}
 
-		g_variant_builder_init (&meta, G_VARIANT_TYPE ("a{sv}"));
-		g_variant_builder_add (&meta, "{sv}", "id", g_variant_new_string (gs_app_get_id (app)));
-		g_variant_builder_add (&meta, "{sv}", "name", g_variant_new_string (gs_app_get_name (app)));
-		pixbuf = gs_app_get_pixbuf (app);
-		if (pixbuf != NULL)
-			g_variant_builder_add (&meta, "{sv}", "icon", g_icon_serialize (G_ICON (pixbuf)));
-		g_variant_builder_add (&meta, "{sv}", "description", g_variant_new_string (gs_app_get_summary (app)));
-		meta_variant = g_variant_builder_end (&meta);
-		g_hash_table_insert (self->metas_cache, g_strdup (gs_app_get_id (app)), g_variant_ref_sink (meta_variant));
-
+		/* resolve all the others in one batch */
+		app_new = gs_app_new (results[i]);
+		gs_app_list_add (list, app_new);
 	}
 
-	g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
-	for (i = 0; results[i]; i++) {
-		meta_variant = (GVariant*)g_hash_table_lookup (self->metas_cache, results[i]);
-		if (meta_variant == NULL)
-			continue;
-		g_variant_builder_add_value (&builder, meta_variant);
+	/* nothing to refine */
+	if (gs_app_list_length (list) == 0) {
+		return_result_metas (self, invocation, results);
+		return TRUE;
 	}
 
-	g_dbus_method_invocation_return_value (invocation, g_variant_new ("(aa{sv})", &builder));
+	pending_search = g_slice_new0 (PendingSearch);
+	pending_search->provider = self;
+	pending_search->invocation = g_object_ref (invocation);
+	pending_search->results = g_strdupv (results);
+	pending_search->list = g_object_ref (list);
 
+	g_application_hold (g_application_get_default ());
+	gs_plugin_loader_refine_async (self->plugin_loader,
+				       list,
+				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION,
+				       NULL,
+				       get_result_metas_refine_cb,
+				       pending_search);
 	return TRUE;
 }
 
@@ -296,6 +588,10 @@ search_provider_dispose (GObject *obj)
 		g_hash_table_destroy (self->metas_cache);
 		self->metas_cache = NULL;
 	}
+	if (self->search_apps != NULL) {
+		g_hash_table_destroy (self->search_apps);
+		self->search_apps = NULL;
+	}
 
 	g_clear_object (&self->plugin_loader);
 	g_clear_object (&self->skeleton);
@@ -308,6 +604,8 @@ gs_shell_search_provider_init (GsShellSearchProvider *self)
 {
 	self->metas_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
 						   g_free, (GDestroyNotify) g_variant_unref);
+	self->search_apps = g_hash_table_new_full (g_str_hash, g_str_equal,
+						   g_free, (GDestroyNotify) g_object_unref);
 
 	self->skeleton = gs_shell_search_provider2_skeleton_new ();
 
@@ -91,16 +91,72 @@ gs_shell_search_waiting_cancel (GsShellSearch *self)
 	self->waiting_id = 0;
 }
 
+static GtkWidget *
+gs_shell_search_create_row_cb (GsApp *app, gpointer user_data)
+{
+	GsShellSearch *self = GS_SHELL_SEARCH (user_data);
+	GtkWidget *app_row;
+
+	app_row = gs_app_row_new (app);
+	gs_app_row_set_show_sandbox (GS_APP_ROW (app_row), TRUE);
+	g_signal_connect (app_row, "button-clicked",
+			  G_CALLBACK (gs_shell_search_app_row_clicked_cb),
+			  self);
+	gs_app_row_set_size_groups (GS_APP_ROW (app_row),
+				    self->sizegroup_image,
+				    self->sizegroup_name);
+	gtk_widget_show (app_row);
+	return app_row;
+}
+
+static void
+gs_shell_search_show_results (GsShellSearch *self, GsAppList *list)
+{
+	GList *l;
+	g_autoptr(GList) children = NULL;
+
+	/* only create rows for the results that are new */
+	gs_stop_spinner (GTK_SPINNER (self->spinner_search));
+	gtk_stack_set_visible_child_name (GTK_STACK (self->stack_search), "results");
+	gs_container_set_apps (GTK_CONTAINER (self->list_box_search), list,
+			       gs_shell_search_create_row_cb, self);
+
+	/* this depends on the other results */
+	children = gtk_container_get_children (GTK_CONTAINER (self->list_box_search));
+	for (l = children; l != NULL; l = l->next) {
+		GsAppRow *app_row = GS_APP_ROW (l->data);
+		GsApp *app = gs_app_row_get_app (app_row);
+		gs_app_row_set_show_source (app_row,
+					    !gs_app_has_quirk (app, AS_APP_QUIRK_PROVENANCE) ||
+					    gs_utils_list_has_app_fuzzy (list, app));
+	}
+}
+
+static void
+gs_shell_search_get_search_results_cb (GsPluginLoader *plugin_loader,
+				       GsAppList *list,
+				       gboolean narrowable_done,
+				       gpointer user_data)
+{
+	GsShellSearch *self = GS_SHELL_SEARCH (user_data);
+
+	/* wait for the final list to show there were no results */
+	if (gs_app_list_length (list) == 0)
+		return;
+
+	/* the list box sorts the rows, so they do not jump around as more
+	 * results come in */
+	gs_shell_search_waiting_cancel (self);
+	gs_shell_search_show_results (self, list);
+}
+
 static void
 gs_shell_search_get_search_cb (GObject *source_object,
 			       GAsyncResult *res,
 			       gpointer user_data)
 {
-	guint i;
-	GsApp *app;
 	GsShellSearch *self = GS_SHELL_SEARCH (user_data);
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
-	GtkWidget *app_row;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GsAppList) list = NULL;
 
@@ -126,27 +182,8 @@ gs_shell_search_get_search_cb (GObject *source_object,
 		return;
 	}
 
-	/* remove old entries */
-	gs_container_remove_all (GTK_CONTAINER (self->list_box_search));
-
-	gs_stop_spinner (GTK_SPINNER (self->spinner_search));
-	gtk_stack_set_visible_child_name (GTK_STACK (self->stack_search), "results");
-	for (i = 0; i < gs_app_list_length (list); i++) {
-		app = gs_app_list_index (list, i);
-		app_row = gs_app_row_new (app);
-		gs_app_row_set_show_sandbox (GS_APP_ROW (app_row), TRUE);
-		if (!gs_app_has_quirk (app, AS_APP_QUIRK_PROVENANCE) ||
-		    gs_utils_list_has_app_fuzzy (list, app))
-			gs_app_row_set_show_source (GS_APP_ROW (app_row), TRUE);
-		g_signal_connect (app_row, "button-clicked",
-				  G_CALLBACK (gs_shell_search_app_row_clicked_cb),
-				  self);
-		gtk_container_add (GTK_CONTAINER (self->list_box_search), app_row);
-		gs_app_row_set_size_groups (GS_APP_ROW (app_row),
-					    self->sizegroup_image,
-					    self->sizegroup_name);
-		gtk_widget_show (app_row);
-	}
+	/* this may remove rows shown for earlier partial results */
+	gs_shell_search_show_results (self, list);
 
 	if (self->appid_to_show != NULL) {
 		g_autoptr (GsApp) a = NULL;
@@ -185,22 +222,24 @@ gs_shell_search_load (GsShellSearch *self)
 	gs_shell_search_waiting_cancel (self);
 	self->waiting_id = g_timeout_add (250, gs_shell_search_waiting_show_cb, self);
 
-	gs_plugin_loader_search_async (self->plugin_loader,
-				       self->value,
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROVENANCE |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_HISTORY |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_SETUP_ACTION |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEW_RATINGS |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_PERMISSIONS |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME |
-				       GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
-				       self->search_cancellable,
-				       gs_shell_search_get_search_cb,
-				       self);
+	gs_plugin_loader_search_incremental_async (self->plugin_loader,
+						   self->value,
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROVENANCE |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_HISTORY |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_SETUP_ACTION |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEW_RATINGS |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_PERMISSIONS |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME |
+						   GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+						   gs_shell_search_get_search_results_cb,
+						   self,
+						   self->search_cancellable,
+						   gs_shell_search_get_search_cb,
+						   self);
 }
 
 static void
@@ -211,6 +250,14 @@ gs_shell_search_reload (GsPage *page)
 		gs_shell_search_load (self);
 }
 
+static gboolean
+gs_shell_search_changed (GsPage *page, GsChangeSet *changes)
+{
+	/* the rows follow the state of each app, and the results would be
+	 * the same if the search was run again */
+	return TRUE;
+}
+
 /**
  * gs_shell_search_set_appid_to_show:
  *
@@ -275,14 +322,15 @@ gs_shell_search_switch_to (GsPage *page, gboolean scroll_up)
  *
  * 1. Application rating
  * 2. Length of the long description
- * 3. Number of screenshots
- * 4. Install date
- * 5. Name
+ * 3. Install date
+ * 4. Name
+ *
+ * The screenshots are not used, as they are only loaded for the details
+ * page; the kudos already say if they exist.
  **/
 static gchar *
 gs_shell_search_get_app_sort_key (GsApp *app)
 {
-	GPtrArray *ss;
 	GString *key;
 	const gchar *desc;
 
@@ -313,10 +361,6 @@ gs_shell_search_get_app_sort_key (GsApp *app)
 	g_string_append_printf (key, "%03" G_GSIZE_FORMAT ":",
 				desc != NULL ? strlen (desc) : 0);
 
-	/* sort by number of screenshots */
-	ss = gs_app_get_screenshots (app);
-	g_string_append_printf (key, "%02u:", ss->len);
-
 	/* sort by install date */
 	g_string_append_printf (key, "%09" G_GUINT64_FORMAT ":",
 				G_MAXUINT64 - gs_app_get_install_date (app));
@@ -474,6 +518,7 @@ gs_shell_search_class_init (GsShellSearchClass *klass)
 	page_class->app_removed = gs_shell_search_app_removed;
 	page_class->switch_to = gs_shell_search_switch_to;
 	page_class->reload = gs_shell_search_reload;
+	page_class->changed = gs_shell_search_changed;
 
 	gtk_widget_class_set_template_from_resource (widget_class, "/org/gnome/Software/gs-shell-search.ui");
 
@@ -496,6 +496,7 @@ gs_shell_updates_get_updates_cb (GsPluginLoader *plugin_loader,
 		widget = GTK_WIDGET (gtk_builder_get_object (self->builder,
 							     "button_updates_counter"));
 		gtk_widget_hide (widget);
+		gs_container_remove_all (GTK_CONTAINER (self->list_box_updates));
 		return;
 	}
 
@@ -508,8 +509,8 @@ gs_shell_updates_get_updates_cb (GsPluginLoader *plugin_loader,
 			self->all_updates_are_live = FALSE;
 		if (gs_app_has_quirk (app, AS_APP_QUIRK_NEEDS_REBOOT))
 			self->any_require_reboot = TRUE;
-		gs_update_list_add_app (GS_UPDATE_LIST (self->list_box_updates), app);
 	}
+	gs_update_list_set_apps (GS_UPDATE_LIST (self->list_box_updates), list);
 
 	/* change the button as to whether a reboot is required to
 	 * apply all the updates */
@@ -592,7 +593,6 @@ gs_shell_updates_load (GsShellUpdates *self)
 
 	if (self->action_cnt > 0)
 		return;
-	gs_container_remove_all (GTK_CONTAINER (self->list_box_updates));
 	refine_flags = GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
 		       GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS |
 		       GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROVENANCE |
@@ -626,6 +626,15 @@ gs_shell_updates_reload (GsPage *page)
 	gs_shell_updates_load (self);
 }
 
+static gboolean
+gs_shell_updates_changed (GsPage *page, GsChangeSet *changes)
+{
+	/* newly installed apps are already up to date, but anything removed
+	 * or updated may have to be dropped from the list */
+	return gs_change_set_get_removed (changes)->len == 0 &&
+		gs_change_set_get_changed (changes)->len == 0;
+}
+
 static void
 gs_shell_updates_switch_to (GsPage *page,
 			    gboolean scroll_up)
@@ -1435,6 +1444,7 @@ gs_shell_updates_class_init (GsShellUpdatesClass *klass)
 	object_class->dispose = gs_shell_updates_dispose;
 	page_class->switch_to = gs_shell_updates_switch_to;
 	page_class->reload = gs_shell_updates_reload;
+	page_class->changed = gs_shell_updates_changed;
 
 	gtk_widget_class_set_template_from_resource (widget_class, "/org/gnome/Software/gs-shell-updates.ui");
 
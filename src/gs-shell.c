@@ -627,16 +627,18 @@ main_window_closed_cb (GtkWidget *dialog, GdkEvent *event, gpointer user_data)
 }
 
 static void
-gs_shell_reload_cb (GsPluginLoader *plugin_loader, GsShell *shell)
+gs_shell_changed_cb (GsPluginLoader *plugin_loader,
+		     GsChangeSet *changes,
+		     GsShell *shell)
 {
 	GsShellPrivate *priv = gs_shell_get_instance_private (shell);
-	gs_page_reload (GS_PAGE (priv->shell_category));
-	gs_page_reload (GS_PAGE (priv->shell_extras));
-	gs_page_reload (GS_PAGE (priv->shell_details));
-	gs_page_reload (GS_PAGE (priv->shell_installed));
-	gs_page_reload (GS_PAGE (priv->shell_overview));
-	gs_page_reload (GS_PAGE (priv->shell_search));
-	gs_page_reload (GS_PAGE (priv->shell_updates));
+	gs_page_changed (GS_PAGE (priv->shell_category), changes);
+	gs_page_changed (GS_PAGE (priv->shell_extras), changes);
+	gs_page_changed (GS_PAGE (priv->shell_details), changes);
+	gs_page_changed (GS_PAGE (priv->shell_installed), changes);
+	gs_page_changed (GS_PAGE (priv->shell_overview), changes);
+	gs_page_changed (GS_PAGE (priv->shell_search), changes);
+	gs_page_changed (GS_PAGE (priv->shell_updates), changes);
 }
 
 static void
@@ -1413,8 +1415,8 @@ gs_shell_setup (GsShell *shell, GsPluginLoader *plugin_loader, GCancellable *can
 	g_return_if_fail (GS_IS_SHELL (shell));
 
 	priv->plugin_loader = g_object_ref (plugin_loader);
-	g_signal_connect (priv->plugin_loader, "reload",
-			  G_CALLBACK (gs_shell_reload_cb), shell);
+	g_signal_connect (priv->plugin_loader, "changed",
+			  G_CALLBACK (gs_shell_changed_cb), shell);
 	g_signal_connect_object (priv->plugin_loader, "notify::events",
 				 G_CALLBACK (gs_shell_events_notify_cb),
 				 shell, 0);
@@ -29,6 +29,7 @@
 
 #include "gs-app.h"
 #include "gs-app-row.h"
+#include "gs-common.h"
 
 typedef struct
 {
@@ -55,10 +56,10 @@ gs_update_list_button_clicked_cb (GsAppRow *app_row,
 	g_signal_emit (update_list, signals[SIGNAL_BUTTON_CLICKED], 0, app);
 }
 
-void
-gs_update_list_add_app (GsUpdateList *update_list,
-			GsApp	*app)
+static GtkWidget *
+gs_update_list_create_row_cb (GsApp *app, gpointer user_data)
 {
+	GsUpdateList *update_list = GS_UPDATE_LIST (user_data);
 	GsUpdateListPrivate *priv = GET_PRIV (update_list);
 	GtkWidget *app_row;
 
@@ -68,11 +69,36 @@ gs_update_list_add_app (GsUpdateList *update_list,
 	g_signal_connect (app_row, "button-clicked",
 			  G_CALLBACK (gs_update_list_button_clicked_cb),
 			  update_list);
-	gtk_container_add (GTK_CONTAINER (update_list), app_row);
 	gs_app_row_set_size_groups (GS_APP_ROW (app_row),
 				    priv->sizegroup_image,
 				    priv->sizegroup_name);
 	gtk_widget_show (app_row);
+	return app_row;
+}
+
+void
+gs_update_list_add_app (GsUpdateList *update_list,
+			GsApp	*app)
+{
+	GtkWidget *app_row = gs_update_list_create_row_cb (app, update_list);
+	gtk_container_add (GTK_CONTAINER (update_list), app_row);
+}
+
+/* only the rows for updates that were not already shown are created */
+void
+gs_update_list_set_apps (GsUpdateList *update_list,
+			 GsAppList *apps)
+{
+	GList *l;
+	g_autoptr(GList) children = NULL;
+
+	gs_container_set_apps (GTK_CONTAINER (update_list), apps,
+			       gs_update_list_create_row_cb, update_list);
+
+	/* the update details may have changed */
+	children = gtk_container_get_children (GTK_CONTAINER (update_list));
+	for (l = children; l != NULL; l = l->next)
+		gs_app_row_refresh (GS_APP_ROW (l->data));
 }
 
 GsAppList *
@@ -43,6 +43,8 @@ struct _GsUpdateListClass
 GtkWidget	*gs_update_list_new		(void);
 void		 gs_update_list_add_app		(GsUpdateList	*update_list,
 						 GsApp		*app);
+void		 gs_update_list_set_apps	(GsUpdateList	*update_list,
+						 GsAppList	*apps);
 GsAppList	*gs_update_list_get_apps	(GsUpdateList	*update_list);
 
 G_END_DECLS
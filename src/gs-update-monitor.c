@@ -47,6 +47,14 @@ struct _GsUpdateMonitor {
 	guint		 check_daily_id;		/* every 3rd day */
 	GNetworkMonitor	*network_monitor;		/* network type detection */
 	guint		 notification_blocked_id;	/* rate limit notifications */
+
+	/* what we know about the last list of updates */
+	gboolean	 updates_valid;
+	gboolean	 updates_pending;		/* getting them now */
+	gboolean	 updates_queued;		/* changed while pending */
+	guint		 updates_serial;
+	guint		 updates_count;
+	gboolean	 updates_important;
 };
 
 G_DEFINE_TYPE (GsUpdateMonitor, gs_update_monitor, G_TYPE_OBJECT)
@@ -149,6 +157,25 @@ no_updates_for_a_week (GsUpdateMonitor *monitor)
 	return FALSE;
 }
 
+static void get_updates (GsUpdateMonitor *monitor);
+
+static void
+notify_updates (GsUpdateMonitor *monitor)
+{
+	/* no updates */
+	if (monitor->updates_count == 0) {
+		g_debug ("no updates; withdrawing updates-available notification");
+		g_application_withdraw_notification (monitor->application,
+						     "updates-available");
+		return;
+	}
+
+	if (monitor->updates_important ||
+	    no_updates_for_a_week (monitor)) {
+		notify_offline_update_available (monitor);
+	}
+}
+
 static void
 get_updates_finished_cb (GObject *object,
 			 GAsyncResult *res,
@@ -165,16 +192,30 @@ get_updates_finished_cb (GObject *object,
 	/* get result */
 	apps = gs_plugin_loader_get_updates_finish (GS_PLUGIN_LOADER (object), res, &error);
 	if (apps == NULL) {
-		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-			g_warning ("failed to get updates: %s", error->message);
+		/* the monitor is being disposed */
+		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
+			return;
+		g_warning ("failed to get updates: %s", error->message);
+		monitor->updates_pending = FALSE;
+		monitor->updates_queued = FALSE;
 		return;
 	}
+	monitor->updates_pending = FALSE;
 
-	/* no updates */
-	if (gs_app_list_length (apps) == 0) {
-		g_debug ("no updates; withdrawing updates-available notification");
-		g_application_withdraw_notification (monitor->application,
-						     "updates-available");
+	/* the list is already out of date */
+	if (monitor->updates_queued) {
+		monitor->updates_queued = FALSE;
+		get_updates (monitor);
+		return;
+	}
+
+	/* save what we need so the list does not have to be got again
+	 * until a plugin says it has changed */
+	monitor->updates_valid = TRUE;
+	monitor->updates_count = gs_app_list_length (apps);
+	monitor->updates_important = has_important_updates (apps);
+	if (monitor->updates_count == 0) {
+		notify_updates (monitor);
 		return;
 	}
 
@@ -194,11 +235,7 @@ get_updates_finished_cb (GObject *object,
 	}
 
 	g_debug ("got %u updates", gs_app_list_length (apps));
-
-	if (has_important_updates (apps) ||
-	    no_updates_for_a_week (monitor)) {
-		notify_offline_update_available (monitor);
-	}
+	notify_updates (monitor);
 }
 
 static gboolean
@@ -279,12 +316,48 @@ get_upgrades_finished_cb (GObject *object,
 	g_application_send_notification (monitor->application, "upgrades-available", n);
 }
 
+static gboolean
+updates_are_stale (GsUpdateMonitor *monitor)
+{
+	if (!monitor->updates_valid)
+		return TRUE;
+	return gs_plugin_loader_get_updates_serial (monitor->plugin_loader) !=
+		monitor->updates_serial;
+}
+
 static void
 get_updates (GsUpdateMonitor *monitor)
 {
+	guint serial = gs_plugin_loader_get_updates_serial (monitor->plugin_loader);
+
+	/* get them again when the current request finishes */
+	if (monitor->updates_pending) {
+		if (serial != monitor->updates_serial)
+			monitor->updates_queued = TRUE;
+		return;
+	}
+
+	/* getting the refined list is expensive, so just decide about the
+	 * notification again if no plugin has said the updates changed */
+	if (!updates_are_stale (monitor)) {
+		g_debug ("Updates unchanged");
+		notify_updates (monitor);
+		return;
+	}
+
+	/* the updates page is showing the list, and the notification is not
+	 * shown with an active window; the hourly check gets the list later */
+	if (gs_application_has_active_window (GS_APPLICATION (monitor->application))) {
+		g_debug ("Not getting updates with an active window");
+		return;
+	}
+
 	/* NOTE: this doesn't actually do any network access, instead it just
 	 * returns already downloaded-and-depsolved packages */
 	g_debug ("Getting updates");
+	monitor->updates_valid = FALSE;
+	monitor->updates_pending = TRUE;
+	monitor->updates_serial = serial;
 	gs_plugin_loader_get_updates_async (monitor->plugin_loader,
 					    GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS |
 					    GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_SEVERITY,
@@ -416,6 +489,10 @@ check_hourly_cb (gpointer data)
 	g_debug ("Hourly updates check");
 	check_updates (monitor);
 
+	/* only if a plugin said they changed since the last time */
+	if (updates_are_stale (monitor))
+		get_updates (monitor);
+
 	return G_SOURCE_CONTINUE;
 }
 
@@ -21,12 +21,27 @@
 
 #include "config.h"
 
+#include <errno.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
 #include <gnome-software.h>
 
 #include "gs-appstream.h"
 
 #define	GS_APPSTREAM_MAX_SCREENSHOTS	5
 
+/* kudos used as markers on compacted items */
+#define	GS_APPSTREAM_KUDO_COMPACT		"GnomeSoftware::Compact"
+#define	GS_APPSTREAM_KUDO_HAS_SCREENSHOTS	"GnomeSoftware::HasScreenshots"
+#define	GS_APPSTREAM_KUDO_PERFECT_SCREENSHOTS	"GnomeSoftware::PerfectScreenshots"
+
+/* where the dropped details of a compacted item were written */
+typedef struct {
+	GMappedFile	*mapped;
+	gsize		 offset;
+	gsize		 len;
+} GsAppstreamDetail;
+
 GsApp *
 gs_appstream_create_app (GsPlugin *plugin, AsApp *item, GError **error)
 {
@@ -154,6 +169,10 @@ gs_appstream_refine_add_screenshots (GsApp *app, AsApp *item)
 	GPtrArray *screenshots_as;
 	guint i;
 
+	/* compacted items only remember that they had some */
+	if (as_app_has_kudo (item, GS_APPSTREAM_KUDO_HAS_SCREENSHOTS))
+		gs_app_add_kudo (app, GS_APP_KUDO_HAS_SCREENSHOTS);
+
 	/* do we have any to add */
 	screenshots_as = as_app_get_screenshots (item);
 	if (screenshots_as->len == 0)
@@ -240,6 +259,10 @@ gs_appstream_are_screenshots_perfect (AsApp *app)
 	guint i;
 	guint width;
 
+	/* worked out before the screenshots were dropped */
+	if (as_app_has_kudo (app, GS_APPSTREAM_KUDO_PERFECT_SCREENSHOTS))
+		return TRUE;
+
 	screenshots = as_app_get_screenshots (app);
 	if (screenshots->len == 0)
 		return FALSE;
@@ -456,6 +479,46 @@ gs_appstream_refine_app_updates (GsPlugin *plugin,
 	return TRUE;
 }
 
+/* looks up a translation with the same fallbacks as used when pruning, as the
+ * locale of the plugin may be different to the one of the process */
+static const gchar *
+gs_appstream_lookup_locale (GsPlugin *plugin, GHashTable *hash)
+{
+	const gchar *locale = gs_plugin_get_locale (plugin);
+	const gchar *language = gs_plugin_get_language (plugin);
+	const gchar *tmp = NULL;
+
+	if (locale != NULL)
+		tmp = g_hash_table_lookup (hash, locale);
+	if (tmp == NULL && language != NULL)
+		tmp = g_hash_table_lookup (hash, language);
+	if (tmp == NULL)
+		tmp = g_hash_table_lookup (hash, "C");
+	return tmp;
+}
+
+static gboolean
+gs_appstream_refine_app_description (GsPlugin *plugin,
+				     GsApp *app,
+				     AsApp *item,
+				     GError **error)
+{
+	const gchar *tmp;
+	g_autofree gchar *from_xml = NULL;
+
+	tmp = gs_appstream_lookup_locale (plugin, as_app_get_descriptions (item));
+	if (tmp == NULL)
+		return TRUE;
+	from_xml = as_markup_convert_simple (tmp, error);
+	if (from_xml == NULL) {
+		gs_utils_error_convert_appstream (error);
+		g_prefix_error (error, "trying to parse '%s': ", tmp);
+		return FALSE;
+	}
+	gs_app_set_description (app, GS_APP_QUALITY_HIGHEST, from_xml);
+	return TRUE;
+}
+
 /**
  * _gs_utils_locale_has_translations:
  * @locale: A locale, e.g. "en_GB"
@@ -582,12 +645,12 @@ gs_appstream_refine_app (GsPlugin *plugin,
 		gs_app_set_bundle_kind (app, gs_appstream_get_bundle_kind (item));
 
 	/* set name */
-	tmp = as_app_get_name (item, NULL);
+	tmp = gs_appstream_lookup_locale (plugin, as_app_get_names (item));
 	if (tmp != NULL)
 		gs_app_set_name (app, GS_APP_QUALITY_HIGHEST, tmp);
 
 	/* set summary */
-	tmp = as_app_get_comment (item, NULL);
+	tmp = gs_appstream_lookup_locale (plugin, as_app_get_comments (item));
 	if (tmp != NULL) {
 		gs_app_set_summary (app, GS_APP_QUALITY_HIGHEST, tmp);
 	}
@@ -629,17 +692,8 @@ gs_appstream_refine_app (GsPlugin *plugin,
 	}
 
 	/* set description */
-	tmp = as_app_get_description (item, NULL);
-	if (tmp != NULL) {
-		g_autofree gchar *from_xml = NULL;
-		from_xml = as_markup_convert_simple (tmp, error);
-		if (from_xml == NULL) {
-			gs_utils_error_convert_appstream (error);
-			g_prefix_error (error, "trying to parse '%s': ", tmp);
-			return FALSE;
-		}
-		gs_app_set_description (app, GS_APP_QUALITY_HIGHEST, from_xml);
-	}
+	if (!gs_appstream_refine_app_description (plugin, app, item, error))
+		return FALSE;
 
 	/* set icon */
 	if (as_app_get_icon_default (item) != NULL &&
@@ -765,6 +819,410 @@ gs_appstream_refine_app (GsPlugin *plugin,
 	return TRUE;
 }
 
+static gboolean
+gs_appstream_can_compact (AsApp *item, GHashTable *installed)
+{
+	AsBundle *bundle;
+	const gchar *fn = as_app_get_source_file (item);
+
+	/* already done */
+	if (as_app_has_kudo (item, GS_APPSTREAM_KUDO_COMPACT))
+		return FALSE;
+
+	/* only the collections, not the files of the installed apps */
+	if (fn != NULL &&
+	    as_app_source_kind_from_filename (fn) != AS_APP_SOURCE_KIND_APPSTREAM)
+		return FALSE;
+
+	/* installed apps need the releases for the update details */
+	switch (as_app_get_state (item)) {
+	case AS_APP_STATE_UNKNOWN:
+	case AS_APP_STATE_AVAILABLE:
+		break;
+	default:
+		return FALSE;
+	}
+	bundle = as_app_get_bundle_default (item);
+	if (installed != NULL && bundle != NULL &&
+	    g_hash_table_contains (installed, as_bundle_get_id (bundle)))
+		return FALSE;
+
+	/* distro upgrades are shown with the full description */
+	switch (as_app_get_kind (item)) {
+	case AS_APP_KIND_OS_UPDATE:
+	case AS_APP_KIND_OS_UPGRADE:
+		return FALSE;
+	default:
+		break;
+	}
+	return TRUE;
+}
+
+/* the parts of the item that gs_appstream_compact_app() drops */
+static GString *
+gs_appstream_detail_to_xml (AsApp *item)
+{
+	AsNodeContext *ctx;
+	GHashTableIter iter;
+	GNode *root;
+	GPtrArray *array;
+	GString *xml;
+	gpointer key;
+	gpointer value;
+	guint i;
+	g_autoptr(AsApp) detail = as_app_new ();
+
+	as_app_set_id (detail, as_app_get_id (item));
+	as_app_set_kind (detail, as_app_get_kind (item));
+	g_hash_table_iter_init (&iter, as_app_get_descriptions (item));
+	while (g_hash_table_iter_next (&iter, &key, &value))
+		as_app_set_description (detail, key, value);
+	array = as_app_get_screenshots (item);
+	for (i = 0; i < array->len; i++)
+		as_app_add_screenshot (detail, g_ptr_array_index (array, i));
+	array = as_app_get_releases (item);
+	for (i = 0; i < array->len; i++)
+		as_app_add_release (detail, g_ptr_array_index (array, i));
+
+	root = as_node_new ();
+	ctx = as_node_context_new ();
+	as_node_context_set_version (ctx, 0.8);
+	as_app_node_insert (detail, root, ctx);
+	xml = as_node_to_xml (root, AS_NODE_TO_XML_FLAG_NONE);
+	as_node_context_free (ctx);
+	as_node_unref (root);
+	return xml;
+}
+
+static gboolean
+gs_appstream_detail_write (gint fd, const gchar *data, gsize len, GError **error)
+{
+	while (len > 0) {
+		gssize wrote = write (fd, data, len);
+		if (wrote < 0) {
+			if (errno == EINTR)
+				continue;
+			g_set_error (error,
+				     GS_PLUGIN_ERROR,
+				     GS_PLUGIN_ERROR_WRITE_FAILED,
+				     "failed to write details: %s",
+				     g_strerror (errno));
+			return FALSE;
+		}
+		data += wrote;
+		len -= (gsize) wrote;
+	}
+	return TRUE;
+}
+
+static void
+gs_appstream_detail_free (GsAppstreamDetail *detail)
+{
+	g_mapped_file_unref (detail->mapped);
+	g_slice_free (GsAppstreamDetail, detail);
+}
+
+/* the details are written to an unlinked file in the cache directory, which
+ * is mapped so that reading the details of one item back only touches the
+ * pages it was written to */
+static GMappedFile *
+gs_appstream_detail_save (GPtrArray *items, GArray *offsets, GError **error)
+{
+	gint fd;
+	gsize offset = 0;
+	guint i;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(GMappedFile) mapped = NULL;
+
+	fn = gs_utils_get_cache_filename ("appstream",
+					  "details-XXXXXX",
+					  GS_UTILS_CACHE_FLAG_WRITEABLE,
+					  error);
+	if (fn == NULL)
+		return NULL;
+	fd = g_mkstemp (fn);
+	if (fd < 0) {
+		g_set_error (error,
+			     GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_WRITE_FAILED,
+			     "failed to create %s: %s",
+			     fn, g_strerror (errno));
+		return NULL;
+	}
+	g_unlink (fn);
+	for (i = 0; i < items->len; i++) {
+		AsApp *item = g_ptr_array_index (items, i);
+		g_autoptr(GString) xml = gs_appstream_detail_to_xml (item);
+		if (!gs_appstream_detail_write (fd, xml->str, xml->len, error)) {
+			close (fd);
+			return NULL;
+		}
+		g_array_append_val (offsets, offset);
+		offset += xml->len;
+	}
+	g_array_append_val (offsets, offset);
+	mapped = g_mapped_file_new_from_fd (fd, FALSE, error);
+	close (fd);
+	if (mapped == NULL)
+		return NULL;
+	return g_steal_pointer (&mapped);
+}
+
+static void
+gs_appstream_compact_app (AsApp *item)
+{
+	GPtrArray *releases;
+
+	/* the search tokens include the description */
+	as_app_search_matches (item, "");
+
+	/* remember what we need for the kudos */
+	if (as_app_get_screenshots(item)->len > 0)
+		as_app_add_kudo (item, GS_APPSTREAM_KUDO_HAS_SCREENSHOTS);
+	if (gs_appstream_are_screenshots_perfect (item))
+		as_app_add_kudo (item, GS_APPSTREAM_KUDO_PERFECT_SCREENSHOTS);
+
+	/* drop everything only used on the details page, but keep the
+	 * newest release for the version and the recent-release kudo */
+	g_hash_table_remove_all (as_app_get_descriptions (item));
+	g_ptr_array_set_size (as_app_get_screenshots (item), 0);
+	releases = as_app_get_releases (item);
+	if (releases->len > 1)
+		g_ptr_array_set_size (releases, 1);
+	as_app_add_kudo (item, GS_APPSTREAM_KUDO_COMPACT);
+}
+
+/**
+ * gs_appstream_store_compact:
+ * @store: a #AsStore
+ * @installed: (nullable): the bundle IDs of the installed apps, or %NULL
+ *
+ * Drops the descriptions, screenshots and old releases from the
+ * applications that are not installed, as these are only needed when
+ * showing the details of a single application.
+ *
+ * The details are first written to a file in the cache directory, and
+ * gs_appstream_refine_app_detail() reads back the details of just the
+ * one application when required. If the file cannot be written then
+ * nothing is dropped.
+ **/
+void
+gs_appstream_store_compact (AsStore *store, GHashTable *installed)
+{
+	AsApp *item;
+	GPtrArray *array;
+	guint i;
+	g_autoptr(GArray) offsets = g_array_new (FALSE, FALSE, sizeof (gsize));
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GMappedFile) mapped = NULL;
+	g_autoptr(GPtrArray) items = g_ptr_array_new ();
+
+	array = as_store_get_apps (store);
+	for (i = 0; i < array->len; i++) {
+		item = g_ptr_array_index (array, i);
+		if (gs_appstream_can_compact (item, installed))
+			g_ptr_array_add (items, item);
+	}
+	if (items->len == 0)
+		return;
+	mapped = gs_appstream_detail_save (items, offsets, &error);
+	if (mapped == NULL) {
+		g_warning ("not compacting applications: %s", error->message);
+		return;
+	}
+	for (i = 0; i < items->len; i++) {
+		GsAppstreamDetail *detail = g_slice_new0 (GsAppstreamDetail);
+		item = g_ptr_array_index (items, i);
+		detail->mapped = g_mapped_file_ref (mapped);
+		detail->offset = g_array_index (offsets, gsize, i);
+		detail->len = g_array_index (offsets, gsize, i + 1) - detail->offset;
+		g_object_set_data_full (G_OBJECT (item),
+					"GsAppstream::detail", detail,
+					(GDestroyNotify) gs_appstream_detail_free);
+		gs_appstream_compact_app (item);
+	}
+	g_debug ("compacted %u of %u applications, moving %" G_GSIZE_FORMAT
+		 " kB of details out of memory",
+		 items->len, array->len,
+		 g_mapped_file_get_length (mapped) / 1024);
+}
+
+static void
+gs_appstream_prune_locale_hash (GHashTable *hash,
+				const gchar *locale,
+				const gchar *language)
+{
+	GHashTableIter iter;
+	gpointer key;
+
+	/* keep the entries gs_appstream_lookup_locale() can return, and the
+	 * untranslated value so that searching still matches it */
+	g_hash_table_iter_init (&iter, hash);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		if (g_strcmp0 (key, "C") == 0 ||
+		    g_strcmp0 (key, locale) == 0 ||
+		    g_strcmp0 (key, language) == 0)
+			continue;
+		g_hash_table_iter_remove (&iter);
+	}
+}
+
+/**
+ * gs_appstream_store_prune_locales:
+ * @store: a #AsStore
+ * @locale: a locale, e.g. "en_GB"
+ * @language: a language, e.g. "en"
+ *
+ * Drops the translated names, summaries and descriptions that are not
+ * going to be used for @locale. Only the entries for @locale, @language
+ * and the untranslated value are kept, so the apps have to be looked up
+ * using the locale of the plugin rather than with a %NULL locale.
+ **/
+void
+gs_appstream_store_prune_locales (AsStore *store,
+				  const gchar *locale,
+				  const gchar *language)
+{
+	AsApp *item;
+	GPtrArray *array;
+	guint i;
+
+	array = as_store_get_apps (store);
+	for (i = 0; i < array->len; i++) {
+		item = g_ptr_array_index (array, i);
+		gs_appstream_prune_locale_hash (as_app_get_names (item),
+						locale, language);
+		gs_appstream_prune_locale_hash (as_app_get_comments (item),
+						locale, language);
+		gs_appstream_prune_locale_hash (as_app_get_descriptions (item),
+						locale, language);
+	}
+}
+
+static AsApp *
+gs_appstream_detail_get_app (AsApp *item, GError **error)
+{
+	AsNodeContext *ctx;
+	GNode *node;
+	GNode *root;
+	GsAppstreamDetail *detail;
+	gboolean ret;
+	const gchar *data;
+	g_autofree gchar *xml = NULL;
+	g_autoptr(AsApp) item_full = NULL;
+
+	detail = g_object_get_data (G_OBJECT (item), "GsAppstream::detail");
+	if (detail == NULL) {
+		g_set_error (error,
+			     GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_NOT_SUPPORTED,
+			     "no details saved for %s",
+			     as_app_get_id (item));
+		return NULL;
+	}
+
+	/* parse just this one component */
+	data = g_mapped_file_get_contents (detail->mapped);
+	xml = g_strndup (data + detail->offset, detail->len);
+	root = as_node_from_xml (xml, AS_NODE_FROM_XML_FLAG_NONE, error);
+	if (root == NULL) {
+		gs_utils_error_convert_appstream (error);
+		return NULL;
+	}
+	node = as_node_find (root, "component");
+	if (node == NULL) {
+		as_node_unref (root);
+		g_set_error (error,
+			     GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_INVALID_FORMAT,
+			     "no component in details for %s",
+			     as_app_get_id (item));
+		return NULL;
+	}
+	ctx = as_node_context_new ();
+	item_full = as_app_new ();
+	ret = as_app_node_parse (item_full, node, ctx, error);
+	as_node_context_free (ctx);
+	as_node_unref (root);
+	if (!ret) {
+		gs_utils_error_convert_appstream (error);
+		return NULL;
+	}
+	return g_steal_pointer (&item_full);
+}
+
+/**
+ * gs_appstream_refine_app_detail:
+ * @plugin: a #GsPlugin
+ * @app: a #GsApp
+ * @item: a #AsApp that may have been compacted
+ * @flags: a #GsPluginRefineFlags
+ * @cancellable: a #GCancellable, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Adds the details that gs_appstream_store_compact() dropped from @item,
+ * but only if they are required by @flags: the description for
+ * %GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION, the screenshots for
+ * %GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS, and the update details for
+ * applications that can be updated.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+gs_appstream_refine_app_detail (GsPlugin *plugin,
+				GsApp *app,
+				AsApp *item,
+				GsPluginRefineFlags flags,
+				GCancellable *cancellable,
+				GError **error)
+{
+	gboolean need_desc;
+	gboolean need_screenshots;
+	gboolean need_update;
+	g_autoptr(AsApp) item_full = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* everything is resident */
+	if (!as_app_has_kudo (item, GS_APPSTREAM_KUDO_COMPACT))
+		return TRUE;
+
+	need_desc = (flags & GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION) > 0 &&
+		    gs_app_get_description (app) == NULL;
+	need_screenshots = (flags & GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS) > 0 &&
+			   gs_app_get_screenshots(app)->len == 0 &&
+			   as_app_has_kudo (item, GS_APPSTREAM_KUDO_HAS_SCREENSHOTS);
+	switch (gs_app_get_state (app)) {
+	case AS_APP_STATE_UPDATABLE:
+	case AS_APP_STATE_UPDATABLE_LIVE:
+		need_update = (flags & (GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS |
+					GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_SEVERITY)) > 0 &&
+			      gs_app_get_version (app) != NULL;
+		break;
+	default:
+		need_update = FALSE;
+		break;
+	}
+	if (!need_desc && !need_screenshots && !need_update)
+		return TRUE;
+
+	item_full = gs_appstream_detail_get_app (item, &error_local);
+	if (item_full == NULL) {
+		g_debug ("failed to get details: %s", error_local->message);
+		return TRUE;
+	}
+	if (need_desc) {
+		if (!gs_appstream_refine_app_description (plugin, app, item_full, error))
+			return FALSE;
+	}
+	if (need_screenshots)
+		gs_appstream_refine_add_screenshots (app, item_full);
+	if (need_update) {
+		if (!gs_appstream_refine_app_updates (plugin, app, item_full, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 gs_appstream_store_search_item (GsPlugin *plugin,
 				AsApp *item,
@@ -835,6 +1293,47 @@ gs_appstream_store_search (GsPlugin *plugin,
 	return TRUE;
 }
 
+gboolean
+gs_appstream_store_search_previous (GsPlugin *plugin,
+				    AsStore *store,
+				    gchar **values,
+				    GsAppList *previous,
+				    GsAppList *list,
+				    GCancellable *cancellable,
+				    GError **error)
+{
+	AsApp *item;
+	GsApp *app;
+	const gchar *unique_id;
+	guint i;
+	g_autoptr(AsProfileTask) ptask = NULL;
+
+	/* only match the apps that were found before */
+	ptask = as_profile_start_literal (gs_plugin_get_profile (plugin),
+					  "appstream::search-previous");
+	g_assert (ptask != NULL);
+	for (i = 0; i < gs_app_list_length (previous); i++) {
+		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+			gs_utils_error_convert_gio (error);
+			return FALSE;
+		}
+
+		app = gs_app_list_index (previous, i);
+		unique_id = gs_app_get_unique_id (app);
+		if (unique_id == NULL)
+			continue;
+		item = as_store_get_app_by_unique_id (store, unique_id,
+						      AS_STORE_SEARCH_FLAG_USE_WILDCARDS);
+		if (item == NULL)
+			continue;
+		if (!gs_appstream_store_search_item (plugin, item,
+						     values, list,
+						     cancellable, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 _as_app_matches_desktop_group_set (AsApp *app, gchar **desktop_groups)
 {
@@ -33,6 +33,17 @@ gboolean	 gs_appstream_refine_app		(GsPlugin	*plugin,
 							 GsApp		*app,
 							 AsApp		*item,
 							 GError		**error);
+gboolean	 gs_appstream_refine_app_detail		(GsPlugin	*plugin,
+							 GsApp		*app,
+							 AsApp		*item,
+							 GsPluginRefineFlags flags,
+							 GCancellable	*cancellable,
+							 GError		**error);
+void		 gs_appstream_store_compact		(AsStore	*store,
+							 GHashTable	*installed);
+void		 gs_appstream_store_prune_locales	(AsStore	*store,
+							 const gchar	*locale,
+							 const gchar	*language);
 GsApp		*gs_appstream_create_runtime		(GsPlugin	*plugin,
 							 GsApp		*parent,
 							 const gchar	*runtime);
@@ -42,6 +53,13 @@ gboolean	 gs_appstream_store_search		(GsPlugin	*plugin,
 							 GsAppList	*list,
 							 GCancellable	*cancellable,
 							 GError		**error);
+gboolean	 gs_appstream_store_search_previous	(GsPlugin	*plugin,
+							 AsStore	*store,
+							 gchar		**values,
+							 GsAppList	*previous,
+							 GsAppList	*list,
+							 GCancellable	*cancellable,
+							 GError		**error);
 gboolean	 gs_appstream_store_add_categories	(GsPlugin	*plugin,
 							 AsStore	*store,
 							 GPtrArray	*list,
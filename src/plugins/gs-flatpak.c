@@ -43,8 +43,16 @@ struct _GsFlatpak {
 	AsAppScope		 scope;
 	GsPlugin		*plugin;
 	AsStore			*store;
+	guint			 download_parallel;
+	GMutex			 size_cache_mutex;
+	GKeyFile		*size_cache;	/* remote:ref : commit and sizes */
+	gchar			*size_cache_fn;
+	gboolean		 size_cache_changed;
 };
 
+/* the number of updates downloaded at the same time */
+#define GS_FLATPAK_DOWNLOAD_PARALLEL_DEFAULT	3
+
 G_DEFINE_TYPE (GsFlatpak, gs_flatpak, G_TYPE_OBJECT)
 
 /* we have to do this until we hard dep on 0.6.11 */
@@ -140,12 +148,9 @@ gs_plugin_create_app (GsFlatpak *self, FlatpakRef *xref)
 }
 
 static void
-gs_plugin_flatpak_changed_cb (GFileMonitor *monitor,
-			      GFile *child,
-			      GFile *other_file,
-			      GFileMonitorEvent event_type,
-			      GsFlatpak *self)
+gs_plugin_flatpak_changed_cb (GsPlugin *plugin, gpointer user_data)
 {
+	GsFlatpak *self = GS_FLATPAK (user_data);
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GError) error_md = NULL;
 
@@ -163,6 +168,17 @@ gs_plugin_flatpak_changed_cb (GFileMonitor *monitor,
 	}
 }
 
+static void
+gs_plugin_flatpak_monitor_changed_cb (GFileMonitor *monitor,
+				      GFile *child,
+				      GFile *other_file,
+				      GFileMonitorEvent event_type,
+				      GsFlatpak *self)
+{
+	/* coalesce bursts of changes with the other file watches */
+	gs_plugin_watch_queue (self->plugin, gs_plugin_flatpak_changed_cb, self);
+}
+
 static void
 gs_flatpak_remove_prefixed_names (AsApp *app)
 {
@@ -197,6 +213,8 @@ gs_flatpak_add_apps_from_xremote (GsFlatpak *self,
 	g_autoptr(AsStore) store = NULL;
 	g_autoptr(GFile) appstream_dir = NULL;
 	g_autoptr(GFile) file = NULL;
+	g_autoptr(GHashTable) installed = NULL;
+	g_autoptr(GPtrArray) xrefs = NULL;
 
 	/* get the AppStream data location */
 	appstream_dir = flatpak_remote_get_appstream_dir (xremote, NULL);
@@ -254,6 +272,26 @@ gs_flatpak_add_apps_from_xremote (GsFlatpak *self,
 		g_debug ("adding %s", as_app_get_unique_id (app));
 	}
 
+	/* the components do not know if they are installed, so use the
+	 * bundle to find the installed apps that need all their details */
+	installed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	xrefs = flatpak_installation_list_installed_refs (self->installation,
+							  cancellable, error);
+	if (xrefs == NULL) {
+		gs_plugin_flatpak_error_convert (error);
+		return FALSE;
+	}
+	for (i = 0; i < xrefs->len; i++) {
+		FlatpakRef *xref = g_ptr_array_index (xrefs, i);
+		g_hash_table_add (installed, flatpak_ref_format_ref (xref));
+	}
+
+	/* only keep what is needed for lists and searching */
+	gs_appstream_store_prune_locales (store,
+					  gs_plugin_get_locale (self->plugin),
+					  gs_plugin_get_language (self->plugin));
+	gs_appstream_store_compact (store, installed);
+
 	/* add them to the main store */
 	as_store_add_apps (self->store, apps);
 	return TRUE;
@@ -403,16 +441,260 @@ gs_flatpak_setup (GsFlatpak *self, GCancellable *cancellable, GError **error)
 		return FALSE;
 	}
 	g_signal_connect (self->monitor, "changed",
-			  G_CALLBACK (gs_plugin_flatpak_changed_cb), self);
+			  G_CALLBACK (gs_plugin_flatpak_monitor_changed_cb), self);
 
 	/* ensure the legacy AppStream symlink cache is deleted */
 	if (!gs_flatpak_symlinks_cleanup (self->installation, cancellable, error))
 		return FALSE;
 
+	/* sizes of refs that are not installed */
+	gs_flatpak_size_cache_load (self);
+
 	/* success */
 	return TRUE;
 }
 
+gboolean
+gs_flatpak_locale_changed (GsFlatpak *self,
+			   GCancellable *cancellable,
+			   GError **error)
+{
+	/* not loaded yet */
+	if (as_store_get_size (self->store) == 0)
+		return TRUE;
+
+	/* the pruned translations can only be got back by loading again */
+	if (!gs_flatpak_rescan_appstream_store (self, cancellable, error))
+		return FALSE;
+	gs_plugin_reload (self->plugin);
+	return TRUE;
+}
+
+/* threads use a private installation so they do not share any state */
+static FlatpakInstallation *
+gs_flatpak_dup_installation (GsFlatpak *self,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	g_autoptr(GFile) path = flatpak_installation_get_path (self->installation);
+	return flatpak_installation_new_for_path (path,
+						  flatpak_installation_get_is_user (self->installation),
+						  cancellable,
+						  error);
+}
+
+/* the sizes of a ref only change with the commit, so keep them across runs */
+static gchar *
+gs_flatpak_size_cache_group (const gchar *remote_name, FlatpakRef *xref)
+{
+	g_autofree gchar *ref = flatpak_ref_format_ref (xref);
+	return g_strdup_printf ("%s:%s", remote_name, ref);
+}
+
+static void
+gs_flatpak_size_cache_load (GsFlatpak *self)
+{
+	g_autofree gchar *basename = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->size_cache_mutex);
+
+	basename = g_strdup_printf ("sizes-%s.ini",
+				    as_app_scope_to_string (self->scope));
+	self->size_cache_fn = gs_utils_get_cache_filename ("flatpak",
+							   basename,
+							   GS_UTILS_CACHE_FLAG_WRITEABLE,
+							   &error);
+	if (self->size_cache_fn == NULL) {
+		g_warning ("failed to get size cache: %s", error->message);
+		return;
+	}
+	if (!g_file_test (self->size_cache_fn, G_FILE_TEST_EXISTS))
+		return;
+	if (!g_key_file_load_from_file (self->size_cache,
+					self->size_cache_fn,
+					G_KEY_FILE_NONE,
+					&error)) {
+		g_warning ("failed to load size cache %s: %s",
+			   self->size_cache_fn, error->message);
+	}
+}
+
+static void
+gs_flatpak_size_cache_save (GsFlatpak *self)
+{
+	gsize len;
+	g_autofree gchar *data = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->size_cache_mutex);
+
+	if (!self->size_cache_changed || self->size_cache_fn == NULL)
+		return;
+	data = g_key_file_to_data (self->size_cache, &len, NULL);
+	if (!g_file_set_contents (self->size_cache_fn, data, (gssize) len, &error)) {
+		g_warning ("failed to save size cache %s: %s",
+			   self->size_cache_fn, error->message);
+		return;
+	}
+	self->size_cache_changed = FALSE;
+}
+
+/* record the commit of every ref in the remote, forgetting any sizes that
+ * were for an older commit or for refs no longer in the remote */
+static void
+gs_flatpak_size_cache_refresh_remote (GsFlatpak *self,
+				      FlatpakInstallation *installation,
+				      const gchar *remote_name,
+				      GCancellable *cancellable)
+{
+	guint i;
+	g_autofree gchar *prefix = NULL;
+	g_auto(GStrv) groups = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) seen = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autoptr(GPtrArray) xrefs = NULL;
+
+	xrefs = flatpak_installation_list_remote_refs_sync (installation,
+							    remote_name,
+							    cancellable,
+							    &error);
+	if (xrefs == NULL) {
+		g_debug ("failed to list refs of %s: %s",
+			 remote_name, error->message);
+		return;
+	}
+	seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	locker = g_mutex_locker_new (&self->size_cache_mutex);
+	for (i = 0; i < xrefs->len; i++) {
+		FlatpakRef *xref = g_ptr_array_index (xrefs, i);
+		const gchar *commit = flatpak_ref_get_commit (xref);
+		g_autofree gchar *commit_old = NULL;
+		gchar *group;
+
+		if (commit == NULL)
+			continue;
+		group = gs_flatpak_size_cache_group (remote_name, xref);
+		g_hash_table_add (seen, group);
+		commit_old = g_key_file_get_string (self->size_cache, group,
+						    "Commit", NULL);
+		if (g_strcmp0 (commit_old, commit) == 0)
+			continue;
+		g_key_file_remove_group (self->size_cache, group, NULL);
+		g_key_file_set_string (self->size_cache, group, "Commit", commit);
+		self->size_cache_changed = TRUE;
+	}
+
+	/* remove refs that have gone away */
+	prefix = g_strdup_printf ("%s:", remote_name);
+	groups = g_key_file_get_groups (self->size_cache, NULL);
+	for (i = 0; groups[i] != NULL; i++) {
+		if (!g_str_has_prefix (groups[i], prefix))
+			continue;
+		if (g_hash_table_contains (seen, groups[i]))
+			continue;
+		g_key_file_remove_group (self->size_cache, groups[i], NULL);
+		self->size_cache_changed = TRUE;
+	}
+}
+
+static gboolean
+gs_flatpak_size_cache_lookup (GsFlatpak *self,
+			      GsApp *app,
+			      FlatpakRef *xref,
+			      guint64 *download_size,
+			      guint64 *installed_size)
+{
+	g_autofree gchar *group = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->size_cache_mutex);
+
+	group = gs_flatpak_size_cache_group (gs_app_get_origin (app), xref);
+	if (!g_key_file_has_key (self->size_cache, group, "DownloadSize", NULL))
+		return FALSE;
+	*download_size = g_key_file_get_uint64 (self->size_cache, group,
+						"DownloadSize", NULL);
+	*installed_size = g_key_file_get_uint64 (self->size_cache, group,
+						 "InstalledSize", NULL);
+	return TRUE;
+}
+
+static void
+gs_flatpak_size_cache_add (GsFlatpak *self,
+			   GsApp *app,
+			   FlatpakRef *xref,
+			   guint64 download_size,
+			   guint64 installed_size)
+{
+	g_autofree gchar *group = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->size_cache_mutex);
+
+	/* without a commit the entry could never be invalidated */
+	group = gs_flatpak_size_cache_group (gs_app_get_origin (app), xref);
+	if (!g_key_file_has_key (self->size_cache, group, "Commit", NULL)) {
+		const gchar *commit = gs_app_get_flatpak_commit (app);
+		if (commit == NULL)
+			return;
+		g_key_file_set_string (self->size_cache, group, "Commit", commit);
+	}
+	g_key_file_set_uint64 (self->size_cache, group,
+			       "DownloadSize", download_size);
+	g_key_file_set_uint64 (self->size_cache, group,
+			       "InstalledSize", installed_size);
+	self->size_cache_changed = TRUE;
+}
+
+/* the longest time to wait for the AppStream metadata of one remote */
+#define GS_FLATPAK_REFRESH_APPSTREAM_TIMEOUT	120 /* seconds */
+
+typedef struct {
+	GMutex			 mutex;
+	GCond			 cond;
+	guint			 pending;
+	GPtrArray		*helpers;
+} GsFlatpakRefreshQueue;
+
+typedef struct {
+	GsFlatpak		*self;
+	FlatpakRemote		*xremote;
+	GCancellable		*cancellable;	/* only for this remote */
+	gint64			 deadline;	/* or 0 when not started */
+	gboolean		 done;
+	gboolean		 timed_out;
+	guint64			 mtime_old;
+	GError			*error;
+} GsFlatpakRefreshHelper;
+
+static void
+gs_flatpak_refresh_helper_free (GsFlatpakRefreshHelper *helper)
+{
+	g_object_unref (helper->xremote);
+	g_object_unref (helper->cancellable);
+	g_clear_error (&helper->error);
+	g_free (helper);
+}
+
+static guint64
+gs_flatpak_get_file_mtime (GFile *file)
+{
+	g_autoptr(GFileInfo) info = NULL;
+	if (file == NULL)
+		return 0;
+	info = g_file_query_info (file,
+				  G_FILE_ATTRIBUTE_TIME_MODIFIED,
+				  G_FILE_QUERY_INFO_NONE,
+				  NULL, NULL);
+	if (info == NULL)
+		return 0;
+	return g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+}
+
+static guint64
+gs_flatpak_get_appstream_mtime (FlatpakRemote *xremote)
+{
+	g_autoptr(GFile) file_timestamp = NULL;
+	file_timestamp = flatpak_remote_get_appstream_timestamp (xremote, NULL);
+	return gs_flatpak_get_file_mtime (file_timestamp);
+}
+
 static gboolean
 gs_flatpak_refresh_appstream_remote (GsFlatpak *self,
 				     const gchar *remote_name,
@@ -420,16 +702,143 @@ gs_flatpak_refresh_appstream_remote (GsFlatpak *self,
 				     GError **error)
 {
 	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(FlatpakInstallation) installation = NULL;
+
 	ptask = as_profile_start (gs_plugin_get_profile (self->plugin),
 				  "flatpak::refresh-appstream{%s}",
 				  remote_name);
 	g_assert (ptask != NULL);
-	return flatpak_installation_update_appstream_sync (self->installation,
-							   remote_name,
-							   NULL, /* arch */
-							   NULL, /* out_changed */
-							   cancellable,
-							   error);
+	installation = gs_flatpak_dup_installation (self, cancellable, error);
+	if (installation == NULL)
+		return FALSE;
+	if (!flatpak_installation_update_appstream_sync (installation,
+							 remote_name,
+							 NULL, /* arch */
+							 NULL, /* out_changed */
+							 cancellable,
+							 error))
+		return FALSE;
+	gs_flatpak_size_cache_refresh_remote (self, installation,
+					      remote_name, cancellable);
+	return TRUE;
+}
+
+static void
+gs_flatpak_refresh_appstream_thread_cb (gpointer data, gpointer user_data)
+{
+	GsFlatpakRefreshHelper *helper = (GsFlatpakRefreshHelper *) data;
+	GsFlatpakRefreshQueue *queue = (GsFlatpakRefreshQueue *) user_data;
+
+	/* start the clock for this remote */
+	g_mutex_lock (&queue->mutex);
+	helper->deadline = g_get_monotonic_time () +
+			   GS_FLATPAK_REFRESH_APPSTREAM_TIMEOUT * G_USEC_PER_SEC;
+	g_cond_broadcast (&queue->cond);
+	g_mutex_unlock (&queue->mutex);
+
+	/* download new data */
+	if (!g_cancellable_set_error_if_cancelled (helper->cancellable,
+						   &helper->error)) {
+		gs_flatpak_refresh_appstream_remote (helper->self,
+						     flatpak_remote_get_name (helper->xremote),
+						     helper->cancellable,
+						     &helper->error);
+	}
+
+	g_mutex_lock (&queue->mutex);
+	helper->done = TRUE;
+	queue->pending--;
+	g_cond_broadcast (&queue->cond);
+	g_mutex_unlock (&queue->mutex);
+}
+
+static void
+gs_flatpak_refresh_appstream_cancelled_cb (GCancellable *cancellable,
+					   GsFlatpakRefreshQueue *queue)
+{
+	guint i;
+	for (i = 0; i < queue->helpers->len; i++) {
+		GsFlatpakRefreshHelper *helper = g_ptr_array_index (queue->helpers, i);
+		g_cancellable_cancel (helper->cancellable);
+	}
+}
+
+/* refresh all the remotes at once, cancelling any that take too long */
+static gboolean
+gs_flatpak_refresh_appstream_queue (GsFlatpakRefreshQueue *queue,
+				    GCancellable *cancellable,
+				    GError **error)
+{
+	GThreadPool *pool;
+	gulong cancellable_id = 0;
+	guint i;
+
+	pool = g_thread_pool_new (gs_flatpak_refresh_appstream_thread_cb,
+				  queue, (gint) queue->helpers->len,
+				  FALSE, error);
+	if (pool == NULL)
+		return FALSE;
+	if (cancellable != NULL) {
+		cancellable_id = g_cancellable_connect (cancellable,
+							G_CALLBACK (gs_flatpak_refresh_appstream_cancelled_cb),
+							queue, NULL);
+	}
+	g_mutex_lock (&queue->mutex);
+	queue->pending = queue->helpers->len;
+	for (i = 0; i < queue->helpers->len; i++)
+		g_thread_pool_push (pool, g_ptr_array_index (queue->helpers, i), NULL);
+	while (queue->pending > 0) {
+		gint64 now = g_get_monotonic_time ();
+		gint64 wakeup = G_MAXINT64;
+		for (i = 0; i < queue->helpers->len; i++) {
+			GsFlatpakRefreshHelper *helper = g_ptr_array_index (queue->helpers, i);
+			if (helper->done || helper->deadline == 0 || helper->timed_out)
+				continue;
+			if (helper->deadline <= now) {
+				helper->timed_out = TRUE;
+				g_cancellable_cancel (helper->cancellable);
+				continue;
+			}
+			wakeup = MIN (wakeup, helper->deadline);
+		}
+		if (wakeup == G_MAXINT64)
+			g_cond_wait (&queue->cond, &queue->mutex);
+		else
+			g_cond_wait_until (&queue->cond, &queue->mutex, wakeup);
+	}
+	g_mutex_unlock (&queue->mutex);
+	g_thread_pool_free (pool, FALSE, TRUE);
+	g_cancellable_disconnect (cancellable, cancellable_id);
+	return TRUE;
+}
+
+/* replace the apps from one remote without reloading the others */
+static gboolean
+gs_flatpak_rescan_appstream_remote (GsFlatpak *self,
+				    FlatpakRemote *xremote,
+				    GCancellable *cancellable,
+				    GError **error)
+{
+	GPtrArray *apps;
+	guint i;
+	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GPtrArray) apps_remove = NULL;
+
+	ptask = as_profile_start (gs_plugin_get_profile (self->plugin),
+				  "flatpak::rescan-appstream{%s}",
+				  flatpak_remote_get_name (xremote));
+	g_assert (ptask != NULL);
+	apps = as_store_get_apps (self->store);
+	apps_remove = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	for (i = 0; i < apps->len; i++) {
+		AsApp *app = g_ptr_array_index (apps, i);
+		if (g_strcmp0 (as_app_get_origin (app),
+			       flatpak_remote_get_name (xremote)) == 0)
+			g_ptr_array_add (apps_remove, g_object_ref (app));
+	}
+	for (i = 0; i < apps_remove->len; i++)
+		as_store_remove_app (self->store, g_ptr_array_index (apps_remove, i));
+	return gs_flatpak_add_apps_from_xremote (self, xremote, cancellable, error);
 }
 
 static gboolean
@@ -437,11 +846,13 @@ gs_flatpak_refresh_appstream (GsFlatpak *self, guint cache_age,
 			      GsPluginRefreshFlags flags,
 			      GCancellable *cancellable, GError **error)
 {
-	gboolean ret;
-	gboolean something_changed = FALSE;
 	guint i;
+	GsFlatpakRefreshQueue queue;
 	g_autoptr(AsProfileTask) ptask = NULL;
+	g_autoptr(GError) error_interactive = NULL;
+	g_autoptr(GPtrArray) helpers = NULL;
 	g_autoptr(GPtrArray) xremotes = NULL;
+	g_autoptr(GPtrArray) xremotes_changed = NULL;
 
 	/* profile */
 	ptask = as_profile_start_literal (gs_plugin_get_profile (self->plugin),
@@ -456,14 +867,13 @@ gs_flatpak_refresh_appstream (GsFlatpak *self, guint cache_age,
 		gs_plugin_flatpak_error_convert (error);
 		return FALSE;
 	}
+	helpers = g_ptr_array_new_with_free_func ((GDestroyNotify) gs_flatpak_refresh_helper_free);
 	for (i = 0; i < xremotes->len; i++) {
 		const gchar *remote_name;
 		guint tmp;
-		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GFile) file = NULL;
 		g_autoptr(GFile) file_timestamp = NULL;
-		g_autofree gchar *appstream_fn = NULL;
 		FlatpakRemote *xremote = g_ptr_array_index (xremotes, i);
+		GsFlatpakRefreshHelper *helper;
 
 		/* not enabled */
 		if (flatpak_remote_get_disabled (xremote))
@@ -489,11 +899,48 @@ gs_flatpak_refresh_appstream (GsFlatpak *self, guint cache_age,
 		/* download new data */
 		g_debug ("%s is %u seconds old, so downloading new data",
 			 remote_name, tmp);
-		ret = gs_flatpak_refresh_appstream_remote (self,
-							   remote_name,
-							   cancellable,
-							   &error_local);
-		if (!ret) {
+		helper = g_new0 (GsFlatpakRefreshHelper, 1);
+		helper->self = self;
+		helper->xremote = g_object_ref (xremote);
+		helper->cancellable = g_cancellable_new ();
+		helper->mtime_old = gs_flatpak_get_file_mtime (file_timestamp);
+		g_ptr_array_add (helpers, helper);
+	}
+
+	/* download all the stale remotes at the same time */
+	if (helpers->len > 0) {
+		gboolean ret;
+		g_mutex_init (&queue.mutex);
+		g_cond_init (&queue.cond);
+		queue.pending = 0;
+		queue.helpers = helpers;
+		ret = gs_flatpak_refresh_appstream_queue (&queue, cancellable, error);
+		g_mutex_clear (&queue.mutex);
+		g_cond_clear (&queue.cond);
+		if (!ret)
+			return FALSE;
+		gs_flatpak_size_cache_save (self);
+	}
+	if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+		gs_plugin_flatpak_error_convert (error);
+		return FALSE;
+	}
+
+	/* only the remotes that really got new data need to be rescanned */
+	xremotes_changed = g_ptr_array_new ();
+	for (i = 0; i < helpers->len; i++) {
+		GsFlatpakRefreshHelper *helper = g_ptr_array_index (helpers, i);
+		const gchar *remote_name = flatpak_remote_get_name (helper->xremote);
+		GError *error_local = helper->error;
+
+		if (helper->timed_out) {
+			g_warning ("Failed to get AppStream metadata for %s: "
+				   "timed out after %u seconds",
+				   remote_name,
+				   (guint) GS_FLATPAK_REFRESH_APPSTREAM_TIMEOUT);
+			continue;
+		}
+		if (error_local != NULL) {
 			if (g_error_matches (error_local,
 					     G_IO_ERROR,
 					     G_IO_ERROR_FAILED) ||
@@ -515,30 +962,40 @@ gs_flatpak_refresh_appstream (GsFlatpak *self, guint cache_age,
 					   error_local->code);
 				continue;
 			}
-			g_set_error (error,
-				     GS_PLUGIN_ERROR,
-				     GS_PLUGIN_ERROR_NOT_SUPPORTED,
-				     "Failed to get AppStream metadata: %s",
-				     error_local->message);
-			return FALSE;
+			if (error_interactive == NULL) {
+				g_set_error (&error_interactive,
+					     GS_PLUGIN_ERROR,
+					     GS_PLUGIN_ERROR_NOT_SUPPORTED,
+					     "Failed to get AppStream metadata: %s",
+					     error_local->message);
+			}
+			continue;
 		}
-
-		/* add the new AppStream repo to the shared store */
-		file = flatpak_remote_get_appstream_dir (xremote, NULL);
-		appstream_fn = g_file_get_path (file);
-		g_debug ("using AppStream metadata found at: %s", appstream_fn);
-
-		/* trigger the symlink rebuild */
-		something_changed = TRUE;
+		if (gs_flatpak_get_appstream_mtime (helper->xremote) == helper->mtime_old) {
+			g_debug ("AppStream metadata for %s is unchanged", remote_name);
+			continue;
+		}
+		g_ptr_array_add (xremotes_changed, helper->xremote);
 	}
 
 	/* ensure the AppStream store is up to date */
-	if (something_changed ||
-	    as_store_get_size (self->store) == 0) {
+	if (as_store_get_size (self->store) == 0) {
 		if (!gs_flatpak_rescan_appstream_store (self, cancellable, error))
 			return FALSE;
+	} else {
+		for (i = 0; i < xremotes_changed->len; i++) {
+			FlatpakRemote *xremote = g_ptr_array_index (xremotes_changed, i);
+			if (!gs_flatpak_rescan_appstream_remote (self, xremote,
+								 cancellable, error))
+				return FALSE;
+		}
 	}
 
+	/* the other remotes have still been refreshed */
+	if (error_interactive != NULL) {
+		g_propagate_error (error, g_steal_pointer (&error_interactive));
+		return FALSE;
+	}
 	return TRUE;
 }
 
@@ -943,6 +1400,190 @@ gs_flatpak_progress_cb (const gchar *status,
 	gs_app_set_progress (app, progress);
 }
 
+typedef struct {
+	GsFlatpak		*self;
+	FlatpakInstalledRef	*xref;
+	GsApp			*app;
+	GCancellable		*cancellable;
+	GError			*error;
+} GsFlatpakPrefetchHelper;
+
+static void
+gs_flatpak_prefetch_helper_free (GsFlatpakPrefetchHelper *helper)
+{
+	g_object_unref (helper->xref);
+	if (helper->app != NULL)
+		g_object_unref (helper->app);
+	if (helper->cancellable != NULL)
+		g_object_unref (helper->cancellable);
+	g_clear_error (&helper->error);
+	g_free (helper);
+}
+
+static void
+gs_flatpak_prefetch_thread_cb (gpointer data, gpointer user_data)
+{
+	GsFlatpakPrefetchHelper *helper = (GsFlatpakPrefetchHelper *) data;
+	FlatpakRef *xref = FLATPAK_REF (helper->xref);
+	g_autoptr(FlatpakInstallation) installation = NULL;
+	g_autoptr(FlatpakInstalledRef) xref2 = NULL;
+
+	/* no point starting another download */
+	if (g_cancellable_set_error_if_cancelled (helper->cancellable,
+						  &helper->error))
+		return;
+	installation = gs_flatpak_dup_installation (helper->self,
+						    helper->cancellable,
+						    &helper->error);
+	if (installation == NULL)
+		return;
+
+	/* fetch but do not deploy */
+	g_debug ("pulling update for %s", flatpak_ref_get_name (xref));
+	xref2 = flatpak_installation_update (installation,
+					     FLATPAK_UPDATE_FLAGS_NO_DEPLOY,
+					     flatpak_ref_get_kind (xref),
+					     flatpak_ref_get_name (xref),
+					     flatpak_ref_get_arch (xref),
+					     flatpak_ref_get_branch (xref),
+					     helper->app != NULL ? gs_flatpak_progress_cb : NULL,
+					     helper->app,
+					     helper->cancellable,
+					     &helper->error);
+	if (xref2 == NULL)
+		return;
+	g_debug ("pulled update for %s", flatpak_ref_get_name (xref));
+}
+
+/* pull all the refs of one kind, returning the helpers with the results */
+static GPtrArray *
+gs_flatpak_prefetch_kind (GsFlatpak *self,
+			  GPtrArray *xrefs,
+			  FlatpakRefKind kind,
+			  GCancellable *cancellable,
+			  GError **error)
+{
+	GThreadPool *pool;
+	guint i;
+	g_autoptr(GPtrArray) helpers = NULL;
+
+	helpers = g_ptr_array_new_with_free_func ((GDestroyNotify) gs_flatpak_prefetch_helper_free);
+	for (i = 0; i < xrefs->len; i++) {
+		FlatpakInstalledRef *xref = g_ptr_array_index (xrefs, i);
+		GsFlatpakPrefetchHelper *helper;
+		if (flatpak_ref_get_kind (FLATPAK_REF (xref)) != kind)
+			continue;
+		helper = g_new0 (GsFlatpakPrefetchHelper, 1);
+		helper->self = self;
+		helper->xref = g_object_ref (xref);
+		if (cancellable != NULL)
+			helper->cancellable = g_object_ref (cancellable);
+
+		/* try to create a GsApp so we can do progress reporting */
+		helper->app = gs_flatpak_create_installed (self, xref, NULL);
+		g_ptr_array_add (helpers, helper);
+	}
+	if (helpers->len == 0)
+		return g_steal_pointer (&helpers);
+
+	/* wait for all the downloads to complete */
+	pool = g_thread_pool_new (gs_flatpak_prefetch_thread_cb, NULL,
+				  (gint) MIN (self->download_parallel, helpers->len),
+				  FALSE, error);
+	if (pool == NULL)
+		return NULL;
+	for (i = 0; i < helpers->len; i++) {
+		if (!g_thread_pool_push (pool, g_ptr_array_index (helpers, i), error)) {
+			g_thread_pool_free (pool, TRUE, TRUE);
+			return NULL;
+		}
+	}
+	g_thread_pool_free (pool, FALSE, TRUE);
+	return g_steal_pointer (&helpers);
+}
+
+/* returns FALSE only if the refs could not be pulled at all */
+static gboolean
+gs_flatpak_prefetch_check (GPtrArray *helpers,
+			   GString *failed,
+			   guint *n_failed,
+			   GError **error)
+{
+	guint i;
+
+	for (i = 0; i < helpers->len; i++) {
+		GsFlatpakPrefetchHelper *helper = g_ptr_array_index (helpers, i);
+		const gchar *name = flatpak_ref_get_name (FLATPAK_REF (helper->xref));
+		if (helper->error == NULL)
+			continue;
+
+		/* stop everything */
+		if (g_error_matches (helper->error,
+				     G_IO_ERROR,
+				     G_IO_ERROR_CANCELLED)) {
+			g_propagate_error (error, g_steal_pointer (&helper->error));
+			gs_plugin_flatpak_error_convert (error);
+			return FALSE;
+		}
+
+		/* just record this one ref */
+		g_warning ("failed to pull update for %s: %s",
+			   name, helper->error->message);
+		if (failed->len > 0)
+			g_string_append (failed, ", ");
+		g_string_append (failed, name);
+		(*n_failed)++;
+	}
+	return TRUE;
+}
+
+static gboolean
+gs_flatpak_prefetch (GsFlatpak *self,
+		     GPtrArray *xrefs,
+		     GCancellable *cancellable,
+		     GError **error)
+{
+	guint n_failed = 0;
+	g_autoptr(GPtrArray) helpers_apps = NULL;
+	g_autoptr(GPtrArray) helpers_runtimes = NULL;
+	g_autoptr(GString) failed = g_string_new (NULL);
+
+	/* pull runtimes first so that apps never wait on their runtime */
+	helpers_runtimes = gs_flatpak_prefetch_kind (self, xrefs,
+						     FLATPAK_REF_KIND_RUNTIME,
+						     cancellable, error);
+	if (helpers_runtimes == NULL)
+		return FALSE;
+	if (!gs_flatpak_prefetch_check (helpers_runtimes, failed,
+					&n_failed, error))
+		return FALSE;
+	helpers_apps = gs_flatpak_prefetch_kind (self, xrefs,
+						 FLATPAK_REF_KIND_APP,
+						 cancellable, error);
+	if (helpers_apps == NULL)
+		return FALSE;
+	if (!gs_flatpak_prefetch_check (helpers_apps, failed,
+					&n_failed, error))
+		return FALSE;
+
+	/* the other refs have still been downloaded */
+	if (n_failed > 0) {
+		g_set_error (error,
+			     GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_FAILED,
+			     "failed to download %u of %u updates: %s",
+			     n_failed, xrefs->len, failed->str);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void
+gs_flatpak_set_download_parallel (GsFlatpak *self, guint download_parallel)
+{
+	self->download_parallel = MAX (download_parallel, 1);
+}
+
 gboolean
 gs_flatpak_refresh (GsFlatpak *self,
 		    guint cache_age,
@@ -950,7 +1591,6 @@ gs_flatpak_refresh (GsFlatpak *self,
 		    GCancellable *cancellable,
 		    GError **error)
 {
-	guint i;
 	g_autoptr(GPtrArray) xrefs = NULL;
 
 	/* give all the repos a second chance */
@@ -975,33 +1615,7 @@ gs_flatpak_refresh (GsFlatpak *self,
 		gs_plugin_flatpak_error_convert (error);
 		return FALSE;
 	}
-	for (i = 0; i < xrefs->len; i++) {
-		FlatpakInstalledRef *xref = g_ptr_array_index (xrefs, i);
-		g_autoptr(GsApp) app = NULL;
-		g_autoptr(FlatpakInstalledRef) xref2 = NULL;
-
-		/* try to create a GsApp so we can do progress reporting */
-		app = gs_flatpak_create_installed (self, xref,
-						   NULL);
-
-		/* fetch but do not deploy */
-		g_debug ("pulling update for %s",
-			 flatpak_ref_get_name (FLATPAK_REF (xref)));
-		xref2 = flatpak_installation_update (self->installation,
-						     FLATPAK_UPDATE_FLAGS_NO_DEPLOY,
-						     flatpak_ref_get_kind (FLATPAK_REF (xref)),
-						     flatpak_ref_get_name (FLATPAK_REF (xref)),
-						     flatpak_ref_get_arch (FLATPAK_REF (xref)),
-						     flatpak_ref_get_branch (FLATPAK_REF (xref)),
-						     gs_flatpak_progress_cb, app,
-						     cancellable, error);
-		if (xref2 == NULL) {
-			gs_plugin_flatpak_error_convert (error);
-			return FALSE;
-		}
-	}
-
-	return TRUE;
+	return gs_flatpak_prefetch (self, xrefs, cancellable, error);
 }
 
 static gboolean
@@ -1654,17 +2268,27 @@ gs_plugin_refine_item_size (GsFlatpak *self,
 		xref = gs_flatpak_create_fake_ref (app, error);
 		if (xref == NULL)
 			return FALSE;
-		ret = flatpak_installation_fetch_remote_size_sync (self->installation,
-								   gs_app_get_origin (app),
-								   xref,
-								   &download_size,
-								   &installed_size,
-								   cancellable,
-								   &error_local);
-
-		if (!ret) {
-			g_warning ("libflatpak failed to return application "
-				   "size: %s", error_local->message);
+		if (gs_flatpak_size_cache_lookup (self, app, xref,
+						  &download_size,
+						  &installed_size)) {
+			g_debug ("using cached size for %s",
+				 gs_app_get_unique_id (app));
+		} else {
+			ret = flatpak_installation_fetch_remote_size_sync (self->installation,
+									   gs_app_get_origin (app),
+									   xref,
+									   &download_size,
+									   &installed_size,
+									   cancellable,
+									   &error_local);
+			if (ret) {
+				gs_flatpak_size_cache_add (self, app, xref,
+							   download_size,
+							   installed_size);
+			} else {
+				g_warning ("libflatpak failed to return application "
+					   "size: %s", error_local->message);
+			}
 		}
 	}
 
@@ -1675,7 +2299,11 @@ gs_plugin_refine_item_size (GsFlatpak *self,
 }
 
 static gboolean
-gs_flatpak_refine_appstream (GsFlatpak *self, GsApp *app, GError **error)
+gs_flatpak_refine_appstream (GsFlatpak *self,
+			     GsApp *app,
+			     GsPluginRefineFlags flags,
+			     GCancellable *cancellable,
+			     GError **error)
 {
 	AsApp *item;
 	const gchar *unique_id = gs_app_get_unique_id (app);
@@ -1694,7 +2322,10 @@ gs_flatpak_refine_appstream (GsFlatpak *self, GsApp *app, GError **error)
 					      AS_STORE_SEARCH_FLAG_USE_WILDCARDS);
 	if (item == NULL)
 		return TRUE;
-	return gs_appstream_refine_app (self->plugin, app, item, error);
+	if (!gs_appstream_refine_app (self->plugin, app, item, error))
+		return FALSE;
+	return gs_appstream_refine_app_detail (self->plugin, app, item, flags,
+					       cancellable, error);
 }
 
 gboolean
@@ -1718,7 +2349,7 @@ gs_flatpak_refine_app (GsFlatpak *self,
 	g_assert (ptask != NULL);
 
 	/* always do AppStream properties */
-	if (!gs_flatpak_refine_appstream (self, app, error))
+	if (!gs_flatpak_refine_appstream (self, app, flags, cancellable, error))
 		return FALSE;
 
 	/* flatpak apps can always be removed */
@@ -2076,6 +2707,43 @@ gs_flatpak_app_install (GsFlatpak *self,
 	return TRUE;
 }
 
+gboolean
+gs_flatpak_download_app (GsFlatpak *self,
+			 GsApp *app,
+			 GCancellable *cancellable,
+			 GError **error)
+{
+	g_autoptr(FlatpakInstallation) installation = NULL;
+	g_autoptr(FlatpakInstalledRef) xref = NULL;
+
+	/* only process this app if was created by this plugin */
+	if (g_strcmp0 (gs_app_get_management_plugin (app),
+		       gs_plugin_get_name (self->plugin)) != 0)
+		return TRUE;
+
+	/* other apps are being downloaded at the same time */
+	installation = gs_flatpak_dup_installation (self, cancellable, error);
+	if (installation == NULL) {
+		gs_plugin_flatpak_error_convert (error);
+		return FALSE;
+	}
+
+	/* fetch but do not deploy */
+	xref = flatpak_installation_update (installation,
+					    FLATPAK_UPDATE_FLAGS_NO_DEPLOY,
+					    gs_app_get_flatpak_kind (app),
+					    gs_app_get_flatpak_name (app),
+					    gs_app_get_flatpak_arch (app),
+					    gs_app_get_flatpak_branch (app),
+					    gs_flatpak_progress_cb, app,
+					    cancellable, error);
+	if (xref == NULL) {
+		gs_plugin_flatpak_error_convert (error);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 gboolean
 gs_flatpak_update_app (GsFlatpak *self,
 		       GsApp *app,
@@ -2557,6 +3225,19 @@ gs_flatpak_search (GsFlatpak *self,
 					  cancellable, error);
 }
 
+gboolean
+gs_flatpak_search_narrow (GsFlatpak *self,
+			  gchar **values,
+			  GsAppList *previous,
+			  GsAppList *list,
+			  GCancellable *cancellable,
+			  GError **error)
+{
+	return gs_appstream_store_search_previous (self->plugin, self->store,
+						   values, previous, list,
+						   cancellable, error);
+}
+
 gboolean
 gs_flatpak_add_category_apps (GsFlatpak *self,
 			      GsCategory *category,
@@ -2586,9 +3267,15 @@ gs_flatpak_finalize (GObject *object)
 	g_return_if_fail (GS_IS_FLATPAK (object));
 	self = GS_FLATPAK (object);
 
+	gs_flatpak_size_cache_save (self);
+	if (self->monitor != NULL)
+		g_object_unref (self->monitor);
 	g_object_unref (self->plugin);
 	g_object_unref (self->store);
 	g_hash_table_unref (self->broken_remotes);
+	g_key_file_unref (self->size_cache);
+	g_free (self->size_cache_fn);
+	g_mutex_clear (&self->size_cache_mutex);
 
 	G_OBJECT_CLASS (gs_flatpak_parent_class)->finalize (object);
 }
@@ -2608,6 +3295,9 @@ gs_flatpak_init (GsFlatpak *self)
 	self->store = as_store_new ();
 	as_store_set_add_flags (self->store, AS_STORE_ADD_FLAG_USE_UNIQUE_ID);
 	as_store_set_watch_flags (self->store, AS_STORE_WATCH_FLAG_REMOVED);
+	self->download_parallel = GS_FLATPAK_DOWNLOAD_PARALLEL_DEFAULT;
+	g_mutex_init (&self->size_cache_mutex);
+	self->size_cache = g_key_file_new ();
 }
 
 GsFlatpak *
@@ -47,6 +47,9 @@ GsFlatpak	*gs_flatpak_new			(GsPlugin		*plugin,
 gboolean	gs_flatpak_setup		(GsFlatpak		*self,
 						 GCancellable		*cancellable,
 						 GError			**error);
+gboolean	gs_flatpak_locale_changed	(GsFlatpak		*self,
+						 GCancellable		*cancellable,
+						 GError			**error);
 gboolean	gs_flatpak_add_installed	(GsFlatpak		*self,
 						 GsAppList		*list,
 						 GCancellable		*cancellable,
@@ -59,6 +62,8 @@ gboolean	gs_flatpak_add_updates		(GsFlatpak		*self,
 						 GsAppList		*list,
 						 GCancellable		*cancellable,
 						 GError			**error);
+void		gs_flatpak_set_download_parallel (GsFlatpak		*self,
+						 guint			 download_parallel);
 gboolean	gs_flatpak_refresh		(GsFlatpak		*self,
 						 guint			cache_age,
 						 GsPluginRefreshFlags	flags,
@@ -87,6 +92,10 @@ gboolean	gs_flatpak_app_install		(GsFlatpak		*self,
 						 GsApp			*app,
 						 GCancellable		*cancellable,
 						 GError			**error);
+gboolean	gs_flatpak_download_app		(GsFlatpak		*self,
+						 GsApp			*app,
+						 GCancellable		*cancellable,
+						 GError			**error);
 gboolean	gs_flatpak_update_app		(GsFlatpak		*self,
 						 GsApp			*app,
 						 GCancellable		*cancellable,
@@ -101,6 +110,12 @@ gboolean	gs_flatpak_search		(GsFlatpak		*self,
 						 GsAppList		*list,
 						 GCancellable		*cancellable,
 						 GError			**error);
+gboolean	gs_flatpak_search_narrow	(GsFlatpak		*self,
+						 gchar			**values,
+						 GsAppList		*previous,
+						 GsAppList		*list,
+						 GCancellable		*cancellable,
+						 GError			**error);
 gboolean	gs_flatpak_add_categories	(GsFlatpak		*self,
 						 GPtrArray		*list,
 						 GCancellable		*cancellable,
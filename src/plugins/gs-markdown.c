@@ -45,6 +45,10 @@
  * been run against any conformance tests. The parsing is single pass, with
  * a simple enumerated intepretor mode and a single line back-memory.
  *
+ * The inline markers of each paragraph are found in one scan and paired up
+ * before anything is written, so formatting takes linear time and all the
+ * output goes into one buffer.
+ *
  ******************************************************************************/
 
 typedef enum {
@@ -57,6 +61,12 @@ typedef enum {
 	GS_MARKDOWN_MODE_UNKNOWN
 } GsMarkdownMode;
 
+typedef struct {
+	gchar		 ch;		/* the marker character */
+	gsize		 pos;		/* offset into the section */
+	const gchar	*tag;		/* what to write instead, or NULL */
+} GsMarkdownToken;
+
 typedef struct {
 	const gchar *em_start;
 	const gchar *em_end;
@@ -86,7 +96,9 @@ struct _GsMarkdown {
 	gboolean		 autocode;
 	gboolean		 autolinkify;
 	GString			*pending;
+	GString			*prepared;
 	GString			*processed;
+	GArray			*tokens;	/* of GsMarkdownToken */
 };
 
 G_DEFINE_TYPE (GsMarkdown, gs_markdown, G_TYPE_OBJECT)
@@ -101,23 +113,16 @@ G_DEFINE_TYPE (GsMarkdown, gs_markdown, G_TYPE_OBJECT)
 static gboolean
 gs_markdown_to_text_line_is_rule (const gchar *line)
 {
-	guint i;
-	guint len;
+	const gchar *p;
 	guint count = 0;
-	g_autofree gchar *copy = NULL;
 
-	len = (guint) strlen (line);
-	if (len == 0)
-		return FALSE;
-
-	/* replace non-rule chars with ~ */
-	copy = g_strdup (line);
-	g_strcanon (copy, "-*_ ", '~');
-	for (i = 0; i < len; i++) {
-		if (copy[i] == '~')
+	/* only rule chars and spaces are allowed */
+	for (p = line; *p != '\0'; p++) {
+		if (*p == ' ')
+			continue;
+		if (*p != '-' && *p != '*' && *p != '_')
 			return FALSE;
-		if (copy[i] != ' ')
-			count++;
+		count++;
 	}
 
 	/* if we matched, return true */
@@ -197,200 +202,76 @@ gs_markdown_to_text_line_is_blank (const gchar *line)
 	return TRUE;
 }
 
-static gchar *
-gs_markdown_replace (const gchar *haystack,
-		     const gchar *needle,
-		     const gchar *replace)
-{
-	g_auto(GStrv) split = NULL;
-	split = g_strsplit (haystack, needle, -1);
-	return g_strjoinv (replace, split);
-}
-
-static gchar *
-gs_markdown_strstr_spaces (const gchar *haystack, const gchar *needle)
+/* the characters g_markup_escape_text() would also escape */
+static gboolean
+gs_markdown_unichar_is_restricted (gunichar c)
 {
-	gchar *found;
-	const gchar *haystack_new = haystack;
-
-retry:
-	/* don't find if surrounded by spaces */
-	found = strstr (haystack_new, needle);
-	if (found == NULL)
-		return NULL;
-
-	/* start of the string, always valid */
-	if (found == haystack)
-		return found;
-
-	/* end of the string, always valid */
-	if (*(found-1) == ' ' && *(found+1) == ' ') {
-		haystack_new = found+1;
-		goto retry;
-	}
-	return found;
+	return (0x1 <= c && c <= 0x8) ||
+		(0xb <= c && c <= 0xc) ||
+		(0xe <= c && c <= 0x1f) ||
+		(0x7f <= c && c <= 0x84) ||
+		(0x86 <= c && c <= 0x9f);
 }
 
-static gchar *
-gs_markdown_to_text_line_formatter (const gchar *line,
-				    const gchar *formatter,
-				    const gchar *left,
-				    const gchar *right)
+/* the same as g_markup_escape_text() but appending to @str */
+static void
+gs_markdown_append_escaped (GString *str, const gchar *text, gsize len)
 {
-	guint len;
-	gchar *str1;
-	gchar *str2;
-	gchar *start = NULL;
-	gchar *middle = NULL;
-	gchar *end = NULL;
-	g_autofree gchar *copy = NULL;
+	const gchar *end = text + len;
+	const gchar *last = text;
+	const gchar *p = text;
 
-	/* needed to know for shifts */
-	len = (guint) strlen (formatter);
-	if (len == 0)
-		return NULL;
-
-	/* find sections */
-	copy = g_strdup (line);
-	str1 = gs_markdown_strstr_spaces (copy, formatter);
-	if (str1 != NULL) {
-		*str1 = '\0';
-		str2 = gs_markdown_strstr_spaces (str1+len, formatter);
-		if (str2 != NULL) {
-			*str2 = '\0';
-			middle = str1 + len;
-			start = copy;
-			end = str2 + len;
+	while (p < end) {
+		const gchar *entity = NULL;
+		switch (*p) {
+		case '&':
+			entity = "&amp;";
+			break;
+		case '<':
+			entity = "&lt;";
+			break;
+		case '>':
+			entity = "&gt;";
+			break;
+		case '\'':
+			entity = "&apos;";
+			break;
+		case '"':
+			entity = "&quot;";
+			break;
+		default:
+			break;
+		}
+		if (entity != NULL) {
+			g_string_append_len (str, last, p - last);
+			g_string_append (str, entity);
+			last = ++p;
+			continue;
 		}
-	}
-
-	/* if we found, replace and keep looking for the same string */
-	if (start != NULL && middle != NULL && end != NULL) {
-		g_autofree gchar *temp = NULL;
-		temp = g_strdup_printf ("%s%s%s%s%s", start, left, middle, right, end);
-		/* recursive */
-		return gs_markdown_to_text_line_formatter (temp, formatter, left, right);
-	}
-
-	/* not found, keep return as-is */
-	return g_strdup (line);
-}
-
-static gchar *
-gs_markdown_to_text_line_format_sections (GsMarkdown *self, const gchar *line)
-{
-	gchar *data = g_strdup (line);
-	gchar *temp;
-
-	/* bold1 */
-	temp = data;
-	data = gs_markdown_to_text_line_formatter (temp, "**",
-						   self->tags.strong_start,
-						   self->tags.strong_end);
-	g_free (temp);
-
-	/* bold2 */
-	temp = data;
-	data = gs_markdown_to_text_line_formatter (temp, "__",
-						   self->tags.strong_start,
-						   self->tags.strong_end);
-	g_free (temp);
-
-	/* italic1 */
-	temp = data;
-	data = gs_markdown_to_text_line_formatter (temp, "*",
-						   self->tags.em_start,
-						   self->tags.em_end);
-	g_free (temp);
-
-	/* italic2 */
-	temp = data;
-	data = gs_markdown_to_text_line_formatter (temp, "_",
-						   self->tags.em_start,
-						   self->tags.em_end);
-	g_free (temp);
-
-	/* em-dash */
-	temp = data;
-	data = gs_markdown_replace (temp, " -- ", " — ");
-	g_free (temp);
-
-	/* smart quoting */
-	if (self->smart_quoting) {
-		temp = data;
-		data = gs_markdown_to_text_line_formatter (temp, "\"", "“", "”");
-		g_free (temp);
-
-		temp = data;
-		data = gs_markdown_to_text_line_formatter (temp, "'", "‘", "’");
-		g_free (temp);
-	}
-
-	return data;
-}
-
-static gchar *
-gs_markdown_to_text_line_format (GsMarkdown *self, const gchar *line)
-{
-	GString *string;
-	gboolean mode = FALSE;
-	gchar *text;
-	guint i;
-	g_auto(GStrv) codes = NULL;
-
-	/* optimise the trivial case where we don't have any code tags */
-	text = strstr (line, "`");
-	if (text == NULL)
-		return gs_markdown_to_text_line_format_sections (self, line);
 
-	/* we want to parse the code sections without formatting */
-	codes = g_strsplit (line, "`", -1);
-	string = g_string_new ("");
-	for (i = 0; codes[i] != NULL; i++) {
-		if (!mode) {
-			text = gs_markdown_to_text_line_format_sections (self, codes[i]);
-			g_string_append (string, text);
-			g_free (text);
-			mode = TRUE;
-		} else {
-			/* just append without formatting */
-			g_string_append (string, self->tags.code_start);
-			g_string_append (string, codes[i]);
-			g_string_append (string, self->tags.code_end);
-			mode = FALSE;
+		/* control characters, which are either ASCII or U+0080 to U+009F */
+		if ((guchar) *p < 0x20 || (guchar) *p == 0x7f || (guchar) *p == 0xc2) {
+			gunichar c = g_utf8_get_char (p);
+			if (gs_markdown_unichar_is_restricted (c)) {
+				g_string_append_len (str, last, p - last);
+				g_string_append_printf (str, "&#x%x;", c);
+				p = g_utf8_next_char (p);
+				last = p;
+				continue;
+			}
 		}
+		p++;
 	}
-	return g_string_free (string, FALSE);
-}
-
-static gboolean
-gs_markdown_add_pending (GsMarkdown *self, const gchar *line)
-{
-	g_autofree gchar *copy = NULL;
-
-	/* would put us over the limit */
-	if (self->max_lines > 0 && self->line_count >= self->max_lines)
-		return FALSE;
-
-	copy = g_strdup (line);
-
-	/* strip leading and trailing spaces */
-	g_strstrip (copy);
-
-	/* append */
-	g_string_append_printf (self->pending, "%s ", copy);
-	return TRUE;
+	g_string_append_len (str, last, end - last);
 }
 
-static gboolean
-gs_markdown_add_pending_header (GsMarkdown *self, const gchar *line)
+static void
+gs_markdown_append_maybe_escaped (GsMarkdown *self, const gchar *text, gsize len)
 {
-	g_autofree gchar *copy = NULL;
-
-	/* strip trailing # */
-	copy = g_strdup (line);
-	g_strdelimit (copy, "#", ' ');
-	return gs_markdown_add_pending (self, copy);
+	if (self->escape)
+		gs_markdown_append_escaped (self->prepared, text, len);
+	else
+		g_string_append_len (self->prepared, text, len);
 }
 
 static guint
@@ -453,35 +334,6 @@ gs_markdown_word_is_code (const gchar *text)
 	return FALSE;
 }
 
-static gchar *
-gs_markdown_word_auto_format_code (const gchar *text)
-{
-	guint i;
-	gchar *temp;
-	gboolean ret = FALSE;
-	g_auto(GStrv) words = NULL;
-
-	/* split sentence up with space */
-	words = g_strsplit (text, " ", -1);
-
-	/* search each word */
-	for (i = 0; words[i] != NULL; i++) {
-		if (gs_markdown_word_is_code (words[i])) {
-			temp = g_strdup_printf ("`%s`", words[i]);
-			g_free (words[i]);
-			words[i] = temp;
-			ret = TRUE;
-		}
-	}
-
-	/* no replacements, so just return a copy */
-	if (!ret)
-		return g_strdup (text);
-
-	/* join the array back into a string */
-	return g_strjoinv (" ", words);
-}
-
 static gboolean
 gs_markdown_word_is_url (const gchar *text)
 {
@@ -494,107 +346,391 @@ gs_markdown_word_is_url (const gchar *text)
 	return FALSE;
 }
 
-static gchar *
-gs_markdown_word_auto_format_urls (const gchar *text)
+/* words that look like code are quoted with backticks so that they are not
+ * formatted, and URLs are turned into links */
+static void
+gs_markdown_prepare_word (GsMarkdown *self,
+			  const gchar *word,
+			  gboolean autocode,
+			  gboolean autolinkify)
 {
-	guint i;
-	gchar *temp;
-	gboolean ret = FALSE;
-	g_auto(GStrv) words = NULL;
-
-	/* split sentence up with space */
-	words = g_strsplit (text, " ", -1);
-
-	/* search each word */
-	for (i = 0; words[i] != NULL; i++) {
-		if (gs_markdown_word_is_url (words[i])) {
-			temp = g_strdup_printf ("<a href=\"%s\">%s</a>",
-						words[i], words[i]);
-			g_free (words[i]);
-			words[i] = temp;
-			ret = TRUE;
+	gsize len = strlen (word);
+
+	if (autocode && gs_markdown_word_is_code (word)) {
+		g_string_append_c (self->prepared, '`');
+		gs_markdown_append_maybe_escaped (self, word, len);
+		g_string_append_c (self->prepared, '`');
+		return;
+	}
+	if (autolinkify && gs_markdown_word_is_url (word)) {
+		g_string_append (self->prepared, "<a href=\"");
+		gs_markdown_append_maybe_escaped (self, word, len);
+		g_string_append (self->prepared, "\">");
+		gs_markdown_append_maybe_escaped (self, word, len);
+		g_string_append (self->prepared, "</a>");
+		return;
+	}
+	gs_markdown_append_maybe_escaped (self, word, len);
+}
+
+/* escape the pending text and apply the word-based rules, copying it into
+ * self->prepared; self->pending is modified in the process */
+static void
+gs_markdown_prepare_pending (GsMarkdown *self)
+{
+	gboolean autocode = FALSE;
+	gboolean autolinkify = FALSE;
+	gchar *word = self->pending->str;
+
+	/* pango requires escaping */
+	if (!self->escape && self->output == GS_MARKDOWN_OUTPUT_PANGO) {
+		g_strdelimit (self->pending->str, "<", '(');
+		g_strdelimit (self->pending->str, ">", ')');
+		g_strdelimit (self->pending->str, "&", '+');
+	}
+
+	/* check words for code and for URLs */
+	if (self->mode == GS_MARKDOWN_MODE_PARA ||
+	    self->mode == GS_MARKDOWN_MODE_BULLETT) {
+		autocode = self->autocode;
+		autolinkify = self->autolinkify &&
+			      self->output == GS_MARKDOWN_OUTPUT_PANGO;
+	}
+
+	g_string_truncate (self->prepared, 0);
+	if (!autocode && !autolinkify) {
+		gs_markdown_append_maybe_escaped (self, self->pending->str,
+						  self->pending->len);
+		return;
+	}
+	while (TRUE) {
+		gchar *space = strchr (word, ' ');
+		if (space != NULL)
+			*space = '\0';
+		gs_markdown_prepare_word (self, word, autocode, autolinkify);
+		if (space == NULL)
+			break;
+		g_string_append_c (self->prepared, ' ');
+		word = space + 1;
+	}
+}
+
+/* is the character before or after the token a space, looking through any
+ * markers that have already been removed */
+static gboolean
+gs_markdown_token_prev_is_space (GsMarkdown *self, const gchar *text, guint idx)
+{
+	gsize pos = g_array_index (self->tokens, GsMarkdownToken, idx).pos;
+
+	while (pos > 0) {
+		GsMarkdownToken *tok;
+		pos--;
+		if (idx == 0)
+			return text[pos] == ' ';
+		tok = &g_array_index (self->tokens, GsMarkdownToken, idx - 1);
+		if (tok->pos != pos || tok->tag == NULL)
+			return text[pos] == ' ';
+		if (tok->tag[0] != '\0')
+			return FALSE;
+		idx--;
+	}
+	return FALSE;
+}
+
+static gboolean
+gs_markdown_token_next_is_space (GsMarkdown *self,
+				 const gchar *text,
+				 gsize len,
+				 guint idx)
+{
+	gsize pos = g_array_index (self->tokens, GsMarkdownToken, idx).pos;
+
+	while (pos + 1 < len) {
+		GsMarkdownToken *tok;
+		pos++;
+		if (idx + 1 >= self->tokens->len)
+			return text[pos] == ' ';
+		tok = &g_array_index (self->tokens, GsMarkdownToken, idx + 1);
+		if (tok->pos != pos || tok->tag == NULL)
+			return text[pos] == ' ';
+		if (tok->tag[0] != '\0')
+			return FALSE;
+		idx++;
+	}
+	return FALSE;
+}
+
+/* a single marker is ignored when it is surrounded by spaces */
+static gboolean
+gs_markdown_token_is_valid (GsMarkdown *self,
+			    const gchar *text,
+			    gsize len,
+			    guint idx)
+{
+	if (!gs_markdown_token_prev_is_space (self, text, idx))
+		return TRUE;
+	return !gs_markdown_token_next_is_space (self, text, len, idx);
+}
+
+/* pair up doubled markers like "**" from left to right; each run of marker
+ * characters is split into pairs starting from the left */
+static void
+gs_markdown_pair_double (GsMarkdown *self,
+			 gchar ch,
+			 const gchar *start,
+			 const gchar *end)
+{
+	GsMarkdownToken *open = NULL;
+	guint i = 0;
+
+	while (i + 1 < self->tokens->len) {
+		GsMarkdownToken *tok = &g_array_index (self->tokens, GsMarkdownToken, i);
+		GsMarkdownToken *next = &g_array_index (self->tokens, GsMarkdownToken, i + 1);
+		if (tok->ch != ch || tok->tag != NULL ||
+		    next->ch != ch || next->pos != tok->pos + 1) {
+			i++;
+			continue;
 		}
+		if (open == NULL) {
+			open = tok;
+		} else {
+			open[0].tag = start;
+			open[1].tag = "";
+			tok->tag = end;
+			next->tag = "";
+			open = NULL;
+		}
+		i += 2;
 	}
+}
 
-	/* no replacements, so just return a copy */
-	if (!ret)
-		return g_strdup (text);
+/* pair up single markers like "*" from left to right, where a marker
+ * immediately after the opening one always closes it */
+static void
+gs_markdown_pair_single (GsMarkdown *self,
+			 const gchar *text,
+			 gsize len,
+			 gchar ch,
+			 const gchar *start,
+			 const gchar *end)
+{
+	GsMarkdownToken *open = NULL;
+	guint i;
 
-	/* join the array back into a string */
-	return g_strjoinv (" ", words);
+	for (i = 0; i < self->tokens->len; i++) {
+		GsMarkdownToken *tok = &g_array_index (self->tokens, GsMarkdownToken, i);
+		if (tok->ch != ch || tok->tag != NULL)
+			continue;
+		if (open == NULL) {
+			if (gs_markdown_token_is_valid (self, text, len, i))
+				open = tok;
+			continue;
+		}
+		if (tok->pos == open->pos + 1 ||
+		    gs_markdown_token_is_valid (self, text, len, i)) {
+			open->tag = start;
+			tok->tag = end;
+			open = NULL;
+		}
+	}
 }
 
+/* append text replacing " -- " with an em-dash */
 static void
-gs_markdown_flush_pending (GsMarkdown *self)
-{
-	g_autofree gchar *copy = NULL;
-	g_autofree gchar *temp = NULL;
+gs_markdown_append_text (GString *str, const gchar *text, gsize len)
+{
+	gsize i;
+	gsize last = 0;
+
+	for (i = 0; i + 4 <= len; i++) {
+		if (memcmp (text + i, " -- ", 4) != 0)
+			continue;
+		g_string_append_len (str, text + last, i - last);
+		g_string_append (str, " — ");
+		i += 3;
+		last = i + 1;
+	}
+	g_string_append_len (str, text + last, len - last);
+}
 
-	/* no data yet */
-	if (self->mode == GS_MARKDOWN_MODE_UNKNOWN)
-		return;
+/* format a section of text that is not code, finding all the markers in one
+ * pass, pairing them, and then writing the text and tags in another */
+static void
+gs_markdown_format_section (GsMarkdown *self,
+			    GString *str,
+			    const gchar *text,
+			    gsize len)
+{
+	gsize i;
+	gsize last = 0;
 
-	/* remove trailing spaces */
-	while (g_str_has_suffix (self->pending->str, " "))
-		g_string_set_size (self->pending, self->pending->len - 1);
+	g_array_set_size (self->tokens, 0);
+	for (i = 0; i < len; i++) {
+		GsMarkdownToken tok;
+		if (text[i] != '*' && text[i] != '_' &&
+		    (!self->smart_quoting || (text[i] != '"' && text[i] != '\'')))
+			continue;
+		tok.ch = text[i];
+		tok.pos = i;
+		tok.tag = NULL;
+		g_array_append_val (self->tokens, tok);
+	}
 
-	/* pango requires escaping */
-	copy = g_strdup (self->pending->str);
-	if (!self->escape && self->output == GS_MARKDOWN_OUTPUT_PANGO) {
-		g_strdelimit (copy, "<", '(');
-		g_strdelimit (copy, ">", ')');
-		g_strdelimit (copy, "&", '+');
+	/* bold, then italic, then quotes */
+	if (self->tokens->len > 0) {
+		gs_markdown_pair_double (self, '*',
+					 self->tags.strong_start,
+					 self->tags.strong_end);
+		gs_markdown_pair_double (self, '_',
+					 self->tags.strong_start,
+					 self->tags.strong_end);
+		gs_markdown_pair_single (self, text, len, '*',
+					 self->tags.em_start,
+					 self->tags.em_end);
+		gs_markdown_pair_single (self, text, len, '_',
+					 self->tags.em_start,
+					 self->tags.em_end);
+		if (self->smart_quoting) {
+			gs_markdown_pair_single (self, text, len, '"', "“", "”");
+			gs_markdown_pair_single (self, text, len, '\'', "‘", "’");
+		}
 	}
 
-	/* check words for code */
-	if (self->autocode &&
-	    (self->mode == GS_MARKDOWN_MODE_PARA ||
-	     self->mode == GS_MARKDOWN_MODE_BULLETT)) {
-		temp = gs_markdown_word_auto_format_code (copy);
-		g_free (copy);
-		copy = temp;
+	/* write everything out */
+	for (i = 0; i < self->tokens->len; i++) {
+		GsMarkdownToken *tok = &g_array_index (self->tokens, GsMarkdownToken, i);
+		gs_markdown_append_text (str, text + last, tok->pos - last);
+		if (tok->tag != NULL)
+			g_string_append (str, tok->tag);
+		else
+			g_string_append_c (str, tok->ch);
+		last = tok->pos + 1;
 	}
+	gs_markdown_append_text (str, text + last, len - last);
+}
+
+static void
+gs_markdown_format_line (GsMarkdown *self,
+			 GString *str,
+			 const gchar *line,
+			 gsize len)
+{
+	const gchar *end = line + len;
+	gboolean code = FALSE;
 
-	/* escape */
-	if (self->escape) {
-		temp = g_markup_escape_text (copy, -1);
-		g_free (copy);
-		copy = temp;
+	/* we want to parse the code sections without formatting */
+	while (TRUE) {
+		const gchar *tick = memchr (line, '`', end - line);
+		const gchar *section_end = tick != NULL ? tick : end;
+		if (code) {
+			g_string_append (str, self->tags.code_start);
+			g_string_append_len (str, line, section_end - line);
+			g_string_append (str, self->tags.code_end);
+		} else {
+			gs_markdown_format_section (self, str, line,
+						    section_end - line);
+		}
+		if (tick == NULL)
+			break;
+		line = tick + 1;
+		code = !code;
 	}
+}
 
-	/* check words for URLS */
-	if (self->autolinkify &&
-	    self->output == GS_MARKDOWN_OUTPUT_PANGO &&
-	    (self->mode == GS_MARKDOWN_MODE_PARA ||
-	     self->mode == GS_MARKDOWN_MODE_BULLETT)) {
-		temp = gs_markdown_word_auto_format_urls (copy);
-		g_free (copy);
-		copy = temp;
+/* strip leading and trailing whitespace, and optionally any header marks */
+static gboolean
+gs_markdown_char_is_strippable (gchar c, gboolean header)
+{
+	if (header && c == '#')
+		return TRUE;
+	return g_ascii_isspace (c);
+}
+
+static gboolean
+gs_markdown_add_pending_full (GsMarkdown *self,
+			      const gchar *line,
+			      gboolean header)
+{
+	const gchar *start = line;
+	const gchar *end = line + strlen (line);
+
+	/* would put us over the limit */
+	if (self->max_lines > 0 && self->line_count >= self->max_lines)
+		return FALSE;
+
+	/* strip leading and trailing spaces */
+	while (start < end && gs_markdown_char_is_strippable (*start, header))
+		start++;
+	while (end > start && gs_markdown_char_is_strippable (end[-1], header))
+		end--;
+
+	/* append */
+	if (header) {
+		const gchar *p;
+		for (p = start; p < end; p++)
+			g_string_append_c (self->pending, *p == '#' ? ' ' : *p);
+	} else {
+		g_string_append_len (self->pending, start, end - start);
 	}
+	g_string_append_c (self->pending, ' ');
+	return TRUE;
+}
+
+static gboolean
+gs_markdown_add_pending (GsMarkdown *self, const gchar *line)
+{
+	return gs_markdown_add_pending_full (self, line, FALSE);
+}
+
+static gboolean
+gs_markdown_add_pending_header (GsMarkdown *self, const gchar *line)
+{
+	/* strip trailing # */
+	return gs_markdown_add_pending_full (self, line, TRUE);
+}
+
+static void
+gs_markdown_flush_pending (GsMarkdown *self)
+{
+	const gchar *start = NULL;
+	const gchar *end = NULL;
+
+	/* no data yet */
+	if (self->mode == GS_MARKDOWN_MODE_UNKNOWN)
+		return;
+
+	/* remove trailing spaces */
+	while (self->pending->len > 0 &&
+	       self->pending->str[self->pending->len - 1] == ' ')
+		g_string_set_size (self->pending, self->pending->len - 1);
 
 	/* do formatting */
-	temp = gs_markdown_to_text_line_format (self, copy);
 	if (self->mode == GS_MARKDOWN_MODE_BULLETT) {
-		g_string_append_printf (self->processed, "%s%s%s\n",
-					self->tags.bullet_start,
-					temp,
-					self->tags.bullet_end);
+		start = self->tags.bullet_start;
+		end = self->tags.bullet_end;
 		self->line_count++;
 	} else if (self->mode == GS_MARKDOWN_MODE_H1) {
-		g_string_append_printf (self->processed, "%s%s%s\n",
-					self->tags.h1_start,
-					temp,
-					self->tags.h1_end);
+		start = self->tags.h1_start;
+		end = self->tags.h1_end;
 	} else if (self->mode == GS_MARKDOWN_MODE_H2) {
-		g_string_append_printf (self->processed, "%s%s%s\n",
-					self->tags.h2_start,
-					temp,
-					self->tags.h2_end);
+		start = self->tags.h2_start;
+		end = self->tags.h2_end;
 	} else if (self->mode == GS_MARKDOWN_MODE_PARA ||
 		   self->mode == GS_MARKDOWN_MODE_RULE) {
-		g_string_append_printf (self->processed, "%s\n", temp);
+		start = "";
+		end = "";
 		self->line_count++;
 	}
+	if (start != NULL) {
+		/* escape, and find code and links */
+		gs_markdown_prepare_pending (self);
+		g_string_append (self->processed, start);
+		gs_markdown_format_line (self, self->processed,
+					 self->prepared->str,
+					 self->prepared->len);
+		g_string_append (self->processed, end);
+		g_string_append_c (self->processed, '\n');
+	}
 
 	/* clear */
 	g_string_truncate (self->pending, 0);
@@ -789,11 +925,9 @@ gs_markdown_set_autolinkify (GsMarkdown *self, gboolean autolinkify)
 gchar *
 gs_markdown_parse (GsMarkdown *self, const gchar *markdown)
 {
-	gboolean ret;
+	gchar *line;
 	gchar *temp;
-	guint i;
-	guint len;
-	g_auto(GStrv) lines = NULL;
+	g_autofree gchar *copy = NULL;
 
 	g_return_val_if_fail (GS_IS_MARKDOWN (self), NULL);
 
@@ -802,14 +936,17 @@ gs_markdown_parse (GsMarkdown *self, const gchar *markdown)
 	self->line_count = 0;
 	g_string_truncate (self->pending, 0);
 	g_string_truncate (self->processed, 0);
-	lines = g_strsplit (markdown, "\n", -1);
-	len = g_strv_length (lines);
 
-	/* process each line */
-	for (i = 0; i < len; i++) {
-		ret = gs_markdown_to_text_line_process (self, lines[i]);
-		if (!ret)
+	/* process each line, splitting a copy in place */
+	copy = g_strdup (markdown);
+	line = copy[0] != '\0' ? copy : NULL;
+	while (line != NULL) {
+		gchar *eol = strchr (line, '\n');
+		if (eol != NULL)
+			*eol = '\0';
+		if (!gs_markdown_to_text_line_process (self, line))
 			break;
+		line = eol != NULL ? eol + 1 : NULL;
 	}
 	gs_markdown_flush_pending (self);
 
@@ -834,7 +971,9 @@ gs_markdown_finalize (GObject *object)
 	self = GS_MARKDOWN (object);
 
 	g_string_free (self->pending, TRUE);
+	g_string_free (self->prepared, TRUE);
 	g_string_free (self->processed, TRUE);
+	g_array_unref (self->tokens);
 
 	G_OBJECT_CLASS (gs_markdown_parent_class)->finalize (object);
 }
@@ -851,7 +990,9 @@ gs_markdown_init (GsMarkdown *self)
 {
 	self->mode = GS_MARKDOWN_MODE_UNKNOWN;
 	self->pending = g_string_new ("");
+	self->prepared = g_string_new ("");
 	self->processed = g_string_new ("");
+	self->tokens = g_array_new (FALSE, FALSE, sizeof (GsMarkdownToken));
 	self->max_lines = -1;
 	self->smart_quoting = FALSE;
 	self->escape = FALSE;
@@ -38,6 +38,7 @@
 
 struct GsPluginData {
 	AsStore			*store;
+	GRWLock			 store_lock;	/* for changing the items in place */
 	GHashTable		*app_hash_old;
 };
 
@@ -120,22 +121,68 @@ gs_plugin_detect_reload_apps (GsPlugin *plugin)
 }
 
 static void
-gs_plugin_appstream_store_changed_cb (AsStore *store, GsPlugin *plugin)
+gs_plugin_appstream_compact_thread_cb (GTask *task,
+				       gpointer source_object,
+				       gpointer task_data,
+				       GCancellable *cancellable)
 {
-	g_debug ("AppStream metadata changed");
+	GsPlugin *plugin = GS_PLUGIN (source_object);
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	AsStore *store = AS_STORE (task_data);
+
+	/* the items are changed in place, so wait for all the readers */
+	g_rw_lock_writer_lock (&priv->store_lock);
+	gs_appstream_store_prune_locales (store,
+					  gs_plugin_get_locale (plugin),
+					  gs_plugin_get_language (plugin));
+	gs_appstream_store_compact (store, NULL);
+	g_rw_lock_writer_unlock (&priv->store_lock);
+	g_task_return_boolean (task, TRUE);
+}
 
-	/* send ::reload-apps */
-	gs_plugin_detect_reload_apps (plugin);
+static void
+gs_plugin_appstream_compact_cb (GObject *source_object,
+				GAsyncResult *res,
+				gpointer user_data)
+{
+	GsPlugin *plugin = GS_PLUGIN (source_object);
 
 	/* all the UI is reloaded as something external has happened */
 	if (!gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_RUNNING_OTHER))
 		gs_plugin_reload (plugin);
 }
 
+static void
+gs_plugin_appstream_reload_cb (GsPlugin *plugin, gpointer user_data)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	g_autoptr(GTask) task = NULL;
+
+	g_debug ("AppStream metadata changed");
+
+	/* send ::reload-apps */
+	gs_plugin_detect_reload_apps (plugin);
+
+	/* any reloaded files have all the details again, so compact them
+	 * in a thread so that the refines in progress can finish first */
+	task = g_task_new (plugin, NULL, gs_plugin_appstream_compact_cb, NULL);
+	g_task_set_task_data (task, g_object_ref (priv->store),
+			      (GDestroyNotify) g_object_unref);
+	g_task_run_in_thread (task, gs_plugin_appstream_compact_thread_cb);
+}
+
+static void
+gs_plugin_appstream_store_changed_cb (AsStore *store, GsPlugin *plugin)
+{
+	/* a package transaction touches many files in quick succession */
+	gs_plugin_watch_queue (plugin, gs_plugin_appstream_reload_cb, NULL);
+}
+
 void
 gs_plugin_initialize (GsPlugin *plugin)
 {
 	GsPluginData *priv = gs_plugin_alloc_data (plugin, sizeof(GsPluginData));
+	g_rw_lock_init (&priv->store_lock);
 	priv->store = as_store_new ();
 	as_store_set_add_flags (priv->store,
 				AS_STORE_ADD_FLAG_USE_UNIQUE_ID |
@@ -146,6 +193,7 @@ gs_plugin_initialize (GsPlugin *plugin)
 
 	/* set plugin flags */
 	gs_plugin_add_flags (plugin, GS_PLUGIN_FLAGS_GLOBAL_CACHE);
+	gs_plugin_add_flags (plugin, GS_PLUGIN_FLAGS_NARROWABLE_SEARCH);
 
 	/* need package name */
 	gs_plugin_add_rule (plugin, GS_PLUGIN_RULE_RUN_AFTER, "dpkg");
@@ -157,6 +205,7 @@ gs_plugin_destroy (GsPlugin *plugin)
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	g_hash_table_unref (priv->app_hash_old);
 	g_object_unref (priv->store);
+	g_rw_lock_clear (&priv->store_lock);
 }
 
 /*
@@ -206,14 +255,17 @@ gs_plugin_appstream_get_origins_hash (GPtrArray *array)
 	return origins;
 }
 
-gboolean
-gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
+static gboolean
+gs_plugin_appstream_load (GsPlugin *plugin,
+			  GCancellable *cancellable,
+			  GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	AsApp *app;
 	GPtrArray *items;
 	gboolean ret;
 	const gchar *tmp;
+	const gchar *catalog;
 	const gchar *test_xml;
 	const gchar *test_icon_root;
 	guint *perc;
@@ -228,12 +280,23 @@ gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
 
 	/* only when in self test */
 	test_xml = g_getenv ("GS_SELF_TEST_APPSTREAM_XML");
+	catalog = g_getenv ("GNOME_SOFTWARE_APPSTREAM_FILE");
 	if (test_xml != NULL) {
 		test_icon_root = g_getenv ("GS_SELF_TEST_APPSTREAM_ICON_ROOT");
 		g_debug ("using self test data of %s... with icon root %s",
 			 test_xml, test_icon_root);
 		if (!as_store_from_xml (priv->store, test_xml, test_icon_root, error))
 			return FALSE;
+
+	/* use a single file instead of the system metadata */
+	} else if (catalog != NULL) {
+		g_autoptr(GFile) file = g_file_new_for_path (catalog);
+		g_debug ("using AppStream data from %s", catalog);
+		if (!as_store_from_file (priv->store, file, NULL,
+					 cancellable, error)) {
+			gs_utils_error_convert_appstream (error);
+			return FALSE;
+		}
 	} else {
 		ret = as_store_load (priv->store,
 				     AS_STORE_LOAD_FLAG_IGNORE_INVALID |
@@ -259,14 +322,6 @@ gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
 		return FALSE;
 	}
 
-	/* prime the cache */
-	priv->app_hash_old = gs_plugin_appstream_create_app_hash (priv->store);
-
-	/* watch for changes */
-	g_signal_connect (priv->store, "changed",
-			  G_CALLBACK (gs_plugin_appstream_store_changed_cb),
-			  plugin);
-
 	/* add search terms for apps not in the main source */
 	origins = gs_plugin_appstream_get_origins_hash (items);
 	for (i = 0; i < items->len; i++) {
@@ -327,13 +382,60 @@ gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
 		}
 	}
 
+	/* only keep what is needed for lists and searching */
+	gs_appstream_store_prune_locales (priv->store,
+					  gs_plugin_get_locale (plugin),
+					  gs_plugin_get_language (plugin));
+	gs_appstream_store_compact (priv->store, NULL);
+	return TRUE;
+}
+
+gboolean
+gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+
+	if (!gs_plugin_appstream_load (plugin, cancellable, error))
+		return FALSE;
+
+	/* prime the cache */
+	priv->app_hash_old = gs_plugin_appstream_create_app_hash (priv->store);
+
+	/* watch for changes */
+	g_signal_connect (priv->store, "changed",
+			  G_CALLBACK (gs_plugin_appstream_store_changed_cb),
+			  plugin);
+
 	/* rely on the store keeping itself updated */
 	return TRUE;
 }
 
+gboolean
+gs_plugin_locale_changed (GsPlugin *plugin,
+			  GCancellable *cancellable,
+			  GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	/* the pruned translations can only be got back by loading again */
+	g_rw_lock_writer_lock (&priv->store_lock);
+	as_store_remove_all (priv->store);
+	ret = gs_plugin_appstream_load (plugin, cancellable, error);
+	g_rw_lock_writer_unlock (&priv->store_lock);
+	if (!ret)
+		return FALSE;
+
+	/* the apps that are already shown have the old translations */
+	gs_plugin_reload (plugin);
+	return TRUE;
+}
+
 static gboolean
 gs_plugin_refine_from_id (GsPlugin *plugin,
 			  GsApp *app,
+			  GsPluginRefineFlags flags,
+			  GCancellable *cancellable,
 			  gboolean *found,
 			  GError **error)
 {
@@ -371,6 +473,9 @@ gs_plugin_refine_from_id (GsPlugin *plugin,
 	/* set new properties */
 	if (!gs_appstream_refine_app (plugin, app, item, error))
 		return FALSE;
+	if (!gs_appstream_refine_app_detail (plugin, app, item, flags,
+					     cancellable, error))
+		return FALSE;
 
 	*found = TRUE;
 	return TRUE;
@@ -379,6 +484,8 @@ gs_plugin_refine_from_id (GsPlugin *plugin,
 static gboolean
 gs_plugin_refine_from_pkgname (GsPlugin *plugin,
 			       GsApp *app,
+			       GsPluginRefineFlags flags,
+			       GCancellable *cancellable,
 			       GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
@@ -402,14 +509,17 @@ gs_plugin_refine_from_pkgname (GsPlugin *plugin,
 		return TRUE;
 
 	/* set new properties */
-	return gs_appstream_refine_app (plugin, app, item, error);
+	if (!gs_appstream_refine_app (plugin, app, item, error))
+		return FALSE;
+	return gs_appstream_refine_app_detail (plugin, app, item, flags,
+					       cancellable, error);
 }
 
-gboolean
-gs_plugin_add_distro_upgrades (GsPlugin *plugin,
-			       GsAppList *list,
-			       GCancellable *cancellable,
-			       GError **error)
+static gboolean
+gs_plugin_appstream_add_distro_upgrades (GsPlugin *plugin,
+					 GsAppList *list,
+					 GCancellable *cancellable,
+					 GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	AsApp *item;
@@ -436,19 +546,37 @@ gs_plugin_add_distro_upgrades (GsPlugin *plugin,
 }
 
 gboolean
-gs_plugin_refine_app (GsPlugin *plugin,
-		      GsApp *app,
-		      GsPluginRefineFlags flags,
-		      GCancellable *cancellable,
-		      GError **error)
+gs_plugin_add_distro_upgrades (GsPlugin *plugin,
+			       GsAppList *list,
+			       GCancellable *cancellable,
+			       GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_plugin_appstream_add_distro_upgrades (plugin, list,
+						       cancellable, error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
+}
+
+static gboolean
+gs_plugin_appstream_refine_app (GsPlugin *plugin,
+				GsApp *app,
+				GsPluginRefineFlags flags,
+				GCancellable *cancellable,
+				GError **error)
 {
 	gboolean found = FALSE;
 
 	/* find by ID then package name */
-	if (!gs_plugin_refine_from_id (plugin, app, &found, error))
+	if (!gs_plugin_refine_from_id (plugin, app, flags, cancellable,
+				       &found, error))
 		return FALSE;
 	if (!found) {
-		if (!gs_plugin_refine_from_pkgname (plugin, app, error))
+		if (!gs_plugin_refine_from_pkgname (plugin, app, flags,
+						    cancellable, error))
 			return FALSE;
 	}
 
@@ -457,12 +585,29 @@ gs_plugin_refine_app (GsPlugin *plugin,
 }
 
 gboolean
-gs_plugin_refine_wildcard (GsPlugin *plugin,
-			   GsApp *app,
-			   GsAppList *list,
-			   GsPluginRefineFlags flags,
-			   GCancellable *cancellable,
-			   GError **error)
+gs_plugin_refine_app (GsPlugin *plugin,
+		      GsApp *app,
+		      GsPluginRefineFlags flags,
+		      GCancellable *cancellable,
+		      GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_plugin_appstream_refine_app (plugin, app, flags, cancellable,
+					      error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
+}
+
+static gboolean
+gs_plugin_appstream_refine_wildcard (GsPlugin *plugin,
+				     GsApp *app,
+				     GsAppList *list,
+				     GsPluginRefineFlags flags,
+				     GCancellable *cancellable,
+				     GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	const gchar *id;
@@ -503,6 +648,24 @@ gs_plugin_refine_wildcard (GsPlugin *plugin,
 	return TRUE;
 }
 
+gboolean
+gs_plugin_refine_wildcard (GsPlugin *plugin,
+			   GsApp *app,
+			   GsAppList *list,
+			   GsPluginRefineFlags flags,
+			   GCancellable *cancellable,
+			   GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_plugin_appstream_refine_wildcard (plugin, app, list, flags,
+						   cancellable, error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
+}
+
 gboolean
 gs_plugin_add_category_apps (GsPlugin *plugin,
 			     GsCategory *category,
@@ -511,12 +674,17 @@ gs_plugin_add_category_apps (GsPlugin *plugin,
 			     GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
-	return gs_appstream_store_add_category_apps (plugin,
-						     priv->store,
-						     category,
-						     list,
-						     cancellable,
-						     error);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_appstream_store_add_category_apps (plugin,
+						    priv->store,
+						    category,
+						    list,
+						    cancellable,
+						    error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
 }
 
 gboolean
@@ -527,19 +695,47 @@ gs_plugin_add_search (GsPlugin *plugin,
 		      GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
-	return gs_appstream_store_search (plugin,
-					  priv->store,
-					  values,
-					  list,
-					  cancellable,
-					  error);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_appstream_store_search (plugin,
+					 priv->store,
+					 values,
+					 list,
+					 cancellable,
+					 error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
 }
 
 gboolean
-gs_plugin_add_installed (GsPlugin *plugin,
-			 GsAppList *list,
-			 GCancellable *cancellable,
-			 GError **error)
+gs_plugin_add_search_narrow (GsPlugin *plugin,
+			     gchar **values,
+			     GsAppList *previous,
+			     GsAppList *list,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_appstream_store_search_previous (plugin,
+						  priv->store,
+						  values,
+						  previous,
+						  list,
+						  cancellable,
+						  error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
+}
+
+static gboolean
+gs_plugin_appstream_add_installed (GsPlugin *plugin,
+				   GsAppList *list,
+				   GCancellable *cancellable,
+				   GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	AsApp *item;
@@ -565,6 +761,22 @@ gs_plugin_add_installed (GsPlugin *plugin,
 	return TRUE;
 }
 
+gboolean
+gs_plugin_add_installed (GsPlugin *plugin,
+			 GsAppList *list,
+			 GCancellable *cancellable,
+			 GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_plugin_appstream_add_installed (plugin, list, cancellable,
+						 error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
+}
+
 gboolean
 gs_plugin_add_categories (GsPlugin *plugin,
 			  GPtrArray *list,
@@ -572,15 +784,20 @@ gs_plugin_add_categories (GsPlugin *plugin,
 			  GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
-	return gs_appstream_store_add_categories (plugin, priv->store, list,
-						  cancellable, error);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_appstream_store_add_categories (plugin, priv->store, list,
+						 cancellable, error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
 }
 
-gboolean
-gs_plugin_add_popular (GsPlugin *plugin,
-		       GsAppList *list,
-		       GCancellable *cancellable,
-		       GError **error)
+static gboolean
+gs_plugin_appstream_add_popular (GsPlugin *plugin,
+				 GsAppList *list,
+				 GCancellable *cancellable,
+				 GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	AsApp *item;
@@ -608,10 +825,26 @@ gs_plugin_add_popular (GsPlugin *plugin,
 }
 
 gboolean
-gs_plugin_add_featured (GsPlugin *plugin,
-			GsAppList *list,
-			GCancellable *cancellable,
-			GError **error)
+gs_plugin_add_popular (GsPlugin *plugin,
+		       GsAppList *list,
+		       GCancellable *cancellable,
+		       GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_plugin_appstream_add_popular (plugin, list, cancellable,
+					       error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
+}
+
+static gboolean
+gs_plugin_appstream_add_featured (GsPlugin *plugin,
+				  GsAppList *list,
+				  GCancellable *cancellable,
+				  GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	AsApp *item;
@@ -637,3 +870,19 @@ gs_plugin_add_featured (GsPlugin *plugin,
 	}
 	return TRUE;
 }
+
+gboolean
+gs_plugin_add_featured (GsPlugin *plugin,
+			GsAppList *list,
+			GCancellable *cancellable,
+			GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gboolean ret;
+
+	g_rw_lock_reader_lock (&priv->store_lock);
+	ret = gs_plugin_appstream_add_featured (plugin, list, cancellable,
+						error);
+	g_rw_lock_reader_unlock (&priv->store_lock);
+	return ret;
+}
@@ -33,12 +33,15 @@ struct GsPluginData {
 	guint			 has_auth;
 	GsAuth			*auth;
 	GsApp			*cached_origin;
+	guint			 latency_ms;
 };
 
 void
 gs_plugin_initialize (GsPlugin *plugin)
 {
 	GsPluginData *priv = gs_plugin_alloc_data (plugin, sizeof(GsPluginData));
+	const gchar *tmp;
+
 	if (g_getenv ("GS_SELF_TEST_DUMMY_ENABLE") == NULL) {
 		g_debug ("disabling '%s' as not in self test",
 			 gs_plugin_get_name (plugin));
@@ -46,6 +49,11 @@ gs_plugin_initialize (GsPlugin *plugin)
 		return;
 	}
 
+	/* emulate a slow backend, e.g. for benchmarking */
+	tmp = g_getenv ("GS_SELF_TEST_DUMMY_LATENCY");
+	if (tmp != NULL)
+		priv->latency_ms = g_ascii_strtoull (tmp, NULL, 10);
+
 	/* set up a dummy authentication provider */
 	priv->auth = gs_auth_new (gs_plugin_get_name (plugin));
 	gs_auth_set_provider_name (priv->auth, "GNOME SSO");
@@ -127,6 +135,18 @@ gs_plugin_dummy_delay (GsPlugin *plugin,
 	return ret;
 }
 
+static gboolean
+gs_plugin_dummy_latency (GsPlugin *plugin,
+			 GCancellable *cancellable,
+			 GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	if (priv->latency_ms == 0)
+		return TRUE;
+	return gs_plugin_dummy_delay (plugin, NULL, priv->latency_ms,
+				      cancellable, error);
+}
+
 static gboolean
 gs_plugin_dummy_poll_cb (gpointer user_data)
 {
@@ -165,6 +185,42 @@ gs_plugin_add_search (GsPlugin *plugin,
 	g_autoptr(GsApp) app = NULL;
 	g_autoptr(AsIcon) ic = NULL;
 
+	/* per-call latency */
+	if (!gs_plugin_dummy_latency (plugin, cancellable, error))
+		return FALSE;
+
+	/* more results than are shown, where the least popular ones match
+	 * in the name and the others only match in the description */
+	if (g_strcmp0 (values[0], "massive") == 0) {
+		guint i;
+		ic = as_icon_new ();
+		as_icon_set_kind (ic, AS_ICON_KIND_STOCK);
+		as_icon_set_name (ic, "drive-harddisk");
+		for (i = 0; i < 150; i++) {
+			g_autofree gchar *id = g_strdup_printf ("item%03u.desktop", i);
+			g_autofree gchar *name = NULL;
+			g_autoptr(GsApp) app_tmp = gs_app_new (id);
+			if (i % 3 == 0) {
+				name = g_strdup_printf ("Massive %03u", i);
+			} else {
+				name = g_strdup_printf ("Item %03u", i);
+				gs_app_set_description (app_tmp, GS_APP_QUALITY_NORMAL,
+							"A massive test application");
+				gs_app_add_kudo (app_tmp, GS_APP_KUDO_FEATURED_RECOMMENDED |
+							  GS_APP_KUDO_MY_LANGUAGE |
+							  GS_APP_KUDO_POPULAR);
+			}
+			gs_app_set_name (app_tmp, GS_APP_QUALITY_NORMAL, name);
+			gs_app_set_summary (app_tmp, GS_APP_QUALITY_NORMAL, "A test application");
+			gs_app_add_icon (app_tmp, ic);
+			gs_app_set_kind (app_tmp, AS_APP_KIND_DESKTOP);
+			gs_app_set_state (app_tmp, AS_APP_STATE_AVAILABLE);
+			gs_app_set_management_plugin (app_tmp, gs_plugin_get_name (plugin));
+			gs_app_list_add (list, app_tmp);
+		}
+		return TRUE;
+	}
+
 	/* we're very specific */
 	if (g_strcmp0 (values[0], "chiron") != 0)
 		return TRUE;
@@ -281,6 +337,10 @@ gs_plugin_add_installed (GsPlugin *plugin,
 	const gchar *app_ids[] = { "Uninstall Zeus.desktop", NULL };
 	guint i;
 
+	/* per-call latency */
+	if (!gs_plugin_dummy_latency (plugin, cancellable, error))
+		return FALSE;
+
 	/* add all packages */
 	for (i = 0; packages[i] != NULL; i++) {
 		g_autoptr(GsApp) app = gs_app_new (NULL);
@@ -313,6 +373,10 @@ gs_plugin_add_popular (GsPlugin *plugin,
 	g_autoptr(GsApp) app1 = NULL;
 	g_autoptr(GsApp) app2 = NULL;
 
+	/* per-call latency */
+	if (!gs_plugin_dummy_latency (plugin, cancellable, error))
+		return FALSE;
+
 	/* add wildcard */
 	app1 = gs_app_new ("zeus.desktop");
 	gs_app_add_quirk (app1, AS_APP_QUIRK_MATCH_ANY_PREFIX);
@@ -376,6 +440,49 @@ gs_plugin_app_install (GsPlugin *plugin,
 	return TRUE;
 }
 
+gboolean
+gs_plugin_install_apps (GsPlugin *plugin,
+			GsAppList *list,
+			GCancellable *cancellable,
+			GError **error)
+{
+	guint i;
+	g_autoptr(GsAppList) list_batch = gs_app_list_new ();
+
+	/* chiron is left for gs_plugin_app_install() */
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		if (g_strcmp0 (gs_app_get_management_plugin (app),
+			       gs_plugin_get_name (plugin)) != 0)
+			continue;
+		if (g_strcmp0 (gs_app_get_id (app), "chiron.desktop") == 0)
+			continue;
+		if (gs_app_get_state (app) != AS_APP_STATE_AVAILABLE)
+			continue;
+		gs_app_list_add (list_batch, app);
+	}
+	if (gs_app_list_length (list_batch) == 0)
+		return TRUE;
+
+	/* install everything in one go */
+	for (i = 0; i < gs_app_list_length (list_batch); i++) {
+		GsApp *app = gs_app_list_index (list_batch, i);
+		gs_app_set_state (app, AS_APP_STATE_INSTALLING);
+	}
+	if (!gs_plugin_dummy_delay (plugin, NULL, 500, cancellable, error)) {
+		for (i = 0; i < gs_app_list_length (list_batch); i++) {
+			GsApp *app = gs_app_list_index (list_batch, i);
+			gs_app_set_state_recover (app);
+		}
+		return FALSE;
+	}
+	for (i = 0; i < gs_app_list_length (list_batch); i++) {
+		GsApp *app = gs_app_list_index (list_batch, i);
+		gs_app_set_state (app, AS_APP_STATE_INSTALLED);
+	}
+	return TRUE;
+}
+
 gboolean
 gs_plugin_update_app (GsPlugin *plugin,
 		      GsApp *app,
@@ -389,13 +496,36 @@ gs_plugin_update_app (GsPlugin *plugin,
 		       gs_plugin_get_name (plugin)) != 0)
 		return TRUE;
 
-	/* always fail */
-	g_set_error_literal (error,
-			     GS_PLUGIN_ERROR,
-			     GS_PLUGIN_ERROR_DOWNLOAD_FAILED,
-			     "no network connection is available");
-	gs_utils_error_add_unique_id (error, priv->cached_origin);
-	return FALSE;
+	if (g_strcmp0 (gs_app_get_id (app), "chiron.desktop") == 0) {
+		g_set_error_literal (error,
+				     GS_PLUGIN_ERROR,
+				     GS_PLUGIN_ERROR_DOWNLOAD_FAILED,
+				     "no network connection is available");
+		gs_utils_error_add_unique_id (error, priv->cached_origin);
+		return FALSE;
+	}
+
+	/* deploy the already downloaded payload */
+	gs_app_set_state (app, AS_APP_STATE_INSTALLING);
+	gs_app_set_state (app, AS_APP_STATE_INSTALLED);
+	return TRUE;
+}
+
+gboolean
+gs_plugin_download_app (GsPlugin *plugin,
+			GsApp *app,
+			GCancellable *cancellable,
+			GError **error)
+{
+	/* only process this app if was created by this plugin */
+	if (g_strcmp0 (gs_app_get_management_plugin (app),
+		       gs_plugin_get_name (plugin)) != 0)
+		return TRUE;
+
+	/* a large payload */
+	if (g_strcmp0 (gs_app_get_id (app), "kronos.desktop") == 0)
+		return gs_plugin_dummy_delay (plugin, app, 1000, cancellable, error);
+	return TRUE;
 }
 
 gboolean
@@ -405,6 +535,10 @@ gs_plugin_refine_app (GsPlugin *plugin,
 		      GCancellable *cancellable,
 		      GError **error)
 {
+	/* per-call latency */
+	if (!gs_plugin_dummy_latency (plugin, cancellable, error))
+		return FALSE;
+
 	/* default */
 	if (g_strcmp0 (gs_app_get_id (app), "chiron.desktop") == 0 ||
 	    g_strcmp0 (gs_app_get_id (app), "mate-spell.desktop") == 0 ||
@@ -515,6 +649,11 @@ gs_plugin_add_category_apps (GsPlugin *plugin,
 			     GError **error)
 {
 	g_autoptr(GsApp) app = gs_app_new ("chiron.desktop");
+
+	/* per-call latency */
+	if (!gs_plugin_dummy_latency (plugin, cancellable, error))
+		return FALSE;
+
 	gs_app_set_name (app, GS_APP_QUALITY_NORMAL, "Chiron");
 	gs_app_set_summary (app, GS_APP_QUALITY_NORMAL, "View and use virtual machines");
 	gs_app_set_url (app, AS_URL_KIND_HOMEPAGE, "http://www.box.org");
@@ -28,7 +28,6 @@
 
 struct GsPluginData {
 	gchar		*cachefn;
-	GFileMonitor	*cachefn_monitor;
 	gchar		*os_name;
 	guint64		 os_version;
 	GsApp		*cached_origin;
@@ -50,8 +49,6 @@ void
 gs_plugin_destroy (GsPlugin *plugin)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
-	if (priv->cachefn_monitor != NULL)
-		g_object_unref (priv->cachefn_monitor);
 	if (priv->cached_origin != NULL)
 		g_object_unref (priv->cached_origin);
 	g_free (priv->os_name);
@@ -59,14 +56,9 @@ gs_plugin_destroy (GsPlugin *plugin)
 }
 
 static void
-gs_plugin_fedora_distro_upgrades_changed_cb (GFileMonitor *monitor,
-					     GFile *file,
-					     GFile *other_file,
-					     GFileMonitorEvent event_type,
+gs_plugin_fedora_distro_upgrades_changed_cb (GsPlugin *plugin,
 					     gpointer user_data)
 {
-	GsPlugin *plugin = GS_PLUGIN (user_data);
-
 	/* only reload the update list if the plugin is NOT running itself
 	 * and the time since it ran is greater than 5 seconds (inotify FTW) */
 	if (gs_plugin_has_flags (plugin, GS_PLUGIN_FLAGS_RUNNING_SELF)) {
@@ -100,14 +92,10 @@ gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
 
 	/* watch this in case it is changed by the user */
 	file = g_file_new_for_path (priv->cachefn);
-	priv->cachefn_monitor = g_file_monitor (file,
-							G_FILE_MONITOR_NONE,
-							cancellable,
-							error);
-	if (priv->cachefn_monitor == NULL)
+	if (!gs_plugin_watch_file (plugin, file,
+				   gs_plugin_fedora_distro_upgrades_changed_cb,
+				   NULL, cancellable, error))
 		return FALSE;
-	g_signal_connect (priv->cachefn_monitor, "changed",
-			  G_CALLBACK (gs_plugin_fedora_distro_upgrades_changed_cb), plugin);
 
 	/* read os-release for the current versions */
 	os_release = gs_os_release_new (error);
@@ -48,6 +48,7 @@ gs_plugin_initialize (GsPlugin *plugin)
 
 	/* set plugin flags */
 	gs_plugin_add_flags (plugin, GS_PLUGIN_FLAGS_GLOBAL_CACHE);
+	gs_plugin_add_flags (plugin, GS_PLUGIN_FLAGS_NARROWABLE_SEARCH);
 
 	/* getting app properties from appstream is quicker */
 	gs_plugin_add_rule (plugin, GS_PLUGIN_RULE_RUN_AFTER, "appstream");
@@ -80,6 +81,15 @@ gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
 	return gs_flatpak_setup (priv->flatpak, cancellable, error);
 }
 
+gboolean
+gs_plugin_locale_changed (GsPlugin *plugin,
+			  GCancellable *cancellable,
+			  GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	return gs_flatpak_locale_changed (priv->flatpak, cancellable, error);
+}
+
 gboolean
 gs_plugin_add_installed (GsPlugin *plugin,
 			 GsAppList *list,
@@ -118,6 +128,9 @@ gs_plugin_refresh (GsPlugin *plugin,
 		   GError **error)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
+	gs_flatpak_set_download_parallel (priv->flatpak,
+					  g_settings_get_uint (priv->settings,
+							       "download-updates-parallel"));
 	return gs_flatpak_refresh (priv->flatpak, cache_age, flags,
 				   cancellable, error);
 }
@@ -177,6 +190,16 @@ gs_plugin_app_install (GsPlugin *plugin,
 	return gs_flatpak_app_install (priv->flatpak, app, cancellable, error);
 }
 
+gboolean
+gs_plugin_download_app (GsPlugin *plugin,
+			GsApp *app,
+			GCancellable *cancellable,
+			GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	return gs_flatpak_download_app (priv->flatpak, app, cancellable, error);
+}
+
 gboolean
 gs_plugin_update_app (GsPlugin *plugin,
 		      GsApp *app,
@@ -222,6 +245,23 @@ gs_plugin_add_search (GsPlugin *plugin,
 				  error);
 }
 
+gboolean
+gs_plugin_add_search_narrow (GsPlugin *plugin,
+			     gchar **values,
+			     GsAppList *previous,
+			     GsAppList *list,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	return gs_flatpak_search_narrow (priv->flatpak,
+					 values,
+					 previous,
+					 list,
+					 cancellable,
+					 error);
+}
+
 gboolean
 gs_plugin_add_categories (GsPlugin *plugin,
 			  GPtrArray *list,
@@ -95,6 +95,10 @@ gs_plugin_initialize (GsPlugin *plugin)
 	priv->client = fwupd_client_new ();
 	priv->to_download = g_ptr_array_new_with_free_func (g_free);
 	priv->to_ignore = g_ptr_array_new_with_free_func (g_free);
+
+	/* connecting to the daemon can wait until firmware is needed */
+	gs_plugin_add_flags (plugin, GS_PLUGIN_FLAGS_SETUP_ON_DEMAND);
+
 	priv->config_fn = g_build_filename (SYSCONFDIR, "fwupd.conf", NULL);
 	if (!g_file_test (priv->config_fn, G_FILE_TEST_EXISTS)) {
 		g_free (priv->config_fn);
@@ -180,6 +180,9 @@ gs_plugin_app_remove (GsPlugin *plugin,
 
 	gs_app_set_state (app, AS_APP_STATE_AVAILABLE);
 
+	/* the removed software no longer has updates */
+	gs_plugin_updates_changed (plugin);
+
 	return TRUE;
 }
 
@@ -235,6 +238,9 @@ gs_plugin_app_install (GsPlugin *plugin,
 
 	gs_app_set_state (app, AS_APP_STATE_INSTALLED);
 
+	/* the installed software may have updates */
+	gs_plugin_updates_changed (plugin);
+
 	return TRUE;
 }
 
@@ -274,6 +280,9 @@ gs_plugin_refresh (GsPlugin *plugin,
 		return FALSE;
 	}
 
+	/* the new metadata may have new updates */
+	gs_plugin_updates_changed (plugin);
+
 	return TRUE;
 }
 
@@ -451,5 +460,8 @@ gs_plugin_update_app (GsPlugin *plugin,
 	}
 	gs_app_set_state (app, AS_APP_STATE_INSTALLED);
 
+	/* the update is no longer available */
+	gs_plugin_updates_changed (plugin);
+
 	return TRUE;
 }
@@ -419,6 +419,86 @@ gs_plugin_app_install (GsPlugin *plugin,
 	return TRUE;
 }
 
+gboolean
+gs_plugin_install_apps (GsPlugin *plugin,
+			GsAppList *list,
+			GCancellable *cancellable,
+			GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	GPtrArray *source_ids;
+	ProgressData data;
+	const gchar *package_id;
+	guint i, j;
+	g_autoptr(GHashTable) package_ids_hash = NULL;
+	g_autoptr(GPtrArray) array_package_ids = NULL;
+	g_autoptr(GsAppList) list_batch = gs_app_list_new ();
+	g_autoptr(PkResults) results = NULL;
+
+	data.app = NULL;
+	data.plugin = plugin;
+	data.ptask = NULL;
+
+	/* collect the packages that can share one transaction */
+	package_ids_hash = g_hash_table_new (g_str_hash, g_str_equal);
+	array_package_ids = g_ptr_array_new_with_free_func (g_free);
+	for (i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+
+		if (g_strcmp0 (gs_app_get_management_plugin (app),
+			       gs_plugin_get_name (plugin)) != 0)
+			continue;
+
+		/* needs a repo enabling or a local file, so is left for
+		 * gs_plugin_app_install() */
+		if (gs_app_get_state (app) != AS_APP_STATE_AVAILABLE &&
+		    gs_app_get_state (app) != AS_APP_STATE_UPDATABLE)
+			continue;
+
+		/* the addons are queued as apps in their own right */
+		source_ids = gs_app_get_source_ids (app);
+		for (j = 0; j < source_ids->len; j++) {
+			package_id = g_ptr_array_index (source_ids, j);
+			if (g_strstr_len (package_id, -1, ";installed") != NULL)
+				continue;
+			if (g_hash_table_contains (package_ids_hash, package_id))
+				continue;
+			g_hash_table_add (package_ids_hash, (gpointer) package_id);
+			g_ptr_array_add (array_package_ids, g_strdup (package_id));
+		}
+		gs_app_list_add (list_batch, app);
+	}
+	if (array_package_ids->len == 0)
+		return TRUE;
+	g_ptr_array_add (array_package_ids, NULL);
+
+	/* install everything else in a single transaction */
+	for (i = 0; i < gs_app_list_length (list_batch); i++) {
+		GsApp *app = gs_app_list_index (list_batch, i);
+		gs_app_set_state (app, AS_APP_STATE_INSTALLING);
+	}
+	results = pk_task_install_packages_sync (priv->task,
+						 (gchar **) array_package_ids->pdata,
+						 cancellable,
+						 gs_plugin_packagekit_progress_cb, &data,
+						 error);
+	if (!gs_plugin_packagekit_results_valid (results, error)) {
+		for (i = 0; i < gs_app_list_length (list_batch); i++) {
+			GsApp *app = gs_app_list_index (list_batch, i);
+			gs_app_set_state_recover (app);
+		}
+		return FALSE;
+	}
+
+	/* state is known */
+	for (i = 0; i < gs_app_list_length (list_batch); i++) {
+		GsApp *app = gs_app_list_index (list_batch, i);
+		gs_app_set_state (app, AS_APP_STATE_INSTALLED);
+		gs_app_clear_source_ids (app);
+	}
+	return TRUE;
+}
+
 static gboolean
 gs_plugin_app_source_disable (GsPlugin *plugin,
 			      GsApp *app,
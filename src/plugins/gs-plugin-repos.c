@@ -25,7 +25,6 @@
 
 struct GsPluginData {
 	GHashTable	*urls;		/* origin : url */
-	GFileMonitor	*monitor;
 	gchar		*reposdir;
 	gboolean	 valid;
 };
@@ -60,8 +59,6 @@ gs_plugin_destroy (GsPlugin *plugin)
 	g_free (priv->reposdir);
 	if (priv->urls != NULL)
 		g_hash_table_unref (priv->urls);
-	if (priv->monitor != NULL)
-		g_object_unref (priv->monitor);
 }
 
 static gboolean
@@ -130,11 +127,7 @@ gs_plugin_repos_setup (GsPlugin *plugin, GCancellable *cancellable, GError **err
 }
 
 static void
-gs_plugin_repos_changed_cb (GFileMonitor *monitor,
-			    GFile *file,
-			    GFile *other_file,
-			    GFileMonitorEvent event_type,
-			    GsPlugin *plugin)
+gs_plugin_repos_changed_cb (GsPlugin *plugin, gpointer user_data)
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	priv->valid = FALSE;
@@ -147,13 +140,10 @@ gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
 	g_autoptr(GFile) file = g_file_new_for_path (priv->reposdir);
 
 	/* watch for changes */
-	priv->monitor = g_file_monitor_directory (file, G_FILE_MONITOR_NONE, cancellable, error);
-	if (priv->monitor == NULL) {
-		gs_utils_error_convert_gio (error);
+	if (!gs_plugin_watch_file (plugin, file,
+				   gs_plugin_repos_changed_cb, NULL,
+				   cancellable, error))
 		return FALSE;
-	}
-	g_signal_connect (priv->monitor, "changed",
-			  G_CALLBACK (gs_plugin_repos_changed_cb), plugin);
 
 	/* unconditionally at startup */
 	return gs_plugin_repos_setup (plugin, cancellable, error);
@@ -79,6 +79,9 @@ gs_plugin_initialize (GsPlugin *plugin)
 	gs_plugin_cache_add (plugin,
 			     gs_app_get_unique_id (priv->cached_origin),
 			     priv->cached_origin);
+
+	/* the shell proxy is only needed when extensions are shown */
+	gs_plugin_add_flags (plugin, GS_PLUGIN_FLAGS_SETUP_ON_DEMAND);
 }
 
 void
@@ -29,6 +29,9 @@
 void
 gs_plugin_initialize (GsPlugin *plugin)
 {
+	/* search only refreshes the store, results come from appstream */
+	gs_plugin_add_flags (plugin, GS_PLUGIN_FLAGS_NARROWABLE_SEARCH);
+
 	/* need metadata */
 	gs_plugin_add_rule (plugin, GS_PLUGIN_RULE_RUN_AFTER, "appstream");
 }
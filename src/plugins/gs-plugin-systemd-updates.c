@@ -52,6 +52,13 @@ gs_plugin_destroy (GsPlugin *plugin)
 		g_object_unref (priv->monitor);
 }
 
+static void
+gs_plugin_systemd_updates_refresh_cb (GsPlugin *plugin, gpointer user_data)
+{
+	/* update UI */
+	gs_plugin_updates_changed (plugin);
+}
+
 static void
 gs_plugin_systemd_updates_changed_cb (GFileMonitor *monitor,
 				      GFile *file, GFile *other_file,
@@ -60,8 +67,8 @@ gs_plugin_systemd_updates_changed_cb (GFileMonitor *monitor,
 {
 	GsPlugin *plugin = GS_PLUGIN (user_data);
 
-	/* update UI */
-	gs_plugin_updates_changed (plugin);
+	/* the prepared-update file is written in several steps */
+	gs_plugin_watch_queue (plugin, gs_plugin_systemd_updates_refresh_cb, NULL);
 }
 
 gboolean
@@ -22,6 +22,7 @@
 #include "config.h"
 
 #include <glib-object.h>
+#include <string.h>
 
 #include "gs-markdown.h"
 
@@ -205,6 +206,125 @@ gs_markdown_func (void)
 	g_free (text);
 }
 
+/* every '<' in escaped Pango output has to be the start of a tag we added */
+static void
+gs_markdown_check_pango (const gchar *text)
+{
+	const gchar *tags[] = { "<b>", "</b>", "<i>", "</i>", "<tt>", "</tt>",
+				"<big>", "</big>", "<a href=", "</a>", NULL };
+	const gchar *tmp;
+	guint i;
+
+	for (tmp = strchr (text, '<'); tmp != NULL; tmp = strchr (tmp + 1, '<')) {
+		for (i = 0; tags[i] != NULL; i++) {
+			if (g_str_has_prefix (tmp, tags[i]))
+				break;
+		}
+		if (tags[i] == NULL)
+			g_error ("unescaped markup in '%s'", text);
+	}
+}
+
+static void
+gs_markdown_fuzz_func (void)
+{
+	const gchar *pieces[] = { "*", "**", "_", "__", "`", "\"", "'", " ",
+				  " ", " -- ", "-", "#", "=", "\n", "\n\n",
+				  "* ", " - ", "<", ">", "&", "\t", "a", "word",
+				  "/usr", "foo()", "me@example.com", "CONFIG_A_B",
+				  "http://example.com/", "\303\251", "\342\200\224" };
+	GsMarkdownOutputKind kinds[] = { GS_MARKDOWN_OUTPUT_TEXT,
+					 GS_MARKDOWN_OUTPUT_PANGO,
+					 GS_MARKDOWN_OUTPUT_HTML };
+	guint i;
+	guint j;
+	guint k;
+	guint iterations = g_test_thorough () ? 100000 : 2000;
+	g_autoptr(GRand) rand = g_rand_new_with_seed (0x5eed);
+	g_autoptr(GString) str = g_string_new (NULL);
+
+	for (k = 0; k < G_N_ELEMENTS (kinds); k++) {
+		g_autoptr(GsMarkdown) md = gs_markdown_new (kinds[k]);
+		for (i = 0; i < iterations; i++) {
+			guint len = (guint) g_rand_int_range (rand, 0, 64);
+			g_autofree gchar *text = NULL;
+			g_autofree gchar *text2 = NULL;
+
+			/* change the settings every so often */
+			if (i % 64 == 0) {
+				gs_markdown_set_smart_quoting (md, g_rand_boolean (rand));
+				gs_markdown_set_autocode (md, g_rand_boolean (rand));
+				gs_markdown_set_max_lines (md, g_rand_int_range (rand, -1, 8));
+			}
+
+			g_string_truncate (str, 0);
+			for (j = 0; j < len; j++) {
+				gint idx = g_rand_int_range (rand, 0, G_N_ELEMENTS (pieces));
+				g_string_append (str, pieces[idx]);
+			}
+			text = gs_markdown_parse (md, str->str);
+			g_assert (text != NULL);
+			g_assert (g_utf8_validate (text, -1, NULL));
+			if (kinds[k] == GS_MARKDOWN_OUTPUT_PANGO)
+				gs_markdown_check_pango (text);
+
+			/* nothing is kept between calls */
+			text2 = gs_markdown_parse (md, str->str);
+			g_assert_cmpstr (text, ==, text2);
+		}
+	}
+}
+
+static gdouble
+gs_markdown_time_parse (GsMarkdown *md, const gchar *markdown)
+{
+	g_autofree gchar *text = NULL;
+	g_autoptr(GTimer) timer = g_timer_new ();
+	text = gs_markdown_parse (md, markdown);
+	g_assert (text != NULL);
+	return g_timer_elapsed (timer, NULL);
+}
+
+static void
+gs_markdown_throughput_func (void)
+{
+	const gchar *line = "* Fix a *crash* in __gs_app_foo__ when `bar` is "
+			    "NULL -- see http://example.com/ and 'the' _bug_\n";
+	gdouble elapsed_small;
+	gdouble elapsed_large;
+	guint i;
+	g_autoptr(GsMarkdown) md = gs_markdown_new (GS_MARKDOWN_OUTPUT_PANGO);
+	g_autoptr(GString) small = g_string_new (NULL);
+	g_autoptr(GString) large = g_string_new (NULL);
+
+	gs_markdown_set_autocode (md, TRUE);
+	gs_markdown_set_smart_quoting (md, TRUE);
+
+	/* a long changelog */
+	for (i = 0; i < 1000; i++)
+		g_string_append (small, line);
+	for (i = 0; i < 8; i++)
+		g_string_append (large, small->str);
+	elapsed_small = gs_markdown_time_parse (md, small->str);
+	elapsed_large = gs_markdown_time_parse (md, large->str);
+	g_test_minimized_result (elapsed_large / 8000, "%.2f us per line",
+				 1000000 * elapsed_large / 8000);
+	g_assert_cmpfloat (elapsed_large, <, 8 * 4 * elapsed_small + 0.01);
+
+	/* one very long paragraph full of markers */
+	g_string_truncate (small, 0);
+	for (i = 0; i < 2000; i++)
+		g_string_append (small, "a * b *c* _d_ **e** ");
+	g_string_truncate (large, 0);
+	for (i = 0; i < 8; i++)
+		g_string_append (large, small->str);
+	elapsed_small = gs_markdown_time_parse (md, small->str);
+	elapsed_large = gs_markdown_time_parse (md, large->str);
+	g_test_minimized_result (elapsed_large, "%.2f ms for %u bytes",
+				 1000 * elapsed_large, (guint) large->len);
+	g_assert_cmpfloat (elapsed_large, <, 8 * 4 * elapsed_small + 0.01);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -216,6 +336,9 @@ main (int argc, char **argv)
 
 	/* tests go here */
 	g_test_add_func ("/gnome-software/markdown", gs_markdown_func);
+	g_test_add_func ("/gnome-software/markdown{fuzz}", gs_markdown_fuzz_func);
+	if (g_test_perf ())
+		g_test_add_func ("/gnome-software/markdown{throughput}", gs_markdown_throughput_func);
 
 	return g_test_run ();
 }